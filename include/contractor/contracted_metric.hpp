@@ -2,6 +2,7 @@
 #define OSMR_CONTRACTOR_CONTRACTED_METRIC_HPP
 
 #include "contractor/query_graph.hpp"
+#include "contractor/shortcut_children.hpp"
 
 namespace osrm
 {
@@ -14,6 +15,8 @@ template <storage::Ownership Ownership> struct ContractedMetric
 {
     detail::QueryGraph<Ownership> graph;
     std::vector<util::ViewOrVector<bool, Ownership>> edge_filter;
+    // Children of the shortcuts in the graph of each edge filter
+    std::vector<ShortcutChildrenTableImpl<Ownership>> shortcut_children;
 };
 } // namespace detail
 
@@ -15,6 +15,26 @@ namespace contractor
 namespace serialization
 {
 
+template <storage::Ownership Ownership>
+inline void read(storage::tar::FileReader &reader,
+                 const std::string &name,
+                 detail::ShortcutChildrenTableImpl<Ownership> &table)
+{
+    storage::serialization::read(reader, name + "/has_children", table.has_children);
+    storage::serialization::read(reader, name + "/ranks", table.ranks);
+    storage::serialization::read(reader, name + "/children", table.children);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::tar::FileWriter &writer,
+                  const std::string &name,
+                  const detail::ShortcutChildrenTableImpl<Ownership> &table)
+{
+    storage::serialization::write(writer, name + "/has_children", table.has_children);
+    storage::serialization::write(writer, name + "/ranks", table.ranks);
+    storage::serialization::write(writer, name + "/children", table.children);
+}
+
 template <storage::Ownership Ownership>
 void write(storage::tar::FileWriter &writer,
            const std::string &name,
@@ -29,6 +49,14 @@ void write(storage::tar::FileWriter &writer,
                                       name + "/exclude/" + std::to_string(index) + "/edge_filter",
                                       metric.edge_filter[index]);
     }
+
+    writer.WriteElementCount64(name + "/shortcut_children", metric.shortcut_children.size());
+    for (const auto index : util::irange<std::size_t>(0, metric.shortcut_children.size()))
+    {
+        serialization::write(writer,
+                             name + "/shortcut_children/" + std::to_string(index),
+                             metric.shortcut_children[index]);
+    }
 }
 
 template <storage::Ownership Ownership>
@@ -45,6 +73,21 @@ void read(storage::tar::FileReader &reader,
                                      name + "/exclude/" + std::to_string(index) + "/edge_filter",
                                      metric.edge_filter[index]);
     }
+
+    // Files of older versions have no children, their shortcuts are unpacked by looking up the
+    // edges of the halves
+    if (!reader.HasEntry(name + "/shortcut_children.meta"))
+    {
+        return;
+    }
+
+    metric.shortcut_children.resize(reader.ReadElementCount64(name + "/shortcut_children"));
+    for (const auto index : util::irange<std::size_t>(0, metric.shortcut_children.size()))
+    {
+        serialization::read(reader,
+                            name + "/shortcut_children/" + std::to_string(index),
+                            metric.shortcut_children[index]);
+    }
 }
 } // namespace serialization
 } // namespace contractor
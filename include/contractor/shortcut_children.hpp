@@ -0,0 +1,200 @@
+#ifndef OSRM_CONTRACTOR_SHORTCUT_CHILDREN_HPP
+#define OSRM_CONTRACTOR_SHORTCUT_CHILDREN_HPP
+
+#include "contractor/query_graph.hpp"
+
+#include "util/bit_range.hpp"
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include "storage/shared_memory_ownership.hpp"
+#include "storage/tar_fwd.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// The edges of the two halves of a shortcut: the edge the path from the start of the shortcut to
+// its middle node takes and the edge the path from the middle node to its end takes. The path of
+// a forward shortcut starts at the node it is stored at, the path of a backward shortcut ends
+// there. Edges that are no shortcuts, shortcuts usable in both directions and edges removed by
+// the edge filter have no children, the halves of their paths have to be looked up.
+struct ShortcutChildren
+{
+    EdgeID first;
+    EdgeID second;
+};
+
+namespace detail
+{
+template <storage::Ownership Ownership> class ShortcutChildrenTableImpl;
+}
+using ShortcutChildrenTable = detail::ShortcutChildrenTableImpl<storage::Ownership::Container>;
+using ShortcutChildrenTableView = detail::ShortcutChildrenTableImpl<storage::Ownership::View>;
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+void read(storage::tar::FileReader &reader,
+          const std::string &name,
+          detail::ShortcutChildrenTableImpl<Ownership> &table);
+template <storage::Ownership Ownership>
+void write(storage::tar::FileWriter &writer,
+           const std::string &name,
+           const detail::ShortcutChildrenTableImpl<Ownership> &table);
+} // namespace serialization
+
+namespace detail
+{
+// Children of the edges that have them, stored once per shortcut. A bit per edge marks these
+// edges and the number of marked edges before each word of bits gives the rank of an edge among
+// them, so a lookup costs two reads and a popcount.
+template <storage::Ownership Ownership> class ShortcutChildrenTableImpl final
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+    using Word = std::uint64_t;
+    static const constexpr std::size_t WORD_BITS = sizeof(Word) * CHAR_BIT;
+
+  public:
+    ShortcutChildrenTableImpl() = default;
+
+    ShortcutChildrenTableImpl(Vector<Word> has_children_,
+                              Vector<std::uint32_t> ranks_,
+                              Vector<ShortcutChildren> children_)
+        : has_children(std::move(has_children_)), ranks(std::move(ranks_)),
+          children(std::move(children_))
+    {
+        BOOST_ASSERT(has_children.size() == ranks.size());
+    }
+
+    // children indexed by edge, edges without children hold SPECIAL_EDGEID
+    template <typename = typename std::enable_if<Ownership == storage::Ownership::Container>>
+    explicit ShortcutChildrenTableImpl(const std::vector<ShortcutChildren> &edge_children)
+        : has_children((edge_children.size() + WORD_BITS - 1) / WORD_BITS, 0),
+          ranks(has_children.size(), 0)
+    {
+        for (std::size_t edge = 0; edge < edge_children.size(); ++edge)
+        {
+            if (edge % WORD_BITS == 0)
+                ranks[edge / WORD_BITS] = children.size();
+
+            if (edge_children[edge].first != SPECIAL_EDGEID)
+            {
+                has_children[edge / WORD_BITS] |= Word{1} << (edge % WORD_BITS);
+                children.push_back(edge_children[edge]);
+            }
+        }
+    }
+
+    // SPECIAL_EDGEID for edges without children and for all edges of an empty table
+    ShortcutChildren operator[](const EdgeID edge) const
+    {
+        const auto word_index = edge / WORD_BITS;
+        if (word_index >= has_children.size())
+            return {SPECIAL_EDGEID, SPECIAL_EDGEID};
+
+        const auto word = has_children[word_index];
+        const auto bit = Word{1} << (edge % WORD_BITS);
+        if ((word & bit) == 0)
+            return {SPECIAL_EDGEID, SPECIAL_EDGEID};
+
+        return children[ranks[word_index] + util::detail::countOnes(word & (bit - 1))];
+    }
+
+    std::size_t GetNumberOfShortcuts() const { return children.size(); }
+
+    friend void serialization::read<Ownership>(storage::tar::FileReader &reader,
+                                               const std::string &name,
+                                               ShortcutChildrenTableImpl &table);
+    friend void serialization::write<Ownership>(storage::tar::FileWriter &writer,
+                                                const std::string &name,
+                                                const ShortcutChildrenTableImpl &table);
+
+  private:
+    Vector<Word> has_children;
+    Vector<std::uint32_t> ranks;
+    Vector<ShortcutChildren> children;
+};
+
+// The edge the path from -> to takes in the graph of the edge filter. Like the engine does when it
+// unpacks a path this is the smallest forward edge from -> to or, for parts of a path found by the
+// backward search, the smallest backward edge to -> from.
+inline EdgeID findPathEdge(const contractor::QueryGraph &graph,
+                           const std::vector<bool> &edge_filter,
+                           const NodeID from,
+                           const NodeID to)
+{
+    const auto find_smallest_edge = [&](const NodeID node,
+                                        const NodeID target,
+                                        const bool forward) {
+        EdgeID smallest_edge = SPECIAL_EDGEID;
+        EdgeWeight smallest_weight = INVALID_EDGE_WEIGHT;
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = graph.GetEdgeData(edge);
+            if (edge_filter[edge] && graph.GetTarget(edge) == target &&
+                data.weight < smallest_weight && (forward ? data.forward : data.backward))
+            {
+                smallest_edge = edge;
+                smallest_weight = data.weight;
+            }
+        }
+        return smallest_edge;
+    };
+
+    const auto edge = find_smallest_edge(from, to, true);
+    return edge != SPECIAL_EDGEID ? edge : find_smallest_edge(to, from, false);
+}
+} // namespace detail
+
+// Children of all shortcuts of the contracted graph that the edge filter keeps
+inline ShortcutChildrenTable makeShortcutChildren(const QueryGraph &graph,
+                                                  const std::vector<bool> &edge_filter)
+{
+    BOOST_ASSERT(edge_filter.size() == graph.GetNumberOfEdges());
+    std::vector<ShortcutChildren> children(graph.GetNumberOfEdges(),
+                                           ShortcutChildren{SPECIAL_EDGEID, SPECIAL_EDGEID});
+
+    const auto add_children = [&](const NodeID node) {
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = graph.GetEdgeData(edge);
+            if (!edge_filter[edge] || !data.shortcut || (data.forward && data.backward))
+                continue;
+
+            const auto target = graph.GetTarget(edge);
+            const NodeID middle = data.turn_id;
+            const auto from = data.forward ? node : target;
+            const auto to = data.forward ? target : node;
+            children[edge] = {detail::findPathEdge(graph, edge_filter, from, middle),
+                              detail::findPathEdge(graph, edge_filter, middle, to)};
+            BOOST_ASSERT(children[edge].first != SPECIAL_EDGEID);
+            BOOST_ASSERT(children[edge].second != SPECIAL_EDGEID);
+        }
+    };
+
+    tbb::parallel_for(tbb::blocked_range<NodeID>(0, graph.GetNumberOfNodes()),
+                      [&](const tbb::blocked_range<NodeID> &range) {
+                          for (auto node = range.begin(); node != range.end(); ++node)
+                          {
+                              add_children(node);
+                          }
+                      });
+
+    return ShortcutChildrenTable{children};
+}
+} // namespace contractor
+} // namespace osrm
+
+#endif // OSRM_CONTRACTOR_SHORTCUT_CHILDREN_HPP
@@ -26,8 +26,12 @@ class CellCustomizer
     };
 
   public:
-    using Heap =
-        util::QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::ArrayStorage<NodeID, int>>;
+    using Heap = util::QueryHeap<NodeID,
+                                 NodeID,
+                                 EdgeWeight,
+                                 HeapData,
+                                 util::ArrayStorage<NodeID, int>,
+                                 util::SearchQueue>;
     using HeapPtr = tbb::enumerable_thread_specific<Heap>;
 
     CellCustomizer(const partitioner::MultiLevelPartition &partition) : partition(partition) {}
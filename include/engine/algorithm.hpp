@@ -50,6 +50,9 @@ template <typename AlgorithmT> struct HasMapMatching final : std::false_type
 template <typename AlgorithmT> struct HasManyToManySearch final : std::false_type
 {
 };
+template <typename AlgorithmT> struct HasOneToAllSearch final : std::false_type
+{
+};
 template <typename AlgorithmT> struct SupportsDistanceAnnotationType final : std::false_type
 {
 };
@@ -59,6 +62,9 @@ template <typename AlgorithmT> struct HasGetTileTurns final : std::false_type
 template <typename AlgorithmT> struct HasExcludeFlags final : std::false_type
 {
 };
+template <typename AlgorithmT> struct HasOverlayPathCache final : std::false_type
+{
+};
 
 // Algorithms supported by Contraction Hierarchies
 template <> struct HasAlternativePathSearch<ch::Algorithm> final : std::true_type
@@ -76,6 +82,9 @@ template <> struct HasMapMatching<ch::Algorithm> final : std::true_type
 template <> struct HasManyToManySearch<ch::Algorithm> final : std::true_type
 {
 };
+template <> struct HasOneToAllSearch<ch::Algorithm> final : std::true_type
+{
+};
 template <> struct SupportsDistanceAnnotationType<ch::Algorithm> final : std::true_type
 {
 };
@@ -102,6 +111,9 @@ template <> struct HasMapMatching<mld::Algorithm> final : std::true_type
 template <> struct HasManyToManySearch<mld::Algorithm> final : std::true_type
 {
 };
+template <> struct HasOneToAllSearch<mld::Algorithm> final : std::true_type
+{
+};
 template <> struct SupportsDistanceAnnotationType<mld::Algorithm> final : std::false_type
 {
 };
@@ -111,6 +123,9 @@ template <> struct HasGetTileTurns<mld::Algorithm> final : std::true_type
 template <> struct HasExcludeFlags<mld::Algorithm> final : std::true_type
 {
 };
+template <> struct HasOverlayPathCache<mld::Algorithm> final : std::true_type
+{
+};
 } // namespace routing_algorithms
 } // namespace engine
 } // namespace osrm
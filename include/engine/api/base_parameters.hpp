@@ -73,7 +73,8 @@ struct BaseParameters
     enum class OutputFormatType
     {
         JSON,
-        FLATBUFFERS
+        FLATBUFFERS,
+        BINARY
     };
 
     std::vector<util::Coordinate> coordinates;
@@ -90,6 +91,14 @@ struct BaseParameters
     // Remove waypoints array from the response.
     bool skip_waypoints = false;
 
+    // Adds the time spent in each phase of the query and the work of its searches to the
+    // response.
+    bool debug_timing = false;
+
+    // Milliseconds the query may run, it is stopped with a Timeout status afterwards. The
+    // maximum query time of the service still applies.
+    boost::optional<unsigned> timeout;
+
     SnappingType snapping = SnappingType::Default;
 
     BaseParameters(std::vector<util::Coordinate> coordinates_ = {},
@@ -4,7 +4,10 @@
 #include <flatbuffers/flatbuffers.h>
 #include <mapbox/variant.hpp>
 
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <vector>
 
 #include "util/json_container.hpp"
 
@@ -14,8 +17,12 @@ namespace engine
 {
 namespace api
 {
-using ResultT =
-    mapbox::util::variant<util::json::Object, std::string, flatbuffers::FlatBufferBuilder>;
+// std::string holds vector tiles, std::vector<char> holds raw binary tables
+using ResultT = mapbox::util::
+    variant<util::json::Object, std::string, flatbuffers::FlatBufferBuilder, std::vector<char>>;
+
+// Receives the pieces of a streamed response in order
+using ResultChunkWriter = std::function<void(const char *data, const std::size_t size)>;
 } // namespace api
 } // namespace engine
 } // namespace osrm
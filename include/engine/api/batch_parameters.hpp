@@ -0,0 +1,83 @@
+/*
+
+Copyright (c) 2021, Project OSRM contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ENGINE_API_BATCH_PARAMETERS_HPP
+#define ENGINE_API_BATCH_PARAMETERS_HPP
+
+#include "engine/api/nearest_parameters.hpp"
+#include "engine/api/route_parameters.hpp"
+
+#include <boost/optional.hpp>
+#include <mapbox/variant.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+/**
+ * Parameters specific to the OSRM Batch service.
+ *
+ * Holds member attributes:
+ *  - queries: independent Route and Nearest queries, answered in their order
+ *  - timeout: milliseconds the whole batch may run, the timeouts of the queries still apply
+ *
+ * All queries of a batch are answered from the same dataset, even if it is updated while the
+ * batch runs. The results are JSON objects.
+ *
+ * \see OSRM, RouteParameters and NearestParameters
+ */
+struct BatchParameters
+{
+    using Query = mapbox::util::variant<RouteParameters, NearestParameters>;
+
+    std::vector<Query> queries;
+    boost::optional<unsigned> timeout;
+
+    BatchParameters() = default;
+
+    BatchParameters(std::vector<Query> queries_) : queries{std::move(queries_)} {}
+
+    bool IsValid() const
+    {
+        return !queries.empty() &&
+               std::all_of(queries.begin(), queries.end(), [](const Query &query) {
+                   return mapbox::util::apply_visitor(
+                       [](const auto &params) { return params.IsValid(); }, query);
+               });
+    }
+};
+} // namespace api
+} // namespace engine
+} // namespace osrm
+
+#endif // ENGINE_API_BATCH_PARAMETERS_HPP
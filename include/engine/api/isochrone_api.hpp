@@ -0,0 +1,210 @@
+#ifndef ENGINE_API_ISOCHRONE_API_HPP
+#define ENGINE_API_ISOCHRONE_API_HPP
+
+#include "engine/api/base_api.hpp"
+#include "engine/api/base_result.hpp"
+#include "engine/api/isochrone_parameters.hpp"
+
+#include "engine/api/json_factory.hpp"
+#include "engine/phantom_node.hpp"
+
+#include "util/coordinate.hpp"
+#include "util/json_container.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+class IsochroneAPI final : public BaseAPI
+{
+  public:
+    IsochroneAPI(const datafacade::BaseDataFacade &facade_, const IsochroneParameters &parameters_)
+        : BaseAPI(facade_, parameters_), parameters(parameters_)
+    {
+    }
+
+    // Every reachable node is reported in the first contour whose duration it is within.
+    // Polygons enclose all nodes of their contour and of the smaller contours.
+    void MakeResponse(const PhantomNode &source_phantom,
+                      const std::vector<std::pair<NodeID, EdgeDuration>> &reachable_nodes,
+                      util::json::Object &response) const
+    {
+        BOOST_ASSERT(!parameters.contours.empty());
+
+        std::vector<std::vector<util::Coordinate>> contour_locations(parameters.contours.size());
+        for (const auto &reachable_node : reachable_nodes)
+        {
+            // contours are in seconds, durations in deciseconds
+            const auto contour = std::lower_bound(
+                parameters.contours.begin(),
+                parameters.contours.end(),
+                reachable_node.second,
+                [](const unsigned contour, const EdgeDuration duration) {
+                    return static_cast<std::int64_t>(contour) * 10 < duration;
+                });
+            if (contour == parameters.contours.end())
+                continue;
+
+            contour_locations[std::distance(parameters.contours.begin(), contour)].push_back(
+                GetStartLocation(reachable_node.first));
+        }
+
+        util::json::Array features;
+        std::vector<util::Coordinate> enclosed_locations;
+        for (std::size_t index = 0; index < parameters.contours.size(); ++index)
+        {
+            util::json::Object geometry;
+            if (parameters.polygons)
+            {
+                enclosed_locations.insert(enclosed_locations.end(),
+                                          contour_locations[index].begin(),
+                                          contour_locations[index].end());
+                enclosed_locations = MakeConvexHull(std::move(enclosed_locations));
+                geometry = MakePolygon(enclosed_locations);
+            }
+            else
+            {
+                geometry = MakeMultiPoint(contour_locations[index]);
+            }
+
+            util::json::Object properties;
+            properties.values["contour"] = parameters.contours[index];
+
+            util::json::Object feature;
+            feature.values["type"] = "Feature";
+            feature.values["properties"] = std::move(properties);
+            feature.values["geometry"] = std::move(geometry);
+            features.values.push_back(std::move(feature));
+        }
+
+        util::json::Object isochrones;
+        isochrones.values["type"] = "FeatureCollection";
+        isochrones.values["features"] = std::move(features);
+        response.values["isochrones"] = std::move(isochrones);
+
+        if (!parameters.skip_waypoints)
+        {
+            util::json::Array waypoints;
+            waypoints.values.push_back(MakeWaypoint(source_phantom));
+            response.values["waypoints"] = std::move(waypoints);
+        }
+
+        response.values["code"] = "Ok";
+    }
+
+    const IsochroneParameters &parameters;
+
+  protected:
+    util::Coordinate GetStartLocation(const NodeID node) const
+    {
+        const auto geometry_index = facade.GetGeometryIndex(node);
+        const auto node_id =
+            geometry_index.forward
+                ? facade.GetUncompressedForwardGeometry(geometry_index.id).front()
+                : facade.GetUncompressedReverseGeometry(geometry_index.id).front();
+        return facade.GetCoordinateOfNode(node_id);
+    }
+
+    // Andrew's monotone chain, returns the hull in counter-clockwise order
+    static std::vector<util::Coordinate> MakeConvexHull(std::vector<util::Coordinate> locations)
+    {
+        const auto less = [](const util::Coordinate lhs, const util::Coordinate rhs) {
+            return std::tie(lhs.lon, lhs.lat) < std::tie(rhs.lon, rhs.lat);
+        };
+        std::sort(locations.begin(), locations.end(), less);
+        locations.erase(std::unique(locations.begin(), locations.end()), locations.end());
+        if (locations.size() < 3)
+            return locations;
+
+        const auto cross = [](const util::Coordinate origin,
+                              const util::Coordinate lhs,
+                              const util::Coordinate rhs) {
+            const auto delta_lon = [&](const util::Coordinate location) {
+                return std::int64_t{static_cast<std::int32_t>(location.lon)} -
+                       static_cast<std::int32_t>(origin.lon);
+            };
+            const auto delta_lat = [&](const util::Coordinate location) {
+                return std::int64_t{static_cast<std::int32_t>(location.lat)} -
+                       static_cast<std::int32_t>(origin.lat);
+            };
+            return delta_lon(lhs) * delta_lat(rhs) - delta_lat(lhs) * delta_lon(rhs);
+        };
+
+        std::vector<util::Coordinate> hull(2 * locations.size());
+        std::size_t size = 0;
+        for (std::size_t index = 0; index < locations.size(); ++index)
+        {
+            while (size >= 2 && cross(hull[size - 2], hull[size - 1], locations[index]) <= 0)
+                --size;
+            hull[size++] = locations[index];
+        }
+        for (std::size_t index = locations.size() - 1, lower_size = size + 1; index > 0; --index)
+        {
+            while (size >= lower_size &&
+                   cross(hull[size - 2], hull[size - 1], locations[index - 1]) <= 0)
+                --size;
+            hull[size++] = locations[index - 1];
+        }
+        // the last point is the first one again
+        hull.resize(size - 1);
+        return hull;
+    }
+
+    static util::json::Object MakePolygon(const std::vector<util::Coordinate> &hull)
+    {
+        util::json::Array ring;
+        for (const auto &location : hull)
+            ring.values.push_back(json::detail::coordinateToLonLat(location));
+        // GeoJSON rings are closed and have at least four positions
+        if (!hull.empty())
+        {
+            do
+            {
+                ring.values.push_back(json::detail::coordinateToLonLat(hull.front()));
+            } while (ring.values.size() < 4);
+        }
+
+        util::json::Array coordinates;
+        if (!hull.empty())
+            coordinates.values.push_back(std::move(ring));
+
+        util::json::Object geometry;
+        geometry.values["type"] = "Polygon";
+        geometry.values["coordinates"] = std::move(coordinates);
+        return geometry;
+    }
+
+    static util::json::Object MakeMultiPoint(const std::vector<util::Coordinate> &locations)
+    {
+        util::json::Array coordinates;
+        coordinates.values.reserve(locations.size());
+        std::transform(locations.begin(),
+                       locations.end(),
+                       std::back_inserter(coordinates.values),
+                       &json::detail::coordinateToLonLat);
+
+        util::json::Object geometry;
+        geometry.values["type"] = "MultiPoint";
+        geometry.values["coordinates"] = std::move(coordinates);
+        return geometry;
+    }
+};
+
+} // namespace api
+} // namespace engine
+} // namespace osrm
+
+#endif
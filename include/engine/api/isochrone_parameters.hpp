@@ -0,0 +1,81 @@
+/*
+
+Copyright (c) 2021, Project OSRM contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ENGINE_API_ISOCHRONE_PARAMETERS_HPP
+#define ENGINE_API_ISOCHRONE_PARAMETERS_HPP
+
+#include "engine/api/base_parameters.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+/**
+ * Parameters specific to the OSRM Isochrone service.
+ *
+ * Holds member attributes:
+ *  - contours: durations in seconds, strictly increasing, that bound the reachable areas
+ *  - polygons: return a polygon enclosing each reachable area instead of the reached points
+ *
+ * \see OSRM, Coordinate, Hint, Bearing, RouteParameters, TableParameters,
+ *      NearestParameters, TripParameters, MatchParameters and TileParameters
+ */
+struct IsochroneParameters : public BaseParameters
+{
+    std::vector<unsigned> contours;
+    bool polygons = false;
+
+    IsochroneParameters() = default;
+
+    template <typename... Args>
+    IsochroneParameters(std::vector<unsigned> contours_, const bool polygons_, Args &&... args_)
+        : BaseParameters{std::forward<Args>(args_)...}, contours{std::move(contours_)},
+          polygons{polygons_}
+    {
+    }
+
+    bool IsValid() const
+    {
+        return BaseParameters::IsValid() && !contours.empty() && contours.front() > 0 &&
+               std::adjacent_find(contours.begin(),
+                                  contours.end(),
+                                  [](const auto lhs, const auto rhs) { return lhs >= rhs; }) ==
+                   contours.end();
+    }
+};
+} // namespace api
+} // namespace engine
+} // namespace osrm
+
+#endif // ENGINE_API_ISOCHRONE_PARAMETERS_HPP
@@ -20,6 +20,8 @@
 #include "engine/guidance/verbosity_reduction.hpp"
 
 #include "engine/internal_route_result.hpp"
+#include "engine/query_deadline.hpp"
+#include "engine/query_statistics.hpp"
 
 #include "guidance/turn_instruction.hpp"
 
@@ -882,6 +884,8 @@ class RouteAPI : public BaseAPI
 
         for (auto idx : util::irange<std::size_t>(0UL, number_of_legs))
         {
+            // guidance of long routes takes a while, e.g. for trips or matchings of long traces
+            checkDeadlineNow();
             const auto &phantoms = segment_end_coordinates[idx];
             const auto &path_data = unpacked_path_segments[idx];
 
@@ -905,6 +909,7 @@ class RouteAPI : public BaseAPI
             util::Log(logDEBUG) << "Assembling steps " << std::endl;
             if (parameters.steps)
             {
+                const QueryPhaseTimer guidance_timer(QueryPhase::Guidance);
                 auto steps = guidance::assembleSteps(BaseAPI::facade,
                                                      path_data,
                                                      leg_geometry,
@@ -18,9 +18,15 @@
 
 #include "util/integer_range.hpp"
 
+#include <boost/assert.hpp>
+#include <boost/endian/conversion.hpp>
 #include <boost/range/algorithm/transform.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <type_traits>
 
 namespace osrm
 {
@@ -29,7 +35,7 @@ namespace engine
 namespace api
 {
 
-class TableAPI final : public BaseAPI
+class TableAPI : public BaseAPI
 {
   public:
     struct TableCellRef
@@ -57,6 +63,11 @@ class TableAPI final : public BaseAPI
             auto &fb_result = response.get<flatbuffers::FlatBufferBuilder>();
             MakeResponse(tables, phantoms, fallback_speed_cells, fb_result);
         }
+        else if (response.is<std::vector<char>>())
+        {
+            auto &binary_result = response.get<std::vector<char>>();
+            MakeResponse(tables, phantoms, fallback_speed_cells, binary_result);
+        }
         else
         {
             auto &json_result = response.get<util::json::Object>();
@@ -228,7 +239,79 @@ class TableAPI final : public BaseAPI
         response.values["code"] = "Ok";
     }
 
+    // Raw little endian table: a header of four uint32 (rows, columns, annotations and duration
+    // units per second), a bitmap of the cells estimated with the fallback speed padded to four
+    // bytes, then the int32 durations and the float32 distances in meters, both row by row.
+    // Cells without a route hold the largest int32 and float32 values.
+    virtual void
+    MakeResponse(const std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>> &tables,
+                 const std::vector<PhantomNode> &phantoms,
+                 const std::vector<TableCellRef> &fallback_speed_cells,
+                 std::vector<char> &binary_result) const
+    {
+        const auto number_of_sources =
+            parameters.sources.empty() ? phantoms.size() : parameters.sources.size();
+        const auto number_of_destinations =
+            parameters.destinations.empty() ? phantoms.size() : parameters.destinations.size();
+        const auto number_of_cells = number_of_sources * number_of_destinations;
+
+        const bool use_durations =
+            parameters.annotations & TableParameters::AnnotationsType::Duration;
+        const bool use_distances =
+            parameters.annotations & TableParameters::AnnotationsType::Distance;
+        BOOST_ASSERT(!use_durations || tables.first.size() == number_of_cells);
+        BOOST_ASSERT(!use_distances || tables.second.size() == number_of_cells);
+
+        const std::uint32_t header[] = {
+            static_cast<std::uint32_t>(number_of_sources),
+            static_cast<std::uint32_t>(number_of_destinations),
+            static_cast<std::uint32_t>(
+                static_cast<std::underlying_type_t<TableParameters::AnnotationsType>>(
+                    parameters.annotations)),
+            10}; // durations are in deciseconds
+
+        std::vector<char> estimated_cells((number_of_cells + 31) / 32 * 4, 0);
+        for (const auto &cell : fallback_speed_cells)
+        {
+            const auto index = cell.row * number_of_destinations + cell.column;
+            estimated_cells[index / 8] |= static_cast<char>(1 << (index % 8));
+        }
+
+        binary_result.clear();
+        binary_result.reserve(sizeof(header) + estimated_cells.size() +
+                              (use_durations ? number_of_cells * sizeof(EdgeDuration) : 0) +
+                              (use_distances ? number_of_cells * sizeof(EdgeDistance) : 0));
+        AppendLittleEndian(binary_result, header, 4);
+        binary_result.insert(binary_result.end(), estimated_cells.begin(), estimated_cells.end());
+        if (use_durations)
+        {
+            AppendLittleEndian(binary_result, tables.first.data(), tables.first.size());
+        }
+        if (use_distances)
+        {
+            AppendLittleEndian(binary_result, tables.second.data(), tables.second.size());
+        }
+    }
+
   protected:
+    // Copies the values as they are and swaps their bytes on big endian platforms only
+    template <typename T>
+    static void
+    AppendLittleEndian(std::vector<char> &buffer, const T *values, const std::size_t size)
+    {
+        static_assert(sizeof(T) == 4, "only 32 bit values are written to binary tables");
+        const auto offset = buffer.size();
+        buffer.resize(offset + size * sizeof(T));
+        std::memcpy(buffer.data() + offset, values, size * sizeof(T));
+        if (boost::endian::order::native != boost::endian::order::little)
+        {
+            for (auto value = buffer.begin() + offset; value != buffer.end(); value += sizeof(T))
+            {
+                std::reverse(value, value + sizeof(T));
+            }
+        }
+    }
+
     virtual flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<fbresult::Waypoint>>>
     MakeWaypoints(flatbuffers::FlatBufferBuilder &builder,
                   const std::vector<PhantomNode> &phantoms) const
@@ -30,6 +30,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "engine/api/base_parameters.hpp"
 
+#include <boost/optional.hpp>
+
 #include <cstddef>
 
 #include <algorithm>
@@ -51,6 +53,9 @@ namespace api
  *             use all coordinates as sources
  *  - destinations: indices into coordinates indicating destinations for the Table service, no
  *                  destinations means use all coordinates as destinations
+ *  - stream: write the table in blocks of rows while it is computed, if a chunk writer is given
+ *  - max_duration: pairs with a longer duration in seconds are not searched and reported as null
+ *  - max_distance: pairs with a longer distance in meters are not searched and reported as null
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
@@ -81,6 +86,11 @@ struct TableParameters : public BaseParameters
 
     double scale_factor = 1;
 
+    bool stream = false;
+
+    boost::optional<double> max_duration;
+    boost::optional<double> max_distance;
+
     TableParameters() = default;
     template <typename... Args>
     TableParameters(std::vector<std::size_t> sources_,
@@ -143,6 +153,9 @@ struct TableParameters : public BaseParameters
         if (scale_factor <= 0)
             return false;
 
+        if ((max_duration && *max_duration <= 0) || (max_distance && *max_distance <= 0))
+            return false;
+
         return true;
     }
 };
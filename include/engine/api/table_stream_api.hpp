@@ -0,0 +1,306 @@
+#ifndef ENGINE_API_TABLE_STREAM_HPP
+#define ENGINE_API_TABLE_STREAM_HPP
+
+#include "engine/api/base_result.hpp"
+#include "engine/api/table_api.hpp"
+#include "engine/api/table_parameters.hpp"
+
+#include "engine/datafacade/datafacade_base.hpp"
+
+#include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+
+#include <boost/assert.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+// Writes a table response piece by piece while its rows are computed in blocks.
+//
+// The JSON response has the same layout as the one of TableAPI and holds either the durations or
+// the distances, whose rows are written as soon as their block arrives.
+//
+// The flatbuffers response is a sequence of size prefixed FBResult messages: the first one holds
+// the waypoints and the dimensions of the table, every following one holds a block of rows.
+class TableStreamAPI final : public TableAPI
+{
+  public:
+    TableStreamAPI(const datafacade::BaseDataFacade &facade_,
+                   const TableParameters &parameters_,
+                   const std::vector<PhantomNode> &phantoms_,
+                   const bool use_flatbuffers_,
+                   const ResultChunkWriter &write_chunk_)
+        : TableAPI(facade_, parameters_), phantoms(phantoms_), use_flatbuffers(use_flatbuffers_),
+          write_chunk(write_chunk_)
+    {
+        BOOST_ASSERT(write_chunk);
+    }
+
+    // Writes everything that precedes the first row
+    void Begin()
+    {
+        if (use_flatbuffers)
+        {
+            BeginFlatbuffers();
+        }
+        else
+        {
+            BeginJSON();
+        }
+    }
+
+    // Writes the next block of rows, fallback_speed_cells hold the estimated cells of the block
+    void AddBlock(std::vector<EdgeDuration> &durations,
+                  std::vector<EdgeDistance> &distances,
+                  const std::vector<TableCellRef> &fallback_speed_cells)
+    {
+        if (use_flatbuffers)
+        {
+            AddFlatbuffersBlock(durations, distances, fallback_speed_cells);
+        }
+        else
+        {
+            AddJSONBlock(durations, distances, fallback_speed_cells);
+        }
+    }
+
+    // Writes everything that follows the last row
+    void Finish()
+    {
+        if (!use_flatbuffers)
+        {
+            FinishJSON();
+        }
+    }
+
+  private:
+    bool UseDurations() const
+    {
+        return parameters.annotations & TableParameters::AnnotationsType::Duration;
+    }
+
+    bool UseDistances() const
+    {
+        return parameters.annotations & TableParameters::AnnotationsType::Distance;
+    }
+
+    bool HaveSpeedCells() const
+    {
+        return parameters.fallback_speed != INVALID_FALLBACK_SPEED && parameters.fallback_speed > 0;
+    }
+
+    std::size_t NumberOfDestinations() const
+    {
+        return parameters.destinations.empty() ? phantoms.size() : parameters.destinations.size();
+    }
+
+    void BeginJSON()
+    {
+        Append("{\"code\":\"Ok\"");
+        if (!parameters.skip_waypoints)
+        {
+            Append(",\"sources\":");
+            AppendValue(parameters.sources.empty() ? MakeWaypoints(phantoms)
+                                                   : MakeWaypoints(phantoms, parameters.sources));
+            Append(",\"destinations\":");
+            AppendValue(parameters.destinations.empty()
+                            ? MakeWaypoints(phantoms)
+                            : MakeWaypoints(phantoms, parameters.destinations));
+        }
+
+        if (UseDurations())
+        {
+            Append(",\"durations\":[");
+        }
+        else if (UseDistances())
+        {
+            Append(",\"distances\":[");
+        }
+        Flush();
+    }
+
+    void AddJSONBlock(std::vector<EdgeDuration> &durations,
+                      std::vector<EdgeDistance> &distances,
+                      const std::vector<TableCellRef> &fallback_speed_cells)
+    {
+        const auto number_of_columns = NumberOfDestinations();
+        const auto number_of_rows = durations.size() / number_of_columns;
+
+        BOOST_ASSERT(!UseDurations() || !UseDistances());
+        if (UseDurations())
+        {
+            AppendRows(MakeDurationTable(durations, number_of_rows, number_of_columns));
+        }
+        else if (UseDistances())
+        {
+            AppendRows(MakeDistanceTable(distances, number_of_rows, number_of_columns));
+        }
+
+        held_fallback_speed_cells.insert(held_fallback_speed_cells.end(),
+                                         fallback_speed_cells.begin(),
+                                         fallback_speed_cells.end());
+        Flush();
+    }
+
+    void FinishJSON()
+    {
+        if (UseDurations() || UseDistances())
+        {
+            Append("]");
+        }
+
+        if (HaveSpeedCells())
+        {
+            Append(",\"fallback_speed_cells\":");
+            AppendValue(MakeEstimatesTable(held_fallback_speed_cells));
+        }
+        Append("}");
+        Flush();
+    }
+
+    void BeginFlatbuffers()
+    {
+        flatbuffers::FlatBufferBuilder fb_result;
+
+        auto data_timestamp = facade.GetTimestamp();
+        flatbuffers::Offset<flatbuffers::String> data_version_string;
+        if (!data_timestamp.empty())
+        {
+            data_version_string = fb_result.CreateString(data_timestamp);
+        }
+
+        flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<fbresult::Waypoint>>> sources;
+        flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<fbresult::Waypoint>>>
+            destinations;
+        if (!parameters.skip_waypoints)
+        {
+            sources = parameters.sources.empty()
+                          ? MakeWaypoints(fb_result, phantoms)
+                          : MakeWaypoints(fb_result, phantoms, parameters.sources);
+            destinations = parameters.destinations.empty()
+                               ? MakeWaypoints(fb_result, phantoms)
+                               : MakeWaypoints(fb_result, phantoms, parameters.destinations);
+        }
+
+        fbresult::TableBuilder table(fb_result);
+        table.add_destinations(destinations);
+        table.add_rows(parameters.sources.empty() ? phantoms.size() : parameters.sources.size());
+        table.add_cols(NumberOfDestinations());
+        auto table_buffer = table.Finish();
+
+        fbresult::FBResultBuilder response(fb_result);
+        if (!data_timestamp.empty())
+        {
+            response.add_data_version(data_version_string);
+        }
+        response.add_table(table_buffer);
+        response.add_waypoints(sources);
+        fbresult::FinishSizePrefixedFBResultBuffer(fb_result, response.Finish());
+        WriteBuffer(fb_result);
+    }
+
+    void AddFlatbuffersBlock(const std::vector<EdgeDuration> &durations,
+                             const std::vector<EdgeDistance> &distances,
+                             const std::vector<TableCellRef> &fallback_speed_cells)
+    {
+        flatbuffers::FlatBufferBuilder fb_result;
+        const auto number_of_columns = NumberOfDestinations();
+
+        flatbuffers::Offset<flatbuffers::Vector<float>> durations_table;
+        if (UseDurations())
+        {
+            durations_table = MakeDurationTable(fb_result, durations);
+        }
+
+        flatbuffers::Offset<flatbuffers::Vector<float>> distances_table;
+        if (UseDistances())
+        {
+            distances_table = MakeDistanceTable(fb_result, distances);
+        }
+
+        flatbuffers::Offset<flatbuffers::Vector<uint32_t>> speed_cells;
+        if (HaveSpeedCells())
+        {
+            speed_cells = MakeEstimatesTable(fb_result, fallback_speed_cells);
+        }
+
+        fbresult::TableBuilder table(fb_result);
+        table.add_rows(durations.size() / number_of_columns);
+        table.add_cols(number_of_columns);
+        if (UseDurations())
+        {
+            table.add_durations(durations_table);
+        }
+        if (UseDistances())
+        {
+            table.add_distances(distances_table);
+        }
+        if (HaveSpeedCells())
+        {
+            table.add_fallback_speed_cells(speed_cells);
+        }
+        auto table_buffer = table.Finish();
+
+        fbresult::FBResultBuilder response(fb_result);
+        response.add_table(table_buffer);
+        fbresult::FinishSizePrefixedFBResultBuffer(fb_result, response.Finish());
+        WriteBuffer(fb_result);
+    }
+
+    void AppendRows(const util::json::Array &rows)
+    {
+        for (const auto &row : rows.values)
+        {
+            if (!is_first_row)
+            {
+                buffer.push_back(',');
+            }
+            is_first_row = false;
+            mapbox::util::apply_visitor(util::json::ArrayRenderer(buffer), row);
+        }
+    }
+
+    void AppendValue(const util::json::Value &value)
+    {
+        mapbox::util::apply_visitor(util::json::ArrayRenderer(buffer), value);
+    }
+
+    void Append(const std::string &text) { buffer.insert(buffer.end(), text.begin(), text.end()); }
+
+    void Flush()
+    {
+        if (!buffer.empty())
+        {
+            write_chunk(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+
+    void WriteBuffer(const flatbuffers::FlatBufferBuilder &fb_result) const
+    {
+        write_chunk(reinterpret_cast<const char *>(fb_result.GetBufferPointer()),
+                    fb_result.GetSize());
+    }
+
+    const std::vector<PhantomNode> &phantoms;
+    const bool use_flatbuffers;
+    const ResultChunkWriter &write_chunk;
+
+    std::vector<char> buffer;
+    bool is_first_row = true;
+    std::vector<TableCellRef> held_fallback_speed_cells;
+};
+
+} // namespace api
+} // namespace engine
+} // namespace osrm
+
+#endif
@@ -14,6 +14,7 @@
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
+#include <cstdint>
 #include <memory>
 #include <thread>
 
@@ -22,8 +23,13 @@ namespace osrm
 namespace engine
 {
 
+// Number of times a watchdog switched to data updated by osrm-datastore since the start
+std::uint64_t GetDataSwapCount();
+
 namespace detail
 {
+void CountDataSwap();
+
 // We need this wrapper type since template-template specilization of FacadeT is broken on clang
 // when it is combined with an templated alias (DataFacade in this case).
 // See https://godbolt.org/g/ZS6Xmt for an example.
@@ -89,6 +95,13 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
         return facade_factory.Get(params);
     }
 
+    // A copy of the factory keeps the current facades alive after an update
+    DataFacadeFactory<datafacade::ContiguousInternalMemoryDataFacade, AlgorithmT> GetFactory() const
+    {
+        boost::shared_lock<boost::shared_mutex> swap_lock(factory_mutex);
+        return facade_factory;
+    }
+
   private:
     void Run()
     {
@@ -126,6 +139,8 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
                             std::vector<storage::SharedRegionRegister::ShmKey>{
                                 static_region.shm_key, updatable_region.shm_key}));
             }
+            // counted once the new data is used, replies of the old data are never taken as new
+            CountDataSwap();
         }
 
         util::Log() << "DataWatchdog thread stopped";
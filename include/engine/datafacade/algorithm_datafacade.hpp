@@ -2,6 +2,7 @@
 #define OSRM_ENGINE_DATAFACADE_ALGORITHM_DATAFACADE_HPP
 
 #include "contractor/query_edge.hpp"
+#include "contractor/shortcut_children.hpp"
 #include "customizer/edge_based_graph.hpp"
 #include "extractor/edge_based_edge.hpp"
 #include "engine/algorithm.hpp"
@@ -55,6 +56,9 @@ template <> class AlgorithmDataFacade<CH>
     virtual EdgeID FindSmallestEdge(const NodeID from,
                                     const NodeID to,
                                     const std::function<bool(EdgeData)> filter) const = 0;
+
+    // edges of the halves of a shortcut, SPECIAL_EDGEID if they have to be looked up
+    virtual contractor::ShortcutChildren GetShortcutChildren(const EdgeID e) const = 0;
 };
 
 template <> class AlgorithmDataFacade<MLD>
@@ -46,6 +46,7 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
     using GraphEdge = QueryGraph::EdgeArrayEntry;
 
     QueryGraph m_query_graph;
+    contractor::ShortcutChildrenTableView m_shortcut_children;
 
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
@@ -66,6 +67,9 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
     {
         m_query_graph =
             make_filtered_graph_view(index, "/ch/metrics/" + metric_name, exclude_index);
+        m_shortcut_children = make_shortcut_children_view(
+            index,
+            "/ch/metrics/" + metric_name + "/shortcut_children/" + std::to_string(exclude_index));
     }
 
     // search graph access
@@ -113,6 +117,11 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
     {
         return m_query_graph.FindSmallestEdge(from, to, filter);
     }
+
+    contractor::ShortcutChildren GetShortcutChildren(const EdgeID e) const override final
+    {
+        return m_shortcut_children[e];
+    }
 };
 
 /**
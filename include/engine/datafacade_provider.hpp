@@ -8,6 +8,8 @@
 #include "engine/datafacade/process_memory_allocator.hpp"
 #include "engine/datafacade_factory.hpp"
 
+#include <memory>
+
 namespace osrm
 {
 namespace engine
@@ -24,6 +26,37 @@ template <typename AlgorithmT, template <typename A> class FacadeT> class DataFa
 
     virtual std::shared_ptr<const Facade> Get(const api::BaseParameters &) const = 0;
     virtual std::shared_ptr<const Facade> Get(const api::TileParameters &) const = 0;
+
+    // The data as of now, it stays the same while the provider switches to updated data
+    virtual std::unique_ptr<const DataFacadeProvider> Snapshot() const = 0;
+};
+
+template <typename AlgorithmT, template <typename A> class FacadeT>
+class SnapshotProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
+{
+  public:
+    using Facade = typename DataFacadeProvider<AlgorithmT, FacadeT>::Facade;
+
+    SnapshotProvider(DataFacadeFactory<FacadeT, AlgorithmT> facade_factory_)
+        : facade_factory(std::move(facade_factory_))
+    {
+    }
+
+    std::shared_ptr<const Facade> Get(const api::TileParameters &params) const override final
+    {
+        return facade_factory.Get(params);
+    }
+    std::shared_ptr<const Facade> Get(const api::BaseParameters &params) const override final
+    {
+        return facade_factory.Get(params);
+    }
+    std::unique_ptr<const DataFacadeProvider<AlgorithmT, FacadeT>> Snapshot() const override final
+    {
+        return std::make_unique<SnapshotProvider>(facade_factory);
+    }
+
+  private:
+    DataFacadeFactory<FacadeT, AlgorithmT> facade_factory;
 };
 
 template <typename AlgorithmT, template <typename A> class FacadeT>
@@ -45,6 +78,10 @@ class ExternalProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
     {
         return facade_factory.Get(params);
     }
+    std::unique_ptr<const DataFacadeProvider<AlgorithmT, FacadeT>> Snapshot() const override final
+    {
+        return std::make_unique<SnapshotProvider<AlgorithmT, FacadeT>>(facade_factory);
+    }
 
   private:
     DataFacadeFactory<FacadeT, AlgorithmT> facade_factory;
@@ -69,6 +106,10 @@ class ImmutableProvider final : public DataFacadeProvider<AlgorithmT, FacadeT>
     {
         return facade_factory.Get(params);
     }
+    std::unique_ptr<const DataFacadeProvider<AlgorithmT, FacadeT>> Snapshot() const override final
+    {
+        return std::make_unique<SnapshotProvider<AlgorithmT, FacadeT>>(facade_factory);
+    }
 
   private:
     DataFacadeFactory<FacadeT, AlgorithmT> facade_factory;
@@ -92,6 +133,10 @@ class WatchingProvider : public DataFacadeProvider<AlgorithmT, FacadeT>
     {
         return watchdog.Get(params);
     }
+    std::unique_ptr<const DataFacadeProvider<AlgorithmT, FacadeT>> Snapshot() const override final
+    {
+        return std::make_unique<SnapshotProvider<AlgorithmT, FacadeT>>(watchdog.GetFactory());
+    }
 };
 } // namespace detail
 
@@ -1,6 +1,8 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include "engine/api/batch_parameters.hpp"
+#include "engine/api/isochrone_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -9,19 +11,28 @@
 #include "engine/api/trip_parameters.hpp"
 #include "engine/datafacade_provider.hpp"
 #include "engine/engine_config.hpp"
+#include "engine/plugins/batch.hpp"
+#include "engine/plugins/isochrone.hpp"
 #include "engine/plugins/match.hpp"
 #include "engine/plugins/nearest.hpp"
 #include "engine/plugins/table.hpp"
 #include "engine/plugins/tile.hpp"
 #include "engine/plugins/trip.hpp"
 #include "engine/plugins/viaroute.hpp"
+#include "engine/query_deadline.hpp"
+#include "engine/query_statistics.hpp"
 #include "engine/routing_algorithms.hpp"
 #include "engine/status.hpp"
 
 #include "util/json_container.hpp"
 
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace osrm
 {
@@ -34,25 +45,51 @@ class EngineInterface
     virtual ~EngineInterface() = default;
     virtual Status Route(const api::RouteParameters &parameters, api::ResultT &result) const = 0;
     virtual Status Table(const api::TableParameters &parameters, api::ResultT &result) const = 0;
+    virtual Status Table(const api::TableParameters &parameters,
+                         api::ResultT &result,
+                         const api::ResultChunkWriter &write_chunk) const = 0;
     virtual Status Nearest(const api::NearestParameters &parameters,
                            api::ResultT &result) const = 0;
     virtual Status Trip(const api::TripParameters &parameters, api::ResultT &result) const = 0;
     virtual Status Match(const api::MatchParameters &parameters, api::ResultT &result) const = 0;
     virtual Status Tile(const api::TileParameters &parameters, api::ResultT &result) const = 0;
+    virtual Status Isochrone(const api::IsochroneParameters &parameters,
+                             api::ResultT &result) const = 0;
+    virtual Status Batch(const api::BatchParameters &parameters, api::ResultT &result) const = 0;
+    virtual Status Batch(const api::BatchParameters &parameters,
+                         api::ResultT &result,
+                         const api::ResultChunkWriter &write_chunk) const = 0;
+    virtual void WarmUp() const = 0;
 };
 
 template <typename Algorithm> class Engine final : public EngineInterface
 {
   public:
     explicit Engine(const EngineConfig &config)
-        : route_plugin(config.max_locations_viaroute, config.max_alternatives),            //
-          table_plugin(config.max_locations_distance_table),                               //
+        : route_plugin(config.max_locations_viaroute, config.max_alternatives), //
+          table_plugin(config.max_locations_distance_table,
+                       config.max_table_parallelism,
+                       config.rphast_min_destinations),                                    //
           nearest_plugin(config.max_results_nearest),                                      //
           trip_plugin(config.max_locations_trip),                                          //
           match_plugin(config.max_locations_map_matching, config.max_radius_map_matching), //
-          tile_plugin()                                                                    //
+          tile_plugin(),                                                                   //
+          isochrone_plugin(config.max_duration_isochrone),                                 //
+          batch_plugin(config.max_batch_size, config.max_batch_parallelism),               //
+          table_bucket_cache(static_cast<std::size_t>(config.table_bucket_cache_size) * 1024 *
+                             1024),
+          overlay_path_cache(routing_algorithms::HasOverlayPathCache<Algorithm>::value
+                                 ? static_cast<std::size_t>(config.overlay_path_cache_size) *
+                                       1024 * 1024
+                                 : 0),
+          max_query_time(config.max_query_time)
 
     {
+        if (config.max_heap_memory > 0)
+        {
+            setSearchHeapBudget(static_cast<std::size_t>(config.max_heap_memory) * 1024 * 1024);
+        }
+
         if (config.use_shared_memory)
         {
             util::Log(logDEBUG) << "Using shared memory with name \"" << config.dataset_name
@@ -87,38 +124,229 @@ template <typename Algorithm> class Engine final : public EngineInterface
 
     Status Route(const api::RouteParameters &params, api::ResultT &result) const override final
     {
-        return route_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return RunQuery("route", route_plugin, params, result);
     }
 
     Status Table(const api::TableParameters &params, api::ResultT &result) const override final
     {
-        return table_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return RunQuery("table", table_plugin, params, result);
+    }
+
+    Status Table(const api::TableParameters &params,
+                 api::ResultT &result,
+                 const api::ResultChunkWriter &write_chunk) const override final
+    {
+        return RunQuery("table", table_plugin, params, result, write_chunk);
     }
 
     Status Nearest(const api::NearestParameters &params, api::ResultT &result) const override final
     {
-        return nearest_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return RunQuery("nearest", nearest_plugin, params, result);
     }
 
     Status Trip(const api::TripParameters &params, api::ResultT &result) const override final
     {
-        return trip_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return RunQuery("trip", trip_plugin, params, result);
     }
 
     Status Match(const api::MatchParameters &params, api::ResultT &result) const override final
     {
-        return match_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return RunQuery("match", match_plugin, params, result);
     }
 
     Status Tile(const api::TileParameters &params, api::ResultT &result) const override final
     {
-        return tile_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return RunQuery("tile", tile_plugin, params, result);
+    }
+
+    Status Isochrone(const api::IsochroneParameters &params,
+                     api::ResultT &result) const override final
+    {
+        return RunQuery("isochrone", isochrone_plugin, params, result);
+    }
+
+    Status Batch(const api::BatchParameters &params, api::ResultT &result) const override final
+    {
+        return Batch(params, result, {});
+    }
+
+    // All queries of a batch use the data as of its start, even if it is updated in the meantime
+    Status Batch(const api::BatchParameters &params,
+                 api::ResultT &result,
+                 const api::ResultChunkWriter &write_chunk) const override final
+    {
+        const QueryPhaseTimer timer(QueryPhase::Assembly);
+        const auto snapshot = facade_provider->Snapshot();
+        const auto handle_query = [&](const api::BatchParameters::Query &query,
+                                      api::ResultT &query_result) {
+            // every query keeps the limits of its own service within those of the batch
+            if (query.is<api::RouteParameters>())
+            {
+                const auto &query_params = query.get<api::RouteParameters>();
+                return RunWithDeadline("route", GetTimeout(query_params), query_result, [&] {
+                    return route_plugin.HandleRequest(
+                        GetAlgorithms(*snapshot, query_params), query_params, query_result);
+                });
+            }
+            const auto &query_params = query.get<api::NearestParameters>();
+            return RunWithDeadline("nearest", GetTimeout(query_params), query_result, [&] {
+                return nearest_plugin.HandleRequest(
+                    GetAlgorithms(*snapshot, query_params), query_params, query_result);
+            });
+        };
+        return RunWithDeadline("batch", GetTimeout(params), result, [&] {
+            return batch_plugin.HandleRequest(handle_query, params, result, write_chunk);
+        });
+    }
+
+    // Heaps are thread-local, so every thread answering queries creates its own
+    void WarmUp() const override final
+    {
+        const auto algorithms = GetAlgorithms(api::BaseParameters{});
+        if (algorithms.IsValid())
+        {
+            algorithms.WarmUpHeaps();
+        }
     }
 
   private:
+    template <typename PluginT, typename ParametersT, typename... Args>
+    Status RunQuery(const char *service,
+                    const PluginT &plugin,
+                    const ParametersT &params,
+                    api::ResultT &result,
+                    const Args &... args) const
+    {
+        return RunWithDeadline(service, GetTimeout(params), result, [&] {
+            return RunPlugin(plugin, params, result, args...);
+        });
+    }
+
+    // Queries that run longer than allowed for their service or by their parameters are stopped
+    // and return a Timeout status
+    template <typename QueryT>
+    Status RunWithDeadline(const char *service,
+                           const boost::optional<unsigned> &timeout,
+                           api::ResultT &result,
+                           const QueryT &query) const
+    {
+        const auto deadline = MakeDeadline(service, timeout);
+        std::unique_ptr<QueryDeadlineScope> deadline_scope;
+        if (deadline)
+        {
+            deadline_scope = std::make_unique<QueryDeadlineScope>(&*deadline);
+        }
+
+        Status status = Status::Error;
+        try
+        {
+            status = query();
+        }
+        catch (const QueryTimeout &)
+        {
+            result = util::json::Object();
+            auto &json_result = result.get<util::json::Object>();
+            json_result.values["code"] = "Timeout";
+            json_result.values["message"] = "Query took longer than allowed";
+            status = Status::Timeout;
+        }
+        // heaps are kept for the next query as long as they are within the budget
+        trimSearchHeaps();
+        return status;
+    }
+
+    // Time outside of the finer phases is accounted to assembling the response
+    template <typename PluginT, typename ParametersT, typename... Args>
+    Status RunPlugin(const PluginT &plugin,
+                     const ParametersT &params,
+                     api::ResultT &result,
+                     const Args &... args) const
+    {
+        const auto debug_timing = HasDebugTiming(params);
+        auto *statistics = QueryStatisticsScope::Current();
+        if (!statistics && !debug_timing)
+        {
+            return plugin.HandleRequest(GetAlgorithms(params), params, result, args...);
+        }
+
+        // Queries asking for their timing collect statistics even if the caller does not
+        QueryStatistics debug_statistics;
+        std::unique_ptr<QueryStatisticsScope> debug_scope;
+        if (!statistics)
+        {
+            debug_scope = std::make_unique<QueryStatisticsScope>(debug_statistics);
+            statistics = &debug_statistics;
+        }
+
+        const auto counters = heaps.GetCounters();
+        Status status = Status::Error;
+        {
+            const QueryPhaseTimer timer(QueryPhase::Assembly);
+            status = plugin.HandleRequest(GetAlgorithms(params), params, result, args...);
+        }
+        const auto work = heaps.GetCounters() - counters;
+        statistics->settled_nodes += work.settled_nodes;
+        statistics->relaxed_edges += work.relaxed_edges;
+        statistics->overlay_edges += work.overlay_edges;
+        statistics->heap_size_in_bytes = heaps.GetSizeInBytes();
+
+        if (debug_timing && result.is<util::json::Object>())
+        {
+            result.get<util::json::Object>().values["debug_timing"] =
+                makeDebugTiming(*statistics);
+        }
+        return status;
+    }
+
+    // Tiles are binary and have no room for the timing
+    static bool HasDebugTiming(const api::BaseParameters &params) { return params.debug_timing; }
+    static bool HasDebugTiming(const api::TileParameters &) { return false; }
+
+    static boost::optional<unsigned> GetTimeout(const api::BaseParameters &params)
+    {
+        return params.timeout;
+    }
+    static boost::optional<unsigned> GetTimeout(const api::TileParameters &) { return {}; }
+    static boost::optional<unsigned> GetTimeout(const api::BatchParameters &params)
+    {
+        return params.timeout;
+    }
+
+    // Deadline of a query of the service, none if neither the service nor the query have a
+    // limit. A deadline of the caller, e.g. of a cancelled request, is kept.
+    boost::optional<QueryDeadline> MakeDeadline(const char *service,
+                                                const boost::optional<unsigned> &timeout) const
+    {
+        boost::optional<unsigned> limit = timeout;
+        const auto service_limit = max_query_time.find(service);
+        if (service_limit != max_query_time.end())
+        {
+            limit = std::min<unsigned>(limit.value_or(service_limit->second),
+                                       service_limit->second);
+        }
+        if (!limit)
+        {
+            return boost::none;
+        }
+
+        const auto time = QueryDeadline::Clock::now() + std::chrono::milliseconds(*limit);
+        const auto *current = QueryDeadlineScope::Current();
+        return current ? current->Before(time) : QueryDeadline(time);
+    }
+
     template <typename ParametersT> auto GetAlgorithms(const ParametersT &params) const
     {
-        return RoutingAlgorithms<Algorithm>{heaps, facade_provider->Get(params)};
+        return GetAlgorithms(*facade_provider, params);
+    }
+    template <typename ParametersT>
+    auto GetAlgorithms(const DataFacadeProvider<Algorithm> &provider,
+                       const ParametersT &params) const
+    {
+        return RoutingAlgorithms<Algorithm>{heaps,
+                                            table_bucket_cache,
+                                            overlay_path_cache,
+                                            downward_graph_cache,
+                                            provider.Get(params)};
     }
     std::unique_ptr<DataFacadeProvider<Algorithm>> facade_provider;
     mutable SearchEngineData<Algorithm> heaps;
@@ -129,6 +357,15 @@ template <typename Algorithm> class Engine final : public EngineInterface
     const plugins::TripPlugin trip_plugin;
     const plugins::MatchPlugin match_plugin;
     const plugins::TilePlugin tile_plugin;
+    const plugins::IsochronePlugin isochrone_plugin;
+    const plugins::BatchPlugin batch_plugin;
+
+    mutable routing_algorithms::TableBucketCache table_bucket_cache;
+    mutable routing_algorithms::OverlayPathCache overlay_path_cache;
+    mutable routing_algorithms::DownwardGraphCache downward_graph_cache;
+
+    // Milliseconds the queries of a service may run
+    const std::unordered_map<std::string, int> max_query_time;
 };
 } // namespace engine
 } // namespace osrm
@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/filesystem/path.hpp>
 
 #include <string>
+#include <unordered_map>
 
 namespace osrm
 {
@@ -53,6 +54,37 @@ namespace engine
  *  - Match
  *  - Nearest
  *
+ * The largest contour (in seconds) of the Isochrone service is bounded by
+ * max_duration_isochrone (-1 for unlimited).
+ *
+ * The number of threads a single Table request may use for its searches can be capped with
+ * max_table_parallelism (1 runs all searches on the calling thread).
+ *
+ * Batch requests hold at most max_batch_size queries (-1 for unlimited), which are answered on up
+ * to max_batch_parallelism threads (1 answers them on the calling thread).
+ *
+ * Table requests with at least rphast_min_destinations destinations (-1 to disable) sweep over the
+ * destinations' search space instead of scanning search buckets. Only CH has a dedicated sweep.
+ *
+ * The backward search buckets of Table request targets are kept across requests in a cache of
+ * table_bucket_cache_size megabytes (0 to disable), so requests against the same targets only
+ * run the searches of their sources. Only CH uses the cache.
+ *
+ * The base graph paths of MLD overlay edges unpacked by route, alternatives, trip and match
+ * queries are kept across requests in a cache of overlay_path_cache_size megabytes (0 to disable),
+ * so overlay edges many routes share are only unpacked by a search once per dataset.
+ *
+ * Asynchronous queries of the OSRM API run on an executor of async_threads threads (0 for one per
+ * hardware thread).
+ *
+ * Queries of a service listed in max_query_time are stopped with a Timeout status after its number
+ * of milliseconds. Requests can ask for a shorter time with their timeout parameter.
+ *
+ * Once a query is done, the search heaps of its threads are shrunk back to their initial size
+ * while they hold more than their share of max_heap_memory megabytes (0 for no budget). Every
+ * thread with heaps has an equal share, index arrays sized by the graph are not counted. Engines
+ * without a budget keep the one of the process.
+ *
  * In addition, shared memory can be used for datasets loaded with osrm-datastore.
  *
  * You can chose between three algorithms:
@@ -87,6 +119,16 @@ struct EngineConfig final
     double max_radius_map_matching = -1.0;
     int max_results_nearest = -1;
     int max_alternatives = 3; // set an arbitrary upper bound; can be adjusted by user
+    int max_table_parallelism = 1;
+    int rphast_min_destinations = 1000;
+    int table_bucket_cache_size = 0;
+    int overlay_path_cache_size = 0;
+    int max_duration_isochrone = -1;
+    int max_batch_size = -1;
+    int max_batch_parallelism = 1;
+    std::unordered_map<std::string, int> max_query_time;
+    int async_threads = 0;
+    int max_heap_memory = 0;
     bool use_shared_memory = true;
     boost::filesystem::path memory_file;
     bool use_mmap = true;
@@ -0,0 +1,42 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "engine/api/base_result.hpp"
+#include "engine/api/batch_parameters.hpp"
+#include "engine/plugins/plugin_base.hpp"
+#include "osrm/json_container.hpp"
+
+#include <functional>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+// Answers the queries of a batch on up to max_batch_parallelism threads. The results are written
+// in the order of the queries, block by block if the response is streamed.
+class BatchPlugin final : public BasePlugin
+{
+  public:
+    // Answers a single query of the batch, it is called from several threads at once
+    using QueryHandler =
+        std::function<Status(const api::BatchParameters::Query &query, api::ResultT &result)>;
+
+    BatchPlugin(const int max_batch_size, const int max_batch_parallelism);
+
+    Status HandleRequest(const QueryHandler &handle_query,
+                         const api::BatchParameters &params,
+                         osrm::engine::api::ResultT &result,
+                         const api::ResultChunkWriter &write_chunk = {}) const;
+
+  private:
+    const int max_batch_size;
+    const int max_batch_parallelism;
+};
+} // namespace plugins
+} // namespace engine
+} // namespace osrm
+
+#endif /* BATCH_HPP */
@@ -0,0 +1,32 @@
+#ifndef ISOCHRONE_HPP
+#define ISOCHRONE_HPP
+
+#include "engine/api/isochrone_parameters.hpp"
+#include "engine/plugins/plugin_base.hpp"
+#include "engine/routing_algorithms.hpp"
+#include "osrm/json_container.hpp"
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+class IsochronePlugin final : public BasePlugin
+{
+  public:
+    explicit IsochronePlugin(const int max_duration_isochrone);
+
+    Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+                         const api::IsochroneParameters &params,
+                         osrm::engine::api::ResultT &result) const;
+
+  private:
+    const int max_duration_isochrone;
+};
+} // namespace plugins
+} // namespace engine
+} // namespace osrm
+
+#endif /* ISOCHRONE_HPP */
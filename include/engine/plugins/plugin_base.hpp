@@ -6,6 +6,7 @@
 #include "engine/api/flatbuffers/fbresult_generated.h"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/query_statistics.hpp"
 #include "engine/routing_algorithms.hpp"
 #include "engine/status.hpp"
 
@@ -89,6 +90,11 @@ class BasePlugin
         {
             str_result = str(boost::format("code=%1% message=%2%") % code % message);
         };
+        void operator()(std::vector<char> &binary_result)
+        {
+            const auto error = str(boost::format("code=%1% message=%2%") % code % message);
+            binary_result.assign(error.begin(), error.end());
+        };
     };
 
     Status Error(const std::string &code,
@@ -171,6 +177,7 @@ class BasePlugin
                            const std::vector<double> radiuses,
                            bool use_all_edges = false) const
     {
+        const QueryPhaseTimer timer(QueryPhase::Snapping);
         std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
             parameters.coordinates.size());
         BOOST_ASSERT(radiuses.size() == parameters.coordinates.size());
@@ -220,6 +227,7 @@ class BasePlugin
                     const api::BaseParameters &parameters,
                     unsigned number_of_results) const
     {
+        const QueryPhaseTimer timer(QueryPhase::Snapping);
         std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
             parameters.coordinates.size());
 
@@ -294,6 +302,7 @@ class BasePlugin
     std::vector<PhantomNodePair> GetPhantomNodes(const datafacade::BaseDataFacade &facade,
                                                  const api::BaseParameters &parameters) const
     {
+        const QueryPhaseTimer timer(QueryPhase::Snapping);
         std::vector<PhantomNodePair> phantom_node_pairs(parameters.coordinates.size());
 
         const bool use_hints = !parameters.hints.empty();
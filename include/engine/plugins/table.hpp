@@ -3,6 +3,7 @@
 
 #include "engine/plugins/plugin_base.hpp"
 
+#include "engine/api/base_result.hpp"
 #include "engine/api/table_parameters.hpp"
 #include "engine/routing_algorithms.hpp"
 
@@ -18,14 +19,19 @@ namespace plugins
 class TablePlugin final : public BasePlugin
 {
   public:
-    explicit TablePlugin(const int max_locations_distance_table);
+    explicit TablePlugin(const int max_locations_distance_table,
+                         const int max_table_parallelism,
+                         const int rphast_min_destinations);
 
     Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                          const api::TableParameters &params,
-                         osrm::engine::api::ResultT &result) const;
+                         osrm::engine::api::ResultT &result,
+                         const api::ResultChunkWriter &write_chunk = {}) const;
 
   private:
     const int max_locations_distance_table;
+    const int max_table_parallelism;
+    const int rphast_min_destinations;
 };
 } // namespace plugins
 } // namespace engine
@@ -0,0 +1,96 @@
+#ifndef OSRM_ENGINE_QUERY_DEADLINE_HPP
+#define OSRM_ENGINE_QUERY_DEADLINE_HPP
+
+#include "util/exception.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Point in time after which a query is stopped, and a flag to stop it earlier, e.g. because the
+// client went away. Copies share the flag.
+class QueryDeadline
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // Never expires on its own, but can be cancelled
+    QueryDeadline();
+    explicit QueryDeadline(const Clock::time_point time);
+
+    // The same deadline or the given time, whatever comes first
+    QueryDeadline Before(const Clock::time_point other_time) const;
+
+    void Cancel() const;
+    bool IsCancelled() const;
+    bool IsExpired() const;
+
+  private:
+    Clock::time_point time;
+    std::shared_ptr<std::atomic<bool>> cancelled;
+};
+
+// Thrown from the searches of a query whose deadline expired, the engine reports it as a timeout
+class QueryTimeout final : public util::exception
+{
+  public:
+    QueryTimeout() : util::exception("Query took too long") {}
+
+  private:
+    void anchor() const override;
+};
+
+// Makes the searches that run on this thread while it exists check the deadline.
+// Without one the checks do nothing.
+class QueryDeadlineScope
+{
+  public:
+    explicit QueryDeadlineScope(const QueryDeadline *deadline);
+    ~QueryDeadlineScope();
+    QueryDeadlineScope(const QueryDeadlineScope &) = delete;
+    QueryDeadlineScope &operator=(const QueryDeadlineScope &) = delete;
+
+    // Deadline checked on this thread, nullptr if there is none
+    static const QueryDeadline *Current();
+
+  private:
+    const QueryDeadline *previous;
+};
+
+namespace detail
+{
+// The deadline of this thread is only looked at every DEADLINE_CHECK_INTERVAL checks, a check
+// costs a thread-local decrement otherwise
+const constexpr std::uint32_t DEADLINE_CHECK_INTERVAL = 1024;
+
+struct DeadlineCheck
+{
+    const QueryDeadline *deadline = nullptr;
+    std::uint32_t countdown = DEADLINE_CHECK_INTERVAL;
+};
+extern thread_local DeadlineCheck current_deadline_check;
+} // namespace detail
+
+// Throws QueryTimeout if the deadline of this thread expired, for loops of few expensive steps
+void checkDeadlineNow();
+
+// Called once per step of a search loop, throws QueryTimeout once the deadline of this thread
+// expired
+inline void checkDeadline()
+{
+    auto &check = detail::current_deadline_check;
+    if (check.deadline && --check.countdown == 0)
+    {
+        checkDeadlineNow();
+    }
+}
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_QUERY_DEADLINE_HPP
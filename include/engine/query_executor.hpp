@@ -0,0 +1,47 @@
+#ifndef OSRM_ENGINE_QUERY_EXECUTOR_HPP
+#define OSRM_ENGINE_QUERY_EXECUTOR_HPP
+
+#include <tbb/task_arena.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Runs queries submitted by asynchronous API calls on a work-stealing TBB arena of its own. The
+// search heaps are thread-specific, so they are reused by all queries that run on a thread.
+class QueryExecutor
+{
+  public:
+    using Task = std::function<void()>;
+
+    // Up to max_threads queries run at the same time, 0 uses a thread per hardware thread
+    explicit QueryExecutor(const int max_threads);
+    // Waits for the submitted tasks
+    ~QueryExecutor();
+    QueryExecutor(const QueryExecutor &) = delete;
+    QueryExecutor &operator=(const QueryExecutor &) = delete;
+
+    // Tasks must not throw, they run on a thread of the arena. Exceptions are logged and dropped.
+    void Submit(Task task);
+    // The tasks are spread over the threads by stealing them from a single submission
+    void Submit(std::vector<Task> tasks);
+
+  private:
+    void Finish(const std::size_t number_of_tasks);
+
+    tbb::task_arena arena;
+    std::mutex lock;
+    std::condition_variable idle;
+    std::size_t pending_tasks = 0;
+};
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_QUERY_EXECUTOR_HPP
@@ -0,0 +1,85 @@
+#ifndef OSRM_ENGINE_QUERY_STATISTICS_HPP
+#define OSRM_ENGINE_QUERY_STATISTICS_HPP
+
+#include "util/json_container.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Parts of a query the time is accounted to, time spent in a nested phase is not counted for
+// the phase around it
+enum class QueryPhase : std::uint8_t
+{
+    Snapping,  // finding the phantom nodes of the coordinates
+    Search,    // routing searches
+    Unpacking, // expanding shortcuts or overlay edges of found paths
+    Guidance,  // assembling and post-processing the route steps
+    Assembly,  // everything else, e.g. annotations and building the response
+};
+
+const constexpr std::size_t NUMBER_OF_QUERY_PHASES = 5;
+
+const char *toString(const QueryPhase phase);
+
+struct QueryStatistics
+{
+    std::array<std::chrono::nanoseconds, NUMBER_OF_QUERY_PHASES> phase_durations = {};
+    // Work of the searches of the query on the thread it ran on
+    std::uint64_t settled_nodes = 0;
+    std::uint64_t relaxed_edges = 0;
+    // Relaxed edges that are MLD overlay shortcuts, the others are edges of the base graph
+    std::uint64_t overlay_edges = 0;
+    // CH shortcuts or MLD overlay edges expanded to get the found paths
+    std::uint64_t unpacked_shortcuts = 0;
+    // Memory held by the search heaps of that thread after the query
+    std::size_t heap_size_in_bytes = 0;
+};
+
+// Collects the statistics of the queries that run on this thread while it exists.
+// Without one the timers below do nothing.
+class QueryStatisticsScope
+{
+  public:
+    explicit QueryStatisticsScope(QueryStatistics &statistics);
+    ~QueryStatisticsScope();
+    QueryStatisticsScope(const QueryStatisticsScope &) = delete;
+    QueryStatisticsScope &operator=(const QueryStatisticsScope &) = delete;
+
+    // Statistics collected on this thread, nullptr if there is no scope
+    static QueryStatistics *Current();
+
+  private:
+    QueryStatistics *previous;
+};
+
+// Creates the debug_timing object of a response with the microseconds per phase and the work of
+// the searches
+util::json::Object makeDebugTiming(const QueryStatistics &statistics);
+
+// Adds to the unpacked shortcuts of the current query statistics, if there are any
+void countUnpackedShortcuts(const std::uint64_t unpacked_shortcuts);
+
+// Accounts the time until it is destroyed to a phase of the current query statistics
+class QueryPhaseTimer
+{
+  public:
+    explicit QueryPhaseTimer(const QueryPhase phase);
+    ~QueryPhaseTimer();
+    QueryPhaseTimer(const QueryPhaseTimer &) = delete;
+    QueryPhaseTimer &operator=(const QueryPhaseTimer &) = delete;
+
+  private:
+    QueryStatistics *statistics;
+    int previous_phase;
+};
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_QUERY_STATISTICS_HPP
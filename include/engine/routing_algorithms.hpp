@@ -4,13 +4,22 @@
 #include "engine/algorithm.hpp"
 #include "engine/internal_route_result.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/query_statistics.hpp"
 #include "engine/routing_algorithms/alternative_path.hpp"
 #include "engine/routing_algorithms/direct_shortest_path.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/routing_algorithms/map_matching.hpp"
+#include "engine/routing_algorithms/one_to_all.hpp"
+#include "engine/routing_algorithms/overlay_path_cache.hpp"
 #include "engine/routing_algorithms/shortest_path.hpp"
 #include "engine/routing_algorithms/tile_turns.hpp"
 
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -34,7 +43,30 @@ class RoutingAlgorithmsInterface
     ManyToManySearch(const std::vector<PhantomNode> &phantom_nodes,
                      const std::vector<std::size_t> &source_indices,
                      const std::vector<std::size_t> &target_indices,
-                     const bool calculate_distance) const = 0;
+                     const bool calculate_distance,
+                     const std::size_t max_parallelism,
+                     const routing_algorithms::TableSearchLimits &limits) const = 0;
+
+    virtual std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+    ManyToManySweepSearch(const std::vector<PhantomNode> &phantom_nodes,
+                          const std::vector<std::size_t> &source_indices,
+                          const std::vector<std::size_t> &target_indices,
+                          const bool calculate_distance,
+                          const std::size_t max_parallelism,
+                          const routing_algorithms::TableSearchLimits &limits) const = 0;
+
+    virtual void
+    ManyToManyBlockSearch(const std::vector<PhantomNode> &phantom_nodes,
+                          const std::vector<std::size_t> &source_indices,
+                          const std::vector<std::size_t> &target_indices,
+                          const bool calculate_distance,
+                          const std::size_t max_parallelism,
+                          const routing_algorithms::TableSearchLimits &limits,
+                          const std::size_t rows_per_block,
+                          const routing_algorithms::TableBlockHandler &handle_block) const = 0;
+
+    virtual std::vector<routing_algorithms::ReachableNode>
+    OneToAllSearch(const PhantomNode &source_phantom, const EdgeDuration max_duration) const = 0;
 
     virtual routing_algorithms::SubMatchingList
     MapMatching(const routing_algorithms::CandidateLists &candidates_list,
@@ -54,6 +86,7 @@ class RoutingAlgorithmsInterface
     virtual bool HasDirectShortestPathSearch() const = 0;
     virtual bool HasMapMatching() const = 0;
     virtual bool HasManyToManySearch() const = 0;
+    virtual bool HasOneToAllSearch() const = 0;
     virtual bool SupportsDistanceAnnotationType() const = 0;
     virtual bool HasGetTileTurns() const = 0;
     virtual bool HasExcludeFlags() const = 0;
@@ -65,8 +98,13 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
 {
   public:
     RoutingAlgorithms(SearchEngineData<Algorithm> &heaps,
+                      routing_algorithms::TableBucketCache &table_bucket_cache,
+                      routing_algorithms::OverlayPathCache &overlay_path_cache,
+                      routing_algorithms::DownwardGraphCache &downward_graph_cache,
                       std::shared_ptr<const DataFacade<Algorithm>> facade)
-        : heaps(heaps), facade(facade)
+        : heaps(heaps), table_bucket_cache(table_bucket_cache),
+          overlay_path_cache(overlay_path_cache), downward_graph_cache(downward_graph_cache),
+          facade(facade)
     {
     }
 
@@ -87,7 +125,31 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
     ManyToManySearch(const std::vector<PhantomNode> &phantom_nodes,
                      const std::vector<std::size_t> &source_indices,
                      const std::vector<std::size_t> &target_indices,
-                     const bool calculate_distance) const final override;
+                     const bool calculate_distance,
+                     const std::size_t max_parallelism,
+                     const routing_algorithms::TableSearchLimits &limits) const final override;
+
+    virtual std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+    ManyToManySweepSearch(const std::vector<PhantomNode> &phantom_nodes,
+                          const std::vector<std::size_t> &source_indices,
+                          const std::vector<std::size_t> &target_indices,
+                          const bool calculate_distance,
+                          const std::size_t max_parallelism,
+                          const routing_algorithms::TableSearchLimits &limits) const final override;
+
+    virtual void ManyToManyBlockSearch(
+        const std::vector<PhantomNode> &phantom_nodes,
+        const std::vector<std::size_t> &source_indices,
+        const std::vector<std::size_t> &target_indices,
+        const bool calculate_distance,
+        const std::size_t max_parallelism,
+        const routing_algorithms::TableSearchLimits &limits,
+        const std::size_t rows_per_block,
+        const routing_algorithms::TableBlockHandler &handle_block) const final override;
+
+    std::vector<routing_algorithms::ReachableNode>
+    OneToAllSearch(const PhantomNode &source_phantom,
+                   const EdgeDuration max_duration) const final override;
 
     routing_algorithms::SubMatchingList
     MapMatching(const routing_algorithms::CandidateLists &candidates_list,
@@ -102,6 +164,9 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
 
     const DataFacadeBase &GetFacade() const final override { return *facade; }
 
+    // Creates the search heaps of the calling thread for the dataset
+    void WarmUpHeaps() const;
+
     bool HasAlternativePathSearch() const final override
     {
         return routing_algorithms::HasAlternativePathSearch<Algorithm>::value;
@@ -127,6 +192,11 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
         return routing_algorithms::HasManyToManySearch<Algorithm>::value;
     }
 
+    bool HasOneToAllSearch() const final override
+    {
+        return routing_algorithms::HasOneToAllSearch<Algorithm>::value;
+    }
+
     bool SupportsDistanceAnnotationType() const final override
     {
         return routing_algorithms::SupportsDistanceAnnotationType<Algorithm>::value;
@@ -146,6 +216,9 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
 
   private:
     SearchEngineData<Algorithm> &heaps;
+    routing_algorithms::TableBucketCache &table_bucket_cache;
+    routing_algorithms::OverlayPathCache &overlay_path_cache;
+    routing_algorithms::DownwardGraphCache &downward_graph_cache;
     std::shared_ptr<const DataFacade<Algorithm>> facade;
 };
 
@@ -154,6 +227,8 @@ InternalManyRoutesResult
 RoutingAlgorithms<Algorithm>::AlternativePathSearch(const PhantomNodes &phantom_node_pair,
                                                     unsigned number_of_alternatives) const
 {
+    const QueryPhaseTimer timer(QueryPhase::Search);
+    const routing_algorithms::OverlayPathCacheScope cache_scope(overlay_path_cache, facade);
     return routing_algorithms::alternativePathSearch(
         heaps, *facade, phantom_node_pair, number_of_alternatives);
 }
@@ -163,6 +238,8 @@ InternalRouteResult RoutingAlgorithms<Algorithm>::ShortestPathSearch(
     const std::vector<PhantomNodes> &phantom_node_pair,
     const boost::optional<bool> continue_straight_at_waypoint) const
 {
+    const QueryPhaseTimer timer(QueryPhase::Search);
+    const routing_algorithms::OverlayPathCacheScope cache_scope(overlay_path_cache, facade);
     return routing_algorithms::shortestPathSearch(
         heaps, *facade, phantom_node_pair, continue_straight_at_waypoint);
 }
@@ -171,6 +248,8 @@ template <typename Algorithm>
 InternalRouteResult
 RoutingAlgorithms<Algorithm>::DirectShortestPathSearch(const PhantomNodes &phantom_nodes) const
 {
+    const QueryPhaseTimer timer(QueryPhase::Search);
+    const routing_algorithms::OverlayPathCacheScope cache_scope(overlay_path_cache, facade);
     return routing_algorithms::directShortestPathSearch(heaps, *facade, phantom_nodes);
 }
 
@@ -182,6 +261,8 @@ inline routing_algorithms::SubMatchingList RoutingAlgorithms<Algorithm>::MapMatc
     const std::vector<boost::optional<double>> &trace_gps_precision,
     const bool allow_splitting) const
 {
+    const QueryPhaseTimer timer(QueryPhase::Search);
+    const routing_algorithms::OverlayPathCacheScope cache_scope(overlay_path_cache, facade);
     return routing_algorithms::mapMatching(heaps,
                                            *facade,
                                            candidates_list,
@@ -191,35 +272,148 @@ inline routing_algorithms::SubMatchingList RoutingAlgorithms<Algorithm>::MapMatc
                                            allow_splitting);
 }
 
+namespace detail
+{
+// The given indices of phantom nodes, all of them if none are given
+inline std::vector<std::size_t> getPhantomIndices(const std::vector<PhantomNode> &phantom_nodes,
+                                                  const std::vector<std::size_t> &indices)
+{
+    if (!indices.empty())
+        return indices;
+
+    std::vector<std::size_t> all_indices(phantom_nodes.size());
+    std::iota(all_indices.begin(), all_indices.end(), 0);
+    return all_indices;
+}
+} // namespace detail
+
 template <typename Algorithm>
 std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
-RoutingAlgorithms<Algorithm>::ManyToManySearch(const std::vector<PhantomNode> &phantom_nodes,
-                                               const std::vector<std::size_t> &_source_indices,
-                                               const std::vector<std::size_t> &_target_indices,
-                                               const bool calculate_distance) const
+RoutingAlgorithms<Algorithm>::ManyToManySearch(
+    const std::vector<PhantomNode> &phantom_nodes,
+    const std::vector<std::size_t> &_source_indices,
+    const std::vector<std::size_t> &_target_indices,
+    const bool calculate_distance,
+    const std::size_t max_parallelism,
+    const routing_algorithms::TableSearchLimits &limits) const
 {
     BOOST_ASSERT(!phantom_nodes.empty());
 
-    auto source_indices = _source_indices;
-    auto target_indices = _target_indices;
-
-    if (source_indices.empty())
-    {
-        source_indices.resize(phantom_nodes.size());
-        std::iota(source_indices.begin(), source_indices.end(), 0);
-    }
-    if (target_indices.empty())
-    {
-        target_indices.resize(phantom_nodes.size());
-        std::iota(target_indices.begin(), target_indices.end(), 0);
-    }
+    auto source_indices = detail::getPhantomIndices(phantom_nodes, _source_indices);
+    auto target_indices = detail::getPhantomIndices(phantom_nodes, _target_indices);
 
+    const QueryPhaseTimer timer(QueryPhase::Search);
     return routing_algorithms::manyToManySearch(heaps,
                                                 *facade,
                                                 phantom_nodes,
                                                 std::move(source_indices),
                                                 std::move(target_indices),
-                                                calculate_distance);
+                                                calculate_distance,
+                                                max_parallelism,
+                                                limits,
+                                                {&table_bucket_cache, facade});
+}
+
+template <typename Algorithm>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+RoutingAlgorithms<Algorithm>::ManyToManySweepSearch(
+    const std::vector<PhantomNode> &phantom_nodes,
+    const std::vector<std::size_t> &_source_indices,
+    const std::vector<std::size_t> &_target_indices,
+    const bool calculate_distance,
+    const std::size_t max_parallelism,
+    const routing_algorithms::TableSearchLimits &limits) const
+{
+    BOOST_ASSERT(!phantom_nodes.empty());
+
+    auto source_indices = detail::getPhantomIndices(phantom_nodes, _source_indices);
+    auto target_indices = detail::getPhantomIndices(phantom_nodes, _target_indices);
+
+    const QueryPhaseTimer timer(QueryPhase::Search);
+    return routing_algorithms::manyToManySweepSearch(heaps,
+                                                     *facade,
+                                                     phantom_nodes,
+                                                     std::move(source_indices),
+                                                     std::move(target_indices),
+                                                     calculate_distance,
+                                                     max_parallelism,
+                                                     limits);
+}
+
+template <typename Algorithm>
+void RoutingAlgorithms<Algorithm>::ManyToManyBlockSearch(
+    const std::vector<PhantomNode> &phantom_nodes,
+    const std::vector<std::size_t> &_source_indices,
+    const std::vector<std::size_t> &_target_indices,
+    const bool calculate_distance,
+    const std::size_t max_parallelism,
+    const routing_algorithms::TableSearchLimits &limits,
+    const std::size_t rows_per_block,
+    const routing_algorithms::TableBlockHandler &handle_block) const
+{
+    BOOST_ASSERT(!phantom_nodes.empty());
+
+    auto source_indices = detail::getPhantomIndices(phantom_nodes, _source_indices);
+    auto target_indices = detail::getPhantomIndices(phantom_nodes, _target_indices);
+
+    const QueryPhaseTimer timer(QueryPhase::Search);
+    routing_algorithms::manyToManyBlockSearch(
+        heaps,
+        *facade,
+        phantom_nodes,
+        source_indices,
+        target_indices,
+        calculate_distance,
+        max_parallelism,
+        limits,
+        {&table_bucket_cache, facade},
+        rows_per_block,
+        [&handle_block](const std::size_t first_row,
+                        std::vector<EdgeDuration> &durations,
+                        std::vector<EdgeDistance> &distances) {
+            // writing out a block is not part of the search
+            const QueryPhaseTimer block_timer(QueryPhase::Assembly);
+            handle_block(first_row, durations, distances);
+        });
+}
+
+template <typename Algorithm>
+std::vector<routing_algorithms::ReachableNode>
+RoutingAlgorithms<Algorithm>::OneToAllSearch(const PhantomNode &source_phantom,
+                                             const EdgeDuration max_duration) const
+{
+    const QueryPhaseTimer timer(QueryPhase::Search);
+    return routing_algorithms::oneToAllSearch(heaps, *facade, source_phantom, max_duration);
+}
+
+template <typename Algorithm> inline void RoutingAlgorithms<Algorithm>::WarmUpHeaps() const
+{
+    const auto number_of_nodes = facade->GetNumberOfNodes();
+    heaps.InitializeOrClearFirstThreadLocalStorage(number_of_nodes);
+    heaps.InitializeOrClearSecondThreadLocalStorage(number_of_nodes);
+    heaps.InitializeOrClearThirdThreadLocalStorage(number_of_nodes);
+    heaps.InitializeOrClearManyToManyThreadLocalStorage(number_of_nodes);
+}
+
+// MLD overrides
+template <> inline void RoutingAlgorithms<routing_algorithms::mld::Algorithm>::WarmUpHeaps() const
+{
+    const auto number_of_nodes = facade->GetNumberOfNodes();
+    const auto number_of_boundary_nodes = facade->GetMaxBorderNodeID() + 1;
+    heaps.InitializeOrClearFirstThreadLocalStorage(number_of_nodes, number_of_boundary_nodes);
+    heaps.InitializeOrClearManyToManyThreadLocalStorage(number_of_nodes, number_of_boundary_nodes);
+}
+
+// CH overrides
+template <>
+inline std::vector<routing_algorithms::ReachableNode>
+RoutingAlgorithms<routing_algorithms::ch::Algorithm>::OneToAllSearch(
+    const PhantomNode &source_phantom, const EdgeDuration max_duration) const
+{
+    const auto downward_graph = downward_graph_cache.Get(facade);
+    const QueryPhaseTimer timer(QueryPhase::Search);
+    return routing_algorithms::oneToAllSearch(
+        heaps, *facade, *downward_graph, source_phantom, max_duration);
 }
 
 template <typename Algorithm>
@@ -3,10 +3,27 @@
 
 #include "engine/algorithm.hpp"
 #include "engine/datafacade.hpp"
+#include "engine/phantom_node.hpp"
+#include "engine/query_deadline.hpp"
+#include "engine/routing_algorithms/table_bucket_cache.hpp"
 #include "engine/search_engine_data.hpp"
 
 #include "util/typedefs.hpp"
 
+#include <boost/assert.hpp>
+#include <boost/range/iterator_range_core.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -15,8 +32,6 @@ namespace engine
 {
 namespace routing_algorithms
 {
-namespace
-{
 struct NodeBucket
 {
     NodeID middle_node;
@@ -49,45 +64,160 @@ struct NodeBucket
           from_clique_arc(false), weight(weight), duration(duration), distance(distance)
     {
     }
+};
 
-    // partial order comparison
-    bool operator<(const NodeBucket &rhs) const
-    {
-        return std::tie(middle_node, column_index) < std::tie(rhs.middle_node, rhs.column_index);
-    }
+// Bucket store of the backward search spaces in a compressed sparse row layout: the buckets of
+// every middle node are stored contiguously and ordered by column. The range of a node is found
+// by an open-addressing lookup of the node in a table that holds the node's offsets, so a
+// forward search settle costs an O(1) lookup plus a linear scan over the node's buckets.
+//
+// A dense node-indexed offsets array would cost O(|V|) per request, the table is instead sized
+// by the number of buckets.
+class NodeBucketIndex
+{
+  public:
+    using BucketRange = boost::iterator_range<std::vector<NodeBucket>::const_iterator>;
 
-    // functor for equal_range
-    struct Compare
+    // Builds the index from the buckets of all backward searches, one list per column
+    explicit NodeBucketIndex(const std::vector<std::vector<NodeBucket>> &column_buckets)
     {
-        bool operator()(const NodeBucket &lhs, const NodeID &rhs) const
+        std::size_t number_of_buckets = 0;
+        for (const auto &buckets : column_buckets)
+            number_of_buckets += buckets.size();
+
+        // at most 2/3 of the table can be filled, so probe sequences stay short
+        std::size_t capacity = 1;
+        while (capacity < number_of_buckets + number_of_buckets / 2 + 1)
+            capacity <<= 1;
+        mask = capacity - 1;
+        slots.resize(capacity, Slot{SPECIAL_NODEID, 0, 0});
+
+        // Count the buckets of every node
+        for (const auto &buckets : column_buckets)
         {
-            return lhs.middle_node < rhs;
+            for (const auto &bucket : buckets)
+            {
+                auto &slot = slots[FindSlot(bucket.middle_node)];
+                slot.node = bucket.middle_node;
+                ++slot.end;
+            }
         }
 
-        bool operator()(const NodeID &lhs, const NodeBucket &rhs) const
+        // Turn the counts into offsets, `end` is the insertion cursor while scattering
+        std::uint32_t offset = 0;
+        for (auto &slot : slots)
         {
-            return lhs < rhs.middle_node;
+            if (slot.node == SPECIAL_NODEID)
+                continue;
+            const auto count = slot.end;
+            slot.begin = offset;
+            slot.end = offset;
+            offset += count;
         }
-    };
 
-    // functor for equal_range
-    struct ColumnCompare
+        // Scatter the buckets in column order, so each node range is ordered by column
+        buckets.resize(number_of_buckets, NodeBucket{SPECIAL_NODEID, SPECIAL_NODEID, 0, 0, 0, 0});
+        for (const auto &column : column_buckets)
+        {
+            for (const auto &bucket : column)
+            {
+                buckets[slots[FindSlot(bucket.middle_node)].end++] = bucket;
+            }
+        }
+    }
+
+    // All buckets with middle node `node`, in column order
+    BucketRange operator[](const NodeID node) const
     {
-        unsigned column_idx;
+        const auto &slot = slots[FindSlot(node)];
+        return boost::make_iterator_range(buckets.begin() + slot.begin,
+                                          buckets.begin() + slot.end);
+    }
 
-        ColumnCompare(unsigned column_idx) : column_idx(column_idx){};
+    // The bucket of `node` in column `column_index` or an empty range
+    BucketRange Find(const NodeID node, const unsigned column_index) const
+    {
+        const auto range = (*this)[node];
+        const auto bucket = std::lower_bound(
+            range.begin(), range.end(), column_index, [](const NodeBucket &lhs, unsigned rhs) {
+                return lhs.column_index < rhs;
+            });
+        if (bucket == range.end() || bucket->column_index != column_index)
+            return boost::make_iterator_range(range.end(), range.end());
+        return boost::make_iterator_range(bucket, std::next(bucket));
+    }
+
+    std::size_t size() const { return buckets.size(); }
 
-        bool operator()(const NodeBucket &lhs, const NodeID &rhs) const // lowerbound
+    std::size_t GetSizeInBytes() const
+    {
+        return buckets.capacity() * sizeof(NodeBucket) + slots.capacity() * sizeof(Slot);
+    }
+
+  private:
+    struct Slot
+    {
+        NodeID node;
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    // Index of the slot of `node` or of the empty slot where it would be inserted
+    std::size_t FindSlot(const NodeID node) const
+    {
+        // Fibonacci hashing spreads consecutive node ids over the table
+        auto index = (static_cast<std::uint64_t>(node) * 0x9E3779B97F4A7C15ull >> 32) & mask;
+        while (slots[index].node != node && slots[index].node != SPECIAL_NODEID)
         {
-            return std::tie(lhs.middle_node, lhs.column_index) < std::tie(rhs, column_idx);
+            index = (index + 1) & mask;
         }
+        return index;
+    }
+
+    std::size_t mask;
+    std::vector<Slot> slots;
+    std::vector<NodeBucket> buckets;
+};
 
-        bool operator()(const NodeID &lhs, const NodeBucket &rhs) const // upperbound
+namespace
+{
+// Calls `search(index)` for every index in [0, number_of_searches). With a parallelism cap
+// above one the searches are spread over a task arena of at most `max_parallelism` threads.
+// The search engine heaps are thread-local, so every worker explores with its own heap. The
+// workers check the deadline of the calling thread and trim their heaps to the budget.
+template <typename SearchT>
+void runSearches(const std::size_t number_of_searches,
+                 const std::size_t max_parallelism,
+                 const SearchT &search)
+{
+    if (max_parallelism <= 1 || number_of_searches <= 1)
+    {
+        for (std::size_t index = 0; index < number_of_searches; ++index)
         {
-            return std::tie(lhs, column_idx) < std::tie(rhs.middle_node, rhs.column_index);
+            search(index);
         }
-    };
-};
+        return;
+    }
+
+    const auto *deadline = QueryDeadlineScope::Current();
+    const auto calling_thread = std::this_thread::get_id();
+    tbb::task_arena arena(static_cast<int>(std::min(max_parallelism, number_of_searches)));
+    arena.execute([&] {
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_searches),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              const QueryDeadlineScope deadline_scope(deadline);
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  search(index);
+                              }
+                              // the heaps of the calling thread may still be used by its query
+                              if (std::this_thread::get_id() != calling_thread)
+                              {
+                                  trimSearchHeaps();
+                              }
+                          });
+    });
+}
 } // namespace
 
 template <typename Algorithm>
@@ -97,7 +227,112 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
                  const std::vector<PhantomNode> &phantom_nodes,
                  const std::vector<std::size_t> &source_indices,
                  const std::vector<std::size_t> &target_indices,
-                 const bool calculate_distance);
+                 const bool calculate_distance,
+                 const std::size_t max_parallelism,
+                 const TableSearchLimits &limits,
+                 const TableBucketCacheRef &bucket_cache);
+
+// Receives the durations and distances of the table rows [first_row, first_row + rows)
+using TableBlockHandler = std::function<void(const std::size_t first_row,
+                                             std::vector<EdgeDuration> &durations,
+                                             std::vector<EdgeDistance> &distances)>;
+
+// Many-to-many search that hands the table to handle_block in blocks of rows_per_block rows,
+// so only a single block of the table is held in memory. Algorithms without a dedicated
+// implementation search every block of sources separately.
+template <typename Algorithm>
+void manyToManyBlockSearch(SearchEngineData<Algorithm> &engine_working_data,
+                           const DataFacade<Algorithm> &facade,
+                           const std::vector<PhantomNode> &phantom_nodes,
+                           const std::vector<std::size_t> &source_indices,
+                           const std::vector<std::size_t> &target_indices,
+                           const bool calculate_distance,
+                           const std::size_t max_parallelism,
+                           const TableSearchLimits &limits,
+                           const TableBucketCacheRef &bucket_cache,
+                           const std::size_t rows_per_block,
+                           const TableBlockHandler &handle_block)
+{
+    BOOST_ASSERT(rows_per_block > 0);
+    for (std::size_t first_row = 0; first_row < source_indices.size(); first_row += rows_per_block)
+    {
+        const auto last_row = std::min(first_row + rows_per_block, source_indices.size());
+        const std::vector<std::size_t> block_source_indices(source_indices.begin() + first_row,
+                                                            source_indices.begin() + last_row);
+        auto block = manyToManySearch(engine_working_data,
+                                      facade,
+                                      phantom_nodes,
+                                      block_source_indices,
+                                      target_indices,
+                                      calculate_distance,
+                                      max_parallelism,
+                                      limits,
+                                      bucket_cache);
+        handle_block(first_row, block.first, block.second);
+    }
+}
+
+template <>
+void manyToManyBlockSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                           const DataFacade<ch::Algorithm> &facade,
+                           const std::vector<PhantomNode> &phantom_nodes,
+                           const std::vector<std::size_t> &source_indices,
+                           const std::vector<std::size_t> &target_indices,
+                           const bool calculate_distance,
+                           const std::size_t max_parallelism,
+                           const TableSearchLimits &limits,
+                           const TableBucketCacheRef &bucket_cache,
+                           const std::size_t rows_per_block,
+                           const TableBlockHandler &handle_block);
+
+template <>
+void manyToManyBlockSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
+                           const DataFacade<mld::Algorithm> &facade,
+                           const std::vector<PhantomNode> &phantom_nodes,
+                           const std::vector<std::size_t> &source_indices,
+                           const std::vector<std::size_t> &target_indices,
+                           const bool calculate_distance,
+                           const std::size_t max_parallelism,
+                           const TableSearchLimits &limits,
+                           const TableBucketCacheRef &bucket_cache,
+                           const std::size_t rows_per_block,
+                           const TableBlockHandler &handle_block);
+
+// Many-to-many search for a large number of targets that sweeps over the targets' search space
+// once per group of sources instead of scanning backward search buckets. Algorithms without a
+// dedicated implementation fall back to the bucket based search.
+template <typename Algorithm>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+manyToManySweepSearch(SearchEngineData<Algorithm> &engine_working_data,
+                      const DataFacade<Algorithm> &facade,
+                      const std::vector<PhantomNode> &phantom_nodes,
+                      const std::vector<std::size_t> &source_indices,
+                      const std::vector<std::size_t> &target_indices,
+                      const bool calculate_distance,
+                      const std::size_t max_parallelism,
+                      const TableSearchLimits &limits)
+{
+    return manyToManySearch(engine_working_data,
+                            facade,
+                            phantom_nodes,
+                            source_indices,
+                            target_indices,
+                            calculate_distance,
+                            max_parallelism,
+                            limits,
+                            TableBucketCacheRef{});
+}
+
+template <>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+manyToManySweepSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                      const DataFacade<ch::Algorithm> &facade,
+                      const std::vector<PhantomNode> &phantom_nodes,
+                      const std::vector<std::size_t> &source_indices,
+                      const std::vector<std::size_t> &target_indices,
+                      const bool calculate_distance,
+                      const std::size_t max_parallelism,
+                      const TableSearchLimits &limits);
 
 } // namespace routing_algorithms
 } // namespace engine
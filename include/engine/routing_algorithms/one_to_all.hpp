@@ -0,0 +1,98 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_ONE_TO_ALL_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_ONE_TO_ALL_HPP
+
+#include "engine/algorithm.hpp"
+#include "engine/datafacade.hpp"
+#include "engine/phantom_node.hpp"
+#include "engine/search_engine_data.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+// Duration until the start of an edge-based node is reached from the source
+using ReachableNode = std::pair<NodeID, EdgeDuration>;
+
+/// Bounded one-to-all search by duration. Returns every edge-based node whose start can be
+/// reached from the source phantom node within max_duration, in order of their durations.
+template <typename Algorithm>
+std::vector<ReachableNode> oneToAllSearch(SearchEngineData<Algorithm> &engine_working_data,
+                                          const DataFacade<Algorithm> &facade,
+                                          const PhantomNode &source_phantom,
+                                          const EdgeDuration max_duration);
+
+namespace ch
+{
+// Downward edges of a CH graph grouped by their upper node, and the position of every node in a
+// topological order of these edges (every node comes after all nodes that have a downward edge
+// into it). The query graph only stores edges at their lower node, so a one-to-all search needs
+// this copy of the graph to go down from the nodes its upward search settled.
+struct DownwardGraph
+{
+    struct Edge
+    {
+        NodeID target;
+        EdgeWeight weight;
+        EdgeDuration duration;
+    };
+
+    std::vector<std::uint32_t> positions;
+    std::vector<std::uint32_t> edge_offsets;
+    std::vector<Edge> edges;
+
+    std::size_t GetSizeInBytes() const;
+};
+
+DownwardGraph makeDownwardGraph(const DataFacade<Algorithm> &facade);
+} // namespace ch
+
+// Downward graphs of the CH datasets in use. A graph is built by the first one-to-all search on
+// its dataset and dropped once the dataset is released.
+class DownwardGraphCache
+{
+  public:
+    DownwardGraphCache() = default;
+    DownwardGraphCache(const DownwardGraphCache &) = delete;
+    DownwardGraphCache &operator=(const DownwardGraphCache &) = delete;
+
+    std::shared_ptr<const ch::DownwardGraph>
+    Get(const std::shared_ptr<const DataFacade<ch::Algorithm>> &dataset);
+
+  private:
+    struct Entry
+    {
+        std::weak_ptr<const void> dataset;
+        std::shared_ptr<const ch::DownwardGraph> graph;
+    };
+
+    std::mutex mutex;
+    std::vector<Entry> entries;
+};
+
+/// Bounded one-to-all search on CH in the manner of PHAST (Delling et al., "PHAST:
+/// Hardware-Accelerated Shortest Path Trees"): an upward search from the source, then the nodes
+/// it settled are swept downwards in the topological order of the downward graph. Only nodes
+/// reached within max_duration are visited. The durations are those of the paths of least weight.
+std::vector<ReachableNode> oneToAllSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                                          const DataFacade<ch::Algorithm> &facade,
+                                          const ch::DownwardGraph &downward_graph,
+                                          const PhantomNode &source_phantom,
+                                          const EdgeDuration max_duration);
+
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
+
+#endif
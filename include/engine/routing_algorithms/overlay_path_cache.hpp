@@ -0,0 +1,125 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_OVERLAY_PATH_CACHE_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_OVERLAY_PATH_CACHE_HPP
+
+#include "util/typedefs.hpp"
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+// Base graph paths of MLD overlay edges kept across queries, so overlay edges that many routes
+// share, e.g. the cell crossings of motorways, are unpacked by a search on the levels below only
+// once. The dataset a path was unpacked on is part of its key, which also separates the metrics
+// and excluded classes that have a dataset of their own. Paths of a dataset are dropped once it
+// is released, e.g. when the data watchdog swaps in new shared memory regions. The cache is split
+// into shards with a lock each that evict their least recently used paths when they exceed their
+// part of the size budget, a budget of zero disables the cache.
+class OverlayPathCache
+{
+  public:
+    // Base graph nodes and edges of an overlay edge from its source to its target
+    struct Path
+    {
+        std::vector<NodeID> nodes;
+        std::vector<EdgeID> edges;
+    };
+    using PathPtr = std::shared_ptr<const Path>;
+
+    // An overlay edge of a dataset and the loops the search unpacking it was forced to take
+    struct Key
+    {
+        const void *dataset;
+        LevelID level;
+        NodeID source;
+        NodeID target;
+        bool force_loop_forward;
+        bool force_loop_reverse;
+
+        bool operator==(const Key &other) const;
+    };
+
+    explicit OverlayPathCache(const std::size_t max_size_in_bytes = 0);
+    OverlayPathCache(const OverlayPathCache &) = delete;
+    OverlayPathCache &operator=(const OverlayPathCache &) = delete;
+
+    bool IsEnabled() const { return max_shard_size_in_bytes > 0; }
+
+    // Paths are only kept for datasets added before. Drops the paths of released datasets, so a
+    // new dataset that reuses the address of a released one never finds its paths.
+    void AddDataset(const std::shared_ptr<const void> &dataset);
+
+    // Path of the overlay edge or nullptr
+    PathPtr Find(const Key &key);
+
+    void Insert(const Key &key, PathPtr path);
+
+    std::size_t GetSizeInBytes() const;
+
+  private:
+    struct KeyHash
+    {
+        std::size_t operator()(const Key &key) const;
+    };
+
+    using LRUList = std::list<std::pair<Key, PathPtr>>;
+
+    struct Shard
+    {
+        mutable std::mutex lock;
+        LRUList entries; // most recently used first
+        std::unordered_map<Key, LRUList::iterator, KeyHash> index;
+        std::size_t size_in_bytes = 0;
+    };
+
+    struct Dataset
+    {
+        std::weak_ptr<const void> dataset;
+        const void *address;
+    };
+
+    static const constexpr std::size_t NUMBER_OF_SHARDS = 16;
+
+    Shard &GetShard(const Key &key);
+    // Forgets the paths of a released dataset
+    void RemovePaths(const void *dataset);
+
+    const std::size_t max_shard_size_in_bytes;
+    std::array<Shard, NUMBER_OF_SHARDS> shards;
+    std::mutex datasets_lock;
+    std::vector<Dataset> datasets;
+};
+
+// Makes the MLD searches that run on this thread while it exists look up and keep the paths of the
+// overlay edges of `dataset` in `cache`. Without one every overlay edge is unpacked by a search.
+class OverlayPathCacheScope
+{
+  public:
+    OverlayPathCacheScope(OverlayPathCache &cache, const std::shared_ptr<const void> &dataset);
+    ~OverlayPathCacheScope();
+    OverlayPathCacheScope(const OverlayPathCacheScope &) = delete;
+    OverlayPathCacheScope &operator=(const OverlayPathCacheScope &) = delete;
+
+    // Cache of this thread for the overlay edges of `dataset`, nullptr if there is none
+    static OverlayPathCache *Current(const void *dataset);
+
+  private:
+    OverlayPathCache *previous_cache;
+    const void *previous_dataset;
+};
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_ROUTING_ALGORITHMS_OVERLAY_PATH_CACHE_HPP
@@ -3,6 +3,8 @@
 
 #include "engine/algorithm.hpp"
 #include "engine/datafacade.hpp"
+#include "engine/query_deadline.hpp"
+#include "engine/query_statistics.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
 
@@ -53,11 +55,13 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
                         const SearchEngineData<Algorithm>::QueryHeap::HeapNode &heapNode,
                         SearchEngineData<Algorithm>::QueryHeap &heap)
 {
+    std::uint64_t relaxed_edges = 0;
     for (const auto edge : facade.GetAdjacentEdgeRange(heapNode.node))
     {
         const auto &data = facade.GetEdgeData(edge);
         if (DIRECTION == FORWARD_DIRECTION ? data.forward : data.backward)
         {
+            ++relaxed_edges;
             const NodeID to = facade.GetTarget(edge);
             const EdgeWeight edge_weight = data.weight;
 
@@ -80,6 +84,7 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
             }
         }
     }
+    heap.CountRelaxedEdges(relaxed_edges);
 }
 
 /*
@@ -123,6 +128,7 @@ void routingStep(const DataFacade<Algorithm> &facade,
                  const bool force_loop_forward,
                  const bool force_loop_reverse)
 {
+    checkDeadline();
     auto heapNode = forward_heap.DeleteMinGetHeapNode();
     const auto reverseHeapNode = reverse_heap.GetHeapNodeIfWasInserted(heapNode.node);
 
@@ -211,6 +217,22 @@ std::tuple<EdgeWeight, EdgeDistance> getLoopWeight(const DataFacade<Algorithm> &
     return std::make_tuple(loop_weight, loop_distance);
 }
 
+/**
+ * Finds the edge of the CH graph that the part `from` -> `to` of a packed path takes. This is the
+ * smallest edge of the forward CH graph from -> to or, for parts of the path that were found by
+ * the backward search, the smallest edge of the backward CH graph to -> from.
+ * @return SPECIAL_EDGEID if there is no such edge
+ */
+inline EdgeID findPathEdge(const DataFacade<Algorithm> &facade, const NodeID from, const NodeID to)
+{
+    const auto edge_id =
+        facade.FindSmallestEdge(from, to, [](const auto &data) { return data.forward; });
+    if (SPECIAL_EDGEID != edge_id)
+        return edge_id;
+
+    return facade.FindSmallestEdge(to, from, [](const auto &data) { return data.backward; });
+}
+
 /**
  * Given a sequence of connected `NodeID`s in the CH graph, performs a depth-first unpacking of
  * the shortcut
@@ -241,35 +263,32 @@ void unpackPath(const DataFacade<Algorithm> &facade,
     if (packed_path_begin == packed_path_end)
         return;
 
-    std::stack<std::pair<NodeID, NodeID>> recursion_stack;
+    const QueryPhaseTimer timer(QueryPhase::Unpacking);
+    // Parts of the path with the edge they take, SPECIAL_EDGEID if it still has to be looked up.
+    // The halves of shortcuts take the children of the shortcut, if the dataset has them.
+    std::stack<std::tuple<NodeID, NodeID, EdgeID>> recursion_stack;
 
     // We have to push the path in reverse order onto the stack because it's LIFO.
     for (auto current = std::prev(packed_path_end); current != packed_path_begin;
          current = std::prev(current))
     {
-        recursion_stack.emplace(*std::prev(current), *current);
+        recursion_stack.emplace(*std::prev(current), *current, SPECIAL_EDGEID);
     }
 
+    std::uint64_t unpacked_shortcuts = 0;
     std::pair<NodeID, NodeID> edge;
+    EdgeID smaller_edge_id;
     while (!recursion_stack.empty())
     {
-        edge = recursion_stack.top();
+        std::tie(edge.first, edge.second, smaller_edge_id) = recursion_stack.top();
         recursion_stack.pop();
 
-        // Look for an edge on the forward CH graph (.forward)
-        EdgeID smaller_edge_id = facade.FindSmallestEdge(
-            edge.first, edge.second, [](const auto &data) { return data.forward; });
-
-        // If we didn't find one there, the we might be looking at a part of the path that
-        // was found using the backward search.  Here, we flip the node order (.second, .first)
-        // and only consider edges with the `.backward` flag.
         if (SPECIAL_EDGEID == smaller_edge_id)
         {
-            smaller_edge_id = facade.FindSmallestEdge(
-                edge.second, edge.first, [](const auto &data) { return data.backward; });
+            smaller_edge_id = findPathEdge(facade, edge.first, edge.second);
         }
 
-        // If we didn't find anything *still*, then something is broken and someone has
+        // If we didn't find anything, then something is broken and someone has
         // called this function with bad values.
         BOOST_ASSERT_MSG(smaller_edge_id != SPECIAL_EDGEID, "Invalid smaller edge ID");
 
@@ -280,11 +299,13 @@ void unpackPath(const DataFacade<Algorithm> &facade,
         // If the edge is a shortcut, we need to add the two halfs to the stack.
         if (data.shortcut)
         { // unpack
+            ++unpacked_shortcuts;
             const NodeID middle_node_id = data.turn_id;
+            const auto children = facade.GetShortcutChildren(smaller_edge_id);
             // Note the order here - we're adding these to a stack, so we
             // want the first->middle to get visited before middle->second
-            recursion_stack.emplace(middle_node_id, edge.second);
-            recursion_stack.emplace(edge.first, middle_node_id);
+            recursion_stack.emplace(middle_node_id, edge.second, children.second);
+            recursion_stack.emplace(edge.first, middle_node_id, children.first);
         }
         else
         {
@@ -292,6 +313,7 @@ void unpackPath(const DataFacade<Algorithm> &facade,
             std::forward<Callback>(callback)(edge, smaller_edge_id);
         }
     }
+    countUnpackedShortcuts(unpacked_shortcuts);
 }
 
 template <typename BidirectionalIterator>
@@ -326,24 +348,10 @@ EdgeDistance calculateEBGNodeAnnotations(const DataFacade<Algorithm> &facade,
 
             std::get<2>(edge) = true; // mark that this edge will now be processed
 
-            // Look for an edge on the forward CH graph (.forward)
-            EdgeID smaller_edge_id =
-                facade.FindSmallestEdge(std::get<0>(edge), std::get<1>(edge), [](const auto &data) {
-                    return data.forward;
-                });
-
-            // If we didn't find one there, the we might be looking at a part of the path that
-            // was found using the backward search.  Here, we flip the node order (.second,
-            // .first) and only consider edges with the `.backward` flag.
-            if (SPECIAL_EDGEID == smaller_edge_id)
-            {
-                smaller_edge_id =
-                    facade.FindSmallestEdge(std::get<1>(edge),
-                                            std::get<0>(edge),
-                                            [](const auto &data) { return data.backward; });
-            }
+            const EdgeID smaller_edge_id =
+                findPathEdge(facade, std::get<0>(edge), std::get<1>(edge));
 
-            // If we didn't find anything *still*, then something is broken and someone has
+            // If we didn't find anything, then something is broken and someone has
             // called this function with bad values.
             BOOST_ASSERT_MSG(smaller_edge_id != SPECIAL_EDGEID, "Invalid smaller edge ID");
 
@@ -401,6 +409,7 @@ void unpackPath(const FacadeT &facade,
                 const PhantomNodes &phantom_nodes,
                 std::vector<PathData> &unpacked_path)
 {
+    const QueryPhaseTimer timer(QueryPhase::Unpacking);
     const auto nodes_number = std::distance(packed_path_begin, packed_path_end);
     BOOST_ASSERT(nodes_number > 0);
 
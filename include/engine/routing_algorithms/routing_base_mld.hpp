@@ -3,6 +3,9 @@
 
 #include "engine/algorithm.hpp"
 #include "engine/datafacade.hpp"
+#include "engine/query_deadline.hpp"
+#include "engine/query_statistics.hpp"
+#include "engine/routing_algorithms/overlay_path_cache.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
 
@@ -237,6 +240,8 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
 
     const auto level = getNodeQueryLevel(partition, heapNode.node, args...);
 
+    std::uint64_t overlay_edges = 0;
+    std::uint64_t base_edges = 0;
     if (level >= 1 && !heapNode.data.from_clique_arc)
     {
         if (DIRECTION == FORWARD_DIRECTION)
@@ -252,6 +257,7 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
 
                 if (shortcut_weight != INVALID_EDGE_WEIGHT && heapNode.node != to)
                 {
+                    ++overlay_edges;
                     const EdgeWeight to_weight = heapNode.weight + shortcut_weight;
                     BOOST_ASSERT(to_weight >= heapNode.weight);
                     const auto toHeapNode = forward_heap.GetHeapNodeIfWasInserted(to);
@@ -282,6 +288,7 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
 
                 if (shortcut_weight != INVALID_EDGE_WEIGHT && heapNode.node != to)
                 {
+                    ++overlay_edges;
                     const EdgeWeight to_weight = heapNode.weight + shortcut_weight;
                     BOOST_ASSERT(to_weight >= heapNode.weight);
                     const auto toHeapNode = forward_heap.GetHeapNodeIfWasInserted(to);
@@ -314,6 +321,7 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
             if (!facade.ExcludeNode(to) &&
                 checkParentCellRestriction(partition.GetCell(level + 1, to), args...))
             {
+                ++base_edges;
                 const auto node_weight =
                     facade.GetNodeWeight(DIRECTION == FORWARD_DIRECTION ? heapNode.node : to);
                 const auto turn_penalty = facade.GetWeightPenaltyForEdgeID(edge_data.turn_id);
@@ -336,6 +344,7 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
             }
         }
     }
+    forward_heap.CountRelaxedEdges(overlay_edges + base_edges, overlay_edges);
 }
 
 template <bool DIRECTION, typename Algorithm, typename... Args>
@@ -348,6 +357,7 @@ void routingStep(const DataFacade<Algorithm> &facade,
                  const bool force_loop_reverse,
                  Args... args)
 {
+    checkDeadline();
     const auto heapNode = forward_heap.DeleteMinGetHeapNode();
     const auto weight = heapNode.weight;
 
@@ -388,6 +398,91 @@ using UnpackedNodes = std::vector<NodeID>;
 using UnpackedEdges = std::vector<EdgeID>;
 using UnpackedPath = std::tuple<EdgeWeight, UnpackedNodes, UnpackedEdges>;
 
+template <typename Algorithm, typename... Args>
+UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
+                    const DataFacade<Algorithm> &facade,
+                    typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                    typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                    const bool force_loop_forward,
+                    const bool force_loop_reverse,
+                    EdgeWeight weight_upper_bound,
+                    Args... args);
+
+// Appends the base graph path of the overlay edge source -> target on `level` without its source
+// node. The path is found by a search in the cell of the edge on the level below, unless the
+// overlay path cache of the query has it already.
+template <typename Algorithm>
+void unpackOverlayEdge(SearchEngineData<Algorithm> &engine_working_data,
+                       const DataFacade<Algorithm> &facade,
+                       typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                       typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                       const bool force_loop_forward,
+                       const bool force_loop_reverse,
+                       const LevelID level,
+                       const NodeID source,
+                       const NodeID target,
+                       std::vector<NodeID> &unpacked_nodes,
+                       std::vector<EdgeID> &unpacked_edges)
+{
+    const auto &partition = facade.GetMultiLevelPartition();
+    const CellID parent_cell_id = partition.GetCell(level, source);
+    BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
+
+    const auto append = [&](const std::vector<NodeID> &subpath_nodes,
+                            const std::vector<EdgeID> &subpath_edges) {
+        BOOST_ASSERT(!subpath_edges.empty());
+        BOOST_ASSERT(subpath_nodes.size() > 1);
+        BOOST_ASSERT(subpath_nodes.front() == source);
+        BOOST_ASSERT(subpath_nodes.back() == target);
+        unpacked_nodes.insert(
+            unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
+        unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+    };
+
+    const auto cache = OverlayPathCacheScope::Current(&facade);
+    const OverlayPathCache::Key key{
+        &facade, level, source, target, force_loop_forward, force_loop_reverse};
+    if (cache)
+    {
+        if (const auto path = cache->Find(key))
+        {
+            append(path->nodes, path->edges);
+            return;
+        }
+    }
+
+    const LevelID sublevel = level - 1;
+
+    // Here heaps can be reused, let's go deeper!
+    forward_heap.Clear();
+    reverse_heap.Clear();
+    forward_heap.Insert(source, 0, {source});
+    reverse_heap.Insert(target, 0, {target});
+
+    // TODO: when structured bindings will be allowed change to
+    // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
+    EdgeWeight subpath_weight;
+    std::vector<NodeID> subpath_nodes;
+    std::vector<EdgeID> subpath_edges;
+    std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(engine_working_data,
+                                                                    facade,
+                                                                    forward_heap,
+                                                                    reverse_heap,
+                                                                    force_loop_forward,
+                                                                    force_loop_reverse,
+                                                                    INVALID_EDGE_WEIGHT,
+                                                                    sublevel,
+                                                                    parent_cell_id);
+    append(subpath_nodes, subpath_edges);
+
+    if (cache)
+    {
+        cache->Insert(key,
+                      std::make_shared<const OverlayPathCache::Path>(OverlayPathCache::Path{
+                          std::move(subpath_nodes), std::move(subpath_edges)}));
+    }
+}
+
 template <typename Algorithm, typename... Args>
 UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
                     const DataFacade<Algorithm> &facade,
@@ -457,7 +552,8 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
     // In this case we return a single node, no edges. We also don't unpack.
     const NodeID source_node = !packed_path.empty() ? std::get<0>(packed_path.front()) : middle;
 
-    // Unpack path
+    // Unpack path, overlay edges are unpacked by searches on the levels below
+    const QueryPhaseTimer unpack_timer(QueryPhase::Unpacking);
     std::vector<NodeID> unpacked_nodes;
     std::vector<EdgeID> unpacked_edges;
     unpacked_nodes.reserve(packed_path.size());
@@ -465,6 +561,7 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
 
     unpacked_nodes.push_back(source_node);
 
+    std::uint64_t unpacked_shortcuts = 0;
     for (auto const &packed_edge : packed_path)
     {
         NodeID source, target;
@@ -477,41 +574,21 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
         }
         else
         { // an overlay graph edge
-            LevelID level = getNodeQueryLevel(partition, source, args...);
-            CellID parent_cell_id = partition.GetCell(level, source);
-            BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
-
-            LevelID sublevel = level - 1;
-
-            // Here heaps can be reused, let's go deeper!
-            forward_heap.Clear();
-            reverse_heap.Clear();
-            forward_heap.Insert(source, 0, {source});
-            reverse_heap.Insert(target, 0, {target});
-
-            // TODO: when structured bindings will be allowed change to
-            // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
-            EdgeWeight subpath_weight;
-            std::vector<NodeID> subpath_nodes;
-            std::vector<EdgeID> subpath_edges;
-            std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(engine_working_data,
-                                                                            facade,
-                                                                            forward_heap,
-                                                                            reverse_heap,
-                                                                            force_loop_forward,
-                                                                            force_loop_reverse,
-                                                                            INVALID_EDGE_WEIGHT,
-                                                                            sublevel,
-                                                                            parent_cell_id);
-            BOOST_ASSERT(!subpath_edges.empty());
-            BOOST_ASSERT(subpath_nodes.size() > 1);
-            BOOST_ASSERT(subpath_nodes.front() == source);
-            BOOST_ASSERT(subpath_nodes.back() == target);
-            unpacked_nodes.insert(
-                unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
-            unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+            ++unpacked_shortcuts;
+            unpackOverlayEdge(engine_working_data,
+                              facade,
+                              forward_heap,
+                              reverse_heap,
+                              force_loop_forward,
+                              force_loop_reverse,
+                              getNodeQueryLevel(partition, source, args...),
+                              source,
+                              target,
+                              unpacked_nodes,
+                              unpacked_edges);
         }
     }
+    countUnpackedShortcuts(unpacked_shortcuts);
 
     return std::make_tuple(weight, std::move(unpacked_nodes), std::move(unpacked_edges));
 }
@@ -548,6 +625,7 @@ void unpackPath(const FacadeT &facade,
                 const PhantomNodes &phantom_nodes,
                 std::vector<PathData> &unpacked_path)
 {
+    const QueryPhaseTimer timer(QueryPhase::Unpacking);
     const auto nodes_number = std::distance(packed_path_begin, packed_path_end);
     BOOST_ASSERT(nodes_number > 0);
 
@@ -0,0 +1,180 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_TABLE_BUCKET_CACHE_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_TABLE_BUCKET_CACHE_HPP
+
+#include "engine/phantom_node.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+class NodeBucketIndex;
+
+// Bounds of a table request. Search nodes beyond a bound are not expanded, so pairs beyond it
+// are reported as missing. The default limits do not bound the searches.
+struct TableSearchLimits
+{
+    EdgeDuration max_duration = MAXIMAL_EDGE_DURATION;
+    EdgeDistance max_distance = MAXIMAL_EDGE_DISTANCE;
+
+    bool IsBounded() const
+    {
+        return max_duration != MAXIMAL_EDGE_DURATION || max_distance != MAXIMAL_EDGE_DISTANCE;
+    }
+
+    bool Exceeds(const EdgeDuration duration, const EdgeDistance distance) const
+    {
+        return duration > max_duration || distance > max_distance;
+    }
+};
+
+// Backward search buckets of target sets kept across table requests, so requests against a
+// fixed set of targets only pay for their forward searches. Entries belong to the dataset they
+// were searched on and are dropped once it is released, e.g. when the data watchdog swaps in new
+// shared memory regions. Entries are found through a hash index and the least recently used ones
+// are evicted when the buckets exceed the size budget, a budget of zero disables the cache. The
+// buckets of a table are large, so unlike the overlay path cache it is not split into shards that
+// would each get a small part of the budget.
+class TableBucketCache
+{
+  public:
+    // Heap entries of the targets' backward searches and the limits they were run with
+    class Key
+    {
+      public:
+        Key() = default;
+        Key(const std::vector<PhantomNode> &phantom_nodes,
+            const std::vector<std::size_t> &target_indices,
+            const TableSearchLimits &limits);
+
+        bool operator==(const Key &other) const
+        {
+            return hash == other.hash && max_duration == other.max_duration &&
+                   max_distance == other.max_distance && targets == other.targets;
+        }
+
+        std::size_t GetHash() const { return hash; }
+
+        std::size_t GetSizeInBytes() const { return targets.capacity() * sizeof(Target); }
+
+      private:
+        struct Target
+        {
+            NodeID forward_node;
+            NodeID reverse_node;
+            EdgeWeight forward_weight;
+            EdgeWeight reverse_weight;
+            EdgeDuration forward_duration;
+            EdgeDuration reverse_duration;
+            EdgeDistance forward_distance;
+            EdgeDistance reverse_distance;
+
+            bool operator==(const Target &other) const
+            {
+                return std::tie(forward_node,
+                                reverse_node,
+                                forward_weight,
+                                reverse_weight,
+                                forward_duration,
+                                reverse_duration,
+                                forward_distance,
+                                reverse_distance) == std::tie(other.forward_node,
+                                                              other.reverse_node,
+                                                              other.forward_weight,
+                                                              other.reverse_weight,
+                                                              other.forward_duration,
+                                                              other.reverse_duration,
+                                                              other.forward_distance,
+                                                              other.reverse_distance);
+            }
+        };
+
+        std::vector<Target> targets;
+        EdgeDuration max_duration = MAXIMAL_EDGE_DURATION;
+        EdgeDistance max_distance = MAXIMAL_EDGE_DISTANCE;
+        std::size_t hash = 0;
+    };
+
+    explicit TableBucketCache(const std::size_t max_size_in_bytes = 0);
+    TableBucketCache(const TableBucketCache &) = delete;
+    TableBucketCache &operator=(const TableBucketCache &) = delete;
+
+    bool IsEnabled() const { return max_size_in_bytes > 0; }
+
+    // Buckets searched on `dataset` for `key` or nullptr
+    std::shared_ptr<const NodeBucketIndex> Find(const std::shared_ptr<const void> &dataset,
+                                                const Key &key);
+
+    void Insert(const std::shared_ptr<const void> &dataset,
+                Key key,
+                std::shared_ptr<const NodeBucketIndex> buckets);
+
+    std::size_t GetSizeInBytes() const;
+
+  private:
+    struct Entry
+    {
+        std::weak_ptr<const void> dataset;
+        const void *address;
+        Key key;
+        std::shared_ptr<const NodeBucketIndex> buckets;
+        std::size_t size_in_bytes;
+    };
+    using LRUList = std::list<Entry>;
+
+    struct Dataset
+    {
+        std::weak_ptr<const void> dataset;
+        const void *address;
+    };
+
+    // Position of the entry of `key` on `dataset` in the list or its end
+    LRUList::iterator FindEntry(const std::shared_ptr<const void> &dataset, const Key &key);
+    void RemoveEntry(const LRUList::iterator entry);
+    // Drops the entries of datasets that are not used anymore and adds `dataset`
+    void UpdateDatasets(const std::shared_ptr<const void> &dataset);
+
+    const std::size_t max_size_in_bytes;
+    mutable std::mutex mutex;
+    LRUList entries; // most recently used first
+    // Entries by the hash of their key and dataset address, keys with the same hash share it
+    std::unordered_multimap<std::size_t, LRUList::iterator> index;
+    std::vector<Dataset> datasets;
+    std::size_t size_in_bytes;
+};
+
+// The bucket cache of an engine together with the dataset a request runs on
+struct TableBucketCacheRef
+{
+    TableBucketCache *cache = nullptr;
+    std::shared_ptr<const void> dataset;
+
+    bool IsEnabled() const { return cache && cache->IsEnabled(); }
+
+    std::shared_ptr<const NodeBucketIndex> Find(const TableBucketCache::Key &key) const
+    {
+        return cache->Find(dataset, key);
+    }
+
+    void Insert(TableBucketCache::Key key, std::shared_ptr<const NodeBucketIndex> buckets) const
+    {
+        cache->Insert(dataset, std::move(key), std::move(buckets));
+    }
+};
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_ROUTING_ALGORITHMS_TABLE_BUCKET_CACHE_HPP
@@ -7,6 +7,9 @@
 
 #include <boost/thread/tss.hpp>
 
+#include <cstddef>
+#include <cstdint>
+
 namespace osrm
 {
 namespace engine
@@ -21,6 +24,35 @@ template <typename Algorithm> struct SearchEngineData
 {
 };
 
+// Memory held by the search heaps of all threads of the process, as of the last time each thread
+// finished a query
+struct SearchHeapMemory
+{
+    std::size_t heap_bytes = 0;
+    std::size_t peak_heap_bytes = 0;
+    // 0 if there is no budget
+    std::size_t max_heap_bytes = 0;
+    // Heaps that were shrunk to their initial size and the memory this freed
+    std::uint64_t shrunk_heaps = 0;
+    std::uint64_t freed_bytes = 0;
+};
+
+SearchHeapMemory getSearchHeapMemory();
+
+// Heaps are owned by their thread, so they are only shrunk by it. Every thread with heaps may keep
+// an equal share of max_heap_bytes (0 for no budget) of memory they grew to in searches, index
+// arrays sized by the graph are not counted. The budget is shared by all engines of the process.
+void setSearchHeapBudget(const std::size_t max_heap_bytes);
+
+// Shrinks the heaps of the calling thread that grew the most until they are within its share of
+// the budget. It is called once a query or a part of it running on a worker is done, so the
+// searches of one query reuse their heaps.
+void trimSearchHeaps();
+
+// Shrinks all heaps of the calling thread, e.g. of a worker thread that had no queries for a
+// while. It must not be called while the thread runs a search.
+void shrinkSearchHeaps();
+
 struct HeapData
 {
     NodeID parent;
@@ -39,14 +71,20 @@ struct ManyToManyHeapData : HeapData
 
 template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
 {
-    using QueryHeap = util::
-        QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::UnorderedMapStorage<NodeID, int>>;
+    // CH searches settle a small part of the graph, so their heaps index nodes in a hash table
+    using QueryHeap = util::QueryHeap<NodeID,
+                                      NodeID,
+                                      EdgeWeight,
+                                      HeapData,
+                                      util::FlatHashStorage<NodeID, int>,
+                                      util::SearchQueue>;
 
     using ManyToManyQueryHeap = util::QueryHeap<NodeID,
                                                 NodeID,
                                                 EdgeWeight,
                                                 ManyToManyHeapData,
-                                                util::UnorderedMapStorage<NodeID, int>>;
+                                                util::FlatHashStorage<NodeID, int>,
+                                                util::SearchQueue>;
 
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
     using ManyToManyHeapPtr = boost::thread_specific_ptr<ManyToManyQueryHeap>;
@@ -66,6 +104,12 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     void InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes);
+
+    // Work done by the heaps of this thread so far
+    util::QueryHeapCounters GetCounters() const;
+
+    // Memory held by the heaps of this thread
+    std::size_t GetSizeInBytes() const;
 };
 
 struct MultiLayerDijkstraHeapData
@@ -95,17 +139,22 @@ struct ManyToManyMultiLayerDijkstraHeapData : MultiLayerDijkstraHeapData
 
 template <> struct SearchEngineData<routing_algorithms::mld::Algorithm>
 {
+    // Overlay nodes are indexed in an array, base graph nodes in a hash table
+    using HeapIndexStorage = util::TwoLevelStorage<NodeID, int, util::FlatHashStorage>;
+
     using QueryHeap = util::QueryHeap<NodeID,
                                       NodeID,
                                       EdgeWeight,
                                       MultiLayerDijkstraHeapData,
-                                      util::TwoLevelStorage<NodeID, int>>;
+                                      HeapIndexStorage,
+                                      util::SearchQueue>;
 
     using ManyToManyQueryHeap = util::QueryHeap<NodeID,
                                                 NodeID,
                                                 EdgeWeight,
                                                 ManyToManyMultiLayerDijkstraHeapData,
-                                                util::TwoLevelStorage<NodeID, int>>;
+                                                HeapIndexStorage,
+                                                util::SearchQueue>;
 
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
     using ManyToManyHeapPtr = boost::thread_specific_ptr<ManyToManyQueryHeap>;
@@ -119,6 +168,12 @@ template <> struct SearchEngineData<routing_algorithms::mld::Algorithm>
 
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes,
                                                        unsigned number_of_boundary_nodes);
+
+    // Work done by the heaps of this thread so far
+    util::QueryHeapCounters GetCounters() const;
+
+    // Memory held by the heaps of this thread
+    std::size_t GetSizeInBytes() const;
 };
 } // namespace engine
 } // namespace osrm
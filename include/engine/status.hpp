@@ -40,7 +40,9 @@ namespace engine
 enum class Status
 {
     Ok,
-    Error
+    Error,
+    // The query ran longer than allowed or was cancelled, the result holds the error
+    Timeout
 };
 } // namespace engine
 } // namespace osrm
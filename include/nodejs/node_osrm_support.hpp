@@ -47,9 +47,11 @@ using table_parameters_ptr = std::unique_ptr<osrm::TableParameters>;
 struct PluginParameters
 {
     bool renderJSONToBuffer = false;
+    bool renderToBinary = false;
 };
 
-using ObjectOrString = typename mapbox::util::variant<osrm::json::Object, std::string>;
+using ObjectOrString =
+    typename mapbox::util::variant<osrm::json::Object, std::string, std::vector<char>>;
 
 template <typename ResultT> inline v8::Local<v8::Value> render(const ResultT &result);
 
@@ -58,7 +60,7 @@ template <> v8::Local<v8::Value> inline render(const std::string &result)
     return Nan::CopyBuffer(result.data(), result.size()).ToLocalChecked();
 }
 
-template <> v8::Local<v8::Value> inline render(const ObjectOrString &result)
+v8::Local<v8::Value> inline render(ObjectOrString &result)
 {
     if (result.is<osrm::json::Object>())
     {
@@ -67,6 +69,18 @@ template <> v8::Local<v8::Value> inline render(const ObjectOrString &result)
         renderToV8(value, result.get<osrm::json::Object>());
         return value;
     }
+    else if (result.is<std::vector<char>>())
+    {
+        // Hand the binary result over to a node Buffer without copying, the Buffer frees it
+        auto *binary_result = new std::vector<char>(std::move(result.get<std::vector<char>>()));
+        return Nan::NewBuffer(binary_result->data(),
+                              binary_result->size(),
+                              [](char *, void *hint) {
+                                  delete static_cast<std::vector<char> *>(hint);
+                              },
+                              binary_result)
+            .ToLocalChecked();
+    }
     else
     {
         // Return the string object as a node Buffer
@@ -82,7 +96,7 @@ inline void ParseResult(const osrm::Status &result_status, osrm::json::Object &r
 
     BOOST_ASSERT(code_iter != end_iter);
 
-    if (result_status == osrm::Status::Error)
+    if (result_status != osrm::Status::Ok)
     {
         throw std::logic_error(code_iter->second.get<osrm::json::String>().value.c_str());
     }
@@ -97,6 +111,14 @@ inline void ParseResult(const osrm::Status &result_status, osrm::json::Object &r
 
 inline void ParseResult(const osrm::Status & /*result_status*/, const std::string & /*unused*/) {}
 
+inline void ParseResult(const osrm::Status &result_status, const std::vector<char> &result)
+{
+    if (result_status != osrm::Status::Ok)
+    {
+        throw std::logic_error(std::string(result.begin(), result.end()));
+    }
+}
+
 inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo<v8::Value> &args)
 {
     Nan::HandleScope scope;
@@ -264,6 +286,14 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
         Nan::Get(params, Nan::New("max_alternatives").ToLocalChecked()).ToLocalChecked();
     auto max_radius_map_matching =
         Nan::Get(params, Nan::New("max_radius_map_matching").ToLocalChecked()).ToLocalChecked();
+    auto max_table_parallelism =
+        Nan::Get(params, Nan::New("max_table_parallelism").ToLocalChecked()).ToLocalChecked();
+    auto rphast_min_destinations =
+        Nan::Get(params, Nan::New("rphast_min_destinations").ToLocalChecked()).ToLocalChecked();
+    auto table_bucket_cache_size =
+        Nan::Get(params, Nan::New("table_bucket_cache_size").ToLocalChecked()).ToLocalChecked();
+    auto overlay_path_cache_size =
+        Nan::Get(params, Nan::New("overlay_path_cache_size").ToLocalChecked()).ToLocalChecked();
 
     if (!max_locations_trip->IsUndefined() && !max_locations_trip->IsNumber())
     {
@@ -295,6 +325,26 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
         Nan::ThrowError("max_alternatives must be an integral number");
         return engine_config_ptr();
     }
+    if (!max_table_parallelism->IsUndefined() && !max_table_parallelism->IsNumber())
+    {
+        Nan::ThrowError("max_table_parallelism must be an integral number");
+        return engine_config_ptr();
+    }
+    if (!rphast_min_destinations->IsUndefined() && !rphast_min_destinations->IsNumber())
+    {
+        Nan::ThrowError("rphast_min_destinations must be an integral number");
+        return engine_config_ptr();
+    }
+    if (!table_bucket_cache_size->IsUndefined() && !table_bucket_cache_size->IsNumber())
+    {
+        Nan::ThrowError("table_bucket_cache_size must be an integral number");
+        return engine_config_ptr();
+    }
+    if (!overlay_path_cache_size->IsUndefined() && !overlay_path_cache_size->IsNumber())
+    {
+        Nan::ThrowError("overlay_path_cache_size must be an integral number");
+        return engine_config_ptr();
+    }
 
     if (max_locations_trip->IsNumber())
         engine_config->max_locations_trip = Nan::To<int>(max_locations_trip).FromJust();
@@ -313,6 +363,14 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
     if (max_radius_map_matching->IsNumber())
         engine_config->max_radius_map_matching =
             Nan::To<double>(max_radius_map_matching).FromJust();
+    if (max_table_parallelism->IsNumber())
+        engine_config->max_table_parallelism = Nan::To<int>(max_table_parallelism).FromJust();
+    if (rphast_min_destinations->IsNumber())
+        engine_config->rphast_min_destinations = Nan::To<int>(rphast_min_destinations).FromJust();
+    if (table_bucket_cache_size->IsNumber())
+        engine_config->table_bucket_cache_size = Nan::To<int>(table_bucket_cache_size).FromJust();
+    if (overlay_path_cache_size->IsNumber())
+        engine_config->overlay_path_cache_size = Nan::To<int>(overlay_path_cache_size).FromJust();
 
     return engine_config;
 }
@@ -675,6 +733,38 @@ inline bool argumentsToParameter(const Nan::FunctionCallbackInfo<v8::Value> &arg
         params->generate_hints = Nan::To<bool>(generate_hints).FromJust();
     }
 
+    if (Nan::Has(obj, Nan::New("debug_timing").ToLocalChecked()).FromJust())
+    {
+        v8::Local<v8::Value> debug_timing =
+            Nan::Get(obj, Nan::New("debug_timing").ToLocalChecked()).ToLocalChecked();
+        if (debug_timing.IsEmpty())
+            return false;
+
+        if (!debug_timing->IsBoolean())
+        {
+            Nan::ThrowError("debug_timing must be of type Boolean");
+            return false;
+        }
+
+        params->debug_timing = Nan::To<bool>(debug_timing).FromJust();
+    }
+
+    if (Nan::Has(obj, Nan::New("timeout").ToLocalChecked()).FromJust())
+    {
+        v8::Local<v8::Value> timeout =
+            Nan::Get(obj, Nan::New("timeout").ToLocalChecked()).ToLocalChecked();
+        if (timeout.IsEmpty())
+            return false;
+
+        if (!timeout->IsUint32())
+        {
+            Nan::ThrowError("timeout must be a non-negative integer");
+            return false;
+        }
+
+        params->timeout = Nan::To<unsigned>(timeout).FromJust();
+    }
+
     if (Nan::Has(obj, Nan::New("exclude").ToLocalChecked()).FromJust())
     {
         v8::Local<v8::Value> exclude =
@@ -889,7 +979,7 @@ argumentsToPluginParameters(const Nan::FunctionCallbackInfo<v8::Value> &args)
 
         if (!format->IsString())
         {
-            Nan::ThrowError("format must be a string: \"object\" or \"json_buffer\"");
+            Nan::ThrowError("format must be a string: \"object\", \"json_buffer\" or \"bin\"");
             return {};
         }
 
@@ -904,9 +994,13 @@ argumentsToPluginParameters(const Nan::FunctionCallbackInfo<v8::Value> &args)
         {
             return {true};
         }
+        else if (format_str == "bin")
+        {
+            return {false, true};
+        }
         else
         {
-            Nan::ThrowError("format must be a string: \"object\" or \"json_buffer\"");
+            Nan::ThrowError("format must be a string: \"object\", \"json_buffer\" or \"bin\"");
             return {};
         }
     }
@@ -1375,6 +1469,44 @@ argumentsToTableParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
         params->scale_factor = Nan::To<double>(scale_factor).FromJust();
     }
 
+    if (Nan::Has(obj, Nan::New("max_duration").ToLocalChecked()).FromJust())
+    {
+        auto max_duration =
+            Nan::Get(obj, Nan::New("max_duration").ToLocalChecked()).ToLocalChecked();
+
+        if (!max_duration->IsNumber())
+        {
+            Nan::ThrowError("max_duration must be a number");
+            return table_parameters_ptr();
+        }
+        else if (Nan::To<double>(max_duration).FromJust() <= 0)
+        {
+            Nan::ThrowError("max_duration must be > 0");
+            return table_parameters_ptr();
+        }
+
+        params->max_duration = Nan::To<double>(max_duration).FromJust();
+    }
+
+    if (Nan::Has(obj, Nan::New("max_distance").ToLocalChecked()).FromJust())
+    {
+        auto max_distance =
+            Nan::Get(obj, Nan::New("max_distance").ToLocalChecked()).ToLocalChecked();
+
+        if (!max_distance->IsNumber())
+        {
+            Nan::ThrowError("max_distance must be a number");
+            return table_parameters_ptr();
+        }
+        else if (Nan::To<double>(max_distance).FromJust() <= 0)
+        {
+            Nan::ThrowError("max_distance must be > 0");
+            return table_parameters_ptr();
+        }
+
+        params->max_distance = Nan::To<double>(max_distance).FromJust();
+    }
+
     return params;
 }
 
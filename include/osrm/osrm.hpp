@@ -32,13 +32,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "osrm/osrm_fwd.hpp"
 #include "osrm/status.hpp"
 
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
 namespace json = util::json;
+using engine::api::BatchParameters;
 using engine::EngineConfig;
+using engine::api::IsochroneParameters;
 using engine::api::MatchParameters;
 using engine::api::NearestParameters;
 using engine::api::RouteParameters;
@@ -46,6 +51,22 @@ using engine::api::TableParameters;
 using engine::api::TileParameters;
 using engine::api::TripParameters;
 
+/**
+ * Status and result of a query answered asynchronously.
+ */
+struct AsyncResult
+{
+    Status status = Status::Error;
+    engine::api::ResultT result;
+};
+
+/**
+ * Receives the result of an asynchronous query on a thread of the executor. A query that throws
+ * has the status Error and the code InternalError. The callback must not throw, exceptions that
+ * leave it are logged and dropped.
+ */
+using AsyncCallback = std::function<void(AsyncResult result)>;
+
 /**
  * Represents a Open Source Routing Machine with access to its services.
  *
@@ -57,8 +78,12 @@ using engine::api::TripParameters;
  *  - Trip: shortest round trip between coordinates
  *  - Match: snaps noisy coordinate traces to the road network
  *  - Tile: vector tiles with internal graph representation
+ *  - Isochrone: areas reachable from a coordinate within durations
  *
  *  All services take service-specific parameters, fill a JSON object, and return a status code.
+ *
+ *  The services can also be called asynchronously. These queries run on an internal executor of
+ *  EngineConfig::async_threads threads and deliver their results through a future or a callback.
  */
 class OSRM final
 {
@@ -97,6 +122,21 @@ class OSRM final
     Status Table(const TableParameters &parameters, json::Object &result) const;
     Status Table(const TableParameters &parameters, engine::api::ResultT &result) const;
 
+    /**
+     * Distance tables for coordinates, written in blocks of rows while they are computed.
+     *
+     * Streams the table to write_chunk if parameters.stream is set. Errors are reported in the
+     * result before anything is written.
+     *
+     * \param parameters table query specific parameters
+     * \param write_chunk receives the pieces of the response in order
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters and json::Object
+     */
+    Status Table(const TableParameters &parameters,
+                 engine::api::ResultT &result,
+                 const engine::api::ResultChunkWriter &write_chunk) const;
+
     /**
      * Nearest street segment for coordinate.
      *
@@ -137,8 +177,93 @@ class OSRM final
     Status Tile(const TileParameters &parameters, std::string &result) const;
     Status Tile(const TileParameters &parameters, engine::api::ResultT &result) const;
 
+    /**
+     * Isochrone: areas reachable from a coordinate within durations
+     *
+     * \param parameters isochrone query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, IsochroneParameters and json::Object
+     */
+    Status Isochrone(const IsochroneParameters &parameters, json::Object &result) const;
+    Status Isochrone(const IsochroneParameters &parameters, engine::api::ResultT &result) const;
+
+    /**
+     * Batch: independent route and nearest queries answered in parallel
+     *
+     * All queries are answered from the same data. A query that fails has its error in place of
+     * its result, the batch itself only fails if it is too big.
+     *
+     * \param parameters batch query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, BatchParameters and json::Object
+     */
+    Status Batch(const BatchParameters &parameters, json::Object &result) const;
+    Status Batch(const BatchParameters &parameters, engine::api::ResultT &result) const;
+
+    /**
+     * Batch results written in the order of the queries while they are computed.
+     *
+     * \param parameters batch query specific parameters
+     * \param write_chunk receives the pieces of the response in order
+     * \return Status indicating success for the query or failure
+     * \see Status, BatchParameters and json::Object
+     */
+    Status Batch(const BatchParameters &parameters,
+                 engine::api::ResultT &result,
+                 const engine::api::ResultChunkWriter &write_chunk) const;
+
+    /**
+     * Creates the search heaps of the calling thread for the loaded dataset. Threads that answer
+     * queries can call it when they start, so their first query does not allocate the heaps.
+     */
+    void WarmUp() const;
+
+    /**
+     * Asynchronous queries taking their parameters by value. They return right away and run on
+     * the executor, the futures hold the results or the exceptions of the queries. Queries
+     * submitted together as a vector are spread over the threads of the executor.
+     *
+     * The results are JSON objects unless the parameters ask for another format. Destroying the
+     * OSRM instance waits for the queries that have not finished yet.
+     *
+     * \param parameters service specific parameters of one or more queries
+     * \param callback receives the result instead of a future
+     * \see AsyncResult, AsyncCallback and EngineConfig
+     */
+    std::future<AsyncResult> RouteAsync(RouteParameters parameters) const;
+    void RouteAsync(RouteParameters parameters, AsyncCallback callback) const;
+    std::vector<std::future<AsyncResult>> RouteAsync(std::vector<RouteParameters> parameters) const;
+
+    std::future<AsyncResult> TableAsync(TableParameters parameters) const;
+    void TableAsync(TableParameters parameters, AsyncCallback callback) const;
+    std::vector<std::future<AsyncResult>> TableAsync(std::vector<TableParameters> parameters) const;
+
+    std::future<AsyncResult> NearestAsync(NearestParameters parameters) const;
+    void NearestAsync(NearestParameters parameters, AsyncCallback callback) const;
+    std::vector<std::future<AsyncResult>>
+    NearestAsync(std::vector<NearestParameters> parameters) const;
+
+    std::future<AsyncResult> TripAsync(TripParameters parameters) const;
+    void TripAsync(TripParameters parameters, AsyncCallback callback) const;
+    std::vector<std::future<AsyncResult>> TripAsync(std::vector<TripParameters> parameters) const;
+
+    std::future<AsyncResult> MatchAsync(MatchParameters parameters) const;
+    void MatchAsync(MatchParameters parameters, AsyncCallback callback) const;
+    std::vector<std::future<AsyncResult>> MatchAsync(std::vector<MatchParameters> parameters) const;
+
+    std::future<AsyncResult> TileAsync(TileParameters parameters) const;
+    void TileAsync(TileParameters parameters, AsyncCallback callback) const;
+    std::vector<std::future<AsyncResult>> TileAsync(std::vector<TileParameters> parameters) const;
+
+    std::future<AsyncResult> IsochroneAsync(IsochroneParameters parameters) const;
+    void IsochroneAsync(IsochroneParameters parameters, AsyncCallback callback) const;
+    std::vector<std::future<AsyncResult>>
+    IsochroneAsync(std::vector<IsochroneParameters> parameters) const;
+
   private:
     std::unique_ptr<engine::EngineInterface> engine_;
+    // Declared after the engine, so it waits for the queries before the engine is destroyed
+    std::unique_ptr<engine::QueryExecutor> executor_;
 };
 } // namespace osrm
 
@@ -52,9 +52,12 @@ struct NearestParameters;
 struct TripParameters;
 struct MatchParameters;
 struct TileParameters;
+struct IsochroneParameters;
+struct BatchParameters;
 } // namespace api
 
 class EngineInterface;
+class QueryExecutor;
 struct EngineConfig;
 } // namespace engine
 } // namespace osrm
@@ -0,0 +1,96 @@
+#ifndef SERVER_ADMISSION_CONTROL_HPP
+#define SERVER_ADMISSION_CONTROL_HPP
+
+#include "server/api/parsed_url.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace osrm
+{
+namespace server
+{
+
+struct AdmissionControlConfig
+{
+    // Requests processed at the same time, 0 is unlimited
+    std::size_t max_inflight_requests = 0;
+    // Estimated cost of the requests of a service processed at the same time, see EstimateCost.
+    // Services without a budget are unlimited.
+    std::unordered_map<std::string, std::uint64_t> max_inflight_cost;
+    // Requests that waited longer than this to be started are dropped, 0 keeps all of them
+    std::chrono::milliseconds max_queue_time{0};
+    // Seconds a client is asked to wait before retrying a rejected request
+    unsigned retry_after = 1;
+};
+
+// Turns requests away before any work is done on them if the server is busy with requests
+// admitted earlier or the request waited too long to be started
+class AdmissionControl
+{
+  public:
+    // Holds the budget taken by an admitted request until it goes out of scope
+    class Ticket
+    {
+      public:
+        Ticket() = default;
+        Ticket(AdmissionControl *admission_control, const std::string *service, std::uint64_t cost)
+            : admission_control(admission_control), service(service), cost(cost)
+        {
+        }
+        Ticket(Ticket &&other)
+            : admission_control(other.admission_control), service(other.service),
+              cost(other.cost)
+        {
+            other.admission_control = nullptr;
+        }
+        Ticket(const Ticket &) = delete;
+        Ticket &operator=(const Ticket &) = delete;
+        ~Ticket()
+        {
+            if (admission_control)
+            {
+                admission_control->Release(service, cost);
+            }
+        }
+
+        explicit operator bool() const { return admission_control != nullptr; }
+
+      private:
+        AdmissionControl *admission_control = nullptr;
+        // set if the service has a cost budget
+        const std::string *service = nullptr;
+        std::uint64_t cost = 0;
+    };
+
+    explicit AdmissionControl(AdmissionControlConfig config);
+
+    // Admits a request received at the given time if it fits into the budgets,
+    // an empty ticket means it has to be rejected
+    Ticket Admit(const api::ParsedURL &parsed_url,
+                 const std::chrono::steady_clock::time_point received);
+
+    unsigned GetRetryAfter() const { return config.retry_after; }
+
+    // Estimated cost of a request from the number of its coordinates: the number of matrix cells
+    // for table and trip requests, the number of coordinates for all others. Batches cost the
+    // coordinates of all their sub-requests.
+    static std::uint64_t EstimateCost(const api::ParsedURL &parsed_url);
+
+  private:
+    void Release(const std::string *service, const std::uint64_t cost);
+
+    const AdmissionControlConfig config;
+
+    std::mutex lock;
+    std::size_t inflight_requests = 0;
+    std::unordered_map<std::string, std::uint64_t> inflight_cost;
+};
+} // namespace server
+} // namespace osrm
+
+#endif // SERVER_ADMISSION_CONTROL_HPP
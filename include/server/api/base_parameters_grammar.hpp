@@ -101,6 +101,10 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
                 base_parameters.bearings.push_back(std::move(bearing));
             };
 
+        const auto has_coordinates = [](const engine::api::BaseParameters &base_parameters) {
+            return !base_parameters.coordinates.empty();
+        };
+
         polyline_chars = qi::char_("a-zA-Z0-9_.--[]{}@?|\\%~`^");
         base64_char = qi::char_("a-zA-Z0-9--_=");
         unlimited_rule = qi::lit("unlimited")[qi::_val = std::numeric_limits<double>::infinity()];
@@ -137,7 +141,9 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
                                            },
                                            qi::_1)];
 
+        // Coordinates given apart from the query, e.g. in a request body, are not part of it
         query_rule =
+            qi::eps(ph::bind(has_coordinates, qi::_r1)) |
             ((location_rule % ';') | polyline_rule |
              polyline6_rule)[ph::bind(&engine::api::BaseParameters::coordinates, qi::_r1) = qi::_1];
 
@@ -158,6 +164,14 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
             qi::lit("skip_waypoints=") >
             qi::bool_[ph::bind(&engine::api::BaseParameters::skip_waypoints, qi::_r1) = qi::_1];
 
+        debug_timing_rule =
+            qi::lit("debug_timing=") >
+            qi::bool_[ph::bind(&engine::api::BaseParameters::debug_timing, qi::_r1) = qi::_1];
+
+        timeout_rule =
+            qi::lit("timeout=") >
+            qi::uint_[ph::bind(&engine::api::BaseParameters::timeout, qi::_r1) = qi::_1];
+
         bearings_rule =
             qi::lit("bearings=") >
             (-(qi::short_ > ',' > qi::short_))[ph::bind(add_bearing, qi::_r1, qi::_1)] % ';';
@@ -190,6 +204,8 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
                     | bearings_rule(qi::_r1)       //
                     | generate_hints_rule(qi::_r1) //
                     | skip_waypoints_rule(qi::_r1) //
+                    | debug_timing_rule(qi::_r1)   //
+                    | timeout_rule(qi::_r1)        //
                     | approach_rule(qi::_r1)       //
                     | exclude_rule(qi::_r1)        //
                     | snapping_rule(qi::_r1);
@@ -211,6 +227,8 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
 
     qi::rule<Iterator, Signature> generate_hints_rule;
     qi::rule<Iterator, Signature> skip_waypoints_rule;
+    qi::rule<Iterator, Signature> debug_timing_rule;
+    qi::rule<Iterator, Signature> timeout_rule;
     qi::rule<Iterator, Signature> approach_rule;
     qi::rule<Iterator, Signature> exclude_rule;
 
@@ -0,0 +1,31 @@
+#ifndef SERVER_API_BODY_PARSER_HPP
+#define SERVER_API_BODY_PARSER_HPP
+
+#include "server/api/parsed_url.hpp"
+
+#include <string>
+
+namespace osrm
+{
+namespace server
+{
+namespace api
+{
+
+// Adds the coordinates and options of a request body to the URL the request was sent to.
+//
+// A JSON body (application/json) is an object with a "coordinates" array of [longitude, latitude]
+// pairs, its other members are options in their query string form. Arrays are joined with ';',
+// arrays nested in them with ','. Batch requests hold a "requests" array of sub-request URL paths
+// instead of the coordinates.
+// A binary body (application/octet-stream) holds the coordinates only, as pairs of little endian
+// 32 bit fixed point longitudes and latitudes in units of 1e-6 degrees.
+//
+// Returns false if the body is malformed or holds neither coordinates nor sub-requests.
+bool parseBody(const std::string &content_type, const std::string &body, ParsedURL &parsed_url);
+
+} // namespace api
+} // namespace server
+} // namespace osrm
+
+#endif
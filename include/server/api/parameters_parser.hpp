@@ -3,10 +3,12 @@
 
 #include "engine/api/base_parameters.hpp"
 #include "engine/api/tile_parameters.hpp"
+#include "util/coordinate.hpp"
 
 #include <boost/optional/optional.hpp>
 
 #include <type_traits>
+#include <vector>
 
 namespace osrm
 {
@@ -33,6 +35,15 @@ template <typename ParameterT,
 boost::optional<ParameterT> parseParameters(std::string::iterator &iter,
                                             const std::string::iterator end);
 
+// Parses the options of a request whose coordinates were given apart from the query, e.g. in the
+// request body. Without such coordinates they are parsed from the query as usual.
+template <typename ParameterT,
+          typename std::enable_if<std::is_base_of<engine::api::BaseParameters, ParameterT>::value,
+                                  int>::type = 0>
+boost::optional<ParameterT> parseParameters(std::string::iterator &iter,
+                                            const std::string::iterator end,
+                                            std::vector<util::Coordinate> coordinates);
+
 // Copy on purpose because we need mutability
 template <typename ParameterT,
           typename std::enable_if<detail::is_parameter_t<ParameterT>::value, int>::type = 0>
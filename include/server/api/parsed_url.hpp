@@ -20,6 +20,10 @@ struct ParsedURL final
     std::string profile;
     std::string query;
     std::size_t prefix_length;
+    // Coordinates sent in the request body, the query then holds the options only
+    std::vector<util::Coordinate> coordinates;
+    // Sub-requests of a batch sent in the request body, each one a URL path like /route/v1/...
+    std::vector<std::string> requests;
 };
 
 } // namespace api
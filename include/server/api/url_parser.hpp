@@ -22,6 +22,17 @@ inline boost::optional<ParsedURL> parseURL(std::string url_string)
     auto iter = url_string.begin();
     return parseURL(iter, url_string.end());
 }
+
+// Parses the URL of a request with its coordinates in the body, e.g. /table/v1/driving?sources=0
+// The query is empty or holds the format and options only
+boost::optional<ParsedURL> parseBodyURL(std::string::iterator &iter,
+                                        const std::string::iterator end);
+
+inline boost::optional<ParsedURL> parseBodyURL(std::string url_string)
+{
+    auto iter = url_string.begin();
+    return parseBodyURL(iter, url_string.end());
+}
 } // namespace api
 } // namespace server
 } // namespace osrm
@@ -0,0 +1,85 @@
+#ifndef SERVER_COMPUTE_POOL_HPP
+#define SERVER_COMPUTE_POOL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+struct ComputePoolConfig
+{
+    // Worker threads running the queries
+    unsigned num_threads = 1;
+    // Requests waiting for a worker before further requests are turned away, 0 is unlimited
+    std::size_t max_queued_requests = 0;
+    // Requests of a service that are processed at the same time, other services are unlimited
+    std::unordered_map<std::string, unsigned> max_service_concurrency;
+    // Runs on every worker before it takes jobs
+    std::function<void()> on_start;
+    // Runs on a worker once it waited idle_time for a job since its last one, 0 never runs it
+    std::chrono::milliseconds idle_time{0};
+    std::function<void()> on_idle;
+};
+
+// Runs requests on a bounded set of worker threads apart from the threads doing the network I/O.
+// Requests beyond the concurrency cap of their service wait in the pool until an earlier request
+// of the same service has finished, requests of other services pass them.
+class ComputePool
+{
+  public:
+    using Job = std::function<void()>;
+
+    explicit ComputePool(const ComputePoolConfig &config);
+    ComputePool(const ComputePool &) = delete;
+    ComputePool &operator=(const ComputePool &) = delete;
+
+    // Drops the jobs that have not started and waits for the running ones
+    ~ComputePool();
+
+    // Queues a job of a service, returns false if the queue is full.
+    // Jobs must not throw.
+    bool Submit(const std::string &service, Job job);
+
+  private:
+    struct ServiceJobs
+    {
+        unsigned max_concurrency;
+        unsigned running;
+        std::deque<Job> waiting;
+    };
+
+    void Work();
+
+    const std::size_t max_queued_requests;
+    const std::function<void()> on_start;
+    const std::chrono::milliseconds idle_time;
+    const std::function<void()> on_idle;
+
+    std::mutex lock;
+    std::condition_variable job_ready;
+    bool stopping;
+    // jobs a worker can pick up right away with the service they count against, if any
+    std::deque<std::pair<ServiceJobs *, Job>> ready_jobs;
+    // jobs that are ready or waiting for their service
+    std::size_t queued_jobs;
+    // only services with a concurrency cap are tracked
+    std::unordered_map<std::string, ServiceJobs> services;
+
+    std::vector<std::thread> workers;
+};
+} // namespace server
+} // namespace osrm
+
+#endif // SERVER_COMPUTE_POOL_HPP
@@ -2,6 +2,7 @@
 #define CONNECTION_HPP
 
 #include "server/http/compression_type.hpp"
+#include "server/http/compressor.hpp"
 #include "server/http/reply.hpp"
 #include "server/http/request.hpp"
 #include "server/request_parser.hpp"
@@ -12,6 +13,7 @@
 #include <boost/version.hpp>
 
 #include <memory>
+#include <string>
 #include <vector>
 
 // workaround for incomplete std::shared_ptr compatibility in old boost versions
@@ -31,13 +33,16 @@ namespace osrm
 namespace server
 {
 
+class ComputePool;
 class RequestHandler;
 
 /// Represents a single connection from a client.
 class Connection : public std::enable_shared_from_this<Connection>
 {
   public:
-    explicit Connection(boost::asio::io_service &io_service, RequestHandler &handler);
+    explicit Connection(boost::asio::io_service &io_service,
+                        RequestHandler &handler,
+                        ComputePool &compute_pool);
     Connection(const Connection &) = delete;
     Connection &operator=(const Connection &) = delete;
 
@@ -49,6 +54,18 @@ class Connection : public std::enable_shared_from_this<Connection>
   private:
     void handle_read(const boost::system::error_code &e, std::size_t bytes_transferred);
 
+    /// Watches the socket while the request is answered and cancels the request if the client
+    /// goes away.
+    void watch_client();
+    void handle_client_readable(const boost::system::error_code &e,
+                                const engine::QueryDeadline &cancellation);
+
+    /// Runs the parsed request and prepares its reply, called on a worker of the compute pool.
+    void handle_request(const http::compression_type compression_type);
+
+    /// Writes the prepared reply, called on the strand.
+    void write_reply();
+
     /// Handle completion of a write operation.
     void handle_write(const boost::system::error_code &e);
 
@@ -57,18 +74,45 @@ class Connection : public std::enable_shared_from_this<Connection>
 
     void handle_shutdown();
 
-    std::vector<char> compress_buffers(const std::vector<char> &uncompressed_data,
-                                       const http::compression_type compression_type);
+    void set_connection_headers();
+
+    /// Writes a piece of a streamed reply, the headers are sent ahead of the first one.
+    /// Throws if the client cannot be written to anymore.
+    void write_chunk(const char *data,
+                     const std::size_t size,
+                     const http::compression_type compression_type);
+
+    /// Ends a streamed reply, returns false if that failed
+    bool write_last_chunk();
+
+    /// Appends a piece of a streamed reply framed as a chunk
+    void append_chunk(std::string &chunk, const char *data, const std::size_t size);
+
+    /// Writes data on the strand and waits until it was sent, called on a worker of the compute
+    /// pool. Fails with timed_out if the client does not take it in time.
+    boost::system::error_code write_from_worker(std::shared_ptr<const std::string> data);
+
+    /// Counts the reply in the metrics, if there are any
+    void count_reply(const std::size_t body_size);
 
     boost::asio::io_service::strand strand;
     boost::asio::ip::tcp::socket TCP_socket;
     boost::asio::deadline_timer timer;
     RequestHandler &request_handler;
+    ComputePool &compute_pool;
     RequestParser request_parser;
     boost::array<char, 8192> incoming_data_buffer;
     http::request current_request;
+    std::string current_service;
     http::reply current_reply;
-    std::vector<char> compressed_output;
+    bool continue_sent = false;
+    bool watching_client = false;
+    // Reused by all replies of the connection
+    http::compressor compressor;
+    // Streamed replies
+    bool chunked_headers_written = false;
+    bool compress_chunks = false;
+    std::size_t chunked_bytes_written = 0;
     // Header compression_header;
     std::vector<boost::asio::const_buffer> output_buffer;
     // Keep alive support
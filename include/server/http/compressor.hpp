@@ -0,0 +1,58 @@
+#ifndef SERVER_HTTP_COMPRESSOR_HPP
+#define SERVER_HTTP_COMPRESSOR_HPP
+
+#include "server/http/compression_type.hpp"
+
+#include <zlib.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+namespace http
+{
+
+// Deflate stream that is reset instead of rebuilt between the replies of a connection, keeping
+// the zlib state and the output buffer allocated across keep-alive requests. The reply is
+// compressed once it has been rendered, the output of large replies is not kept afterwards.
+class compressor
+{
+  public:
+    compressor();
+    ~compressor();
+    compressor(const compressor &) = delete;
+    compressor &operator=(const compressor &) = delete;
+
+    // Starts a new gzip or deflate stream, the previous output is discarded
+    void begin(const compression_type type);
+
+    // Compresses the data and appends the output that is ready. With flush set all data written
+    // so far is available in the output, otherwise zlib may hold it back for better compression.
+    void write(const char *data, const std::size_t size, const bool flush);
+
+    // Ends the stream, the output holds the rest of the compressed data afterwards
+    void finish();
+
+    const std::vector<char> &output() const { return compressed; }
+    void clear_output() { compressed.clear(); }
+
+    // Clears the output once it has been sent and frees it if a large reply made it grow
+    void release_output();
+
+  private:
+    void deflate_input(const int flush_mode);
+
+    z_stream stream;
+    bool initialized;
+    compression_type type;
+    std::vector<char> compressed;
+    std::vector<char> output_block;
+};
+} // namespace http
+} // namespace server
+} // namespace osrm
+
+#endif // SERVER_HTTP_COMPRESSOR_HPP
@@ -0,0 +1,56 @@
+#ifndef SERVER_HTTP_CONTENT_CHAIN_HPP
+#define SERVER_HTTP_CONTENT_CHAIN_HPP
+
+#include <boost/asio/buffer.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+namespace http
+{
+
+// Reply content in a chain of fixed-size blocks that are handed to the socket as they are.
+// Appending never moves content that has been written already, unlike a growing vector.
+// The blocks are taken from a pool shared by all replies and go back to it afterwards.
+class content_chain
+{
+  public:
+    using value_type = char;
+
+    static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+    content_chain() = default;
+    ~content_chain();
+    content_chain(content_chain &&) = default;
+    content_chain &operator=(content_chain &&) = default;
+    content_chain(const content_chain &) = delete;
+    content_chain &operator=(const content_chain &) = delete;
+
+    void push_back(const char value)
+    {
+        if (blocks.empty() || blocks.back()->size() == BLOCK_SIZE)
+        {
+            add_block();
+        }
+        blocks.back()->push_back(value);
+    }
+
+    std::size_t size() const;
+
+    std::vector<boost::asio::const_buffer> buffers() const;
+
+  private:
+    void add_block();
+
+    std::vector<std::unique_ptr<std::vector<char>>> blocks;
+};
+} // namespace http
+} // namespace server
+} // namespace osrm
+
+#endif // SERVER_HTTP_CONTENT_CHAIN_HPP
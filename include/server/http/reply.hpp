@@ -5,6 +5,7 @@
 
 #include <boost/asio.hpp>
 
+#include <memory>
 #include <vector>
 
 namespace osrm
@@ -21,16 +22,26 @@ class reply
     {
         ok = 200,
         bad_request = 400,
-        internal_server_error = 500
+        internal_server_error = 500,
+        service_unavailable = 503,
+        gateway_timeout = 504
     } status;
 
     std::vector<header> headers;
     std::vector<boost::asio::const_buffer> to_buffers();
     std::vector<boost::asio::const_buffer> headers_to_buffers();
     std::vector<char> content;
+    // Content written straight from buffers owned by its producer instead of being copied into
+    // content, they stay valid as long as the reply keeps content_owner
+    std::vector<boost::asio::const_buffer> external_content;
+    std::shared_ptr<const void> content_owner;
+    // The content is written in chunks while it is produced instead of all at once
+    bool chunked;
     static reply stock_reply(const status_type status);
     void set_size(const std::size_t size);
     void set_uncompressed_size();
+    std::size_t content_size() const;
+    std::vector<boost::asio::const_buffer> content_buffers() const;
 
     reply();
 
@@ -1,8 +1,11 @@
 #ifndef REQUEST_HPP
 #define REQUEST_HPP
 
+#include "engine/query_deadline.hpp"
+
 #include <boost/asio.hpp>
 
+#include <chrono>
 #include <string>
 
 namespace osrm
@@ -14,11 +17,19 @@ namespace http
 
 struct request
 {
+    std::string method;
     std::string uri;
     std::string referrer;
     std::string agent;
     std::string connection;
+    std::string content_type;
+    // Content-Length bounded body, empty if the request has none
+    std::string body;
     boost::asio::ip::address endpoint;
+    // Time the request was read completely, before it waited for a worker
+    std::chrono::steady_clock::time_point received;
+    // Cancelled when the client goes away while the request is answered
+    engine::QueryDeadline cancellation;
 };
 } // namespace http
 } // namespace server
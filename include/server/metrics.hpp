@@ -0,0 +1,105 @@
+#ifndef SERVER_METRICS_HPP
+#define SERVER_METRICS_HPP
+
+#include "engine/query_statistics.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace osrm
+{
+namespace server
+{
+
+// Parts of handling a request, the engine phases are the query phases of the engine
+enum class RequestPhase : std::uint8_t
+{
+    Queue,     // waiting for a thread of the compute pool
+    Parse,     // parsing the URL and body
+    Snapping,  // engine::QueryPhase::Snapping
+    Search,    // engine::QueryPhase::Search
+    Unpacking, // engine::QueryPhase::Unpacking
+    Guidance,  // engine::QueryPhase::Guidance
+    Assembly,  // engine::QueryPhase::Assembly
+    Render,    // rendering the result
+    Compress,  // compressing the reply
+};
+
+const constexpr std::size_t NUMBER_OF_REQUEST_PHASES = 9;
+
+RequestPhase toRequestPhase(const engine::QueryPhase phase);
+
+// Histogram of durations with fixed buckets that is updated without locks
+class LatencyHistogram
+{
+  public:
+    // Upper bounds of the buckets in seconds, larger values are only counted for +Inf
+    static const std::array<double, 15> BUCKET_BOUNDS;
+
+    LatencyHistogram();
+
+    void Observe(const std::chrono::nanoseconds duration);
+
+    // Writes the series of the histogram in the Prometheus text format
+    void Render(std::ostream &out, const std::string &name, const std::string &labels) const;
+
+  private:
+    std::array<std::atomic<std::uint64_t>, 16> buckets;
+    std::atomic<std::uint64_t> sum_in_nanoseconds;
+    std::atomic<std::uint64_t> count;
+};
+
+// Counters of osrm-routed that are rendered for the /metrics endpoint. All of them are updated
+// without taking locks, the services are known when the registry is created.
+class Metrics
+{
+  public:
+    Metrics();
+    Metrics(const Metrics &) = delete;
+    Metrics &operator=(const Metrics &) = delete;
+
+    // Requests of unknown services are counted as service "other"
+    void CountRequest(const std::string &service,
+                      const unsigned status_code,
+                      const std::chrono::nanoseconds duration);
+    void ObservePhase(const std::string &service,
+                      const RequestPhase phase,
+                      const std::chrono::nanoseconds duration);
+    void ObserveQuery(const std::string &service, const engine::QueryStatistics &statistics);
+    void CountResponseBytes(const std::string &service, const std::size_t bytes);
+
+    // Writes all metrics in the Prometheus text exposition format
+    void Render(std::ostream &out) const;
+    std::string Render() const;
+
+  private:
+    struct ServiceMetrics
+    {
+        // Replies with the status codes 200, 400, 500, 503 and 504
+        std::array<std::atomic<std::uint64_t>, 5> requests = {};
+        LatencyHistogram duration;
+        std::array<LatencyHistogram, NUMBER_OF_REQUEST_PHASES> phase_durations;
+        std::atomic<std::uint64_t> settled_nodes{0};
+        std::atomic<std::uint64_t> response_bytes{0};
+    };
+
+    ServiceMetrics &GetService(const std::string &service);
+
+    // Size of the search heaps of the threads that ran queries, by the order they started
+    static const constexpr std::size_t MAX_THREADS = 256;
+    std::array<std::atomic<std::size_t>, MAX_THREADS> heap_size_in_bytes = {};
+
+    std::map<std::string, std::unique_ptr<ServiceMetrics>> services;
+    ServiceMetrics &other_service;
+};
+} // namespace server
+} // namespace osrm
+
+#endif // SERVER_METRICS_HPP
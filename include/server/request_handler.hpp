@@ -1,8 +1,12 @@
 #ifndef REQUEST_HANDLER_HPP
 #define REQUEST_HANDLER_HPP
 
+#include "server/admission_control.hpp"
+#include "server/metrics.hpp"
+#include "server/result_cache.hpp"
 #include "server/service_handler.hpp"
 
+#include <memory>
 #include <string>
 
 namespace osrm
@@ -26,10 +30,27 @@ class RequestHandler
 
     void RegisterServiceHandler(std::unique_ptr<ServiceHandlerInterface> service_handler);
 
-    void HandleRequest(const http::request &current_request, http::reply &current_reply);
+    // Without admission control all requests are processed
+    void RegisterAdmissionControl(std::unique_ptr<AdmissionControl> admission_control);
+
+    // Without metrics no statistics are collected and there is no /metrics endpoint
+    void RegisterMetrics(std::unique_ptr<Metrics> metrics);
+    Metrics *GetMetrics() const { return metrics.get(); }
+
+    // Without a result cache all requests are run by the engine
+    void RegisterResultCache(std::unique_ptr<ResultCache> result_cache);
+
+    // Streamed replies are written with write_chunk while the request is handled,
+    // current_reply.chunked is set if that happened
+    void HandleRequest(const http::request &current_request,
+                       http::reply &current_reply,
+                       const engine::api::ResultChunkWriter &write_chunk);
 
   private:
     std::unique_ptr<ServiceHandlerInterface> service_handler;
+    std::unique_ptr<AdmissionControl> admission_control;
+    std::unique_ptr<Metrics> metrics;
+    std::unique_ptr<ResultCache> result_cache;
 };
 } // namespace server
 } // namespace osrm
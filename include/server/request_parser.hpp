@@ -4,6 +4,7 @@
 #include "server/http/compression_type.hpp"
 #include "server/http/header.hpp"
 
+#include <cstddef>
 #include <tuple>
 
 namespace osrm
@@ -31,6 +32,9 @@ class RequestParser
     std::tuple<RequestStatus, http::compression_type>
     parse(http::request &current_request, char *begin, char *end);
 
+    // True once the headers of a request with a body and "Expect: 100-continue" have been read
+    bool expects_continue() const;
+
   private:
     RequestStatus consume(http::request &current_request, const char input);
 
@@ -63,11 +67,14 @@ class RequestParser
         header_name,
         header_value,
         expecting_newline_2,
-        expecting_newline_3
+        expecting_newline_3,
+        body
     } state;
 
     http::header current_header;
     http::compression_type selected_compression;
+    std::size_t content_length;
+    bool expect_continue;
 };
 } // namespace server
 } // namespace osrm
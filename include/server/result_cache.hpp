@@ -0,0 +1,86 @@
+#ifndef SERVER_RESULT_CACHE_HPP
+#define SERVER_RESULT_CACHE_HPP
+
+#include "server/api/parsed_url.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+struct ResultCacheConfig
+{
+    // Memory for the cached replies, 0 disables the cache
+    std::size_t max_size_in_bytes = 0;
+    // Services whose successful replies are cached
+    std::vector<std::string> services = {"route", "nearest"};
+};
+
+// Least recently used replies of identical requests. The cache is split into shards with a lock
+// each and forgets all replies as soon as the engine switches to an updated dataset.
+class ResultCache
+{
+  public:
+    // A reply as it was sent, shared by the cache and the replies writing it
+    struct Entry
+    {
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::vector<char> content;
+    };
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    explicit ResultCache(ResultCacheConfig config);
+    ResultCache(const ResultCache &) = delete;
+    ResultCache &operator=(const ResultCache &) = delete;
+
+    // Key of the request, the options are sorted by their names. Empty if the request is not
+    // cached, e.g. because it asks for debug_timing.
+    std::string MakeKey(const api::ParsedURL &parsed_url) const;
+
+    // Version of the data the replies are computed from, it has to be taken before the query
+    static std::uint64_t GetGeneration();
+
+    EntryPtr Get(const std::string &key);
+
+    // Replies computed from older data than the current one are dropped
+    void Put(const std::string &key, const std::uint64_t generation, EntryPtr entry);
+
+    std::size_t GetSizeInBytes() const;
+
+  private:
+    using LRUList = std::list<std::pair<std::string, EntryPtr>>;
+
+    struct Shard
+    {
+        mutable std::mutex lock;
+        LRUList entries;
+        std::unordered_map<std::string, LRUList::iterator> index;
+        std::size_t size_in_bytes = 0;
+        std::uint64_t generation = 0;
+    };
+
+    static const constexpr std::size_t NUMBER_OF_SHARDS = 16;
+
+    Shard &GetShard(const std::string &key);
+    // Forgets the entries of a shard that was filled from older data, needs its lock
+    static void Invalidate(Shard &shard, const std::uint64_t generation);
+
+    const ResultCacheConfig config;
+    const std::size_t max_shard_size_in_bytes;
+    std::array<Shard, NUMBER_OF_SHARDS> shards;
+};
+} // namespace server
+} // namespace osrm
+
+#endif // SERVER_RESULT_CACHE_HPP
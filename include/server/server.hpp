@@ -1,6 +1,7 @@
 #ifndef SERVER_HPP
 #define SERVER_HPP
 
+#include "server/compute_pool.hpp"
 #include "server/connection.hpp"
 #include "server/request_handler.hpp"
 #include "server/service_handler.hpp"
@@ -18,6 +19,12 @@
 #include <sys/types.h>
 #endif
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <string>
@@ -33,49 +40,91 @@ class Server
 {
   public:
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server>
-    CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_io_threads,
+                                                unsigned requested_num_io_shards,
+                                                bool pin_io_shards,
+                                                ComputePoolConfig compute_pool_config)
     {
         util::Log() << "http 1.1 compression handled by zlib version " << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
-        const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+        const unsigned real_num_io_threads = std::min(hardware_threads, requested_num_io_threads);
+#ifndef SO_REUSEPORT
+        if (requested_num_io_shards > 0)
+        {
+            util::Log(logWARNING) << "SO_REUSEPORT is not supported, not sharding connections";
+            requested_num_io_shards = 0;
+        }
+#endif
+        const unsigned real_num_io_shards = std::min(hardware_threads, requested_num_io_shards);
+        compute_pool_config.num_threads =
+            std::max(1u, std::min(hardware_threads, compute_pool_config.num_threads));
+        return std::make_shared<Server>(ip_address,
+                                        ip_port,
+                                        real_num_io_threads,
+                                        real_num_io_shards,
+                                        pin_io_shards,
+                                        compute_pool_config);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
-          new_connection(std::make_shared<Connection>(io_service, request_handler))
+    // Without shards all I/O threads share one io_service and acceptor. With shards every I/O
+    // thread runs an io_service with an acceptor of its own and the kernel spreads the incoming
+    // connections over them.
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned thread_pool_size,
+                    const unsigned num_shards,
+                    const bool pin_shards,
+                    const ComputePoolConfig &compute_pool_config)
+        : thread_pool_size(num_shards > 0 ? 1 : thread_pool_size), pin_shards(pin_shards),
+          compute_pool(compute_pool_config)
     {
         const auto port_string = std::to_string(port);
 
-        boost::asio::ip::tcp::resolver resolver(io_service);
-        boost::asio::ip::tcp::resolver::query query(address, port_string);
-        boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve(query);
+        for (unsigned shard_index = 0; shard_index < std::max(1u, num_shards); ++shard_index)
+        {
+            shards.push_back(std::make_unique<Shard>());
+            auto &shard = *shards.back();
+
+            boost::asio::ip::tcp::resolver resolver(shard.io_service);
+            boost::asio::ip::tcp::resolver::query query(address, port_string);
+            boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve(query);
 
-        acceptor.open(endpoint.protocol());
+            shard.acceptor.open(endpoint.protocol());
 #ifdef SO_REUSEPORT
-        const int option = 1;
-        setsockopt(acceptor.native_handle(), SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option));
+            const int option = 1;
+            setsockopt(
+                shard.acceptor.native_handle(), SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option));
 #endif
-        acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-        acceptor.bind(endpoint);
-        acceptor.listen();
+            shard.acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            shard.acceptor.bind(endpoint);
+            shard.acceptor.listen();
 
-        util::Log() << "Listening on: " << acceptor.local_endpoint();
+            Accept(shard);
+        }
 
-        acceptor.async_accept(
-            new_connection->socket(),
-            boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
+        util::Log() << "Listening on: " << shards.front()->acceptor.local_endpoint();
     }
 
     void Run()
     {
         std::vector<std::shared_ptr<std::thread>> threads;
-        for (unsigned i = 0; i < thread_pool_size; ++i)
+        for (const auto shard_index : util::irange<std::size_t>(0, shards.size()))
         {
-            std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-                boost::bind(&boost::asio::io_service::run, &io_service));
-            threads.push_back(thread);
+            auto &shard = *shards[shard_index];
+            for (unsigned i = 0; i < thread_pool_size; ++i)
+            {
+                std::shared_ptr<std::thread> thread =
+                    std::make_shared<std::thread>([this, &shard, shard_index] {
+                        if (pin_shards)
+                        {
+                            PinToCPU(shard_index);
+                        }
+                        shard.io_service.run();
+                    });
+                threads.push_back(thread);
+            }
         }
         for (auto thread : threads)
         {
@@ -83,31 +132,88 @@ class Server
         }
     }
 
-    void Stop() { io_service.stop(); }
+    void Stop()
+    {
+        for (auto &shard : shards)
+        {
+            shard->io_service.stop();
+        }
+    }
 
     void RegisterServiceHandler(std::unique_ptr<ServiceHandlerInterface> service_handler_)
     {
         request_handler.RegisterServiceHandler(std::move(service_handler_));
     }
 
+    void RegisterAdmissionControl(std::unique_ptr<AdmissionControl> admission_control_)
+    {
+        request_handler.RegisterAdmissionControl(std::move(admission_control_));
+    }
+
+    void RegisterMetrics(std::unique_ptr<Metrics> metrics_)
+    {
+        request_handler.RegisterMetrics(std::move(metrics_));
+    }
+
+    void RegisterResultCache(std::unique_ptr<ResultCache> result_cache_)
+    {
+        request_handler.RegisterResultCache(std::move(result_cache_));
+    }
+
   private:
-    void HandleAccept(const boost::system::error_code &e)
+    struct Shard
+    {
+        Shard() : acceptor(io_service) {}
+
+        boost::asio::io_service io_service;
+        boost::asio::ip::tcp::acceptor acceptor;
+        std::shared_ptr<Connection> new_connection;
+    };
+
+    void Accept(Shard &shard)
+    {
+        // connections stay on the io_service of the shard that accepted them
+        shard.new_connection =
+            std::make_shared<Connection>(shard.io_service, request_handler, compute_pool);
+        shard.acceptor.async_accept(shard.new_connection->socket(),
+                                    [this, &shard](const boost::system::error_code &e) {
+                                        HandleAccept(shard, e);
+                                    });
+    }
+
+    void HandleAccept(Shard &shard, const boost::system::error_code &e)
     {
         if (!e)
         {
-            new_connection->start();
-            new_connection = std::make_shared<Connection>(io_service, request_handler);
-            acceptor.async_accept(
-                new_connection->socket(),
-                boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
+            shard.new_connection->start();
+            Accept(shard);
+        }
+    }
+
+    static void PinToCPU(const std::size_t shard_index)
+    {
+#ifdef __linux__
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(shard_index % std::max(1u, std::thread::hardware_concurrency()), &cpu_set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0)
+        {
+            util::Log(logWARNING) << "Could not pin I/O shard " << shard_index << " to a CPU";
         }
+#else
+        util::Log(logWARNING) << "Pinning I/O shards to CPUs is not supported";
+#endif
     }
 
+    // I/O threads per shard accepting connections, parsing requests and writing replies
     unsigned thread_pool_size;
-    boost::asio::io_service io_service;
-    boost::asio::ip::tcp::acceptor acceptor;
-    std::shared_ptr<Connection> new_connection;
+    bool pin_shards;
     RequestHandler request_handler;
+    // Declared before the compute pool, so the io_services outlive the queued and running requests
+    // whose connections post to them
+    std::vector<std::unique_ptr<Shard>> shards;
+    // Worker threads running the queries, waits for running requests when it is destroyed
+    ComputePool compute_pool;
 };
 } // namespace server
 } // namespace osrm
@@ -4,6 +4,7 @@
 #include "engine/status.hpp"
 #include "osrm/osrm.hpp"
 #include "util/coordinate.hpp"
+#include "util/json_container.hpp"
 
 #include <mapbox/variant.hpp>
 
@@ -23,8 +24,36 @@ class BaseService
     BaseService(OSRM &routing_machine) : routing_machine(routing_machine) {}
     virtual ~BaseService() = default;
 
-    virtual engine::Status
-    RunQuery(std::size_t prefix_length, std::string &query, osrm::engine::api::ResultT &result) = 0;
+    // The coordinates are those of the request body, empty if they are part of the query
+    virtual engine::Status RunQuery(std::size_t prefix_length,
+                                    std::string &query,
+                                    const std::vector<util::Coordinate> &coordinates,
+                                    osrm::engine::api::ResultT &result) = 0;
+
+    // Services that can stream their response hand write_chunk on to the engine,
+    // all others answer in one piece
+    virtual engine::Status RunStreamingQuery(std::size_t prefix_length,
+                                             std::string &query,
+                                             const std::vector<util::Coordinate> &coordinates,
+                                             osrm::engine::api::ResultT &result,
+                                             const osrm::engine::api::ResultChunkWriter &)
+    {
+        return RunQuery(prefix_length, query, coordinates, result);
+    }
+
+    // Batch requests hand over the sub-requests of their body, all other services take none
+    virtual engine::Status RunBatchQuery(std::size_t /*prefix_length*/,
+                                         std::string & /*query*/,
+                                         const std::vector<std::string> & /*requests*/,
+                                         osrm::engine::api::ResultT &result,
+                                         const osrm::engine::api::ResultChunkWriter &)
+    {
+        result = util::json::Object();
+        auto &json_result = result.get<util::json::Object>();
+        json_result.values["code"] = "InvalidQuery";
+        json_result.values["message"] = "Only batch requests hold sub-requests";
+        return engine::Status::Error;
+    }
 
     virtual unsigned GetVersion() = 0;
 
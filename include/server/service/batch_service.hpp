@@ -0,0 +1,44 @@
+#ifndef SERVER_SERVICE_BATCH_SERVICE_HPP
+#define SERVER_SERVICE_BATCH_SERVICE_HPP
+
+#include "server/service/base_service.hpp"
+
+#include "engine/status.hpp"
+#include "osrm/osrm.hpp"
+#include "util/coordinate.hpp"
+
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+namespace service
+{
+
+// Route and nearest sub-requests sent together in a JSON request body, answered in their order
+class BatchService final : public BaseService
+{
+  public:
+    BatchService(OSRM &routing_machine) : BaseService(routing_machine) {}
+
+    engine::Status RunQuery(std::size_t prefix_length,
+                            std::string &query,
+                            const std::vector<util::Coordinate> &coordinates,
+                            osrm::engine::api::ResultT &result) final override;
+
+    engine::Status
+    RunBatchQuery(std::size_t prefix_length,
+                  std::string &query,
+                  const std::vector<std::string> &requests,
+                  osrm::engine::api::ResultT &result,
+                  const osrm::engine::api::ResultChunkWriter &write_chunk) final override;
+
+    unsigned GetVersion() final override { return 1; }
+};
+} // namespace service
+} // namespace server
+} // namespace osrm
+
+#endif
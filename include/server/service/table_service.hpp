@@ -24,8 +24,16 @@ class TableService final : public BaseService
 
     engine::Status RunQuery(std::size_t prefix_length,
                             std::string &query,
+                            const std::vector<util::Coordinate> &coordinates,
                             osrm::engine::api::ResultT &result) final override;
 
+    engine::Status RunStreamingQuery(std::size_t prefix_length,
+                                     std::string &query,
+                                     const std::vector<util::Coordinate> &coordinates,
+                                     osrm::engine::api::ResultT &result,
+                                     const osrm::engine::api::ResultChunkWriter &write_chunk)
+        final override;
+
     unsigned GetVersion() final override { return 1; }
 };
 } // namespace service
@@ -24,6 +24,7 @@ class TileService final : public BaseService
 
     engine::Status RunQuery(std::size_t prefix_length,
                             std::string &query,
+                            const std::vector<util::Coordinate> &coordinates,
                             osrm::engine::api::ResultT &result) final override;
 
     unsigned GetVersion() final override { return 1; }
@@ -29,7 +29,8 @@ class ServiceHandlerInterface
   public:
     virtual ~ServiceHandlerInterface() {}
     virtual engine::Status RunQuery(api::ParsedURL parsed_url,
-                                    osrm::engine::api::ResultT &result) = 0;
+                                    osrm::engine::api::ResultT &result,
+                                    const osrm::engine::api::ResultChunkWriter &write_chunk) = 0;
 };
 
 class ServiceHandler final : public ServiceHandlerInterface
@@ -38,7 +39,13 @@ class ServiceHandler final : public ServiceHandlerInterface
     ServiceHandler(osrm::EngineConfig &config);
     using ResultT = osrm::engine::api::ResultT;
 
-    virtual engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result) override;
+    virtual engine::Status
+    RunQuery(api::ParsedURL parsed_url,
+             ResultT &result,
+             const osrm::engine::api::ResultChunkWriter &write_chunk) override;
+
+    // Creates the search heaps of the calling thread
+    void WarmUp() const;
 
   private:
     std::unordered_map<std::string, std::unique_ptr<service::BaseService>> service_map;
@@ -69,6 +69,11 @@ class SharedDataIndex
         return reinterpret_cast<T *>(region.layout->GetBlockPtr(region.memory_ptr, name));
     }
 
+    bool HasBlock(const std::string &name) const
+    {
+        return block_to_region.find(name) != block_to_region.end();
+    }
+
     std::size_t GetBlockEntries(const std::string &name) const
     {
         const auto &region = GetBlockRegion(name);
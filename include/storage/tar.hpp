@@ -95,6 +95,12 @@ class FileReader
 
     ~FileReader() { mtar_close(&handle); }
 
+    bool HasEntry(const std::string &name)
+    {
+        mtar_header_t header;
+        return mtar_find(&handle, name.c_str(), &header) == MTAR_ESUCCESS;
+    }
+
     std::uint64_t ReadElementCount64(const std::string &name)
     {
         std::uint64_t size;
@@ -28,6 +28,7 @@
 #include "partitioner/multi_level_partition.hpp"
 
 #include "util/coordinate.hpp"
+#include "util/integer_range.hpp"
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/static_graph.hpp"
@@ -243,6 +244,20 @@ inline auto make_entry_classes_view(const SharedDataIndex &index, const std::str
     return make_vector_view<util::guidance::EntryClass>(index, name);
 }
 
+// An empty table for datasets without children, the engine looks up the halves of shortcuts then
+inline auto make_shortcut_children_view(const SharedDataIndex &index, const std::string &name)
+{
+    if (!index.HasBlock(name + "/children"))
+    {
+        return contractor::ShortcutChildrenTableView{};
+    }
+
+    return contractor::ShortcutChildrenTableView{
+        make_vector_view<std::uint64_t>(index, name + "/has_children"),
+        make_vector_view<std::uint32_t>(index, name + "/ranks"),
+        make_vector_view<contractor::ShortcutChildren>(index, name + "/children")};
+}
+
 inline auto make_contracted_metric_view(const SharedDataIndex &index, const std::string &name)
 {
     auto node_list = make_vector_view<contractor::QueryGraphView::NodeArrayEntry>(
@@ -256,8 +271,16 @@ inline auto make_contracted_metric_view(const SharedDataIndex &index, const std:
                    edge_filter.push_back(make_vector_view<bool>(index, filter_name));
                }));
 
+    std::vector<contractor::ShortcutChildrenTableView> shortcut_children;
+    for (const auto exclude_index : util::irange<std::size_t>(0, edge_filter.size()))
+    {
+        shortcut_children.push_back(make_shortcut_children_view(
+            index, name + "/shortcut_children/" + std::to_string(exclude_index)));
+    }
+
     return contractor::ContractedMetricView{{std::move(node_list), std::move(edge_list)},
-                                            std::move(edge_filter)};
+                                            std::move(edge_filter),
+                                            std::move(shortcut_children)};
 }
 
 inline auto make_partition_view(const SharedDataIndex &index, const std::string &name)
@@ -10,6 +10,7 @@
 
 #include "osrm/json_container.hpp"
 
+#include <algorithm>
 #include <iterator>
 #include <ostream>
 #include <string>
@@ -106,22 +107,36 @@ struct Renderer
     std::ostream &out;
 };
 
-struct ArrayRenderer
+namespace detail
 {
-    explicit ArrayRenderer(std::vector<char> &_out) : out(_out) {}
+template <typename Out, typename Iterator> void append(Out &out, Iterator first, Iterator last)
+{
+    std::copy(first, last, std::back_inserter(out));
+}
+
+template <typename Iterator> void append(std::vector<char> &out, Iterator first, Iterator last)
+{
+    out.insert(out.end(), first, last);
+}
+} // namespace detail
+
+// Renders into any sequence of chars that can be appended to with push_back
+template <typename Out> struct BasicArrayRenderer
+{
+    explicit BasicArrayRenderer(Out &_out) : out(_out) {}
 
     void operator()(const String &string) const
     {
         out.push_back('\"');
         const auto string_to_insert = escape_JSON(string.value);
-        out.insert(std::end(out), std::begin(string_to_insert), std::end(string_to_insert));
+        detail::append(out, std::begin(string_to_insert), std::end(string_to_insert));
         out.push_back('\"');
     }
 
     void operator()(const Number &number) const
     {
         const std::string number_string = cast::to_string_with_precision(number.value);
-        out.insert(out.end(), number_string.begin(), number_string.end());
+        detail::append(out, number_string.begin(), number_string.end());
     }
 
     void operator()(const Object &object) const
@@ -130,11 +145,11 @@ struct ArrayRenderer
         for (auto it = object.values.begin(), end = object.values.end(); it != end;)
         {
             out.push_back('\"');
-            out.insert(out.end(), it->first.begin(), it->first.end());
+            detail::append(out, it->first.begin(), it->first.end());
             out.push_back('\"');
             out.push_back(':');
 
-            mapbox::util::apply_visitor(ArrayRenderer(out), it->second);
+            mapbox::util::apply_visitor(BasicArrayRenderer(out), it->second);
             if (++it != end)
             {
                 out.push_back(',');
@@ -148,7 +163,7 @@ struct ArrayRenderer
         out.push_back('[');
         for (auto it = array.values.cbegin(), end = array.values.cend(); it != end;)
         {
-            mapbox::util::apply_visitor(ArrayRenderer(out), *it);
+            mapbox::util::apply_visitor(BasicArrayRenderer(out), *it);
             if (++it != end)
             {
                 out.push_back(',');
@@ -160,35 +175,38 @@ struct ArrayRenderer
     void operator()(const True &) const
     {
         const std::string temp("true");
-        out.insert(out.end(), temp.begin(), temp.end());
+        detail::append(out, temp.begin(), temp.end());
     }
 
     void operator()(const False &) const
     {
         const std::string temp("false");
-        out.insert(out.end(), temp.begin(), temp.end());
+        detail::append(out, temp.begin(), temp.end());
     }
 
     void operator()(const Null &) const
     {
         const std::string temp("null");
-        out.insert(out.end(), temp.begin(), temp.end());
+        detail::append(out, temp.begin(), temp.end());
     }
 
   private:
-    std::vector<char> &out;
+    Out &out;
 };
 
+using ArrayRenderer = BasicArrayRenderer<std::vector<char>>;
+
+// The object is rendered in place, wrapping it into a Value would copy the whole document
 inline void render(std::ostream &out, const Object &object)
 {
-    Value value = object;
-    mapbox::util::apply_visitor(Renderer(out), value);
+    const Renderer renderer(out);
+    renderer(object);
 }
 
 inline void render(std::vector<char> &out, const Object &object)
 {
-    Value value = object;
-    mapbox::util::apply_visitor(ArrayRenderer(out), value);
+    const ArrayRenderer renderer(out);
+    renderer(object);
 }
 
 } // namespace json
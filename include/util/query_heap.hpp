@@ -6,9 +6,13 @@
 #include <boost/optional.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <limits>
 #include <map>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -22,13 +26,13 @@ template <typename NodeID, typename Key> class GenerationArrayStorage
 
   public:
     explicit GenerationArrayStorage(std::size_t size)
-        : positions(size, 0), generation(1), generations(size, 0)
+        : generation(1), generations(size, 0), positions(size, 0)
     {
     }
 
     Key &operator[](NodeID node)
     {
-        generation[node] = generation;
+        generations[node] = generation;
         return positions[node];
     }
 
@@ -52,6 +56,15 @@ template <typename NodeID, typename Key> class GenerationArrayStorage
         }
     }
 
+    // The arrays are sized by the graph, not by the searches
+    void Shrink() { Clear(); }
+
+    std::size_t GetSizeInBytes() const
+    {
+        return generations.capacity() * sizeof(GenerationCounter) +
+               positions.capacity() * sizeof(Key);
+    }
+
   private:
     GenerationCounter generation;
     std::vector<GenerationCounter> generations;
@@ -71,6 +84,10 @@ template <typename NodeID, typename Key> class ArrayStorage
 
     void Clear() {}
 
+    void Shrink() {}
+
+    std::size_t GetSizeInBytes() const { return positions.capacity() * sizeof(Key); }
+
   private:
     std::vector<Key> positions;
 };
@@ -84,6 +101,14 @@ template <typename NodeID, typename Key> class MapStorage
 
     void Clear() { nodes.clear(); }
 
+    void Shrink() { Clear(); }
+
+    // Estimate, every tree node holds three pointers and a color next to the entry
+    std::size_t GetSizeInBytes() const
+    {
+        return nodes.size() * (sizeof(typename decltype(nodes)::value_type) + 4 * sizeof(void *));
+    }
+
     Key peek_index(const NodeID node) const
     {
         const auto iter = nodes.find(node);
@@ -123,10 +148,133 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
 
     void Clear() { nodes.clear(); }
 
+    // Clearing keeps the buckets
+    void Shrink()
+    {
+        decltype(nodes)().swap(nodes);
+        nodes.rehash(1000);
+    }
+
+    // Estimate, every entry is a list node with a pointer to the next one
+    std::size_t GetSizeInBytes() const
+    {
+        return nodes.bucket_count() * sizeof(void *) +
+               nodes.size() * (sizeof(typename decltype(nodes)::value_type) + sizeof(void *));
+    }
+
   private:
     std::unordered_map<NodeID, Key> nodes;
 };
 
+// Open addressing hash table with linear probing. Cells are stamped with the generation of the
+// search that wrote them, so clearing the table between searches is O(1) and never frees memory.
+template <typename NodeID, typename Key> class FlatHashStorage
+{
+    using GenerationCounter = std::uint32_t;
+
+    struct Cell
+    {
+        GenerationCounter generation;
+        NodeID node;
+        Key key;
+    };
+
+    static constexpr std::size_t INITIAL_CAPACITY = 1024;
+
+  public:
+    explicit FlatHashStorage(std::size_t)
+        : generation(1), number_of_entries(0), cells(INITIAL_CAPACITY, Cell{0, 0, 0})
+    {
+    }
+
+    Key &operator[](const NodeID node)
+    {
+        auto position = Find(node);
+        if (cells[position].generation != generation)
+        {
+            // keep the load factor below 1/2 to keep probe sequences short
+            if (2 * (number_of_entries + 1) > cells.size())
+            {
+                Grow();
+                position = Find(node);
+            }
+            cells[position] = Cell{generation, node, 0};
+            ++number_of_entries;
+        }
+        return cells[position].key;
+    }
+
+    Key peek_index(const NodeID node) const
+    {
+        const auto &cell = cells[Find(node)];
+        if (cell.generation != generation)
+        {
+            return std::numeric_limits<Key>::max();
+        }
+        return cell.key;
+    }
+
+    Key const &operator[](const NodeID node) const
+    {
+        const auto &cell = cells[Find(node)];
+        BOOST_ASSERT(cell.generation == generation);
+        return cell.key;
+    }
+
+    void Clear()
+    {
+        number_of_entries = 0;
+        generation++;
+        // if generation overflows we end up at 0 again and need to clear the cells
+        if (generation == 0)
+        {
+            generation = 1;
+            std::fill(cells.begin(), cells.end(), Cell{0, 0, 0});
+        }
+    }
+
+    void Shrink()
+    {
+        number_of_entries = 0;
+        generation = 1;
+        std::vector<Cell>(INITIAL_CAPACITY, Cell{0, 0, 0}).swap(cells);
+    }
+
+    std::size_t GetSizeInBytes() const { return cells.capacity() * sizeof(Cell); }
+
+  private:
+    std::size_t Find(const NodeID node) const
+    {
+        const auto mask = cells.size() - 1;
+        // Fibonacci hashing spreads the consecutive node ids of a search area over the table
+        auto position = static_cast<std::size_t>(
+                            (static_cast<std::uint64_t>(node) * 0x9E3779B97F4A7C15ull) >> 32) &
+                        mask;
+        while (cells[position].generation == generation && cells[position].node != node)
+        {
+            position = (position + 1) & mask;
+        }
+        return position;
+    }
+
+    void Grow()
+    {
+        std::vector<Cell> old_cells(2 * cells.size(), Cell{0, 0, 0});
+        old_cells.swap(cells);
+        for (const auto &cell : old_cells)
+        {
+            if (cell.generation == generation)
+            {
+                cells[Find(cell.node)] = cell;
+            }
+        }
+    }
+
+    GenerationCounter generation;
+    std::size_t number_of_entries;
+    std::vector<Cell> cells;
+};
+
 template <typename NodeID,
           typename Key,
           template <typename N, typename K> class BaseIndexStorage = UnorderedMapStorage,
@@ -182,26 +330,320 @@ class TwoLevelStorage
         overlay.Clear();
     }
 
+    void Shrink()
+    {
+        base.Shrink();
+        overlay.Shrink();
+    }
+
+    std::size_t GetSizeInBytes() const { return base.GetSizeInBytes() + overlay.GetSizeInBytes(); }
+
   private:
     const std::size_t number_of_overlay_nodes;
     BaseIndexStorage<NodeID, Key> base;
     OverlayIndexStorage<NodeID, Key> overlay;
 };
 
+// Work of the searches that used a heap, the counters are never reset
+struct QueryHeapCounters
+{
+    std::uint64_t settled_nodes = 0;
+    std::uint64_t relaxed_edges = 0;
+    // Relaxed edges that are shortcuts of a multi-level overlay
+    std::uint64_t overlay_edges = 0;
+
+    QueryHeapCounters &operator+=(const QueryHeapCounters &other)
+    {
+        settled_nodes += other.settled_nodes;
+        relaxed_edges += other.relaxed_edges;
+        overlay_edges += other.overlay_edges;
+        return *this;
+    }
+
+    QueryHeapCounters operator-(const QueryHeapCounters &other) const
+    {
+        QueryHeapCounters difference;
+        difference.settled_nodes = settled_nodes - other.settled_nodes;
+        difference.relaxed_edges = relaxed_edges - other.relaxed_edges;
+        difference.overlay_edges = overlay_edges - other.overlay_edges;
+        return difference;
+    }
+};
+
+// Priority queues of the query heap. They hold the indices of the inserted nodes by their weights
+// and return a handle to decrease the weight of an index later.
+
+// 4-ary heap with mutable handles, decreasing a weight takes logarithmic time
+template <typename Weight, typename Key> class DAryHeapQueue
+{
+    using HeapData = std::pair<Weight, Key>;
+    using HeapContainer = boost::heap::d_ary_heap<HeapData,
+                                                  boost::heap::arity<4>,
+                                                  boost::heap::mutable_<true>,
+                                                  boost::heap::compare<std::greater<HeapData>>>;
+
+  public:
+    using Handle = typename HeapContainer::handle_type;
+
+    Handle Push(const Weight weight, const Key key)
+    {
+        return heap.push(std::make_pair(weight, key));
+    }
+
+    void Decrease(const Handle handle, const Weight weight)
+    {
+        heap.increase(handle, std::make_pair(weight, (*handle).second));
+    }
+
+    Weight TopWeight() const { return heap.top().first; }
+    Key TopKey() const { return heap.top().second; }
+
+    Key Pop()
+    {
+        const Key key = heap.top().second;
+        heap.pop();
+        return key;
+    }
+
+    // Handle of the keys that are not in the queue
+    Handle Removed() const
+    {
+        // Use end iterator as a reliable "non-existent" handle.
+        // Default-constructed handles are singular and
+        // can only be checked-compared to another singular instance.
+        // Behaviour investigated at https://lists.boost.org/boost-users/2017/08/87787.php,
+        // eventually confirmation at https://stackoverflow.com/a/45622940/151641.
+        // Corrected in https://github.com/Project-OSRM/osrm-backend/pull/4396
+        auto const end_it = const_cast<HeapContainer &>(heap).end();  // non-const iterator
+        return heap.s_handle_from_iterator(end_it); // from non-const iterator
+    }
+
+    bool Empty() const { return heap.empty(); }
+    std::size_t Size() const { return heap.size(); }
+    void Clear() { heap.clear(); }
+    void Shrink() { HeapContainer().swap(heap); }
+
+    // The entries are list nodes that are freed when they are popped
+    std::size_t GetSizeInBytes() const { return 0; }
+
+  private:
+    HeapContainer heap;
+};
+
+// Radix heap for integer weights. Pushing and decreasing take constant time, popping takes
+// amortized time logarithmic in the weight range. It is fastest if no weight smaller than the
+// last popped one is pushed, as in Dijkstra searches with non-negative edge weights. Smaller
+// weights are still ordered correctly, but they make the heap redistribute all entries.
+template <typename Weight, typename Key> class RadixHeapQueue
+{
+    static_assert(std::is_integral<Weight>::value, "radix heaps need integer weights");
+    using Radix = typename std::make_unsigned<Weight>::type;
+    static const constexpr std::size_t RADIX_BITS = std::numeric_limits<Radix>::digits;
+    // Flipping the sign bit keeps the order of signed weights as unsigned radixes
+    static const constexpr Radix SIGN_BIT =
+        std::is_signed<Weight>::value ? Radix{1} << (RADIX_BITS - 1) : Radix{0};
+
+    struct Entry
+    {
+        Radix radix;
+        std::uint8_t bucket;
+        std::size_t position;
+    };
+
+  public:
+    // Handles are the keys themselves
+    using Handle = Key;
+
+    Handle Push(const Weight weight, const Key key)
+    {
+        if (static_cast<std::size_t>(key) >= entries.size())
+        {
+            entries.resize(static_cast<std::size_t>(key) + 1);
+        }
+        Insert(key, toRadix(weight));
+        ++size;
+        return key;
+    }
+
+    void Decrease(const Handle key, const Weight weight)
+    {
+        BOOST_ASSERT(toRadix(weight) <= entries[key].radix);
+        Erase(key);
+        Insert(key, toRadix(weight));
+    }
+
+    Weight TopWeight() const
+    {
+        Normalize();
+        return fromRadix(last);
+    }
+
+    Key TopKey() const
+    {
+        Normalize();
+        return buckets[0].back();
+    }
+
+    Key Pop()
+    {
+        Normalize();
+        const Key key = buckets[0].back();
+        buckets[0].pop_back();
+        --size;
+        return key;
+    }
+
+    Handle Removed() const { return std::numeric_limits<Key>::max(); }
+
+    bool Empty() const { return size == 0; }
+    std::size_t Size() const { return size; }
+
+    void Clear()
+    {
+        for (auto &bucket : buckets)
+        {
+            bucket.clear();
+        }
+        entries.clear();
+        last = 0;
+        size = 0;
+    }
+
+    void Shrink()
+    {
+        for (auto &bucket : buckets)
+        {
+            std::vector<Key>().swap(bucket);
+        }
+        std::vector<Entry>().swap(entries);
+        last = 0;
+        size = 0;
+    }
+
+    std::size_t GetSizeInBytes() const
+    {
+        std::size_t bytes = entries.capacity() * sizeof(Entry);
+        for (const auto &bucket : buckets)
+        {
+            bytes += bucket.capacity() * sizeof(Key);
+        }
+        return bytes;
+    }
+
+  private:
+    static Radix toRadix(const Weight weight) { return static_cast<Radix>(weight) ^ SIGN_BIT; }
+    static Weight fromRadix(const Radix radix) { return static_cast<Weight>(radix ^ SIGN_BIT); }
+
+    // Bucket 0 holds the radixes equal to the last popped one, bucket i those whose highest bit
+    // that differs from it is bit i - 1
+    std::size_t GetBucket(const Radix radix) const
+    {
+        auto difference = static_cast<std::uint64_t>(radix ^ last);
+#if defined(__GNUC__)
+        return difference == 0 ? 0 : 64 - __builtin_clzll(difference);
+#else
+        std::size_t bucket = 0;
+        for (; difference != 0; difference >>= 1)
+        {
+            ++bucket;
+        }
+        return bucket;
+#endif
+    }
+
+    void Insert(const Key key, const Radix radix) const
+    {
+        if (radix < last)
+        {
+            Rebase(radix);
+        }
+        const auto bucket = GetBucket(radix);
+        entries[key] = Entry{radix, static_cast<std::uint8_t>(bucket), buckets[bucket].size()};
+        buckets[bucket].push_back(key);
+    }
+
+    void Erase(const Key key)
+    {
+        const auto &entry = entries[key];
+        auto &bucket = buckets[entry.bucket];
+        const auto moved_key = bucket.back();
+        bucket[entry.position] = moved_key;
+        entries[moved_key].position = entry.position;
+        bucket.pop_back();
+    }
+
+    // Moves the smallest radixes to bucket 0, the other entries of their bucket go to lower ones
+    void Normalize() const
+    {
+        BOOST_ASSERT(size > 0);
+        if (!buckets[0].empty())
+        {
+            return;
+        }
+
+        std::size_t index = 1;
+        while (buckets[index].empty())
+        {
+            ++index;
+        }
+        std::vector<Key> keys;
+        keys.swap(buckets[index]);
+        last = entries[keys.front()].radix;
+        for (const auto key : keys)
+        {
+            last = std::min(last, entries[key].radix);
+        }
+        for (const auto key : keys)
+        {
+            Insert(key, entries[key].radix);
+        }
+        // keep the memory of the bucket for the next searches
+        keys.clear();
+        buckets[index].swap(keys);
+    }
+
+    // Buckets all entries anew relative to a radix smaller than the last popped one
+    void Rebase(const Radix radix) const
+    {
+        std::vector<Key> keys;
+        for (auto &bucket : buckets)
+        {
+            keys.insert(keys.end(), bucket.begin(), bucket.end());
+            bucket.clear();
+        }
+        last = radix;
+        for (const auto key : keys)
+        {
+            Insert(key, entries[key].radix);
+        }
+    }
+
+    // Entries are moved between buckets lazily, when the smallest one is asked for
+    mutable std::array<std::vector<Key>, RADIX_BITS + 1> buckets;
+    mutable std::vector<Entry> entries;
+    mutable Radix last = 0;
+    std::size_t size = 0;
+};
+
+// Queue of the heaps of the routing searches and the customizer, the ENABLE_RADIX_HEAP build
+// option switches them to radix heaps
+#ifdef ENABLE_RADIX_HEAP
+template <typename Weight, typename Key> using SearchQueue = RadixHeapQueue<Weight, Key>;
+#else
+template <typename Weight, typename Key> using SearchQueue = DAryHeapQueue<Weight, Key>;
+#endif
+
 template <typename NodeID,
           typename Key,
           typename Weight,
           typename Data,
-          typename IndexStorage = ArrayStorage<NodeID, NodeID>>
+          typename IndexStorage = ArrayStorage<NodeID, NodeID>,
+          template <typename W, typename K> class PriorityQueue = DAryHeapQueue>
 class QueryHeap
 {
   private:
-    using HeapData = std::pair<Weight, Key>;
-    using HeapContainer = boost::heap::d_ary_heap<HeapData,
-                                                  boost::heap::arity<4>,
-                                                  boost::heap::mutable_<true>,
-                                                  boost::heap::compare<std::greater<HeapData>>>;
-    using HeapHandle = typename HeapContainer::handle_type;
+    using HeapContainer = PriorityQueue<Weight, Key>;
+    using HeapHandle = typename HeapContainer::Handle;
 
   public:
     using WeightType = Weight;
@@ -218,16 +660,50 @@ class QueryHeap
     template <typename... StorageArgs> explicit QueryHeap(StorageArgs... args) : node_index(args...)
     {
         Clear();
+        initial_size_in_bytes = GetSizeInBytes();
     }
 
     void Clear()
     {
-        heap.clear();
+        heap.Clear();
         inserted_nodes.clear();
         node_index.Clear();
     }
 
-    std::size_t Size() const { return heap.size(); }
+    // Clears the heap and frees the memory it grew to in earlier searches
+    void Shrink()
+    {
+        heap.Shrink();
+        std::vector<HeapNode>().swap(inserted_nodes);
+        node_index.Shrink();
+    }
+
+    std::size_t Size() const { return heap.Size(); }
+
+    // Work done with the heap since it was created, Clear does not reset it
+    const QueryHeapCounters &GetCounters() const { return counters; }
+
+    // The heap sees the settled nodes only, the edges are counted by the relaxing searches
+    void CountRelaxedEdges(const std::uint64_t edges, const std::uint64_t overlay_edges = 0)
+    {
+        counters.relaxed_edges += edges;
+        counters.overlay_edges += overlay_edges;
+    }
+
+    // Memory held by the heap, it is kept across searches to avoid allocations
+    std::size_t GetSizeInBytes() const
+    {
+        return inserted_nodes.capacity() * sizeof(HeapNode) + node_index.GetSizeInBytes() +
+               heap.GetSizeInBytes();
+    }
+
+    // Memory the heap grew to in searches, Shrink frees it. Index arrays sized by the graph are
+    // held from the start and not part of it.
+    std::size_t GetGrowthInBytes() const
+    {
+        const auto size_in_bytes = GetSizeInBytes();
+        return size_in_bytes > initial_size_in_bytes ? size_in_bytes - initial_size_in_bytes : 0;
+    }
 
     bool Empty() const { return 0 == Size(); }
 
@@ -235,7 +711,7 @@ class QueryHeap
     {
         BOOST_ASSERT(node < std::numeric_limits<NodeID>::max());
         const auto index = static_cast<Key>(inserted_nodes.size());
-        const auto handle = heap.push(std::make_pair(weight, index));
+        const auto handle = heap.Push(weight, index);
         inserted_nodes.emplace_back(HeapNode{handle, node, weight, data});
         node_index[node] = index;
     }
@@ -271,16 +747,7 @@ class QueryHeap
     {
         BOOST_ASSERT(WasInserted(node));
         const Key index = node_index.peek_index(node);
-
-        // Use end iterator as a reliable "non-existent" handle.
-        // Default-constructed handles are singular and
-        // can only be checked-compared to another singular instance.
-        // Behaviour investigated at https://lists.boost.org/boost-users/2017/08/87787.php,
-        // eventually confirmation at https://stackoverflow.com/a/45622940/151641.
-        // Corrected in https://github.com/Project-OSRM/osrm-backend/pull/4396
-        auto const end_it = const_cast<HeapContainer &>(heap).end();  // non-const iterator
-        auto const none_handle = heap.s_handle_from_iterator(end_it); // from non-const iterator
-        return inserted_nodes[index].handle == none_handle;
+        return inserted_nodes[index].handle == heap.Removed();
     }
 
     bool WasInserted(const NodeID node) const
@@ -317,41 +784,41 @@ class QueryHeap
 
     NodeID Min() const
     {
-        BOOST_ASSERT(!heap.empty());
-        return inserted_nodes[heap.top().second].node;
+        BOOST_ASSERT(!heap.Empty());
+        return inserted_nodes[heap.TopKey()].node;
     }
 
     Weight MinKey() const
     {
-        BOOST_ASSERT(!heap.empty());
-        return heap.top().first;
+        BOOST_ASSERT(!heap.Empty());
+        return heap.TopWeight();
     }
 
     NodeID DeleteMin()
     {
-        BOOST_ASSERT(!heap.empty());
-        const Key removedIndex = heap.top().second;
-        heap.pop();
-        inserted_nodes[removedIndex].handle = heap.s_handle_from_iterator(heap.end());
+        BOOST_ASSERT(!heap.Empty());
+        const Key removedIndex = heap.Pop();
+        ++counters.settled_nodes;
+        inserted_nodes[removedIndex].handle = heap.Removed();
         return inserted_nodes[removedIndex].node;
     }
 
     HeapNode &DeleteMinGetHeapNode()
     {
-        BOOST_ASSERT(!heap.empty());
-        const Key removedIndex = heap.top().second;
-        heap.pop();
-        inserted_nodes[removedIndex].handle = heap.s_handle_from_iterator(heap.end());
+        BOOST_ASSERT(!heap.Empty());
+        const Key removedIndex = heap.Pop();
+        ++counters.settled_nodes;
+        inserted_nodes[removedIndex].handle = heap.Removed();
         return inserted_nodes[removedIndex];
     }
 
     void DeleteAll()
     {
-        auto const none_handle = heap.s_handle_from_iterator(heap.end());
+        auto const none_handle = heap.Removed();
         std::for_each(inserted_nodes.begin(), inserted_nodes.end(), [&none_handle](auto &node) {
             node.handle = none_handle;
         });
-        heap.clear();
+        heap.Clear();
     }
 
     void DecreaseKey(NodeID node, Weight weight)
@@ -360,19 +827,21 @@ class QueryHeap
         const auto index = node_index.peek_index(node);
         auto &reference = inserted_nodes[index];
         reference.weight = weight;
-        heap.increase(reference.handle, std::make_pair(weight, index));
+        heap.Decrease(reference.handle, weight);
     }
 
     void DecreaseKey(const HeapNode &heapNode)
     {
         BOOST_ASSERT(!WasRemoved(heapNode.node));
-        heap.increase(heapNode.handle, std::make_pair(heapNode.weight, (*heapNode.handle).second));
+        heap.Decrease(heapNode.handle, heapNode.weight);
     }
 
   private:
     std::vector<HeapNode> inserted_nodes;
     HeapContainer heap;
     IndexStorage node_index;
+    QueryHeapCounters counters;
+    std::size_t initial_size_in_bytes;
 };
 } // namespace util
 } // namespace osrm
@@ -73,6 +73,8 @@ class XORFastHashStorage
         }
     }
 
+    std::size_t GetSizeInBytes() const { return positions.capacity() * sizeof(HashCell); }
+
   private:
     std::vector<HashCell> positions;
     XORFastHash<MaxNumElements> fast_hasher;
@@ -0,0 +1,158 @@
+#include "util/query_heap.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+// Runs Dijkstra searches on a grid graph with random edge weights, the way the routing searches
+// use the query heaps: relaxations of settled nodes are skipped, reached nodes are decreased.
+// Searches over the whole graph compare the priority queues, searches that stop after a few
+// thousand settled nodes, like CH searches do, compare the index storages of the heaps.
+struct GridGraph
+{
+    GridGraph(const NodeID width, const NodeID height) : width(width), height(height)
+    {
+        std::mt19937 generator(1337);
+        std::uniform_int_distribution<EdgeWeight> weights(1, 1000);
+
+        offsets.push_back(0);
+        for (const auto node : util::irange<NodeID>(0, width * height))
+        {
+            const auto x = node % width;
+            const auto y = node / width;
+            if (x > 0)
+                AddEdge(node - 1, weights(generator));
+            if (x + 1 < width)
+                AddEdge(node + 1, weights(generator));
+            if (y > 0)
+                AddEdge(node - width, weights(generator));
+            if (y + 1 < height)
+                AddEdge(node + width, weights(generator));
+            offsets.push_back(targets.size());
+        }
+    }
+
+    void AddEdge(const NodeID target, const EdgeWeight weight)
+    {
+        targets.push_back(target);
+        edge_weights.push_back(weight);
+    }
+
+    NodeID GetNumberOfNodes() const { return width * height; }
+
+    NodeID width;
+    NodeID height;
+    std::vector<std::size_t> offsets;
+    std::vector<NodeID> targets;
+    std::vector<EdgeWeight> edge_weights;
+};
+
+struct HeapData
+{
+    NodeID parent;
+};
+
+template <typename HeapT>
+double measure_searches(const GridGraph &graph,
+                        HeapT &heap,
+                        const std::vector<NodeID> &sources,
+                        const std::size_t max_settled_nodes,
+                        std::uint64_t &checksum)
+{
+    TIMER_START(search);
+    for (const auto source : sources)
+    {
+        heap.Clear();
+        heap.Insert(source, 0, {source});
+        std::size_t settled_nodes = 0;
+        while (!heap.Empty() && settled_nodes++ < max_settled_nodes)
+        {
+            const auto weight = heap.MinKey();
+            const auto node = heap.DeleteMin();
+            checksum += weight;
+            for (auto edge = graph.offsets[node]; edge < graph.offsets[node + 1]; ++edge)
+            {
+                const auto target = graph.targets[edge];
+                const auto to_weight = weight + graph.edge_weights[edge];
+                if (!heap.WasInserted(target))
+                {
+                    heap.Insert(target, to_weight, {node});
+                }
+                else if (!heap.WasRemoved(target) && to_weight < heap.GetKey(target))
+                {
+                    heap.GetData(target).parent = node;
+                    heap.DecreaseKey(target, to_weight);
+                }
+            }
+        }
+    }
+    TIMER_STOP(search);
+
+    return TIMER_MSEC(search);
+}
+
+template <template <typename W, typename K> class PriorityQueue,
+          template <typename N, typename K> class IndexStorage>
+void run_searches(const std::string &name,
+                  const GridGraph &graph,
+                  const std::vector<NodeID> &sources,
+                  const std::size_t max_settled_nodes)
+{
+    using Heap = util::
+        QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, IndexStorage<NodeID, int>, PriorityQueue>;
+    Heap heap(graph.GetNumberOfNodes());
+
+    std::uint64_t checksum = 0;
+    const auto search_ms = measure_searches(graph, heap, sources, max_settled_nodes, checksum);
+    util::Log() << name << ": " << search_ms << " ms for " << sources.size() << " searches, "
+                << search_ms / sources.size() << " ms per search (checksum " << checksum << ")";
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    const GridGraph graph(1000, 1000);
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<NodeID> nodes(0, graph.GetNumberOfNodes() - 1);
+    const auto make_sources = [&](const std::size_t number_of_sources) {
+        std::vector<NodeID> sources(number_of_sources);
+        for (auto &source : sources)
+        {
+            source = nodes(generator);
+        }
+        return sources;
+    };
+
+    const auto full_sources = make_sources(5);
+    const auto all_nodes = graph.GetNumberOfNodes();
+    run_searches<util::DAryHeapQueue, util::ArrayStorage>(
+        "d-ary heap, array storage", graph, full_sources, all_nodes);
+    run_searches<util::RadixHeapQueue, util::ArrayStorage>(
+        "radix heap, array storage", graph, full_sources, all_nodes);
+    run_searches<util::DAryHeapQueue, util::FlatHashStorage>(
+        "d-ary heap, flat hash storage", graph, full_sources, all_nodes);
+    run_searches<util::RadixHeapQueue, util::FlatHashStorage>(
+        "radix heap, flat hash storage", graph, full_sources, all_nodes);
+
+    const auto local_sources = make_sources(10000);
+    const std::size_t local_nodes = 2000;
+    run_searches<util::DAryHeapQueue, util::ArrayStorage>(
+        "local searches, array storage", graph, local_sources, local_nodes);
+    run_searches<util::DAryHeapQueue, util::GenerationArrayStorage>(
+        "local searches, generation array storage", graph, local_sources, local_nodes);
+    run_searches<util::DAryHeapQueue, util::UnorderedMapStorage>(
+        "local searches, unordered map storage", graph, local_sources, local_nodes);
+    run_searches<util::DAryHeapQueue, util::FlatHashStorage>(
+        "local searches, flat hash storage", graph, local_sources, local_nodes);
+
+    return EXIT_SUCCESS;
+}
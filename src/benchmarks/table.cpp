@@ -0,0 +1,104 @@
+#include "util/timing_util.hpp"
+
+#include "osrm/table_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <cmath>
+#include <cstdlib>
+
+int main(int argc, const char *argv[])
+try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [ch|mld] [number of coordinates]\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    // Configure based on a .osrm base path, and no datasets in shared mem from osrm-datastore
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+    config.algorithm = EngineConfig::Algorithm::CH;
+    if (argc > 2 && boost::to_lower_copy(std::string{argv[2]}) == "mld")
+    {
+        config.algorithm = EngineConfig::Algorithm::MLD;
+    }
+    const std::size_t number_of_coordinates = argc > 3 ? std::stoul(argv[3]) : 500;
+
+    using osrm::util::FloatCoordinate;
+    using osrm::util::FloatLatitude;
+    using osrm::util::FloatLongitude;
+
+    // Full matrix over a grid of coordinates in monaco
+    TableParameters params;
+    params.annotations = TableParameters::AnnotationsType::All;
+    const double min_lon = 7.4100, max_lon = 7.4400;
+    const double min_lat = 43.7250, max_lat = 43.7500;
+    const auto columns = static_cast<std::size_t>(std::ceil(std::sqrt(number_of_coordinates)));
+    for (std::size_t index = 0; index < number_of_coordinates; ++index)
+    {
+        const auto column = index % columns;
+        const auto row = index / columns;
+        params.coordinates.push_back(
+            FloatCoordinate{FloatLongitude{min_lon + (max_lon - min_lon) * column / columns},
+                            FloatLatitude{min_lat + (max_lat - min_lat) * row / columns}});
+    }
+
+    const auto hardware_threads = std::max<int>(1, std::thread::hardware_concurrency());
+
+    double sequential_msec = 0;
+    for (int parallelism = 1; parallelism <= hardware_threads; parallelism *= 2)
+    {
+        config.max_table_parallelism = parallelism;
+        OSRM osrm{config};
+
+        TIMER_START(tables);
+        auto NUM = 10;
+        for (int i = 0; i < NUM; ++i)
+        {
+            engine::api::ResultT result = json::Object();
+            const auto rc = osrm.Table(params, result);
+            auto &json_result = result.get<json::Object>();
+            if (rc != Status::Ok ||
+                json_result.values.at("durations").get<json::Array>().values.size() !=
+                    number_of_coordinates)
+            {
+                return EXIT_FAILURE;
+            }
+        }
+        TIMER_STOP(tables);
+
+        const auto msec = TIMER_MSEC(tables) / NUM;
+        if (parallelism == 1)
+            sequential_msec = msec;
+
+        std::cout << parallelism << " thread(s): " << msec << "ms/req at "
+                  << number_of_coordinates << "x" << number_of_coordinates << " matrix, speedup "
+                  << (sequential_msec / msec) << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -5,6 +5,7 @@
 #include "contractor/files.hpp"
 #include "contractor/graph_contractor.hpp"
 #include "contractor/graph_contractor_adaptors.hpp"
+#include "contractor/shortcut_children.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
@@ -120,8 +121,19 @@ int Contractor::Run()
     util::Log() << "Contracted graph has " << query_graph.GetNumberOfEdges() << " edges.";
     util::Log() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
+    TIMER_START(shortcut_children);
+    std::vector<ShortcutChildrenTable> shortcut_children;
+    for (const auto &edge_filter : edge_filters)
+    {
+        shortcut_children.push_back(makeShortcutChildren(query_graph, edge_filter));
+    }
+    TIMER_STOP(shortcut_children);
+    util::Log() << "Finding the children of shortcuts took " << TIMER_SEC(shortcut_children)
+                << " sec";
+
     std::unordered_map<std::string, ContractedMetric> metrics = {
-        {metric_name, {std::move(query_graph), std::move(edge_filters)}}};
+        {metric_name,
+         {std::move(query_graph), std::move(edge_filters), std::move(shortcut_children)}}};
 
     files::writeGraph(config.GetPath(".osrm.hsgr"), metrics, connectivity_checksum);
 
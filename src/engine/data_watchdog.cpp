@@ -0,0 +1,22 @@
+#include "engine/data_watchdog.hpp"
+
+#include <atomic>
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+std::atomic<std::uint64_t> data_swap_count{0};
+} // namespace
+
+std::uint64_t GetDataSwapCount() { return data_swap_count.load(std::memory_order_relaxed); }
+
+namespace detail
+{
+void CountDataSwap() { data_swap_count.fetch_add(1, std::memory_order_relaxed); }
+} // namespace detail
+} // namespace engine
+} // namespace osrm
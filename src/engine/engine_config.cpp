@@ -1,5 +1,7 @@
 #include "engine/engine_config.hpp"
 
+#include <algorithm>
+
 namespace osrm
 {
 namespace engine
@@ -21,7 +23,16 @@ bool EngineConfig::IsValid() const
                               unlimited_or_more_than(max_locations_trip, 2) &&
                               unlimited_or_more_than(max_locations_viaroute, 2) &&
                               unlimited_or_more_than(max_results_nearest, 0) &&
-                              max_alternatives >= 0;
+                              unlimited_or_more_than(max_duration_isochrone, 0) &&
+                              max_alternatives >= 0 && max_table_parallelism >= 1 &&
+                              unlimited_or_more_than(rphast_min_destinations, 0) &&
+                              table_bucket_cache_size >= 0 && overlay_path_cache_size >= 0 &&
+                              unlimited_or_more_than(max_batch_size, 0) &&
+                              max_batch_parallelism >= 1 && async_threads >= 0 &&
+                              max_heap_memory >= 0 &&
+                              std::all_of(max_query_time.begin(),
+                                          max_query_time.end(),
+                                          [](const auto &limit) { return limit.second > 0; });
 
     return ((use_shared_memory && all_path_are_empty) || (use_mmap && storage_config.IsValid()) ||
             storage_config.IsValid()) &&
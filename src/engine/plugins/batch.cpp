@@ -0,0 +1,119 @@
+#include "engine/plugins/batch.hpp"
+#include "engine/query_deadline.hpp"
+#include "engine/routing_algorithms/many_to_many.hpp"
+
+#include "util/json_renderer.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+namespace
+{
+// Queries answered before their results are written, a block is spread over all workers
+const constexpr std::size_t BATCH_STREAM_BLOCK_QUERIES = 64;
+const constexpr char BATCH_STREAM_BEGIN[] = "{\"code\":\"Ok\",\"results\":[";
+const constexpr char BATCH_STREAM_END[] = "]}";
+} // namespace
+
+BatchPlugin::BatchPlugin(const int max_batch_size_, const int max_batch_parallelism_)
+    : max_batch_size{max_batch_size_}, max_batch_parallelism{max_batch_parallelism_}
+{
+}
+
+Status BatchPlugin::HandleRequest(const QueryHandler &handle_query,
+                                  const api::BatchParameters &params,
+                                  osrm::engine::api::ResultT &result,
+                                  const api::ResultChunkWriter &write_chunk) const
+{
+    BOOST_ASSERT(params.IsValid());
+
+    if (!result.is<util::json::Object>())
+    {
+        return Error("NotImplemented", "Batch results are only available as JSON.", result);
+    }
+
+    if (max_batch_size > 0 && params.queries.size() > static_cast<std::size_t>(max_batch_size))
+    {
+        return Error("TooBig",
+                     "Number of queries " + std::to_string(params.queries.size()) +
+                         " is higher than current maximum (" + std::to_string(max_batch_size) +
+                         ")",
+                     result);
+    }
+
+    // Nothing can be reported as an error once the first block has been written
+    if (write_chunk)
+    {
+        write_chunk(BATCH_STREAM_BEGIN, sizeof(BATCH_STREAM_BEGIN) - 1);
+    }
+
+    util::json::Array results;
+    std::vector<char> rendered_block;
+    for (std::size_t first = 0; first < params.queries.size(); first += BATCH_STREAM_BLOCK_QUERIES)
+    {
+        // once the batch is out of time its queries fail, a batch that is not streamed fails as
+        // a whole instead
+        if (!write_chunk)
+        {
+            checkDeadlineNow();
+        }
+        const auto block_size =
+            std::min(BATCH_STREAM_BLOCK_QUERIES, params.queries.size() - first);
+        // results are JSON objects until their queries fill them in
+        std::vector<api::ResultT> block_results(block_size);
+        // A query that fails has its error object in place of its result
+        routing_algorithms::runSearches(
+            block_size,
+            static_cast<std::size_t>(std::max(1, max_batch_parallelism)),
+            [&](const std::size_t index) {
+                handle_query(params.queries[first + index], block_results[index]);
+            });
+
+        rendered_block.clear();
+        for (auto &query_result : block_results)
+        {
+            BOOST_ASSERT(query_result.is<util::json::Object>());
+            auto &object = query_result.get<util::json::Object>();
+            if (write_chunk)
+            {
+                if (first > 0 || !rendered_block.empty())
+                {
+                    rendered_block.push_back(',');
+                }
+                util::json::render(rendered_block, object);
+            }
+            else
+            {
+                results.values.push_back(std::move(object));
+            }
+        }
+        if (write_chunk)
+        {
+            write_chunk(rendered_block.data(), rendered_block.size());
+        }
+    }
+
+    if (write_chunk)
+    {
+        write_chunk(BATCH_STREAM_END, sizeof(BATCH_STREAM_END) - 1);
+        return Status::Ok;
+    }
+
+    auto &json_result = result.get<util::json::Object>();
+    json_result.values["code"] = "Ok";
+    json_result.values["results"] = std::move(results);
+    return Status::Ok;
+}
+} // namespace plugins
+} // namespace engine
+} // namespace osrm
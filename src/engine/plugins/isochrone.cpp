@@ -0,0 +1,89 @@
+#include "engine/plugins/isochrone.hpp"
+#include "engine/api/isochrone_api.hpp"
+#include "engine/api/isochrone_parameters.hpp"
+#include "engine/phantom_node.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+IsochronePlugin::IsochronePlugin(const int max_duration_isochrone_)
+    : max_duration_isochrone{max_duration_isochrone_}
+{
+}
+
+Status IsochronePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+                                      const api::IsochroneParameters &params,
+                                      osrm::engine::api::ResultT &result) const
+{
+    if (!algorithms.HasOneToAllSearch())
+    {
+        return Error("NotImplemented",
+                     "Isochrone search is not implemented for the chosen search algorithm.",
+                     result);
+    }
+
+    BOOST_ASSERT(params.IsValid());
+
+    if (!CheckAlgorithms(params, algorithms, result))
+        return Status::Error;
+
+    if (!result.is<util::json::Object>())
+    {
+        return Error("NotImplemented", "Isochrones are only available as JSON.", result);
+    }
+
+    if (max_duration_isochrone > 0 &&
+        params.contours.back() > static_cast<unsigned>(max_duration_isochrone))
+    {
+        return Error("TooBig",
+                     "Contour " + std::to_string(params.contours.back()) +
+                         " is higher than current maximum (" +
+                         std::to_string(max_duration_isochrone) + ")",
+                     result);
+    }
+
+    if (!CheckAllCoordinates(params.coordinates))
+        return Error("InvalidOptions", "Coordinates are invalid", result);
+
+    if (params.coordinates.size() != 1)
+    {
+        return Error("InvalidOptions", "Only one input coordinate is supported", result);
+    }
+
+    const auto &facade = algorithms.GetFacade();
+    const auto phantom_nodes = GetPhantomNodes(facade, params);
+    if (phantom_nodes.size() != params.coordinates.size())
+    {
+        return Error(
+            "NoSegment", MissingPhantomErrorMessage(phantom_nodes, params.coordinates), result);
+    }
+
+    const auto snapped_phantoms = SnapPhantomNodes(phantom_nodes);
+    BOOST_ASSERT(snapped_phantoms.size() == 1);
+
+    // contours are in seconds, durations in deciseconds
+    const auto max_duration = static_cast<EdgeDuration>(std::min<std::uint64_t>(
+        std::uint64_t{params.contours.back()} * 10, MAXIMAL_EDGE_DURATION_INT_30));
+    const auto reachable_nodes =
+        algorithms.OneToAllSearch(snapped_phantoms.front(), max_duration);
+
+    api::IsochroneAPI isochrone_api(facade, params);
+    isochrone_api.MakeResponse(
+        snapped_phantoms.front(), reachable_nodes, result.get<util::json::Object>());
+
+    return Status::Ok;
+}
+} // namespace plugins
+} // namespace engine
+} // namespace osrm
@@ -2,12 +2,14 @@
 
 #include "engine/api/table_api.hpp"
 #include "engine/api/table_parameters.hpp"
+#include "engine/api/table_stream_api.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/search_engine_data.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/json_container.hpp"
 #include "util/string_util.hpp"
 
+#include <cmath>
 #include <cstdlib>
 
 #include <algorithm>
@@ -24,14 +26,121 @@ namespace engine
 namespace plugins
 {
 
-TablePlugin::TablePlugin(const int max_locations_distance_table)
-    : max_locations_distance_table(max_locations_distance_table)
+namespace
+{
+// Cells of a streamed block, the rows of a block are computed and written together
+const constexpr std::size_t TABLE_STREAM_BLOCK_CELLS = 1 << 20;
+
+// Search limits of the max_duration (seconds) and max_distance (meters) parameters
+routing_algorithms::TableSearchLimits makeSearchLimits(const api::TableParameters &params)
+{
+    routing_algorithms::TableSearchLimits limits;
+    if (params.max_duration)
+    {
+        limits.max_duration = static_cast<EdgeDuration>(
+            std::min<double>(std::round(*params.max_duration * 10.), MAXIMAL_EDGE_DURATION));
+    }
+    if (params.max_distance)
+    {
+        limits.max_distance = static_cast<EdgeDistance>(
+            std::min<double>(*params.max_distance, MAXIMAL_EDGE_DISTANCE));
+    }
+    return limits;
+}
+
+// Scan the rows [first_row, first_row + number of rows in the tables) for results beyond the
+// limits and null results, replace null results with distance estimates within the limits and
+// apply the scale factor
+void estimateAndScaleRows(const api::TableParameters &params,
+                          const routing_algorithms::TableSearchLimits &limits,
+                          const std::vector<PhantomNode> &snapped_phantoms,
+                          const std::size_t first_row,
+                          const std::size_t num_destinations,
+                          std::vector<EdgeDuration> &durations,
+                          std::vector<EdgeDistance> &distances,
+                          std::vector<api::TableAPI::TableCellRef> &estimated_pairs)
+{
+    const auto num_rows = durations.size() / num_destinations;
+    for (std::size_t row = first_row; row < first_row + num_rows; row++)
+    {
+        for (std::size_t column = 0; column < num_destinations; column++)
+        {
+            const auto &table_index = (row - first_row) * num_destinations + column;
+            BOOST_ASSERT(table_index < durations.size());
+            // The searches only prune both halves of a path, so the sum can still exceed a limit
+            if (limits.IsBounded() &&
+                limits.Exceeds(durations[table_index],
+                               distances.empty() ? EdgeDistance{0} : distances[table_index]))
+            {
+                durations[table_index] = MAXIMAL_EDGE_DURATION;
+                if (!distances.empty())
+                {
+                    distances[table_index] = MAXIMAL_EDGE_DISTANCE;
+                }
+            }
+            if (params.fallback_speed != INVALID_FALLBACK_SPEED && params.fallback_speed > 0 &&
+                durations[table_index] == MAXIMAL_EDGE_DURATION)
+            {
+                const auto &source =
+                    snapped_phantoms[params.sources.empty() ? row : params.sources[row]];
+                const auto &destination =
+                    snapped_phantoms[params.destinations.empty() ? column
+                                                                 : params.destinations[column]];
+
+                auto distance_estimate =
+                    params.fallback_coordinate_type ==
+                            api::TableParameters::FallbackCoordinateType::Input
+                        ? util::coordinate_calculation::fccApproximateDistance(
+                              source.input_location, destination.input_location)
+                        : util::coordinate_calculation::fccApproximateDistance(
+                              source.location, destination.location);
+
+                const EdgeDuration duration_estimate =
+                    distance_estimate / (double)params.fallback_speed;
+                if (!limits.Exceeds(duration_estimate, distance_estimate))
+                {
+                    durations[table_index] = duration_estimate;
+                    if (!distances.empty())
+                    {
+                        distances[table_index] = distance_estimate;
+                    }
+
+                    estimated_pairs.emplace_back(row, column);
+                }
+            }
+            if (params.scale_factor > 0 && params.scale_factor != 1 &&
+                durations[table_index] != MAXIMAL_EDGE_DURATION && durations[table_index] != 0)
+            {
+                EdgeDuration diff = MAXIMAL_EDGE_DURATION / durations[table_index];
+
+                if (params.scale_factor >= diff)
+                {
+                    durations[table_index] = MAXIMAL_EDGE_DURATION - 1;
+                }
+                else
+                {
+                    durations[table_index] =
+                        std::lround(durations[table_index] * params.scale_factor);
+                }
+            }
+        }
+    }
+}
+} // namespace
+
+TablePlugin::TablePlugin(const int max_locations_distance_table,
+                         const int max_table_parallelism,
+                         const int rphast_min_destinations)
+    : max_locations_distance_table(max_locations_distance_table),
+      max_table_parallelism(max_table_parallelism),
+      rphast_min_destinations(rphast_min_destinations)
 {
 }
 
 Status TablePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                                   const api::TableParameters &params,
-                                  osrm::engine::api::ResultT &result) const
+                                  osrm::engine::api::ResultT &result,
+                                  const api::ResultChunkWriter &write_chunk) const
 {
     if (!algorithms.HasManyToManySearch())
     {
@@ -84,8 +193,85 @@ Status TablePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
     bool request_distance = params.annotations & api::TableParameters::AnnotationsType::Distance;
     bool request_duration = params.annotations & api::TableParameters::AnnotationsType::Duration;
 
-    auto result_tables_pair = algorithms.ManyToManySearch(
-        snapped_phantoms, params.sources, params.destinations, request_distance);
+    // Results beyond max_distance can only be dropped if their distances are known
+    const auto limits = makeSearchLimits(params);
+    const bool calculate_distance = request_distance || params.max_distance;
+    const bool postprocess_rows = params.fallback_speed != INVALID_FALLBACK_SPEED ||
+                                  params.scale_factor != 1 || limits.IsBounded();
+
+    // Binary tables start with the bitmap of all estimated cells and list all durations before
+    // all distances, which leaves nothing to write before the whole table is known
+    if (params.stream && result.is<std::vector<char>>())
+    {
+        return Error("InvalidOptions",
+                     "Binary tables cannot be streamed, use format=flatbuffers to stream tables",
+                     result);
+    }
+
+    if (params.stream && write_chunk)
+    {
+        // JSON lists all durations before all distances, one of them would have to be held
+        if (result.is<util::json::Object>() && request_duration && request_distance)
+        {
+            return Error("InvalidOptions",
+                         "Streamed JSON tables support a single annotation, use "
+                         "format=flatbuffers for durations and distances",
+                         result);
+        }
+
+        // Nothing can be reported as an error once the first block has been written
+        api::TableStreamAPI table_api{facade,
+                                      params,
+                                      snapped_phantoms,
+                                      result.is<flatbuffers::FlatBufferBuilder>(),
+                                      write_chunk};
+        table_api.Begin();
+        algorithms.ManyToManyBlockSearch(
+            snapped_phantoms,
+            params.sources,
+            params.destinations,
+            calculate_distance,
+            std::max(1, max_table_parallelism),
+            limits,
+            std::max<std::size_t>(1, TABLE_STREAM_BLOCK_CELLS / num_destinations),
+            [&](const std::size_t first_row,
+                std::vector<EdgeDuration> &durations,
+                std::vector<EdgeDistance> &distances) {
+                std::vector<api::TableAPI::TableCellRef> estimated_pairs;
+                if (postprocess_rows)
+                {
+                    estimateAndScaleRows(params,
+                                         limits,
+                                         snapped_phantoms,
+                                         first_row,
+                                         num_destinations,
+                                         durations,
+                                         distances,
+                                         estimated_pairs);
+                }
+                table_api.AddBlock(durations, distances, estimated_pairs);
+            });
+        table_api.Finish();
+
+        return Status::Ok;
+    }
+
+    // Many destinations make a single sweep over their search space cheaper than the buckets
+    const bool use_sweep = rphast_min_destinations > 0 &&
+                           num_destinations >= static_cast<std::size_t>(rphast_min_destinations);
+    auto result_tables_pair =
+        use_sweep ? algorithms.ManyToManySweepSearch(snapped_phantoms,
+                                                     params.sources,
+                                                     params.destinations,
+                                                     calculate_distance,
+                                                     std::max(1, max_table_parallelism),
+                                                     limits)
+                  : algorithms.ManyToManySearch(snapped_phantoms,
+                                                params.sources,
+                                                params.destinations,
+                                                calculate_distance,
+                                                std::max(1, max_table_parallelism),
+                                                limits);
 
     if ((request_duration && result_tables_pair.first.empty()) ||
         (request_distance && result_tables_pair.second.empty()))
@@ -96,59 +282,16 @@ Status TablePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
     std::vector<api::TableAPI::TableCellRef> estimated_pairs;
 
     // Scan table for null results - if any exist, replace with distance estimates
-    if (params.fallback_speed != INVALID_FALLBACK_SPEED || params.scale_factor != 1)
+    if (postprocess_rows)
     {
-        for (std::size_t row = 0; row < num_sources; row++)
-        {
-            for (std::size_t column = 0; column < num_destinations; column++)
-            {
-                const auto &table_index = row * num_destinations + column;
-                BOOST_ASSERT(table_index < result_tables_pair.first.size());
-                if (params.fallback_speed != INVALID_FALLBACK_SPEED && params.fallback_speed > 0 &&
-                    result_tables_pair.first[table_index] == MAXIMAL_EDGE_DURATION)
-                {
-                    const auto &source =
-                        snapped_phantoms[params.sources.empty() ? row : params.sources[row]];
-                    const auto &destination =
-                        snapped_phantoms[params.destinations.empty() ? column
-                                                                     : params.destinations[column]];
-
-                    auto distance_estimate =
-                        params.fallback_coordinate_type ==
-                                api::TableParameters::FallbackCoordinateType::Input
-                            ? util::coordinate_calculation::fccApproximateDistance(
-                                  source.input_location, destination.input_location)
-                            : util::coordinate_calculation::fccApproximateDistance(
-                                  source.location, destination.location);
-
-                    result_tables_pair.first[table_index] =
-                        distance_estimate / (double)params.fallback_speed;
-                    if (!result_tables_pair.second.empty())
-                    {
-                        result_tables_pair.second[table_index] = distance_estimate;
-                    }
-
-                    estimated_pairs.emplace_back(row, column);
-                }
-                if (params.scale_factor > 0 && params.scale_factor != 1 &&
-                    result_tables_pair.first[table_index] != MAXIMAL_EDGE_DURATION &&
-                    result_tables_pair.first[table_index] != 0)
-                {
-                    EdgeDuration diff =
-                        MAXIMAL_EDGE_DURATION / result_tables_pair.first[table_index];
-
-                    if (params.scale_factor >= diff)
-                    {
-                        result_tables_pair.first[table_index] = MAXIMAL_EDGE_DURATION - 1;
-                    }
-                    else
-                    {
-                        result_tables_pair.first[table_index] = std::lround(
-                            result_tables_pair.first[table_index] * params.scale_factor);
-                    }
-                }
-            }
-        }
+        estimateAndScaleRows(params,
+                             limits,
+                             snapped_phantoms,
+                             0,
+                             num_destinations,
+                             result_tables_pair.first,
+                             result_tables_pair.second,
+                             estimated_pairs);
     }
 
     api::TableAPI table_api{facade, params};
@@ -217,7 +217,13 @@ Status TripPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
 
     // compute the duration table of all phantom nodes
     auto result_duration_table = util::DistTableWrapper<EdgeWeight>(
-        algorithms.ManyToManySearch(snapped_phantoms, {}, {}, /*requestDistance*/ false).first,
+        algorithms.ManyToManySearch(snapped_phantoms,
+                                    {},
+                                    {},
+                                    /*requestDistance*/ false,
+                                    /*max_parallelism*/ 1,
+                                    routing_algorithms::TableSearchLimits{})
+            .first,
         number_of_locations);
 
     if (result_duration_table.size() == 0)
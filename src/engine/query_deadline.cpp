@@ -0,0 +1,64 @@
+#include "engine/query_deadline.hpp"
+
+#include <algorithm>
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace detail
+{
+thread_local DeadlineCheck current_deadline_check;
+} // namespace detail
+
+void checkDeadlineNow()
+{
+    auto &check = detail::current_deadline_check;
+    check.countdown = detail::DEADLINE_CHECK_INTERVAL;
+    if (check.deadline && check.deadline->IsExpired())
+    {
+        throw QueryTimeout();
+    }
+}
+
+QueryDeadline::QueryDeadline() : QueryDeadline(Clock::time_point::max()) {}
+
+QueryDeadline::QueryDeadline(const Clock::time_point time)
+    : time(time), cancelled(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+QueryDeadline QueryDeadline::Before(const Clock::time_point other_time) const
+{
+    auto deadline = *this;
+    deadline.time = std::min(time, other_time);
+    return deadline;
+}
+
+void QueryDeadline::Cancel() const { cancelled->store(true, std::memory_order_relaxed); }
+
+bool QueryDeadline::IsCancelled() const { return cancelled->load(std::memory_order_relaxed); }
+
+bool QueryDeadline::IsExpired() const
+{
+    return IsCancelled() || (time != Clock::time_point::max() && Clock::now() >= time);
+}
+
+void QueryTimeout::anchor() const {}
+
+QueryDeadlineScope::QueryDeadlineScope(const QueryDeadline *deadline)
+    : previous(detail::current_deadline_check.deadline)
+{
+    detail::current_deadline_check.deadline = deadline;
+    detail::current_deadline_check.countdown = detail::DEADLINE_CHECK_INTERVAL;
+}
+
+QueryDeadlineScope::~QueryDeadlineScope() { detail::current_deadline_check.deadline = previous; }
+
+const QueryDeadline *QueryDeadlineScope::Current()
+{
+    return detail::current_deadline_check.deadline;
+}
+} // namespace engine
+} // namespace osrm
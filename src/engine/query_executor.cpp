@@ -0,0 +1,104 @@
+#include "engine/query_executor.hpp"
+
+#include "util/log.hpp"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+int getConcurrency(const int max_threads)
+{
+    if (max_threads > 0)
+    {
+        return max_threads;
+    }
+    return std::max<int>(1, std::thread::hardware_concurrency());
+}
+
+// An exception leaving a task would terminate the process from inside TBB before the task is
+// finished, so it is logged and dropped
+void runTask(const QueryExecutor::Task &task)
+{
+    try
+    {
+        task();
+    }
+    catch (const std::exception &exception)
+    {
+        util::Log(logERROR) << "Asynchronous query task failed: " << exception.what();
+    }
+    catch (...)
+    {
+        util::Log(logERROR) << "Asynchronous query task failed";
+    }
+}
+} // namespace
+
+// no slots are reserved for threads joining the arena, its tasks are only run by its workers
+QueryExecutor::QueryExecutor(const int max_threads) : arena(getConcurrency(max_threads), 0) {}
+
+QueryExecutor::~QueryExecutor()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    idle.wait(guard, [this] { return pending_tasks == 0; });
+}
+
+void QueryExecutor::Submit(Task task)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        ++pending_tasks;
+    }
+    arena.enqueue([this, task] {
+        runTask(task);
+        Finish(1);
+    });
+}
+
+void QueryExecutor::Submit(std::vector<Task> tasks)
+{
+    if (tasks.empty())
+    {
+        return;
+    }
+
+    const auto number_of_tasks = tasks.size();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pending_tasks += number_of_tasks;
+    }
+    const auto shared_tasks = std::make_shared<std::vector<Task>>(std::move(tasks));
+    arena.enqueue([this, shared_tasks, number_of_tasks] {
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_tasks, 1),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  runTask((*shared_tasks)[index]);
+                              }
+                          });
+        Finish(number_of_tasks);
+    });
+}
+
+void QueryExecutor::Finish(const std::size_t number_of_tasks)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    pending_tasks -= number_of_tasks;
+    if (pending_tasks == 0)
+    {
+        idle.notify_all();
+    }
+}
+} // namespace engine
+} // namespace osrm
@@ -0,0 +1,112 @@
+#include "engine/query_statistics.hpp"
+
+#include <boost/assert.hpp>
+
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+const constexpr int NO_PHASE = -1;
+
+// The phase that is timed on this thread and the moment its current stretch started
+thread_local QueryStatistics *current_statistics = nullptr;
+thread_local int current_phase = NO_PHASE;
+thread_local std::chrono::steady_clock::time_point phase_start;
+
+// Accounts the time since the last switch to the running phase
+void switchPhase(QueryStatistics &statistics, const int next_phase)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (current_phase != NO_PHASE)
+    {
+        statistics.phase_durations[current_phase] +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - phase_start);
+    }
+    current_phase = next_phase;
+    phase_start = now;
+}
+} // namespace
+
+const char *toString(const QueryPhase phase)
+{
+    switch (phase)
+    {
+    case QueryPhase::Snapping:
+        return "snapping";
+    case QueryPhase::Search:
+        return "search";
+    case QueryPhase::Unpacking:
+        return "unpacking";
+    case QueryPhase::Guidance:
+        return "guidance";
+    case QueryPhase::Assembly:
+        return "assembly";
+    }
+    BOOST_ASSERT_MSG(false, "unknown query phase");
+    return "";
+}
+
+util::json::Object makeDebugTiming(const QueryStatistics &statistics)
+{
+    util::json::Object durations;
+    for (std::size_t phase = 0; phase < NUMBER_OF_QUERY_PHASES; ++phase)
+    {
+        const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+            statistics.phase_durations[phase]);
+        durations.values[toString(static_cast<QueryPhase>(phase))] =
+            util::json::Number(microseconds.count());
+    }
+
+    util::json::Object debug_timing;
+    debug_timing.values["durations"] = std::move(durations);
+    debug_timing.values["settled_nodes"] = util::json::Number(statistics.settled_nodes);
+    debug_timing.values["relaxed_edges"] = util::json::Number(statistics.relaxed_edges);
+    debug_timing.values["overlay_edges"] = util::json::Number(statistics.overlay_edges);
+    debug_timing.values["base_edges"] =
+        util::json::Number(statistics.relaxed_edges - statistics.overlay_edges);
+    debug_timing.values["unpacked_shortcuts"] = util::json::Number(statistics.unpacked_shortcuts);
+    return debug_timing;
+}
+
+QueryStatisticsScope::QueryStatisticsScope(QueryStatistics &statistics)
+    : previous(current_statistics)
+{
+    BOOST_ASSERT(current_phase == NO_PHASE);
+    current_statistics = &statistics;
+}
+
+QueryStatisticsScope::~QueryStatisticsScope() { current_statistics = previous; }
+
+QueryStatistics *QueryStatisticsScope::Current() { return current_statistics; }
+
+void countUnpackedShortcuts(const std::uint64_t unpacked_shortcuts)
+{
+    if (current_statistics)
+    {
+        current_statistics->unpacked_shortcuts += unpacked_shortcuts;
+    }
+}
+
+QueryPhaseTimer::QueryPhaseTimer(const QueryPhase phase)
+    : statistics(current_statistics), previous_phase(current_phase)
+{
+    if (statistics)
+    {
+        switchPhase(*statistics, static_cast<int>(phase));
+    }
+}
+
+QueryPhaseTimer::~QueryPhaseTimer()
+{
+    if (statistics)
+    {
+        switchPhase(*statistics, previous_phase);
+    }
+}
+} // namespace engine
+} // namespace osrm
@@ -59,6 +59,7 @@ void alternativeRoutingStep(const DataFacade<Algorithm> &facade,
                             std::vector<SearchSpaceEdge> &search_space,
                             const EdgeWeight min_edge_offset)
 {
+    checkDeadline();
     QueryHeap &forward_heap = DIRECTION == FORWARD_DIRECTION ? heap1 : heap2;
     QueryHeap &reverse_heap = DIRECTION == FORWARD_DIRECTION ? heap2 : heap1;
 
@@ -4,8 +4,15 @@
 #include <boost/assert.hpp>
 #include <boost/range/iterator_range_core.hpp>
 
+#include <tbb/enumerable_thread_specific.h>
+
+#include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -56,11 +63,13 @@ void relaxOutgoingEdges(
         return;
     }
 
+    std::uint64_t relaxed_edges = 0;
     for (auto edge : facade.GetAdjacentEdgeRange(heapNode.node))
     {
         const auto &data = facade.GetEdgeData(edge);
         if (DIRECTION == FORWARD_DIRECTION ? data.forward : data.backward)
         {
+            ++relaxed_edges;
             const NodeID to = facade.GetTarget(edge);
             const auto edge_weight = data.weight;
 
@@ -88,29 +97,34 @@ void relaxOutgoingEdges(
             }
         }
     }
+    query_heap.CountRelaxedEdges(relaxed_edges);
 }
 
 void forwardRoutingStep(const DataFacade<Algorithm> &facade,
                         const std::size_t row_index,
                         const std::size_t number_of_targets,
                         typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
-                        const std::vector<NodeBucket> &search_space_with_buckets,
+                        const NodeBucketIndex &search_space_with_buckets,
                         std::vector<EdgeWeight> &weights_table,
                         std::vector<EdgeDuration> &durations_table,
                         std::vector<EdgeDistance> &distances_table,
                         std::vector<NodeID> &middle_nodes_table,
-                        const PhantomNode &phantom_node)
+                        const PhantomNode &phantom_node,
+                        const TableSearchLimits &limits)
 {
+    checkDeadline();
     // Take a copy of the extracted node because otherwise could be modified later if toHeapNode is
     // the same
     const auto heapNode = query_heap.DeleteMinGetHeapNode();
 
+    // Paths via a node beyond the limits exceed them as well
+    if (limits.Exceeds(heapNode.data.duration, heapNode.data.distance))
+    {
+        return;
+    }
+
     // Check if each encountered node has an entry
-    const auto &bucket_list = std::equal_range(search_space_with_buckets.begin(),
-                                               search_space_with_buckets.end(),
-                                               heapNode.node,
-                                               NodeBucket::Compare());
-    for (const auto &current_bucket : boost::make_iterator_range(bucket_list))
+    for (const auto &current_bucket : search_space_with_buckets[heapNode.node])
     {
         // Get target id from bucket entry
         const auto column_index = current_bucket.column_index;
@@ -158,12 +172,20 @@ void backwardRoutingStep(const DataFacade<Algorithm> &facade,
                          const unsigned column_index,
                          typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
                          std::vector<NodeBucket> &search_space_with_buckets,
-                         const PhantomNode &phantom_node)
+                         const PhantomNode &phantom_node,
+                         const TableSearchLimits &limits)
 {
+    checkDeadline();
     // Take a copy (no ref &) of the extracted node because otherwise could be modified later if
     // toHeapNode is the same
     const auto heapNode = query_heap.DeleteMinGetHeapNode();
 
+    // Nodes beyond the limits get no bucket and are not expanded
+    if (limits.Exceeds(heapNode.data.duration, heapNode.data.distance))
+    {
+        return;
+    }
+
     // Store settled nodes in search space bucket
     search_space_with_buckets.emplace_back(heapNode.node,
                                            heapNode.data.parent,
@@ -175,8 +197,257 @@ void backwardRoutingStep(const DataFacade<Algorithm> &facade,
     relaxOutgoingEdges<REVERSE_DIRECTION>(facade, heapNode, query_heap, phantom_node);
 }
 
+// Union of the upward search spaces of the targets for RPHAST sweeps. Nodes are numbered in a
+// topological order of the downward edges (every node comes after all nodes that have a downward
+// edge into it) and the incoming downward edges are stored per node with these local ids, so a
+// sweep over the space is a linear scan.
+struct RestrictedSearchSpace
+{
+    struct DownwardEdge
+    {
+        std::uint32_t from;
+        EdgeWeight weight;
+        EdgeDuration duration;
+        EdgeDistance distance;
+    };
+
+    std::vector<NodeID> nodes;
+    std::unordered_map<NodeID, std::uint32_t> local_ids;
+    std::vector<std::uint32_t> edge_offsets;
+    std::vector<DownwardEdge> edges;
+};
+
+RestrictedSearchSpace selectRestrictedSearchSpace(const DataFacade<Algorithm> &facade,
+                                                  const std::vector<NodeID> &target_nodes)
+{
+    RestrictedSearchSpace space;
+
+    // Depth-first search along the upward edges of the backward search, a node gets its local id
+    // after all nodes above it have been numbered (post-order). Nodes are marked when expanded,
+    // not when pushed, so a node is never numbered before a node above it.
+    const constexpr auto EXPANDED = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::pair<NodeID, bool>> stack;
+    for (const auto node : target_nodes)
+        stack.emplace_back(node, false);
+
+    while (!stack.empty())
+    {
+        const auto node = stack.back().first;
+        const auto finished = stack.back().second;
+        stack.pop_back();
+
+        if (finished)
+        {
+            space.local_ids[node] = space.nodes.size();
+            space.nodes.push_back(node);
+            continue;
+        }
+
+        if (!space.local_ids.emplace(node, EXPANDED).second)
+            continue;
+
+        stack.emplace_back(node, true);
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            const auto to = facade.GetTarget(edge);
+            if (facade.GetEdgeData(edge).backward && to != node && !space.local_ids.count(to))
+                stack.emplace_back(to, false);
+        }
+    }
+
+    space.edge_offsets.reserve(space.nodes.size() + 1);
+    space.edge_offsets.push_back(0);
+    for (const auto node : space.nodes)
+    {
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = facade.GetEdgeData(edge);
+            const auto from = facade.GetTarget(edge);
+            if (data.backward && from != node)
+            {
+                BOOST_ASSERT(space.local_ids.at(from) < space.local_ids.at(node));
+                space.edges.push_back(
+                    {space.local_ids.at(from), data.weight, data.duration, data.distance});
+            }
+        }
+        space.edge_offsets.push_back(space.edges.size());
+    }
+
+    return space;
+}
+
+// Values of the nodes of the restricted search space for a group of sources, laid out
+// contiguously per node with a lane per source. Kept per thread across the groups of a request.
+struct SweepLanes
+{
+    std::vector<EdgeWeight> weights;
+    std::vector<EdgeDuration> durations;
+    std::vector<EdgeDistance> distances;
+};
+
+// Sum of 32 bit values that wraps around instead of overflowing
+template <typename T> inline T wrappingAdd(const T lhs, const T rhs)
+{
+    static_assert(sizeof(T) == sizeof(std::uint32_t), "only 32 bit values are added");
+    return static_cast<T>(static_cast<std::uint32_t>(lhs) + static_cast<std::uint32_t>(rhs));
+}
+
+// Relaxes a downward edge for all lanes of its nodes at once. The sums are computed for all lanes,
+// including unreached ones whose sums are discarded, and the lanes are updated by selects instead
+// of branches, so the compiler vectorises the loops over the lanes. The distances are summed in a
+// loop of their own, as floating point additions are never moved into a select.
+template <std::size_t LANES, bool CALCULATE_DISTANCE>
+inline void relaxDownwardEdge(const RestrictedSearchSpace::DownwardEdge &downward_edge,
+                              const std::size_t from,
+                              const std::size_t to,
+                              SweepLanes &values)
+{
+    auto *const weights = values.weights.data();
+    auto *const durations = values.durations.data();
+    const auto edge_weight = downward_edge.weight;
+    const auto edge_duration = downward_edge.duration;
+
+    std::int32_t improved[LANES];
+    for (std::size_t lane = 0; lane < LANES; ++lane)
+    {
+        const auto from_weight = weights[from + lane];
+        const auto to_weight = weights[to + lane];
+        const auto to_duration = durations[to + lane];
+        const auto new_weight = wrappingAdd(from_weight, edge_weight);
+        const auto new_duration = wrappingAdd(durations[from + lane], edge_duration);
+
+        const bool improves =
+            (from_weight != INVALID_EDGE_WEIGHT) &
+            ((new_weight < to_weight) | ((new_weight == to_weight) & (new_duration < to_duration)));
+        improved[lane] = improves;
+        weights[to + lane] = improves ? new_weight : to_weight;
+        durations[to + lane] = improves ? new_duration : to_duration;
+    }
+
+    if (CALCULATE_DISTANCE)
+    {
+        auto *const distances = values.distances.data();
+        const auto edge_distance = downward_edge.distance;
+
+        EdgeDistance new_distances[LANES];
+        for (std::size_t lane = 0; lane < LANES; ++lane)
+        {
+            new_distances[lane] = distances[from + lane] + edge_distance;
+        }
+        for (std::size_t lane = 0; lane < LANES; ++lane)
+        {
+            distances[to + lane] = improved[lane] ? new_distances[lane] : distances[to + lane];
+        }
+    }
+}
+
 } // namespace ch
 
+// The backward searches of the targets run once, the forward searches of the sources run
+// per block of rows and only the tables of the current block are held in memory.
+template <>
+void manyToManyBlockSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                           const DataFacade<ch::Algorithm> &facade,
+                           const std::vector<PhantomNode> &phantom_nodes,
+                           const std::vector<std::size_t> &source_indices,
+                           const std::vector<std::size_t> &target_indices,
+                           const bool calculate_distance,
+                           const std::size_t max_parallelism,
+                           const TableSearchLimits &limits,
+                           const TableBucketCacheRef &bucket_cache,
+                           const std::size_t rows_per_block,
+                           const TableBlockHandler &handle_block)
+{
+    BOOST_ASSERT(rows_per_block > 0);
+    const auto number_of_sources = source_indices.size();
+    const auto number_of_targets = target_indices.size();
+
+    // Reuse the buckets of an earlier request with the same targets
+    TableBucketCache::Key cache_key;
+    std::shared_ptr<const NodeBucketIndex> search_space_with_buckets;
+    if (bucket_cache.IsEnabled())
+    {
+        cache_key = TableBucketCache::Key(phantom_nodes, target_indices, limits);
+        search_space_with_buckets = bucket_cache.Find(cache_key);
+    }
+
+    if (!search_space_with_buckets)
+    {
+        std::vector<std::vector<NodeBucket>> column_buckets(number_of_targets);
+
+        // Populate buckets with paths from all accessible nodes to destinations via backward
+        // searches
+        runSearches(number_of_targets, max_parallelism, [&](const std::size_t column_index) {
+            const auto index = target_indices[column_index];
+            const auto &phantom = phantom_nodes[index];
+
+            engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+                facade.GetNumberOfNodes());
+            auto &query_heap = *(engine_working_data.many_to_many_heap);
+            insertTargetInHeap(query_heap, phantom);
+
+            auto &buckets = column_buckets[column_index];
+
+            // Explore search space
+            while (!query_heap.Empty())
+            {
+                backwardRoutingStep(facade, column_index, query_heap, buckets, phantom, limits);
+            }
+        });
+
+        // Group lookup buckets by node
+        search_space_with_buckets = std::make_shared<const NodeBucketIndex>(column_buckets);
+
+        if (bucket_cache.IsEnabled())
+        {
+            bucket_cache.Insert(std::move(cache_key), search_space_with_buckets);
+        }
+    }
+
+    for (std::size_t first_row = 0; first_row < number_of_sources; first_row += rows_per_block)
+    {
+        const auto number_of_rows = std::min(rows_per_block, number_of_sources - first_row);
+        const auto number_of_entries = number_of_rows * number_of_targets;
+
+        std::vector<EdgeWeight> weights_table(number_of_entries, INVALID_EDGE_WEIGHT);
+        std::vector<EdgeDuration> durations_table(number_of_entries, MAXIMAL_EDGE_DURATION);
+        std::vector<EdgeDistance> distances_table(calculate_distance ? number_of_entries : 0,
+                                                  MAXIMAL_EDGE_DISTANCE);
+        std::vector<NodeID> middle_nodes_table(number_of_entries, SPECIAL_NODEID);
+
+        // Find shortest paths from sources to all accessible nodes,
+        // every search writes only to its own row of the tables
+        runSearches(number_of_rows, max_parallelism, [&](const std::size_t row_index) {
+            const auto source_index = source_indices[first_row + row_index];
+            const auto &source_phantom = phantom_nodes[source_index];
+
+            // Clear heap and insert source nodes
+            engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+                facade.GetNumberOfNodes());
+            auto &query_heap = *(engine_working_data.many_to_many_heap);
+            insertSourceInHeap(query_heap, source_phantom);
+
+            // Explore search space
+            while (!query_heap.Empty())
+            {
+                forwardRoutingStep(facade,
+                                   row_index,
+                                   number_of_targets,
+                                   query_heap,
+                                   *search_space_with_buckets,
+                                   weights_table,
+                                   durations_table,
+                                   distances_table,
+                                   middle_nodes_table,
+                                   source_phantom,
+                                   limits);
+            }
+        });
+
+        handle_block(first_row, durations_table, distances_table);
+    }
+}
+
 template <>
 std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
 manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
@@ -184,8 +455,53 @@ manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
                  const std::vector<PhantomNode> &phantom_nodes,
                  const std::vector<std::size_t> &source_indices,
                  const std::vector<std::size_t> &target_indices,
-                 const bool calculate_distance)
+                 const bool calculate_distance,
+                 const std::size_t max_parallelism,
+                 const TableSearchLimits &limits,
+                 const TableBucketCacheRef &bucket_cache)
 {
+    std::vector<EdgeDuration> durations_table;
+    std::vector<EdgeDistance> distances_table;
+
+    // The whole table is a single block, its tables are taken over as they are
+    manyToManyBlockSearch(engine_working_data,
+                          facade,
+                          phantom_nodes,
+                          source_indices,
+                          target_indices,
+                          calculate_distance,
+                          max_parallelism,
+                          limits,
+                          bucket_cache,
+                          std::max<std::size_t>(source_indices.size(), 1),
+                          [&](const std::size_t,
+                              std::vector<EdgeDuration> &durations,
+                              std::vector<EdgeDistance> &distances) {
+                              durations_table = std::move(durations);
+                              distances_table = std::move(distances);
+                          });
+
+    return std::make_pair(std::move(durations_table), std::move(distances_table));
+}
+
+// RPHAST (Delling et al., "Faster Batched Shortest Paths in Road Networks"):
+// The targets' restricted search space is selected once. Every source runs a forward upward
+// search and a linear sweep over the restricted space propagates the distances downwards.
+// Sources are processed in groups of SWEEP_LANES with the values of a node laid out
+// contiguously per source lane, so each downward edge is read once per group.
+template <>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+manyToManySweepSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                      const DataFacade<ch::Algorithm> &facade,
+                      const std::vector<PhantomNode> &phantom_nodes,
+                      const std::vector<std::size_t> &source_indices,
+                      const std::vector<std::size_t> &target_indices,
+                      const bool calculate_distance,
+                      const std::size_t max_parallelism,
+                      const TableSearchLimits &limits)
+{
+    const constexpr std::size_t SWEEP_LANES = 8;
+
     const auto number_of_sources = source_indices.size();
     const auto number_of_targets = target_indices.size();
     const auto number_of_entries = number_of_sources * number_of_targets;
@@ -194,59 +510,179 @@ manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
     std::vector<EdgeDuration> durations_table(number_of_entries, MAXIMAL_EDGE_DURATION);
     std::vector<EdgeDistance> distances_table(calculate_distance ? number_of_entries : 0,
                                               MAXIMAL_EDGE_DISTANCE);
-    std::vector<NodeID> middle_nodes_table(number_of_entries, SPECIAL_NODEID);
 
-    std::vector<NodeBucket> search_space_with_buckets;
-
-    // Populate buckets with paths from all accessible nodes to destinations via backward searches
-    for (std::uint32_t column_index = 0; column_index < target_indices.size(); ++column_index)
+    struct TargetNode
     {
-        const auto index = target_indices[column_index];
-        const auto &phantom = phantom_nodes[index];
-
-        engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
-            facade.GetNumberOfNodes());
-        auto &query_heap = *(engine_working_data.many_to_many_heap);
-        insertTargetInHeap(query_heap, phantom);
-
-        // Explore search space
-        while (!query_heap.Empty())
+        std::size_t column_index;
+        NodeID node;
+        EdgeWeight weight;
+        EdgeDuration duration;
+        EdgeDistance distance;
+    };
+    std::vector<TargetNode> targets;
+    std::vector<NodeID> target_nodes;
+    for (std::size_t column_index = 0; column_index < number_of_targets; ++column_index)
+    {
+        const auto &phantom = phantom_nodes[target_indices[column_index]];
+        if (phantom.IsValidForwardTarget())
+        {
+            targets.push_back({column_index,
+                               phantom.forward_segment_id.id,
+                               phantom.GetForwardWeightPlusOffset(),
+                               phantom.GetForwardDuration(),
+                               phantom.GetForwardDistance()});
+            target_nodes.push_back(phantom.forward_segment_id.id);
+        }
+        if (phantom.IsValidReverseTarget())
         {
-            backwardRoutingStep(
-                facade, column_index, query_heap, search_space_with_buckets, phantom);
+            targets.push_back({column_index,
+                               phantom.reverse_segment_id.id,
+                               phantom.GetReverseWeightPlusOffset(),
+                               phantom.GetReverseDuration(),
+                               phantom.GetReverseDistance()});
+            target_nodes.push_back(phantom.reverse_segment_id.id);
         }
     }
 
-    // Order lookup buckets
-    std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+    const auto space = ch::selectRestrictedSearchSpace(facade, target_nodes);
+    const auto number_of_nodes = space.nodes.size();
+    const auto number_of_groups = (number_of_sources + SWEEP_LANES - 1) / SWEEP_LANES;
+
+    tbb::enumerable_thread_specific<ch::SweepLanes> thread_lanes;
+    runSearches(number_of_groups, max_parallelism, [&](const std::size_t group) {
+        const auto first_row = group * SWEEP_LANES;
+        const auto number_of_lanes = std::min(SWEEP_LANES, number_of_sources - first_row);
+
+        // the lanes of a thread are allocated by its first group and refilled by the others
+        auto &lanes = thread_lanes.local();
+        lanes.weights.assign(number_of_nodes * SWEEP_LANES, INVALID_EDGE_WEIGHT);
+        lanes.durations.assign(number_of_nodes * SWEEP_LANES, MAXIMAL_EDGE_DURATION);
+        lanes.distances.assign(calculate_distance ? number_of_nodes * SWEEP_LANES : 0,
+                               MAXIMAL_EDGE_DISTANCE);
+        auto &weights = lanes.weights;
+        auto &durations = lanes.durations;
+        auto &distances = lanes.distances;
+
+        // Upward searches from the sources seed the nodes of the restricted space
+        for (std::size_t lane = 0; lane < number_of_lanes; ++lane)
+        {
+            const auto &source_phantom = phantom_nodes[source_indices[first_row + lane]];
 
-    // Find shortest paths from sources to all accessible nodes
-    for (std::uint32_t row_index = 0; row_index < source_indices.size(); ++row_index)
-    {
-        const auto source_index = source_indices[row_index];
-        const auto &source_phantom = phantom_nodes[source_index];
+            engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+                facade.GetNumberOfNodes());
+            auto &query_heap = *(engine_working_data.many_to_many_heap);
+            insertSourceInHeap(query_heap, source_phantom);
 
-        // Clear heap and insert source nodes
-        engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
-            facade.GetNumberOfNodes());
-        auto &query_heap = *(engine_working_data.many_to_many_heap);
-        insertSourceInHeap(query_heap, source_phantom);
+            while (!query_heap.Empty())
+            {
+                checkDeadline();
+                const auto heapNode = query_heap.DeleteMinGetHeapNode();
+                if (limits.Exceeds(heapNode.data.duration, heapNode.data.distance))
+                    continue;
+
+                const auto local_id = space.local_ids.find(heapNode.node);
+                if (local_id != space.local_ids.end())
+                {
+                    const auto index = local_id->second * SWEEP_LANES + lane;
+                    weights[index] = heapNode.weight;
+                    durations[index] = heapNode.data.duration;
+                    if (calculate_distance)
+                        distances[index] = heapNode.data.distance;
+                }
+
+                ch::relaxOutgoingEdges<FORWARD_DIRECTION>(
+                    facade, heapNode, query_heap, source_phantom);
+            }
+        }
 
-        // Explore search space
-        while (!query_heap.Empty())
+        // Downward sweep in topological order, all lanes at once
+        for (std::uint32_t node = 0; node < number_of_nodes; ++node)
         {
-            forwardRoutingStep(facade,
-                               row_index,
-                               number_of_targets,
-                               query_heap,
-                               search_space_with_buckets,
-                               weights_table,
-                               durations_table,
-                               distances_table,
-                               middle_nodes_table,
-                               source_phantom);
+            checkDeadline();
+            const auto to = node * SWEEP_LANES;
+            for (auto edge = space.edge_offsets[node]; edge < space.edge_offsets[node + 1];
+                 ++edge)
+            {
+                const auto &downward_edge = space.edges[edge];
+                const auto from = downward_edge.from * SWEEP_LANES;
+                if (calculate_distance)
+                    ch::relaxDownwardEdge<SWEEP_LANES, true>(downward_edge, from, to, lanes);
+                else
+                    ch::relaxDownwardEdge<SWEEP_LANES, false>(downward_edge, from, to, lanes);
+            }
         }
-    }
+
+        // Collect the tables rows of this group
+        for (const auto &target : targets)
+        {
+            const auto local_id = space.local_ids.at(target.node);
+            for (std::size_t lane = 0; lane < number_of_lanes; ++lane)
+            {
+                const auto index = local_id * SWEEP_LANES + lane;
+                if (weights[index] == INVALID_EDGE_WEIGHT)
+                    continue;
+
+                auto new_weight = weights[index] + target.weight;
+                auto new_duration = durations[index] + target.duration;
+                auto new_distance =
+                    (calculate_distance ? distances[index] : EdgeDistance{0}) + target.distance;
+
+                if (new_weight < 0)
+                {
+                    // The target lies before the source on the same segment, the path has to
+                    // leave the node and come back to it via a loop or from a higher node
+                    auto loop_weight = new_weight;
+                    auto loop_duration = new_duration;
+                    auto loop_distance = new_distance;
+                    if (!ch::addLoopWeight(
+                            facade, target.node, loop_weight, loop_duration, loop_distance))
+                    {
+                        loop_weight = INVALID_EDGE_WEIGHT;
+                    }
+
+                    new_weight = loop_weight;
+                    new_duration = loop_duration;
+                    new_distance = loop_distance;
+                    for (auto edge = space.edge_offsets[local_id];
+                         edge < space.edge_offsets[local_id + 1];
+                         ++edge)
+                    {
+                        const auto &downward_edge = space.edges[edge];
+                        const auto from = downward_edge.from * SWEEP_LANES + lane;
+                        if (weights[from] == INVALID_EDGE_WEIGHT)
+                            continue;
+
+                        const auto via_weight =
+                            weights[from] + downward_edge.weight + target.weight;
+                        const auto via_duration =
+                            durations[from] + downward_edge.duration + target.duration;
+                        if (via_weight >= 0 &&
+                            std::tie(via_weight, via_duration) < std::tie(new_weight, new_duration))
+                        {
+                            new_weight = via_weight;
+                            new_duration = via_duration;
+                            new_distance =
+                                (calculate_distance ? distances[from] : EdgeDistance{0}) +
+                                downward_edge.distance + target.distance;
+                        }
+                    }
+
+                    if (new_weight == INVALID_EDGE_WEIGHT)
+                        continue;
+                }
+
+                const auto location = (first_row + lane) * number_of_targets + target.column_index;
+                if (std::tie(new_weight, new_duration) <
+                    std::tie(weights_table[location], durations_table[location]))
+                {
+                    weights_table[location] = new_weight;
+                    durations_table[location] = new_duration;
+                    if (calculate_distance)
+                        distances_table[location] = new_distance;
+                }
+            }
+        }
+    });
 
     return std::make_pair(std::move(durations_table), std::move(distances_table));
 }
@@ -45,6 +45,7 @@ void relaxBorderEdges(const DataFacade<mld::Algorithm> &facade,
                       typename SearchEngineData<mld::Algorithm>::ManyToManyQueryHeap &query_heap,
                       LevelID level)
 {
+    std::uint64_t relaxed_edges = 0;
     for (const auto edge : facade.GetBorderEdgeRange(level, node))
     {
         const auto &data = facade.GetEdgeData(edge);
@@ -56,6 +57,7 @@ void relaxBorderEdges(const DataFacade<mld::Algorithm> &facade,
             {
                 continue;
             }
+            ++relaxed_edges;
 
             const auto turn_id = data.turn_id;
             const auto node_id = DIRECTION == FORWARD_DIRECTION ? node : facade.GetTarget(edge);
@@ -89,6 +91,7 @@ void relaxBorderEdges(const DataFacade<mld::Algorithm> &facade,
             }
         }
     }
+    query_heap.CountRelaxedEdges(relaxed_edges);
 }
 
 template <bool DIRECTION, typename... Args>
@@ -113,6 +116,7 @@ void relaxOutgoingEdges(
 
     if (level >= 1 && !heapNode.data.from_clique_arc)
     {
+        std::uint64_t overlay_edges = 0;
         const auto &cell = cells.GetCell(metric, level, partition.GetCell(level, heapNode.node));
         if (DIRECTION == FORWARD_DIRECTION)
         { // Shortcuts in forward direction
@@ -128,6 +132,7 @@ void relaxOutgoingEdges(
 
                 if (shortcut_weight != INVALID_EDGE_WEIGHT && heapNode.node != to)
                 {
+                    ++overlay_edges;
                     const auto to_weight = heapNode.weight + shortcut_weight;
                     const auto to_duration = heapNode.data.duration + shortcut_durations.front();
                     const auto to_distance = heapNode.data.distance + shortcut_distances.front();
@@ -169,6 +174,7 @@ void relaxOutgoingEdges(
 
                 if (shortcut_weight != INVALID_EDGE_WEIGHT && heapNode.node != to)
                 {
+                    ++overlay_edges;
                     const auto to_weight = heapNode.weight + shortcut_weight;
                     const auto to_duration = heapNode.data.duration + shortcut_durations.front();
                     const auto to_distance = heapNode.data.distance + shortcut_distances.front();
@@ -196,6 +202,7 @@ void relaxOutgoingEdges(
             BOOST_ASSERT(shortcut_durations.empty());
             BOOST_ASSERT(shortcut_distances.empty());
         }
+        query_heap.CountRelaxedEdges(overlay_edges, overlay_edges);
     }
 
     relaxBorderEdges<DIRECTION>(facade,
@@ -217,7 +224,8 @@ oneToManySearch(SearchEngineData<Algorithm> &engine_working_data,
                 const std::vector<PhantomNode> &phantom_nodes,
                 std::size_t phantom_index,
                 const std::vector<std::size_t> &phantom_indices,
-                const bool calculate_distance)
+                const bool calculate_distance,
+                const TableSearchLimits &limits)
 {
     std::vector<EdgeWeight> weights_table(phantom_indices.size(), INVALID_EDGE_WEIGHT);
     std::vector<EdgeDuration> durations_table(phantom_indices.size(), MAXIMAL_EDGE_DURATION);
@@ -379,10 +387,15 @@ oneToManySearch(SearchEngineData<Algorithm> &engine_working_data,
 
     while (!query_heap.Empty() && !target_nodes_index.empty())
     {
+        checkDeadline();
         // Extract node from the heap. Take a copy (no ref) because otherwise can be modified later
         // if toHeapNode is the same
         const auto heapNode = query_heap.DeleteMinGetHeapNode();
 
+        // Skip nodes beyond the limits, paths via them exceed the limits as well
+        if (limits.Exceeds(heapNode.data.duration, heapNode.data.distance))
+            continue;
+
         // Update values
         update_values(
             heapNode.node, heapNode.weight, heapNode.data.duration, heapNode.data.distance);
@@ -404,23 +417,25 @@ void forwardRoutingStep(const DataFacade<Algorithm> &facade,
                         const unsigned number_of_sources,
                         const unsigned number_of_targets,
                         typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
-                        const std::vector<NodeBucket> &search_space_with_buckets,
+                        const NodeBucketIndex &search_space_with_buckets,
                         std::vector<EdgeWeight> &weights_table,
                         std::vector<EdgeDuration> &durations_table,
                         std::vector<EdgeDistance> &distances_table,
                         std::vector<NodeID> &middle_nodes_table,
-                        const PhantomNode &phantom_node)
+                        const PhantomNode &phantom_node,
+                        const TableSearchLimits &limits)
 {
+    checkDeadline();
     // Take a copy of the extracted node because otherwise could be modified later if toHeapNode is
     // the same
     const auto heapNode = query_heap.DeleteMinGetHeapNode();
 
+    // Paths via a node beyond the limits exceed them as well
+    if (limits.Exceeds(heapNode.data.duration, heapNode.data.distance))
+        return;
+
     // Check if each encountered node has an entry
-    const auto &bucket_list = std::equal_range(search_space_with_buckets.begin(),
-                                               search_space_with_buckets.end(),
-                                               heapNode.node,
-                                               NodeBucket::Compare());
-    for (const auto &current_bucket : boost::make_iterator_range(bucket_list))
+    for (const auto &current_bucket : search_space_with_buckets[heapNode.node])
     {
         // Get target id from bucket entry
         const auto column_idx = current_bucket.column_index;
@@ -463,12 +478,18 @@ void backwardRoutingStep(const DataFacade<Algorithm> &facade,
                          const unsigned column_idx,
                          typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
                          std::vector<NodeBucket> &search_space_with_buckets,
-                         const PhantomNode &phantom_node)
+                         const PhantomNode &phantom_node,
+                         const TableSearchLimits &limits)
 {
+    checkDeadline();
     // Take a copy of the extracted node because otherwise could be modified later if toHeapNode is
     // the same
     const auto heapNode = query_heap.DeleteMinGetHeapNode();
 
+    // Nodes beyond the limits get no bucket and are not expanded
+    if (limits.Exceeds(heapNode.data.duration, heapNode.data.distance))
+        return;
+
     // Store settled nodes in search space bucket
     search_space_with_buckets.emplace_back(heapNode.node,
                                            heapNode.data.parent,
@@ -487,63 +508,42 @@ void backwardRoutingStep(const DataFacade<Algorithm> &facade,
 template <bool DIRECTION>
 void retrievePackedPathFromSearchSpace(NodeID middle_node_id,
                                        const unsigned column_idx,
-                                       const std::vector<NodeBucket> &search_space_with_buckets,
+                                       const NodeBucketIndex &search_space_with_buckets,
                                        PackedPath &path)
 {
-    auto bucket_list = std::equal_range(search_space_with_buckets.begin(),
-                                        search_space_with_buckets.end(),
-                                        middle_node_id,
-                                        NodeBucket::ColumnCompare(column_idx));
+    auto bucket_list = search_space_with_buckets.Find(middle_node_id, column_idx);
 
-    BOOST_ASSERT_MSG(std::distance(bucket_list.first, bucket_list.second) == 1,
-                     "The pointers are not pointing to the same element.");
+    BOOST_ASSERT_MSG(bucket_list.size() == 1, "The bucket of the middle node is missing.");
 
     NodeID current_node_id = middle_node_id;
 
-    while (bucket_list.first->parent_node != current_node_id &&
-           bucket_list.first != search_space_with_buckets.end())
+    while (!bucket_list.empty() && bucket_list.front().parent_node != current_node_id)
     {
-        const auto parent_node_id = bucket_list.first->parent_node;
+        const auto parent_node_id = bucket_list.front().parent_node;
 
         const auto from = DIRECTION == FORWARD_DIRECTION ? current_node_id : parent_node_id;
         const auto to = DIRECTION == FORWARD_DIRECTION ? parent_node_id : current_node_id;
-        path.emplace_back(std::make_tuple(from, to, bucket_list.first->from_clique_arc));
+        path.emplace_back(std::make_tuple(from, to, bucket_list.front().from_clique_arc));
 
         current_node_id = parent_node_id;
-        bucket_list = std::equal_range(search_space_with_buckets.begin(),
-                                       search_space_with_buckets.end(),
-                                       current_node_id,
-                                       NodeBucket::ColumnCompare(column_idx));
+        bucket_list = search_space_with_buckets.Find(current_node_id, column_idx);
 
-        BOOST_ASSERT_MSG(std::distance(bucket_list.first, bucket_list.second) == 1,
-                         "The pointers are not pointing to the same element.");
+        BOOST_ASSERT_MSG(bucket_list.size() == 1, "The bucket of the parent node is missing.");
     }
 }
 
+// Populate buckets with paths from all accessible nodes to destinations via backward searches
 template <bool DIRECTION>
-std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
-manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
-                 const DataFacade<Algorithm> &facade,
-                 const std::vector<PhantomNode> &phantom_nodes,
-                 const std::vector<std::size_t> &source_indices,
-                 const std::vector<std::size_t> &target_indices,
-                 const bool calculate_distance)
+NodeBucketIndex makeSearchSpaceWithBuckets(SearchEngineData<Algorithm> &engine_working_data,
+                                           const DataFacade<Algorithm> &facade,
+                                           const std::vector<PhantomNode> &phantom_nodes,
+                                           const std::vector<std::size_t> &target_indices,
+                                           const std::size_t max_parallelism,
+                                           const TableSearchLimits &limits)
 {
-    const auto number_of_sources = source_indices.size();
-    const auto number_of_targets = target_indices.size();
-    const auto number_of_entries = number_of_sources * number_of_targets;
-
-    std::vector<EdgeWeight> weights_table(number_of_entries, INVALID_EDGE_WEIGHT);
-    std::vector<EdgeDuration> durations_table(number_of_entries, MAXIMAL_EDGE_DURATION);
-    std::vector<EdgeDistance> distances_table(calculate_distance ? number_of_entries : 0,
-                                              INVALID_EDGE_DISTANCE);
-    std::vector<NodeID> middle_nodes_table(number_of_entries, SPECIAL_NODEID);
-
-    std::vector<NodeBucket> search_space_with_buckets;
+    std::vector<std::vector<NodeBucket>> column_buckets(target_indices.size());
 
-    // Populate buckets with paths from all accessible nodes to destinations via backward searches
-    for (std::uint32_t column_idx = 0; column_idx < target_indices.size(); ++column_idx)
-    {
+    runSearches(target_indices.size(), max_parallelism, [&](const std::size_t column_idx) {
         const auto index = target_indices[column_idx];
         const auto &target_phantom = phantom_nodes[index];
 
@@ -556,20 +556,48 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
         else
             insertSourceInHeap(query_heap, target_phantom);
 
+        auto &search_space_with_buckets = column_buckets[column_idx];
+
         // explore search space
         while (!query_heap.Empty())
         {
-            backwardRoutingStep<DIRECTION>(
-                facade, column_idx, query_heap, search_space_with_buckets, target_phantom);
+            backwardRoutingStep<DIRECTION>(facade,
+                                           column_idx,
+                                           query_heap,
+                                           search_space_with_buckets,
+                                           target_phantom,
+                                           limits);
         }
-    }
+    });
 
-    // Order lookup buckets
-    std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+    // Group lookup buckets by node
+    return NodeBucketIndex(column_buckets);
+}
 
-    // Find shortest paths from sources to all accessible nodes
-    for (std::uint32_t row_idx = 0; row_idx < source_indices.size(); ++row_idx)
-    {
+// Find shortest paths from sources to all accessible nodes,
+// every search writes only to its own (possibly transposed) row of the tables
+template <bool DIRECTION>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+searchRows(SearchEngineData<Algorithm> &engine_working_data,
+           const DataFacade<Algorithm> &facade,
+           const std::vector<PhantomNode> &phantom_nodes,
+           const std::vector<std::size_t> &source_indices,
+           const std::size_t number_of_targets,
+           const bool calculate_distance,
+           const std::size_t max_parallelism,
+           const TableSearchLimits &limits,
+           const NodeBucketIndex &search_space_with_buckets)
+{
+    const auto number_of_sources = source_indices.size();
+    const auto number_of_entries = number_of_sources * number_of_targets;
+
+    std::vector<EdgeWeight> weights_table(number_of_entries, INVALID_EDGE_WEIGHT);
+    std::vector<EdgeDuration> durations_table(number_of_entries, MAXIMAL_EDGE_DURATION);
+    std::vector<EdgeDistance> distances_table(calculate_distance ? number_of_entries : 0,
+                                              INVALID_EDGE_DISTANCE);
+    std::vector<NodeID> middle_nodes_table(number_of_entries, SPECIAL_NODEID);
+
+    runSearches(number_of_sources, max_parallelism, [&](const std::size_t row_idx) {
         const auto source_index = source_indices[row_idx];
         const auto &source_phantom = phantom_nodes[source_index];
 
@@ -597,13 +625,39 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
                                           durations_table,
                                           distances_table,
                                           middle_nodes_table,
-                                          source_phantom);
+                                          source_phantom,
+                                          limits);
         }
-    }
+    });
 
     return std::make_pair(std::move(durations_table), std::move(distances_table));
 }
 
+template <bool DIRECTION>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
+                 const DataFacade<Algorithm> &facade,
+                 const std::vector<PhantomNode> &phantom_nodes,
+                 const std::vector<std::size_t> &source_indices,
+                 const std::vector<std::size_t> &target_indices,
+                 const bool calculate_distance,
+                 const std::size_t max_parallelism,
+                 const TableSearchLimits &limits)
+{
+    const auto search_space_with_buckets = makeSearchSpaceWithBuckets<DIRECTION>(
+        engine_working_data, facade, phantom_nodes, target_indices, max_parallelism, limits);
+
+    return searchRows<DIRECTION>(engine_working_data,
+                                 facade,
+                                 phantom_nodes,
+                                 source_indices,
+                                 target_indices.size(),
+                                 calculate_distance,
+                                 max_parallelism,
+                                 limits,
+                                 search_space_with_buckets);
+}
+
 } // namespace mld
 
 // Dispatcher function for one-to-many and many-to-one tasks that can be handled by MLD differently:
@@ -625,7 +679,10 @@ manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                  const std::vector<PhantomNode> &phantom_nodes,
                  const std::vector<std::size_t> &source_indices,
                  const std::vector<std::size_t> &target_indices,
-                 const bool calculate_distance)
+                 const bool calculate_distance,
+                 const std::size_t max_parallelism,
+                 const TableSearchLimits &limits,
+                 const TableBucketCacheRef & /*bucket_cache*/)
 {
     if (source_indices.size() == 1)
     { // TODO: check if target_indices.size() == 1 and do a bi-directional search
@@ -634,7 +691,8 @@ manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                                                        phantom_nodes,
                                                        source_indices.front(),
                                                        target_indices,
-                                                       calculate_distance);
+                                                       calculate_distance,
+                                                       limits);
     }
 
     if (target_indices.size() == 1)
@@ -644,7 +702,8 @@ manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                                                        phantom_nodes,
                                                        target_indices.front(),
                                                        source_indices,
-                                                       calculate_distance);
+                                                       calculate_distance,
+                                                       limits);
     }
 
     if (target_indices.size() < source_indices.size())
@@ -654,7 +713,9 @@ manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                                                         phantom_nodes,
                                                         target_indices,
                                                         source_indices,
-                                                        calculate_distance);
+                                                        calculate_distance,
+                                                        max_parallelism,
+                                                        limits);
     }
 
     return mld::manyToManySearch<FORWARD_DIRECTION>(engine_working_data,
@@ -662,7 +723,74 @@ manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                                                     phantom_nodes,
                                                     source_indices,
                                                     target_indices,
-                                                    calculate_distance);
+                                                    calculate_distance,
+                                                    max_parallelism,
+                                                    limits);
+}
+
+// Tables of a single block are searched as a whole, so they use the same search as
+// manyToManySearch. Otherwise the backward searches of the targets run once and the forward
+// searches of the sources run per block of rows, which rules out the transposed search.
+template <>
+void manyToManyBlockSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
+                           const DataFacade<mld::Algorithm> &facade,
+                           const std::vector<PhantomNode> &phantom_nodes,
+                           const std::vector<std::size_t> &source_indices,
+                           const std::vector<std::size_t> &target_indices,
+                           const bool calculate_distance,
+                           const std::size_t max_parallelism,
+                           const TableSearchLimits &limits,
+                           const TableBucketCacheRef &bucket_cache,
+                           const std::size_t rows_per_block,
+                           const TableBlockHandler &handle_block)
+{
+    BOOST_ASSERT(rows_per_block > 0);
+    if (source_indices.size() <= rows_per_block || target_indices.size() == 1)
+    {
+        for (std::size_t first_row = 0; first_row < source_indices.size();
+             first_row += rows_per_block)
+        {
+            const auto last_row = std::min(first_row + rows_per_block, source_indices.size());
+            const std::vector<std::size_t> block_source_indices(
+                source_indices.begin() + first_row, source_indices.begin() + last_row);
+            auto block = manyToManySearch(engine_working_data,
+                                          facade,
+                                          phantom_nodes,
+                                          block_source_indices,
+                                          target_indices,
+                                          calculate_distance,
+                                          max_parallelism,
+                                          limits,
+                                          bucket_cache);
+            handle_block(first_row, block.first, block.second);
+        }
+        return;
+    }
+
+    const auto search_space_with_buckets =
+        mld::makeSearchSpaceWithBuckets<FORWARD_DIRECTION>(engine_working_data,
+                                                           facade,
+                                                           phantom_nodes,
+                                                           target_indices,
+                                                           max_parallelism,
+                                                           limits);
+
+    for (std::size_t first_row = 0; first_row < source_indices.size(); first_row += rows_per_block)
+    {
+        const auto last_row = std::min(first_row + rows_per_block, source_indices.size());
+        const std::vector<std::size_t> block_source_indices(source_indices.begin() + first_row,
+                                                            source_indices.begin() + last_row);
+        auto block = mld::searchRows<FORWARD_DIRECTION>(engine_working_data,
+                                                        facade,
+                                                        phantom_nodes,
+                                                        block_source_indices,
+                                                        target_indices.size(),
+                                                        calculate_distance,
+                                                        max_parallelism,
+                                                        limits,
+                                                        search_space_with_buckets);
+        handle_block(first_row, block.first, block.second);
+    }
 }
 
 } // namespace routing_algorithms
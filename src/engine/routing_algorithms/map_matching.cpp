@@ -161,6 +161,7 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
     prev_unbroken_timestamps.push_back(initial_timestamp);
     for (auto t = initial_timestamp + 1; t < candidates_list.size(); ++t)
     {
+        checkDeadline();
 
         const auto step_time = [&] {
             if (use_timestamps)
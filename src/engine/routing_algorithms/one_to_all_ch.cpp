@@ -0,0 +1,231 @@
+#include "engine/routing_algorithms/one_to_all.hpp"
+#include "engine/routing_algorithms/routing_base_ch.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+namespace ch
+{
+
+std::size_t DownwardGraph::GetSizeInBytes() const
+{
+    return positions.capacity() * sizeof(std::uint32_t) +
+           edge_offsets.capacity() * sizeof(std::uint32_t) + edges.capacity() * sizeof(Edge);
+}
+
+DownwardGraph makeDownwardGraph(const DataFacade<Algorithm> &facade)
+{
+    const auto number_of_nodes = facade.GetNumberOfNodes();
+    DownwardGraph graph;
+
+    // A downward edge from an upper node is stored at its lower node with the backward flag
+    graph.edge_offsets.assign(number_of_nodes + 1, 0);
+    for (NodeID node = 0; node < number_of_nodes; ++node)
+    {
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            const auto upper = facade.GetTarget(edge);
+            if (facade.GetEdgeData(edge).backward && upper != node)
+                ++graph.edge_offsets[upper + 1];
+        }
+    }
+    std::partial_sum(
+        graph.edge_offsets.begin(), graph.edge_offsets.end(), graph.edge_offsets.begin());
+
+    graph.edges.resize(graph.edge_offsets.back());
+    auto edge_ends = graph.edge_offsets;
+    for (NodeID node = 0; node < number_of_nodes; ++node)
+    {
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = facade.GetEdgeData(edge);
+            const auto upper = facade.GetTarget(edge);
+            if (data.backward && upper != node)
+                graph.edges[edge_ends[upper]++] = {node, data.weight, data.duration};
+        }
+    }
+
+    // Depth-first search along the upward edges, a node gets its position after all nodes above
+    // it have been numbered (post-order), like the restricted search spaces of RPHAST sweeps
+    const constexpr auto UNVISITED = std::numeric_limits<std::uint32_t>::max();
+    const constexpr auto EXPANDED = UNVISITED - 1;
+    graph.positions.assign(number_of_nodes, UNVISITED);
+    std::uint32_t next_position = 0;
+    std::vector<std::pair<NodeID, bool>> stack;
+    for (NodeID root = 0; root < number_of_nodes; ++root)
+    {
+        stack.emplace_back(root, false);
+        while (!stack.empty())
+        {
+            const auto node = stack.back().first;
+            const auto finished = stack.back().second;
+            stack.pop_back();
+
+            if (finished)
+            {
+                graph.positions[node] = next_position++;
+                continue;
+            }
+
+            if (graph.positions[node] != UNVISITED)
+                continue;
+            graph.positions[node] = EXPANDED;
+
+            stack.emplace_back(node, true);
+            for (const auto edge : facade.GetAdjacentEdgeRange(node))
+            {
+                const auto upper = facade.GetTarget(edge);
+                if (facade.GetEdgeData(edge).backward && upper != node &&
+                    graph.positions[upper] == UNVISITED)
+                    stack.emplace_back(upper, false);
+            }
+        }
+    }
+    BOOST_ASSERT(next_position == number_of_nodes);
+
+    return graph;
+}
+
+} // namespace ch
+
+std::shared_ptr<const ch::DownwardGraph>
+DownwardGraphCache::Get(const std::shared_ptr<const DataFacade<ch::Algorithm>> &dataset)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    entries.erase(std::remove_if(entries.begin(),
+                                 entries.end(),
+                                 [](const Entry &entry) { return entry.dataset.expired(); }),
+                  entries.end());
+
+    const std::shared_ptr<const void> dataset_key = dataset;
+    const auto entry = std::find_if(entries.begin(), entries.end(), [&](const Entry &entry) {
+        return !entry.dataset.owner_before(dataset_key) &&
+               !dataset_key.owner_before(entry.dataset);
+    });
+    if (entry != entries.end())
+        return entry->graph;
+
+    // searches on other datasets wait for the graph, it is built only once per dataset
+    auto graph = std::make_shared<const ch::DownwardGraph>(ch::makeDownwardGraph(*dataset));
+    entries.push_back({dataset_key, graph});
+    return graph;
+}
+
+std::vector<ReachableNode> oneToAllSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                                          const DataFacade<ch::Algorithm> &facade,
+                                          const ch::DownwardGraph &downward_graph,
+                                          const PhantomNode &source_phantom,
+                                          const EdgeDuration max_duration)
+{
+    std::vector<ReachableNode> reachable_nodes;
+
+    // The labels of all nodes are kept in the many-to-many heap, its queue orders the upward
+    // search by weight
+    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(facade.GetNumberOfNodes());
+    auto &labels = *(engine_working_data.many_to_many_heap);
+    insertSourceInHeap(labels, source_phantom);
+
+    // The sweep visits the reached nodes in the topological order of the downward graph
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
+    auto &sweep_queue = *(engine_working_data.forward_heap_1);
+    const auto enqueue = [&](const NodeID node) {
+        if (!sweep_queue.WasInserted(node))
+            sweep_queue.Insert(node, downward_graph.positions[node], node);
+    };
+
+    // Upward search, nodes beyond max_duration are not expanded
+    while (!labels.Empty())
+    {
+        checkDeadline();
+        const auto heapNode = labels.DeleteMinGetHeapNode();
+        if (heapNode.data.duration > max_duration)
+            continue;
+
+        enqueue(heapNode.node);
+        for (const auto edge : facade.GetAdjacentEdgeRange(heapNode.node))
+        {
+            const auto &data = facade.GetEdgeData(edge);
+            if (!data.forward)
+                continue;
+
+            const auto to = facade.GetTarget(edge);
+            const auto to_weight = heapNode.weight + data.weight;
+            const auto to_duration = heapNode.data.duration + data.duration;
+            const auto toHeapNode = labels.GetHeapNodeIfWasInserted(to);
+            if (!toHeapNode)
+            {
+                labels.Insert(to, to_weight, {heapNode.node, to_duration, 0});
+            }
+            else if (std::tie(to_weight, to_duration) <
+                     std::tie(toHeapNode->weight, toHeapNode->data.duration))
+            {
+                toHeapNode->data = {heapNode.node, to_duration, 0};
+                toHeapNode->weight = to_weight;
+                labels.DecreaseKey(*toHeapNode);
+            }
+        }
+    }
+
+    // Downward sweep. A node is taken from the queue after all reached nodes above it, so its
+    // label is final. The upward search is done, so labels are updated without their queue.
+    while (!sweep_queue.Empty())
+    {
+        checkDeadline();
+        const auto node = sweep_queue.DeleteMin();
+        const auto &label = *labels.GetHeapNodeIfWasInserted(node);
+        if (label.data.duration > max_duration)
+            continue;
+
+        reachable_nodes.emplace_back(node, std::max(label.data.duration, EdgeDuration{0}));
+        const auto weight = label.weight;
+        const auto duration = label.data.duration;
+        for (auto edge = downward_graph.edge_offsets[node];
+             edge < downward_graph.edge_offsets[node + 1];
+             ++edge)
+        {
+            const auto &downward_edge = downward_graph.edges[edge];
+            const auto to_weight = weight + downward_edge.weight;
+            const auto to_duration = duration + downward_edge.duration;
+            if (to_duration > max_duration)
+                continue;
+
+            const auto toHeapNode = labels.GetHeapNodeIfWasInserted(downward_edge.target);
+            if (!toHeapNode)
+            {
+                labels.Insert(downward_edge.target, to_weight, {node, to_duration, 0});
+            }
+            else if (std::tie(to_weight, to_duration) <
+                     std::tie(toHeapNode->weight, toHeapNode->data.duration))
+            {
+                toHeapNode->data = {node, to_duration, 0};
+                toHeapNode->weight = to_weight;
+            }
+            enqueue(downward_edge.target);
+        }
+    }
+
+    std::sort(reachable_nodes.begin(),
+              reachable_nodes.end(),
+              [](const ReachableNode &lhs, const ReachableNode &rhs) {
+                  return lhs.second < rhs.second;
+              });
+    return reachable_nodes;
+}
+
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
@@ -0,0 +1,106 @@
+#include "engine/routing_algorithms/one_to_all.hpp"
+#include "engine/routing_algorithms/routing_base_mld.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+namespace mld
+{
+
+// Plain Dijkstra on the base graph keyed by duration. The overlay cliques skip the interior of
+// cells, but an isochrone has to report the interior nodes as well, so they are of no use here.
+void relaxBaseEdges(const DataFacade<Algorithm> &facade,
+                    const NodeID node,
+                    const EdgeDuration duration,
+                    typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
+                    const EdgeDuration max_duration)
+{
+    const auto node_duration = facade.GetNodeDuration(node);
+
+    for (const auto edge : facade.GetBorderEdgeRange(0, node))
+    {
+        if (!facade.IsForwardEdge(edge))
+            continue;
+
+        const NodeID to = facade.GetTarget(edge);
+        if (facade.ExcludeNode(to))
+            continue;
+
+        const auto turn_id = facade.GetEdgeData(edge).turn_id;
+        const auto to_duration =
+            duration + node_duration + facade.GetDurationPenaltyForEdgeID(turn_id);
+        if (to_duration > max_duration)
+            continue;
+
+        const auto toHeapNode = query_heap.GetHeapNodeIfWasInserted(to);
+        if (!toHeapNode)
+        {
+            query_heap.Insert(to, to_duration, {node, false, to_duration, 0});
+        }
+        else if (to_duration < toHeapNode->weight)
+        {
+            toHeapNode->data = {node, false, to_duration, 0};
+            toHeapNode->weight = to_duration;
+            query_heap.DecreaseKey(*toHeapNode);
+        }
+    }
+}
+
+} // namespace mld
+
+template <>
+std::vector<ReachableNode>
+oneToAllSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
+               const DataFacade<mld::Algorithm> &facade,
+               const PhantomNode &source_phantom,
+               const EdgeDuration max_duration)
+{
+    std::vector<ReachableNode> reachable_nodes;
+
+    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+        facade.GetNumberOfNodes(), facade.GetMaxBorderNodeID() + 1);
+    auto &query_heap = *(engine_working_data.many_to_many_heap);
+
+    // The heap is keyed by duration: the source nodes start at the negated duration of the part
+    // of their segment that lies behind the phantom node
+    if (source_phantom.IsValidForwardSource())
+    {
+        const auto duration = -source_phantom.GetForwardDuration();
+        query_heap.Insert(source_phantom.forward_segment_id.id,
+                          duration,
+                          {source_phantom.forward_segment_id.id, false, duration, 0});
+    }
+    if (source_phantom.IsValidReverseSource())
+    {
+        const auto duration = -source_phantom.GetReverseDuration();
+        query_heap.Insert(source_phantom.reverse_segment_id.id,
+                          duration,
+                          {source_phantom.reverse_segment_id.id, false, duration, 0});
+    }
+
+    while (!query_heap.Empty())
+    {
+        checkDeadline();
+        const auto node = query_heap.DeleteMin();
+        const auto duration = query_heap.GetKey(node);
+        BOOST_ASSERT(duration <= max_duration);
+
+        reachable_nodes.emplace_back(node, std::max(duration, EdgeDuration{0}));
+        mld::relaxBaseEdges(facade, node, duration, query_heap, max_duration);
+    }
+
+    return reachable_nodes;
+}
+
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
@@ -0,0 +1,202 @@
+#include "engine/routing_algorithms/overlay_path_cache.hpp"
+
+#include "util/std_hash.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tuple>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+namespace
+{
+// Bookkeeping of a path besides its vectors: list node, index node and the shared path
+const constexpr std::size_t PATH_OVERHEAD_IN_BYTES = 128;
+
+std::size_t getSizeInBytes(const OverlayPathCache::Path &path)
+{
+    return PATH_OVERHEAD_IN_BYTES + path.nodes.capacity() * sizeof(NodeID) +
+           path.edges.capacity() * sizeof(EdgeID);
+}
+
+struct CurrentCache
+{
+    OverlayPathCache *cache = nullptr;
+    const void *dataset = nullptr;
+};
+thread_local CurrentCache current_cache;
+} // namespace
+
+bool OverlayPathCache::Key::operator==(const Key &other) const
+{
+    return std::tie(dataset, level, source, target, force_loop_forward, force_loop_reverse) ==
+           std::tie(other.dataset,
+                    other.level,
+                    other.source,
+                    other.target,
+                    other.force_loop_forward,
+                    other.force_loop_reverse);
+}
+
+std::size_t OverlayPathCache::KeyHash::operator()(const Key &key) const
+{
+    return hash_val(key.dataset,
+                    key.level,
+                    key.source,
+                    key.target,
+                    key.force_loop_forward,
+                    key.force_loop_reverse);
+}
+
+OverlayPathCache::OverlayPathCache(const std::size_t max_size_in_bytes)
+    : max_shard_size_in_bytes(max_size_in_bytes / NUMBER_OF_SHARDS)
+{
+}
+
+void OverlayPathCache::AddDataset(const std::shared_ptr<const void> &dataset)
+{
+    BOOST_ASSERT(dataset);
+    std::lock_guard<std::mutex> guard(datasets_lock);
+
+    bool is_added = false;
+    for (auto position = datasets.begin(); position != datasets.end();)
+    {
+        if (position->dataset.expired())
+        {
+            RemovePaths(position->address);
+            position = datasets.erase(position);
+        }
+        else
+        {
+            is_added |= position->address == dataset.get();
+            ++position;
+        }
+    }
+
+    if (!is_added)
+    {
+        datasets.push_back(Dataset{dataset, dataset.get()});
+    }
+}
+
+void OverlayPathCache::RemovePaths(const void *dataset)
+{
+    for (auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        for (auto entry = shard.entries.begin(); entry != shard.entries.end();)
+        {
+            if (entry->first.dataset == dataset)
+            {
+                shard.size_in_bytes -= getSizeInBytes(*entry->second);
+                shard.index.erase(entry->first);
+                entry = shard.entries.erase(entry);
+            }
+            else
+            {
+                ++entry;
+            }
+        }
+    }
+}
+
+OverlayPathCache::Shard &OverlayPathCache::GetShard(const Key &key)
+{
+    return shards[KeyHash()(key) % NUMBER_OF_SHARDS];
+}
+
+OverlayPathCache::PathPtr OverlayPathCache::Find(const Key &key)
+{
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    const auto position = shard.index.find(key);
+    if (position == shard.index.end())
+    {
+        return nullptr;
+    }
+    // move to the front as the most recently used path
+    shard.entries.splice(shard.entries.begin(), shard.entries, position->second);
+    return position->second->second;
+}
+
+void OverlayPathCache::Insert(const Key &key, PathPtr path)
+{
+    BOOST_ASSERT(path);
+    const auto path_size = getSizeInBytes(*path);
+    if (path_size > max_shard_size_in_bytes)
+    {
+        return;
+    }
+
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    const auto position = shard.index.find(key);
+    if (position != shard.index.end())
+    {
+        // a concurrent query unpacked the same overlay edge
+        shard.entries.splice(shard.entries.begin(), shard.entries, position->second);
+        return;
+    }
+
+    while (shard.size_in_bytes + path_size > max_shard_size_in_bytes)
+    {
+        BOOST_ASSERT(!shard.entries.empty());
+        const auto &oldest = shard.entries.back();
+        shard.size_in_bytes -= getSizeInBytes(*oldest.second);
+        shard.index.erase(oldest.first);
+        shard.entries.pop_back();
+    }
+
+    shard.entries.emplace_front(key, std::move(path));
+    shard.index.emplace(key, shard.entries.begin());
+    shard.size_in_bytes += path_size;
+}
+
+std::size_t OverlayPathCache::GetSizeInBytes() const
+{
+    std::size_t size = 0;
+    for (const auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        size += shard.size_in_bytes;
+    }
+    return size;
+}
+
+OverlayPathCacheScope::OverlayPathCacheScope(OverlayPathCache &cache,
+                                             const std::shared_ptr<const void> &dataset)
+    : previous_cache(current_cache.cache), previous_dataset(current_cache.dataset)
+{
+    if (cache.IsEnabled() && dataset)
+    {
+        cache.AddDataset(dataset);
+        current_cache.cache = &cache;
+        current_cache.dataset = dataset.get();
+    }
+    else
+    {
+        current_cache.cache = nullptr;
+        current_cache.dataset = nullptr;
+    }
+}
+
+OverlayPathCacheScope::~OverlayPathCacheScope()
+{
+    current_cache.cache = previous_cache;
+    current_cache.dataset = previous_dataset;
+}
+
+OverlayPathCache *OverlayPathCacheScope::Current(const void *dataset)
+{
+    return current_cache.dataset == dataset ? current_cache.cache : nullptr;
+}
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
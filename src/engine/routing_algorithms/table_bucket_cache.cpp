@@ -0,0 +1,171 @@
+#include "engine/routing_algorithms/table_bucket_cache.hpp"
+#include "engine/routing_algorithms/many_to_many.hpp"
+
+#include "util/std_hash.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+namespace
+{
+std::size_t getIndexHash(const void *dataset, const TableBucketCache::Key &key)
+{
+    return hash_val(dataset, key.GetHash());
+}
+
+bool isSameDataset(const std::weak_ptr<const void> &lhs, const std::shared_ptr<const void> &rhs)
+{
+    return !lhs.owner_before(rhs) && !rhs.owner_before(lhs);
+}
+} // namespace
+
+TableBucketCache::Key::Key(const std::vector<PhantomNode> &phantom_nodes,
+                           const std::vector<std::size_t> &target_indices,
+                           const TableSearchLimits &limits)
+    : max_duration(limits.max_duration), max_distance(limits.max_distance)
+{
+    targets.reserve(target_indices.size());
+    for (const auto index : target_indices)
+    {
+        const auto &phantom = phantom_nodes[index];
+        Target target{SPECIAL_NODEID, SPECIAL_NODEID, 0, 0, 0, 0, 0, 0};
+        if (phantom.IsValidForwardTarget())
+        {
+            target.forward_node = phantom.forward_segment_id.id;
+            target.forward_weight = phantom.GetForwardWeightPlusOffset();
+            target.forward_duration = phantom.GetForwardDuration();
+            target.forward_distance = phantom.GetForwardDistance();
+        }
+        if (phantom.IsValidReverseTarget())
+        {
+            target.reverse_node = phantom.reverse_segment_id.id;
+            target.reverse_weight = phantom.GetReverseWeightPlusOffset();
+            target.reverse_duration = phantom.GetReverseDuration();
+            target.reverse_distance = phantom.GetReverseDistance();
+        }
+        hash_val(hash,
+                 target.forward_node,
+                 target.reverse_node,
+                 target.forward_weight,
+                 target.reverse_weight);
+        targets.push_back(target);
+    }
+    hash_combine(hash, max_duration);
+}
+
+TableBucketCache::TableBucketCache(const std::size_t max_size_in_bytes)
+    : max_size_in_bytes(max_size_in_bytes), size_in_bytes(0)
+{
+}
+
+std::shared_ptr<const NodeBucketIndex>
+TableBucketCache::Find(const std::shared_ptr<const void> &dataset, const Key &key)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    UpdateDatasets(dataset);
+
+    const auto entry = FindEntry(dataset, key);
+    if (entry == entries.end())
+        return nullptr;
+
+    // move to the front as the most recently used entry
+    entries.splice(entries.begin(), entries, entry);
+    return entry->buckets;
+}
+
+void TableBucketCache::Insert(const std::shared_ptr<const void> &dataset,
+                              Key key,
+                              std::shared_ptr<const NodeBucketIndex> buckets)
+{
+    const auto entry_size = key.GetSizeInBytes() + buckets->GetSizeInBytes();
+    if (entry_size > max_size_in_bytes)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    UpdateDatasets(dataset);
+
+    // A concurrent request with the same targets may have added them already
+    if (FindEntry(dataset, key) != entries.end())
+        return;
+
+    while (size_in_bytes + entry_size > max_size_in_bytes)
+    {
+        BOOST_ASSERT(!entries.empty());
+        RemoveEntry(std::prev(entries.end()));
+    }
+
+    const auto index_hash = getIndexHash(dataset.get(), key);
+    entries.push_front(
+        Entry{dataset, dataset.get(), std::move(key), std::move(buckets), entry_size});
+    index.emplace(index_hash, entries.begin());
+    size_in_bytes += entry_size;
+}
+
+std::size_t TableBucketCache::GetSizeInBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return size_in_bytes;
+}
+
+TableBucketCache::LRUList::iterator
+TableBucketCache::FindEntry(const std::shared_ptr<const void> &dataset, const Key &key)
+{
+    const auto range = index.equal_range(getIndexHash(dataset.get(), key));
+    const auto position = std::find_if(range.first, range.second, [&](const auto &indexed) {
+        const auto &entry = *indexed.second;
+        return isSameDataset(entry.dataset, dataset) && entry.key == key;
+    });
+    return position == range.second ? entries.end() : position->second;
+}
+
+void TableBucketCache::RemoveEntry(const LRUList::iterator entry)
+{
+    const auto range = index.equal_range(getIndexHash(entry->address, entry->key));
+    const auto position = std::find_if(
+        range.first, range.second, [&](const auto &indexed) { return indexed.second == entry; });
+    BOOST_ASSERT(position != range.second);
+    index.erase(position);
+
+    size_in_bytes -= entry->size_in_bytes;
+    entries.erase(entry);
+}
+
+void TableBucketCache::UpdateDatasets(const std::shared_ptr<const void> &dataset)
+{
+    bool is_added = false;
+    for (auto position = datasets.begin(); position != datasets.end();)
+    {
+        if (position->dataset.expired())
+        {
+            for (auto entry = entries.begin(); entry != entries.end();)
+            {
+                const auto next = std::next(entry);
+                if (entry->address == position->address)
+                    RemoveEntry(entry);
+                entry = next;
+            }
+            position = datasets.erase(position);
+        }
+        else
+        {
+            is_added |= position->address == dataset.get();
+            ++position;
+        }
+    }
+
+    if (!is_added)
+    {
+        datasets.push_back(Dataset{dataset, dataset.get()});
+    }
+}
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
@@ -1,93 +1,140 @@
 #include "engine/search_engine_data.hpp"
 
+#include <algorithm>
+#include <atomic>
+
 namespace osrm
 {
 namespace engine
 {
 
-// CH heaps
-using CH = routing_algorithms::ch::Algorithm;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_1;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_1;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_2;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_2;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_3;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_3;
-SearchEngineData<CH>::ManyToManyHeapPtr SearchEngineData<CH>::many_to_many_heap;
+namespace
+{
+// Heaps are only created by the threads that need them
+template <typename HeapPtr> util::QueryHeapCounters getCounters(const HeapPtr &heap)
+{
+    return heap.get() ? heap->GetCounters() : util::QueryHeapCounters{};
+}
 
-void SearchEngineData<CH>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
+template <typename HeapPtr> std::size_t getSizeInBytes(const HeapPtr &heap)
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
+    return heap.get() ? heap->GetSizeInBytes() : 0;
+}
+
+std::atomic<std::size_t> max_heap_bytes{0};
+std::atomic<std::size_t> heap_bytes{0};
+std::atomic<std::size_t> peak_heap_bytes{0};
+std::atomic<std::size_t> number_of_threads{0};
+std::atomic<std::uint64_t> shrunk_heaps{0};
+std::atomic<std::uint64_t> freed_bytes{0};
+
+// Heaps of a thread as they are accounted for in heap_bytes and number_of_threads
+struct ThreadHeapBytes
+{
+    // the heaps are destroyed with their thread
+    ~ThreadHeapBytes()
     {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
+        if (has_heaps)
+        {
+            heap_bytes.fetch_sub(bytes);
+            number_of_threads.fetch_sub(1);
+        }
     }
 
-    if (reverse_heap_1.get())
+    std::size_t bytes = 0;
+    bool has_heaps = false;
+};
+thread_local ThreadHeapBytes thread_heap_bytes;
+
+template <typename HeapPtr, typename... Sizes>
+void initializeOrClear(HeapPtr &heap, const Sizes... sizes)
+{
+    if (!heap.get())
     {
-        reverse_heap_1->Clear();
+        if (!thread_heap_bytes.has_heaps)
+        {
+            thread_heap_bytes.has_heaps = true;
+            number_of_threads.fetch_add(1);
+        }
+        heap.reset(new typename HeapPtr::element_type(sizes...));
     }
     else
     {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
+        heap->Clear();
     }
 }
 
-void SearchEngineData<CH>::InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes)
+template <typename HeapPtr> void shrinkHeap(HeapPtr &heap)
 {
-    if (forward_heap_2.get())
+    if (!heap.get())
     {
-        forward_heap_2->Clear();
-    }
-    else
-    {
-        forward_heap_2.reset(new QueryHeap(number_of_nodes));
+        return;
     }
 
-    if (reverse_heap_2.get())
-    {
-        reverse_heap_2->Clear();
-    }
-    else
-    {
-        reverse_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
+    const auto bytes = heap->GetSizeInBytes();
+    heap->Shrink();
+    const auto shrunk_bytes = heap->GetSizeInBytes();
+    shrunk_heaps.fetch_add(1);
+    freed_bytes.fetch_add(bytes > shrunk_bytes ? bytes - shrunk_bytes : 0);
 }
 
-void SearchEngineData<CH>::InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes)
+template <typename HeapPtr> std::size_t getGrowthInBytes(const HeapPtr &heap)
 {
-    if (forward_heap_3.get())
-    {
-        forward_heap_3->Clear();
-    }
-    else
-    {
-        forward_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
+    return heap.get() ? heap->GetGrowthInBytes() : 0;
+}
+} // namespace
 
-    if (reverse_heap_3.get())
-    {
-        reverse_heap_3->Clear();
-    }
-    else
-    {
-        reverse_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
+// CH heaps
+using CH = routing_algorithms::ch::Algorithm;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_1;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_1;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_2;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_2;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_3;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_3;
+SearchEngineData<CH>::ManyToManyHeapPtr SearchEngineData<CH>::many_to_many_heap;
+
+void SearchEngineData<CH>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClear(forward_heap_1, number_of_nodes);
+    initializeOrClear(reverse_heap_1, number_of_nodes);
+}
+
+void SearchEngineData<CH>::InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClear(forward_heap_2, number_of_nodes);
+    initializeOrClear(reverse_heap_2, number_of_nodes);
+}
+
+void SearchEngineData<CH>::InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClear(forward_heap_3, number_of_nodes);
+    initializeOrClear(reverse_heap_3, number_of_nodes);
 }
 
 void SearchEngineData<CH>::InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (many_to_many_heap.get())
-    {
-        many_to_many_heap->Clear();
-    }
-    else
-    {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes));
-    }
+    initializeOrClear(many_to_many_heap, number_of_nodes);
+}
+
+util::QueryHeapCounters SearchEngineData<CH>::GetCounters() const
+{
+    auto counters = getCounters(forward_heap_1);
+    counters += getCounters(reverse_heap_1);
+    counters += getCounters(forward_heap_2);
+    counters += getCounters(reverse_heap_2);
+    counters += getCounters(forward_heap_3);
+    counters += getCounters(reverse_heap_3);
+    counters += getCounters(many_to_many_heap);
+    return counters;
+}
+
+std::size_t SearchEngineData<CH>::GetSizeInBytes() const
+{
+    return getSizeInBytes(forward_heap_1) + getSizeInBytes(reverse_heap_1) +
+           getSizeInBytes(forward_heap_2) + getSizeInBytes(reverse_heap_2) +
+           getSizeInBytes(forward_heap_3) + getSizeInBytes(reverse_heap_3) +
+           getSizeInBytes(many_to_many_heap);
 }
 
 // MLD
@@ -99,36 +146,117 @@ SearchEngineData<MLD>::ManyToManyHeapPtr SearchEngineData<MLD>::many_to_many_hea
 void SearchEngineData<MLD>::InitializeOrClearFirstThreadLocalStorage(
     unsigned number_of_nodes, unsigned number_of_boundary_nodes)
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
-    {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes, number_of_boundary_nodes));
-    }
+    initializeOrClear(forward_heap_1, number_of_nodes, number_of_boundary_nodes);
+    initializeOrClear(reverse_heap_1, number_of_nodes, number_of_boundary_nodes);
+}
 
-    if (reverse_heap_1.get())
+void SearchEngineData<MLD>::InitializeOrClearManyToManyThreadLocalStorage(
+    unsigned number_of_nodes, unsigned number_of_boundary_nodes)
+{
+    initializeOrClear(many_to_many_heap, number_of_nodes, number_of_boundary_nodes);
+}
+
+util::QueryHeapCounters SearchEngineData<MLD>::GetCounters() const
+{
+    auto counters = getCounters(forward_heap_1);
+    counters += getCounters(reverse_heap_1);
+    counters += getCounters(many_to_many_heap);
+    return counters;
+}
+
+std::size_t SearchEngineData<MLD>::GetSizeInBytes() const
+{
+    return getSizeInBytes(forward_heap_1) + getSizeInBytes(reverse_heap_1) +
+           getSizeInBytes(many_to_many_heap);
+}
+
+namespace
+{
+// Calls `f` for every heap of this thread, whether it was created or not
+template <typename F> void forEachHeap(const F &f)
+{
+    f(SearchEngineData<CH>::forward_heap_1);
+    f(SearchEngineData<CH>::reverse_heap_1);
+    f(SearchEngineData<CH>::forward_heap_2);
+    f(SearchEngineData<CH>::reverse_heap_2);
+    f(SearchEngineData<CH>::forward_heap_3);
+    f(SearchEngineData<CH>::reverse_heap_3);
+    f(SearchEngineData<CH>::many_to_many_heap);
+    f(SearchEngineData<MLD>::forward_heap_1);
+    f(SearchEngineData<MLD>::reverse_heap_1);
+    f(SearchEngineData<MLD>::many_to_many_heap);
+}
+
+// Accounts for the memory the heaps of this thread grew to or freed since the last time
+void updateHeapBytes()
+{
+    std::size_t bytes = 0;
+    forEachHeap([&bytes](const auto &heap) { bytes += getSizeInBytes(heap); });
+    auto &accounted_bytes = thread_heap_bytes.bytes;
+    if (bytes > accounted_bytes)
     {
-        reverse_heap_1->Clear();
+        const auto growth = bytes - accounted_bytes;
+        const auto total = heap_bytes.fetch_add(growth) + growth;
+        auto peak = peak_heap_bytes.load();
+        while (total > peak && !peak_heap_bytes.compare_exchange_weak(peak, total))
+        {
+        }
     }
-    else
+    else if (bytes < accounted_bytes)
     {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes, number_of_boundary_nodes));
+        heap_bytes.fetch_sub(accounted_bytes - bytes);
     }
+    accounted_bytes = bytes;
 }
+} // namespace
 
-void SearchEngineData<MLD>::InitializeOrClearManyToManyThreadLocalStorage(
-    unsigned number_of_nodes, unsigned number_of_boundary_nodes)
+SearchHeapMemory getSearchHeapMemory()
 {
-    if (many_to_many_heap.get())
-    {
-        many_to_many_heap->Clear();
-    }
-    else
+    SearchHeapMemory memory;
+    memory.heap_bytes = heap_bytes.load();
+    memory.peak_heap_bytes = peak_heap_bytes.load();
+    memory.max_heap_bytes = max_heap_bytes.load();
+    memory.shrunk_heaps = shrunk_heaps.load();
+    memory.freed_bytes = freed_bytes.load();
+    return memory;
+}
+
+void setSearchHeapBudget(const std::size_t max_heap_bytes_) { max_heap_bytes = max_heap_bytes_; }
+
+void trimSearchHeaps()
+{
+    const auto budget = max_heap_bytes.load(std::memory_order_relaxed);
+    if (budget > 0)
     {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes, number_of_boundary_nodes));
+        // every thread with heaps keeps its share of the budget, the largest heaps go first
+        const auto threads = std::max<std::size_t>(1, number_of_threads.load());
+        const auto thread_budget = budget / threads;
+        std::size_t growth = 0;
+        forEachHeap([&growth](const auto &heap) { growth += getGrowthInBytes(heap); });
+        while (growth > thread_budget)
+        {
+            std::size_t largest_growth = 0;
+            forEachHeap([&largest_growth](const auto &heap) {
+                largest_growth = std::max(largest_growth, getGrowthInBytes(heap));
+            });
+            bool shrunk = false;
+            forEachHeap([&](auto &heap) {
+                if (!shrunk && getGrowthInBytes(heap) == largest_growth)
+                {
+                    shrinkHeap(heap);
+                    shrunk = true;
+                }
+            });
+            growth -= largest_growth;
+        }
     }
+    updateHeapBytes();
+}
+
+void shrinkSearchHeaps()
+{
+    forEachHeap([](auto &heap) { shrinkHeap(heap); });
+    updateHeapBytes();
 }
 } // namespace engine
 } // namespace osrm
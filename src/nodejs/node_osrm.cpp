@@ -83,6 +83,10 @@ NAN_MODULE_INIT(Engine::Init)
  * @param {Number} [options.max_radius_map_matching] Max. radius size supported in map matching query (default: 5).
  * @param {Number} [options.max_results_nearest] Max. results supported in nearest query (default: unlimited).
  * @param {Number} [options.max_alternatives] Max. number of alternatives supported in alternative routes query (default: 3).
+ * @param {Number} [options.max_table_parallelism] Max. number of threads a single table query may use (default: 1).
+ * @param {Number} [options.rphast_min_destinations] Min. number of destinations for which table queries sweep over the search space of the destinations, -1 to disable (default: 1000).
+ * @param {Number} [options.table_bucket_cache_size] Size in megabytes of the cache keeping the search buckets of table query destinations across queries, 0 to disable (default: 0).
+ * @param {Number} [options.overlay_path_cache_size] Size in megabytes of the cache keeping the unpacked paths of MLD overlay edges across queries, 0 to disable (default: 0).
  *
  * @class OSRM
  *
@@ -135,6 +139,9 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
     auto *const self = Nan::ObjectWrap::Unwrap<Engine>(info.Holder());
     using ParamPtr = decltype(params);
 
+    if (pluginParams.renderToBinary && !std::is_same<ParamPtr, table_parameters_ptr>::value)
+        return Nan::ThrowError("format \"bin\" is only supported by the table plugin");
+
     struct Worker final : Nan::AsyncWorker
     {
         using Base = Nan::AsyncWorker;
@@ -154,7 +161,17 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
         {
             osrm::engine::api::ResultT r;
             r = osrm::util::json::Object();
+            if (pluginParams.renderToBinary)
+            {
+                r = std::vector<char>();
+            }
             const auto status = ((*osrm).*(service))(*params, r);
+            if (r.is<std::vector<char>>())
+            {
+                ParseResult(status, r.get<std::vector<char>>());
+                result = std::move(r.get<std::vector<char>>());
+                return;
+            }
             auto json_result = r.get<osrm::json::Object>();
             ParseResult(status, json_result);
             if (pluginParams.renderJSONToBuffer)
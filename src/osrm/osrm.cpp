@@ -1,6 +1,8 @@
 #include "osrm/osrm.hpp"
 
 #include "engine/algorithm.hpp"
+#include "engine/api/batch_parameters.hpp"
+#include "engine/api/isochrone_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -8,13 +10,147 @@
 #include "engine/api/trip_parameters.hpp"
 #include "engine/engine.hpp"
 #include "engine/engine_config.hpp"
+#include "engine/query_executor.hpp"
 #include "engine/status.hpp"
 
+#include <exception>
 #include <memory>
+#include <utility>
 
 namespace osrm
 {
 
+namespace
+{
+template <typename ParametersT>
+using QueryFn = Status (engine::EngineInterface::*)(const ParametersT &,
+                                                     engine::api::ResultT &) const;
+
+// Result in the output format asked for, like the services of osrm-routed prepare it
+engine::api::ResultT makeResult(const engine::api::BaseParameters &params)
+{
+    if (params.format == engine::api::BaseParameters::OutputFormatType::FLATBUFFERS)
+    {
+        return flatbuffers::FlatBufferBuilder();
+    }
+    if (params.format == engine::api::BaseParameters::OutputFormatType::BINARY)
+    {
+        return std::vector<char>();
+    }
+    return json::Object();
+}
+engine::api::ResultT makeResult(const engine::api::TileParameters &) { return std::string(); }
+
+// Answers the query on a thread of the executor and hands its result or exception to done
+template <typename ParametersT, typename DoneT>
+engine::QueryExecutor::Task makeTask(const engine::EngineInterface &engine,
+                                     ParametersT params,
+                                     const QueryFn<ParametersT> query,
+                                     DoneT done)
+{
+    return [&engine, params = std::move(params), query, done] {
+        AsyncResult async_result;
+        std::exception_ptr error;
+        try
+        {
+            async_result.result = makeResult(params);
+            async_result.status = (engine.*query)(params, async_result.result);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        done(error, std::move(async_result));
+    };
+}
+
+template <typename ParametersT>
+engine::QueryExecutor::Task makeFutureTask(const engine::EngineInterface &engine,
+                                           ParametersT params,
+                                           const QueryFn<ParametersT> query,
+                                           std::future<AsyncResult> &future)
+{
+    const auto promise = std::make_shared<std::promise<AsyncResult>>();
+    future = promise->get_future();
+    return makeTask(engine,
+                    std::move(params),
+                    query,
+                    [promise](std::exception_ptr error, AsyncResult async_result) {
+                        if (error)
+                        {
+                            promise->set_exception(error);
+                        }
+                        else
+                        {
+                            promise->set_value(std::move(async_result));
+                        }
+                    });
+}
+
+template <typename ParametersT>
+std::future<AsyncResult> submitQuery(engine::QueryExecutor &executor,
+                                     const engine::EngineInterface &engine,
+                                     ParametersT params,
+                                     const QueryFn<ParametersT> query)
+{
+    std::future<AsyncResult> future;
+    executor.Submit(makeFutureTask(engine, std::move(params), query, future));
+    return future;
+}
+
+template <typename ParametersT>
+void submitQuery(engine::QueryExecutor &executor,
+                 const engine::EngineInterface &engine,
+                 ParametersT params,
+                 const QueryFn<ParametersT> query,
+                 AsyncCallback callback)
+{
+    executor.Submit(makeTask(
+        engine,
+        std::move(params),
+        query,
+        [callback](std::exception_ptr error, AsyncResult async_result) {
+            if (error)
+            {
+                async_result.status = Status::Error;
+                async_result.result = json::Object();
+                auto &json_result = async_result.result.get<json::Object>();
+                json_result.values["code"] = "InternalError";
+                try
+                {
+                    std::rethrow_exception(error);
+                }
+                catch (const std::exception &exception)
+                {
+                    json_result.values["message"] = exception.what();
+                }
+                catch (...)
+                {
+                    json_result.values["message"] = "Query failed";
+                }
+            }
+            callback(std::move(async_result));
+        }));
+}
+
+template <typename ParametersT>
+std::vector<std::future<AsyncResult>> submitQueries(engine::QueryExecutor &executor,
+                                                    const engine::EngineInterface &engine,
+                                                    std::vector<ParametersT> params,
+                                                    const QueryFn<ParametersT> query)
+{
+    std::vector<std::future<AsyncResult>> futures(params.size());
+    std::vector<engine::QueryExecutor::Task> tasks;
+    tasks.reserve(params.size());
+    for (std::size_t index = 0; index < params.size(); ++index)
+    {
+        tasks.push_back(makeFutureTask(engine, std::move(params[index]), query, futures[index]));
+    }
+    executor.Submit(std::move(tasks));
+    return futures;
+}
+} // namespace
+
 // Pimpl idiom
 
 OSRM::OSRM(engine::EngineConfig &config)
@@ -49,6 +185,7 @@ OSRM::OSRM(engine::EngineConfig &config)
     default:
         util::exception("Algorithm not implemented!");
     }
+    executor_ = std::make_unique<engine::QueryExecutor>(config.async_threads);
 }
 OSRM::~OSRM() = default;
 OSRM::OSRM(OSRM &&) noexcept = default;
@@ -82,6 +219,13 @@ Status OSRM::Table(const TableParameters &params, engine::api::ResultT &result)
     return engine_->Table(params, result);
 }
 
+Status OSRM::Table(const TableParameters &params,
+                   engine::api::ResultT &result,
+                   const engine::api::ResultChunkWriter &write_chunk) const
+{
+    return engine_->Table(params, result, write_chunk);
+}
+
 Status OSRM::Nearest(const engine::api::NearestParameters &params, json::Object &json_result) const
 {
     osrm::engine::api::ResultT result = json::Object();
@@ -135,4 +279,180 @@ Status OSRM::Tile(const engine::api::TileParameters &params, engine::api::Result
     return engine_->Tile(params, result);
 }
 
+Status OSRM::Isochrone(const engine::api::IsochroneParameters &params,
+                       json::Object &json_result) const
+{
+    osrm::engine::api::ResultT result = json::Object();
+    auto status = engine_->Isochrone(params, result);
+    json_result = std::move(result.get<json::Object>());
+    return status;
+}
+
+Status OSRM::Isochrone(const IsochroneParameters &params, engine::api::ResultT &result) const
+{
+    return engine_->Isochrone(params, result);
+}
+
+Status OSRM::Batch(const engine::api::BatchParameters &params, json::Object &json_result) const
+{
+    osrm::engine::api::ResultT result = json::Object();
+    auto status = engine_->Batch(params, result);
+    json_result = std::move(result.get<json::Object>());
+    return status;
+}
+
+Status OSRM::Batch(const BatchParameters &params, engine::api::ResultT &result) const
+{
+    return engine_->Batch(params, result);
+}
+
+Status OSRM::Batch(const BatchParameters &params,
+                   engine::api::ResultT &result,
+                   const engine::api::ResultChunkWriter &write_chunk) const
+{
+    return engine_->Batch(params, result, write_chunk);
+}
+
+void OSRM::WarmUp() const { engine_->WarmUp(); }
+
+// Asynchronous queries
+
+std::future<AsyncResult> OSRM::RouteAsync(RouteParameters params) const
+{
+    return submitQuery(*executor_, *engine_, std::move(params), &engine::EngineInterface::Route);
+}
+
+void OSRM::RouteAsync(RouteParameters params, AsyncCallback callback) const
+{
+    submitQuery(*executor_,
+                *engine_,
+                std::move(params),
+                &engine::EngineInterface::Route,
+                std::move(callback));
+}
+
+std::vector<std::future<AsyncResult>> OSRM::RouteAsync(std::vector<RouteParameters> params) const
+{
+    return submitQueries(*executor_, *engine_, std::move(params), &engine::EngineInterface::Route);
+}
+
+std::future<AsyncResult> OSRM::TableAsync(TableParameters params) const
+{
+    return submitQuery(*executor_, *engine_, std::move(params), &engine::EngineInterface::Table);
+}
+
+void OSRM::TableAsync(TableParameters params, AsyncCallback callback) const
+{
+    submitQuery(*executor_,
+                *engine_,
+                std::move(params),
+                &engine::EngineInterface::Table,
+                std::move(callback));
+}
+
+std::vector<std::future<AsyncResult>> OSRM::TableAsync(std::vector<TableParameters> params) const
+{
+    return submitQueries(*executor_, *engine_, std::move(params), &engine::EngineInterface::Table);
+}
+
+std::future<AsyncResult> OSRM::NearestAsync(NearestParameters params) const
+{
+    return submitQuery(*executor_, *engine_, std::move(params), &engine::EngineInterface::Nearest);
+}
+
+void OSRM::NearestAsync(NearestParameters params, AsyncCallback callback) const
+{
+    submitQuery(*executor_,
+                *engine_,
+                std::move(params),
+                &engine::EngineInterface::Nearest,
+                std::move(callback));
+}
+
+std::vector<std::future<AsyncResult>>
+OSRM::NearestAsync(std::vector<NearestParameters> params) const
+{
+    return submitQueries(
+        *executor_, *engine_, std::move(params), &engine::EngineInterface::Nearest);
+}
+
+std::future<AsyncResult> OSRM::TripAsync(TripParameters params) const
+{
+    return submitQuery(*executor_, *engine_, std::move(params), &engine::EngineInterface::Trip);
+}
+
+void OSRM::TripAsync(TripParameters params, AsyncCallback callback) const
+{
+    submitQuery(*executor_,
+                *engine_,
+                std::move(params),
+                &engine::EngineInterface::Trip,
+                std::move(callback));
+}
+
+std::vector<std::future<AsyncResult>> OSRM::TripAsync(std::vector<TripParameters> params) const
+{
+    return submitQueries(*executor_, *engine_, std::move(params), &engine::EngineInterface::Trip);
+}
+
+std::future<AsyncResult> OSRM::MatchAsync(MatchParameters params) const
+{
+    return submitQuery(*executor_, *engine_, std::move(params), &engine::EngineInterface::Match);
+}
+
+void OSRM::MatchAsync(MatchParameters params, AsyncCallback callback) const
+{
+    submitQuery(*executor_,
+                *engine_,
+                std::move(params),
+                &engine::EngineInterface::Match,
+                std::move(callback));
+}
+
+std::vector<std::future<AsyncResult>> OSRM::MatchAsync(std::vector<MatchParameters> params) const
+{
+    return submitQueries(*executor_, *engine_, std::move(params), &engine::EngineInterface::Match);
+}
+
+std::future<AsyncResult> OSRM::TileAsync(TileParameters params) const
+{
+    return submitQuery(*executor_, *engine_, std::move(params), &engine::EngineInterface::Tile);
+}
+
+void OSRM::TileAsync(TileParameters params, AsyncCallback callback) const
+{
+    submitQuery(*executor_,
+                *engine_,
+                std::move(params),
+                &engine::EngineInterface::Tile,
+                std::move(callback));
+}
+
+std::vector<std::future<AsyncResult>> OSRM::TileAsync(std::vector<TileParameters> params) const
+{
+    return submitQueries(*executor_, *engine_, std::move(params), &engine::EngineInterface::Tile);
+}
+
+std::future<AsyncResult> OSRM::IsochroneAsync(IsochroneParameters params) const
+{
+    return submitQuery(
+        *executor_, *engine_, std::move(params), &engine::EngineInterface::Isochrone);
+}
+
+void OSRM::IsochroneAsync(IsochroneParameters params, AsyncCallback callback) const
+{
+    submitQuery(*executor_,
+                *engine_,
+                std::move(params),
+                &engine::EngineInterface::Isochrone,
+                std::move(callback));
+}
+
+std::vector<std::future<AsyncResult>>
+OSRM::IsochroneAsync(std::vector<IsochroneParameters> params) const
+{
+    return submitQueries(
+        *executor_, *engine_, std::move(params), &engine::EngineInterface::Isochrone);
+}
+
 } // namespace osrm
@@ -0,0 +1,116 @@
+#include "server/admission_control.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace osrm
+{
+namespace server
+{
+
+namespace
+{
+// Counts the coordinates of a query like 1,2;3,4?... or polyline(...)?... without decoding them
+std::uint64_t countQueryCoordinates(const std::string &query)
+{
+    const auto coordinates_end = query.find('?');
+    const auto coordinates = query.substr(0, coordinates_end);
+
+    const auto polyline_begin = coordinates.find('(');
+    if (polyline_begin != std::string::npos)
+    {
+        // every encoded number ends with a chunk without the continuation bit,
+        // a coordinate has two of them
+        const auto polyline_end = coordinates.find(')', polyline_begin);
+        const auto is_last_chunk = [](const char chunk) { return ((chunk - 63) & 0x20) == 0; };
+        const auto numbers = std::count_if(coordinates.begin() + polyline_begin + 1,
+                                           polyline_end == std::string::npos
+                                               ? coordinates.end()
+                                               : coordinates.begin() + polyline_end,
+                                           is_last_chunk);
+        return std::max<std::uint64_t>(1, numbers / 2);
+    }
+    return std::count(coordinates.begin(), coordinates.end(), ';') + 1;
+}
+} // namespace
+
+AdmissionControl::AdmissionControl(AdmissionControlConfig config_) : config(std::move(config_))
+{
+    for (const auto &budget : config.max_inflight_cost)
+    {
+        inflight_cost[budget.first] = 0;
+    }
+}
+
+std::uint64_t AdmissionControl::EstimateCost(const api::ParsedURL &parsed_url)
+{
+    // a batch costs as much as its sub-requests, all of them are routes or nearest queries
+    if (!parsed_url.requests.empty())
+    {
+        std::uint64_t cost = 0;
+        for (const auto &request : parsed_url.requests)
+        {
+            const auto query_begin = request.rfind('/', request.find('?'));
+            cost += countQueryCoordinates(
+                request.substr(query_begin == std::string::npos ? 0 : query_begin + 1));
+        }
+        return cost;
+    }
+
+    const std::uint64_t num_coordinates = parsed_url.coordinates.empty()
+                                              ? countQueryCoordinates(parsed_url.query)
+                                              : parsed_url.coordinates.size();
+    if (parsed_url.service == "table" || parsed_url.service == "trip")
+    {
+        return num_coordinates * num_coordinates;
+    }
+    return num_coordinates;
+}
+
+AdmissionControl::Ticket
+AdmissionControl::Admit(const api::ParsedURL &parsed_url,
+                        const std::chrono::steady_clock::time_point received)
+{
+    if (config.max_queue_time.count() > 0 &&
+        std::chrono::steady_clock::now() - received > config.max_queue_time)
+    {
+        return {};
+    }
+
+    const auto budget = config.max_inflight_cost.find(parsed_url.service);
+    const auto cost = budget == config.max_inflight_cost.end() ? 0 : EstimateCost(parsed_url);
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (config.max_inflight_requests > 0 && inflight_requests >= config.max_inflight_requests)
+    {
+        return {};
+    }
+
+    const std::string *service = nullptr;
+    if (budget != config.max_inflight_cost.end())
+    {
+        auto &service_cost = inflight_cost[budget->first];
+        // a request beyond the whole budget is still admitted while its service is idle
+        if (service_cost > 0 && service_cost + cost > budget->second)
+        {
+            return {};
+        }
+        service_cost += cost;
+        service = &budget->first;
+    }
+    ++inflight_requests;
+
+    return {this, service, cost};
+}
+
+void AdmissionControl::Release(const std::string *service, const std::uint64_t cost)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    --inflight_requests;
+    if (service)
+    {
+        inflight_cost[*service] -= cost;
+    }
+}
+} // namespace server
+} // namespace osrm
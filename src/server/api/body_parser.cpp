@@ -0,0 +1,263 @@
+#include "server/api/body_parser.hpp"
+
+#include "util/coordinate.hpp"
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+namespace api
+{
+
+namespace
+{
+const constexpr char JSON_CONTENT_TYPE[] = "application/json";
+const constexpr char BINARY_CONTENT_TYPE[] = "application/octet-stream";
+const constexpr char COORDINATES_MEMBER[] = "coordinates";
+const constexpr char REQUESTS_MEMBER[] = "requests";
+
+bool isMediaType(const std::string &content_type, const char *media_type)
+{
+    // parameters like "; charset=UTF-8" may follow the media type
+    const auto media_type_end = content_type.find(';');
+    return boost::iequals(boost::trim_copy(content_type.substr(0, media_type_end)), media_type);
+}
+
+// Appends text to the query string. Characters that would end the option or the query are
+// percent-encoded, so the text stays a single value. List separators are kept, a string like
+// "duration,distance" is taken as a list as in the URL.
+void appendEncoded(const char *text, const std::size_t length, std::string &options)
+{
+    const constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+    for (std::size_t index = 0; index < length; ++index)
+    {
+        const auto character = static_cast<unsigned char>(text[index]);
+        if (character <= ' ' || character >= 0x7f || character == '&' || character == '?' ||
+            character == '#' || character == '%')
+        {
+            options += '%';
+            options += HEX_DIGITS[character >> 4];
+            options += HEX_DIGITS[character & 0xf];
+        }
+        else
+        {
+            options += text[index];
+        }
+    }
+}
+
+// Appends a value in its query string form, only two levels of arrays map to a query string
+bool appendOption(const rapidjson::Value &value, const unsigned depth, std::string &options)
+{
+    if (value.IsNull())
+    {
+        return true;
+    }
+    if (value.IsString())
+    {
+        appendEncoded(value.GetString(), value.GetStringLength(), options);
+        return true;
+    }
+    if (value.IsBool())
+    {
+        options += value.GetBool() ? "true" : "false";
+        return true;
+    }
+    if (value.IsNumber())
+    {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        value.Accept(writer);
+        options.append(buffer.GetString(), buffer.GetSize());
+        return true;
+    }
+    if (value.IsArray() && depth < 2)
+    {
+        for (auto element = value.Begin(); element != value.End(); ++element)
+        {
+            if (element != value.Begin())
+            {
+                options += depth == 0 ? ';' : ',';
+            }
+            if (!appendOption(*element, depth + 1, options))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool parseJSONCoordinates(const rapidjson::Value &value,
+                          std::vector<util::Coordinate> &coordinates)
+{
+    if (!value.IsArray())
+    {
+        return false;
+    }
+
+    coordinates.reserve(value.Size());
+    for (auto location = value.Begin(); location != value.End(); ++location)
+    {
+        if (!location->IsArray() || location->Size() != 2 || !(*location)[0].IsNumber() ||
+            !(*location)[1].IsNumber())
+        {
+            return false;
+        }
+        coordinates.emplace_back(
+            util::toFixed(util::UnsafeFloatLongitude{(*location)[0].GetDouble()}),
+            util::toFixed(util::UnsafeFloatLatitude{(*location)[1].GetDouble()}));
+    }
+    return true;
+}
+
+bool parseJSONRequests(const rapidjson::Value &value, std::vector<std::string> &requests)
+{
+    if (!value.IsArray())
+    {
+        return false;
+    }
+
+    requests.reserve(value.Size());
+    for (auto request = value.Begin(); request != value.End(); ++request)
+    {
+        if (!request->IsString())
+        {
+            return false;
+        }
+        requests.emplace_back(request->GetString(), request->GetStringLength());
+    }
+    return true;
+}
+
+bool parseJSONBody(const std::string &body,
+                   std::vector<util::Coordinate> &coordinates,
+                   std::vector<std::string> &requests,
+                   std::string &options)
+{
+    rapidjson::Document document;
+    document.Parse(body.c_str(), body.size());
+    if (document.HasParseError() || !document.IsObject())
+    {
+        return false;
+    }
+
+    for (auto member = document.MemberBegin(); member != document.MemberEnd(); ++member)
+    {
+        const std::string name(member->name.GetString(), member->name.GetStringLength());
+        if (name == COORDINATES_MEMBER)
+        {
+            if (!parseJSONCoordinates(member->value, coordinates))
+            {
+                return false;
+            }
+            continue;
+        }
+        if (name == REQUESTS_MEMBER)
+        {
+            if (!parseJSONRequests(member->value, requests))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        if (!options.empty())
+        {
+            options += '&';
+        }
+        appendEncoded(name.c_str(), name.size(), options);
+        options += '=';
+        if (!appendOption(member->value, 0, options))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::int32_t readLittleEndian(const char *data)
+{
+    const auto byte = [data](const std::size_t index) {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(data[index]));
+    };
+    return static_cast<std::int32_t>(byte(0) | byte(1) << 8 | byte(2) << 16 | byte(3) << 24);
+}
+
+bool parseBinaryBody(const std::string &body, std::vector<util::Coordinate> &coordinates)
+{
+    const constexpr std::size_t COORDINATE_SIZE = 2 * sizeof(std::int32_t);
+    if (body.size() % COORDINATE_SIZE != 0)
+    {
+        return false;
+    }
+
+    coordinates.reserve(body.size() / COORDINATE_SIZE);
+    for (std::size_t offset = 0; offset < body.size(); offset += COORDINATE_SIZE)
+    {
+        coordinates.emplace_back(
+            util::FixedLongitude{readLittleEndian(body.data() + offset)},
+            util::FixedLatitude{readLittleEndian(body.data() + offset + sizeof(std::int32_t))});
+    }
+    return true;
+}
+} // namespace
+
+bool parseBody(const std::string &content_type, const std::string &body, ParsedURL &parsed_url)
+{
+    std::vector<util::Coordinate> coordinates;
+    std::vector<std::string> requests;
+    std::string options;
+
+    if (isMediaType(content_type, JSON_CONTENT_TYPE))
+    {
+        if (!parseJSONBody(body, coordinates, requests, options))
+        {
+            return false;
+        }
+    }
+    else if (isMediaType(content_type, BINARY_CONTENT_TYPE))
+    {
+        if (!parseBinaryBody(body, coordinates))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    // the sub-requests of a batch have their own coordinates
+    if (coordinates.empty() == requests.empty())
+    {
+        return false;
+    }
+
+    // options of the body follow those of the URL
+    if (!options.empty())
+    {
+        parsed_url.query += parsed_url.query.find('?') == std::string::npos ? '?' : '&';
+        parsed_url.query += options;
+    }
+    parsed_url.coordinates = std::move(coordinates);
+    parsed_url.requests = std::move(requests);
+    return true;
+}
+
+} // namespace api
+} // namespace server
+} // namespace osrm
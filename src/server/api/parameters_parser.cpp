@@ -1,5 +1,6 @@
 #include "server/api/parameters_parser.hpp"
 
+#include "server/api/isochrone_parameter_grammar.hpp"
 #include "server/api/match_parameter_grammar.hpp"
 #include "server/api/nearest_parameter_grammar.hpp"
 #include "server/api/route_parameters_grammar.hpp"
@@ -8,6 +9,8 @@
 #include "server/api/trip_parameter_grammar.hpp"
 
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
@@ -26,14 +29,16 @@ using is_grammar_t =
                                std::is_same<NearestParametersGrammar<>, T>::value ||
                                std::is_same<TripParametersGrammar<>, T>::value ||
                                std::is_same<MatchParametersGrammar<>, T>::value ||
-                               std::is_same<TileParametersGrammar<>, T>::value>;
+                               std::is_same<TileParametersGrammar<>, T>::value ||
+                               std::is_same<IsochroneParametersGrammar<>, T>::value>;
 
 template <typename ParameterT,
           typename GrammarT,
           typename std::enable_if<detail::is_parameter_t<ParameterT>::value, int>::type = 0,
           typename std::enable_if<detail::is_grammar_t<GrammarT>::value, int>::type = 0>
 boost::optional<ParameterT> parseParameters(std::string::iterator &iter,
-                                            const std::string::iterator end)
+                                            const std::string::iterator end,
+                                            ParameterT parameters = {})
 {
     using It = std::decay<decltype(iter)>::type;
 
@@ -41,7 +46,6 @@ boost::optional<ParameterT> parseParameters(std::string::iterator &iter,
 
     try
     {
-        ParameterT parameters;
         const auto ok =
             boost::spirit::qi::parse(iter, end, grammar(boost::phoenix::ref(parameters)));
 
@@ -110,6 +114,87 @@ boost::optional<engine::api::TileParameters> parseParameters(std::string::iterat
     return detail::parseParameters<engine::api::TileParameters, TileParametersGrammar<>>(iter, end);
 }
 
+template <>
+boost::optional<engine::api::IsochroneParameters> parseParameters(std::string::iterator &iter,
+                                                                  const std::string::iterator end)
+{
+    return detail::parseParameters<engine::api::IsochroneParameters, IsochroneParametersGrammar<>>(
+        iter, end);
+}
+
+namespace detail
+{
+template <typename ParameterT, typename GrammarT>
+boost::optional<ParameterT> parseParameters(std::string::iterator &iter,
+                                            const std::string::iterator end,
+                                            std::vector<util::Coordinate> coordinates)
+{
+    ParameterT parameters;
+    parameters.coordinates = std::move(coordinates);
+    return parseParameters<ParameterT, GrammarT>(iter, end, std::move(parameters));
+}
+} // namespace detail
+
+template <>
+boost::optional<engine::api::RouteParameters>
+parseParameters(std::string::iterator &iter,
+                const std::string::iterator end,
+                std::vector<util::Coordinate> coordinates)
+{
+    return detail::parseParameters<engine::api::RouteParameters, RouteParametersGrammar<>>(
+        iter, end, std::move(coordinates));
+}
+
+template <>
+boost::optional<engine::api::TableParameters>
+parseParameters(std::string::iterator &iter,
+                const std::string::iterator end,
+                std::vector<util::Coordinate> coordinates)
+{
+    return detail::parseParameters<engine::api::TableParameters, TableParametersGrammar<>>(
+        iter, end, std::move(coordinates));
+}
+
+template <>
+boost::optional<engine::api::NearestParameters>
+parseParameters(std::string::iterator &iter,
+                const std::string::iterator end,
+                std::vector<util::Coordinate> coordinates)
+{
+    return detail::parseParameters<engine::api::NearestParameters, NearestParametersGrammar<>>(
+        iter, end, std::move(coordinates));
+}
+
+template <>
+boost::optional<engine::api::TripParameters>
+parseParameters(std::string::iterator &iter,
+                const std::string::iterator end,
+                std::vector<util::Coordinate> coordinates)
+{
+    return detail::parseParameters<engine::api::TripParameters, TripParametersGrammar<>>(
+        iter, end, std::move(coordinates));
+}
+
+template <>
+boost::optional<engine::api::MatchParameters>
+parseParameters(std::string::iterator &iter,
+                const std::string::iterator end,
+                std::vector<util::Coordinate> coordinates)
+{
+    return detail::parseParameters<engine::api::MatchParameters, MatchParametersGrammar<>>(
+        iter, end, std::move(coordinates));
+}
+
+template <>
+boost::optional<engine::api::IsochroneParameters>
+parseParameters(std::string::iterator &iter,
+                const std::string::iterator end,
+                std::vector<util::Coordinate> coordinates)
+{
+    return detail::parseParameters<engine::api::IsochroneParameters, IsochroneParametersGrammar<>>(
+        iter, end, std::move(coordinates));
+}
+
 } // namespace api
 } // namespace server
 } // namespace osrm
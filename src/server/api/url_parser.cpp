@@ -22,7 +22,7 @@ namespace qi = boost::spirit::qi;
 template <typename Iterator, typename Into> //
 struct URLParser final : qi::grammar<Iterator, Into>
 {
-    URLParser() : URLParser::base_type(start)
+    URLParser(const bool coordinates_in_query) : URLParser::base_type(start)
     {
         using boost::spirit::repository::qi::iter_pos;
 
@@ -36,15 +36,27 @@ struct URLParser final : qi::grammar<Iterator, Into>
         version = qi::uint_;
         profile = +alpha_numeral;
         query = +all_chars;
+        options = *all_chars;
 
-        // Example input: /route/v1/driving/7.416351,43.731205;7.420363,43.736189
+        prefix_length = qi::omit[iter_pos[ph::bind(&osrm::server::api::ParsedURL::prefix_length,
+                                                   qi::_r1) = qi::_1 - qi::_r2]];
 
-        start = qi::lit('/') > service > qi::lit('/') > qi::lit('v') > version > qi::lit('/') >
-                profile > qi::lit('/') >
-                qi::omit[iter_pos[ph::bind(&osrm::server::api::ParsedURL::prefix_length, qi::_val) =
-                                      qi::_1 - qi::_r1]] > query;
+        if (coordinates_in_query)
+        {
+            // Example input: /route/v1/driving/7.416351,43.731205;7.420363,43.736189
 
-        BOOST_SPIRIT_DEBUG_NODES((start)(service)(version)(profile)(query))
+            start = qi::lit('/') > service > qi::lit('/') > qi::lit('v') > version > qi::lit('/') >
+                    profile > qi::lit('/') > prefix_length(qi::_val, qi::_r1) > query;
+        }
+        else
+        {
+            // Example input: /route/v1/driving?overview=false
+
+            start = qi::lit('/') > service > qi::lit('/') > qi::lit('v') > version > qi::lit('/') >
+                    profile > -qi::lit('/') > prefix_length(qi::_val, qi::_r1) > options;
+        }
+
+        BOOST_SPIRIT_DEBUG_NODES((start)(service)(version)(profile)(query)(options))
     }
 
     qi::rule<Iterator, Into> start;
@@ -53,6 +65,8 @@ struct URLParser final : qi::grammar<Iterator, Into>
     qi::rule<Iterator, unsigned()> version;
     qi::rule<Iterator, std::string()> profile;
     qi::rule<Iterator, std::string()> query;
+    qi::rule<Iterator, std::string()> options;
+    qi::rule<Iterator, void(osrm::server::api::ParsedURL &, Iterator)> prefix_length;
 
     qi::rule<Iterator, char()> alpha_numeral;
     qi::rule<Iterator, char()> all_chars;
@@ -69,11 +83,14 @@ namespace server
 namespace api
 {
 
-boost::optional<ParsedURL> parseURL(std::string::iterator &iter, const std::string::iterator end)
+namespace
+{
+template <typename ParserT>
+boost::optional<ParsedURL>
+parseURL(const ParserT &parser, std::string::iterator &iter, const std::string::iterator end)
 {
     using It = std::decay<decltype(iter)>::type;
 
-    static URLParser<It, ParsedURL(It)> const parser;
     ParsedURL out;
 
     try
@@ -92,6 +109,24 @@ boost::optional<ParsedURL> parseURL(std::string::iterator &iter, const std::stri
 
     return boost::none;
 }
+} // namespace
+
+boost::optional<ParsedURL> parseURL(std::string::iterator &iter, const std::string::iterator end)
+{
+    using It = std::decay<decltype(iter)>::type;
+
+    static URLParser<It, ParsedURL(It)> const parser(true);
+    return parseURL(parser, iter, end);
+}
+
+boost::optional<ParsedURL> parseBodyURL(std::string::iterator &iter,
+                                        const std::string::iterator end)
+{
+    using It = std::decay<decltype(iter)>::type;
+
+    static URLParser<It, ParsedURL(It)> const parser(false);
+    return parseURL(parser, iter, end);
+}
 
 } // namespace api
 } // namespace server
@@ -0,0 +1,142 @@
+#include "server/compute_pool.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace osrm
+{
+namespace server
+{
+
+ComputePool::ComputePool(const ComputePoolConfig &config)
+    : max_queued_requests(config.max_queued_requests), on_start(config.on_start),
+      idle_time(config.idle_time), on_idle(config.on_idle), stopping(false), queued_jobs(0)
+{
+    for (const auto &service_concurrency : config.max_service_concurrency)
+    {
+        if (service_concurrency.second > 0)
+        {
+            services[service_concurrency.first] = {service_concurrency.second, 0, {}};
+        }
+    }
+
+    const auto num_threads = std::max(1u, config.num_threads);
+    workers.reserve(num_threads);
+    for (unsigned index = 0; index < num_threads; ++index)
+    {
+        workers.emplace_back([this] { Work(); });
+    }
+}
+
+ComputePool::~ComputePool()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+        ready_jobs.clear();
+        for (auto &service : services)
+        {
+            service.second.waiting.clear();
+        }
+        queued_jobs = 0;
+    }
+    job_ready.notify_all();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+bool ComputePool::Submit(const std::string &service, Job job)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (stopping || (max_queued_requests > 0 && queued_jobs >= max_queued_requests))
+        {
+            return false;
+        }
+        ++queued_jobs;
+
+        const auto service_iter = services.find(service);
+        if (service_iter == services.end())
+        {
+            ready_jobs.emplace_back(nullptr, std::move(job));
+        }
+        else if (service_iter->second.running < service_iter->second.max_concurrency)
+        {
+            ++service_iter->second.running;
+            ready_jobs.emplace_back(&service_iter->second, std::move(job));
+        }
+        else
+        {
+            service_iter->second.waiting.push_back(std::move(job));
+            return true;
+        }
+    }
+    job_ready.notify_one();
+    return true;
+}
+
+void ComputePool::Work()
+{
+    if (on_start)
+    {
+        on_start();
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    const auto has_job = [this] { return stopping || !ready_jobs.empty(); };
+    bool idle = false;
+    while (true)
+    {
+        if (on_idle && idle_time.count() > 0 && !idle)
+        {
+            if (!job_ready.wait_for(guard, idle_time, has_job))
+            {
+                idle = true;
+                guard.unlock();
+                on_idle();
+                guard.lock();
+                continue;
+            }
+        }
+        else
+        {
+            job_ready.wait(guard, has_job);
+        }
+        if (stopping)
+        {
+            return;
+        }
+        idle = false;
+
+        auto service_jobs = ready_jobs.front().first;
+        auto job = std::move(ready_jobs.front().second);
+        ready_jobs.pop_front();
+        --queued_jobs;
+        guard.unlock();
+
+        job();
+        // the captures of a job may hold resources of their own
+        job = nullptr;
+
+        guard.lock();
+        if (service_jobs)
+        {
+            BOOST_ASSERT(service_jobs->running > 0);
+            --service_jobs->running;
+            // the next job of the service takes over its slot
+            if (!service_jobs->waiting.empty())
+            {
+                ++service_jobs->running;
+                ready_jobs.emplace_back(service_jobs, std::move(service_jobs->waiting.front()));
+                service_jobs->waiting.pop_front();
+            }
+        }
+    }
+}
+} // namespace server
+} // namespace osrm
@@ -1,14 +1,17 @@
 #include "server/connection.hpp"
+#include "server/compute_pool.hpp"
 #include "server/request_handler.hpp"
 #include "server/request_parser.hpp"
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/assert.hpp>
 #include <boost/bind.hpp>
-#include <boost/iostreams/filter/gzip.hpp>
-#include <boost/iostreams/filtering_stream.hpp>
 
+#include <chrono>
+#include <future>
 #include <iterator>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -17,8 +20,35 @@ namespace osrm
 namespace server
 {
 
-Connection::Connection(boost::asio::io_service &io_service, RequestHandler &handler)
-    : strand(io_service), TCP_socket(io_service), timer(io_service), request_handler(handler)
+namespace
+{
+// Replies smaller than this are sent as they are, compressing them saves less than it costs
+const constexpr std::size_t MIN_COMPRESSED_REPLY_SIZE = 1024;
+
+// Clients that take longer to receive a piece of a streamed reply are treated as gone, which also
+// frees the worker if the I/O threads were stopped
+const constexpr std::chrono::seconds CHUNK_WRITE_TIMEOUT{30};
+
+// Service of a request like /route/v1/driving/..., used for the limits of the compute pool
+std::string getService(const std::string &uri)
+{
+    const auto service_begin = uri.find_first_not_of('/');
+    if (service_begin == std::string::npos)
+    {
+        return {};
+    }
+    const auto service_end = uri.find_first_of("/?", service_begin);
+    return uri.substr(service_begin,
+                      service_end == std::string::npos ? service_end
+                                                       : service_end - service_begin);
+}
+} // namespace
+
+Connection::Connection(boost::asio::io_service &io_service,
+                       RequestHandler &handler,
+                       ComputePool &compute_pool)
+    : strand(io_service), TCP_socket(io_service), timer(io_service), request_handler(handler),
+      compute_pool(compute_pool)
 {
 }
 
@@ -76,52 +106,25 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
             handle_shutdown();
             return;
         }
-        request_handler.HandleRequest(current_request, current_reply);
+        current_request.received = std::chrono::steady_clock::now();
 
-        if (boost::iequals(current_request.connection, "close"))
+        // the query runs on the compute pool, the connection is idle until its reply is written
+        auto self = this->shared_from_this();
+        current_service = getService(current_request.uri);
+        const bool accepted = compute_pool.Submit(
+            current_service, [self, compression_type] { self->handle_request(compression_type); });
+        if (!accepted)
         {
-            current_reply.headers.emplace_back("Connection", "close");
+            current_reply = http::reply::stock_reply(http::reply::service_unavailable);
+            count_reply(current_reply.content_size());
+            set_connection_headers();
+            output_buffer = current_reply.to_buffers();
+            write_reply();
         }
         else
         {
-            keep_alive = true;
-            current_reply.headers.emplace_back("Connection", "keep-alive");
-            current_reply.headers.emplace_back("Keep-Alive", "timeout=5, max=512");
+            watch_client();
         }
-
-        // compress the result w/ gzip/deflate if requested
-        switch (compression_type)
-        {
-        case http::deflate_rfc1951:
-            // use deflate for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "deflate"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::gzip_rfc1952:
-            // use gzip for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "gzip"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::no_compression:
-            // don't use any compression
-            current_reply.set_uncompressed_size();
-            output_buffer = current_reply.to_buffers();
-            break;
-        }
-        // write result to stream
-        boost::asio::async_write(TCP_socket,
-                                 output_buffer,
-                                 strand.wrap(boost::bind(&Connection::handle_write,
-                                                         this->shared_from_this(),
-                                                         boost::asio::placeholders::error)));
     }
     else if (result == RequestParser::RequestStatus::invalid)
     { // request is not parseable
@@ -135,6 +138,21 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
     }
     else
     {
+        // clients sending "Expect: 100-continue" hold the body back until they are told to go on
+        if (request_parser.expects_continue() && !continue_sent)
+        {
+            const char continue_reply[] = "HTTP/1.1 100 Continue\r\n\r\n";
+            boost::system::error_code ec;
+            boost::asio::write(
+                TCP_socket, boost::asio::buffer(continue_reply, sizeof(continue_reply) - 1), ec);
+            if (ec)
+            {
+                handle_shutdown();
+                return;
+            }
+            continue_sent = true;
+        }
+
         // we don't have a result yet, so continue reading
         TCP_socket.async_read_some(
             boost::asio::buffer(incoming_data_buffer),
@@ -145,6 +163,272 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
     }
 }
 
+void Connection::watch_client()
+{
+    watching_client = true;
+    TCP_socket.async_read_some(boost::asio::null_buffers(),
+                               strand.wrap(boost::bind(&Connection::handle_client_readable,
+                                                       this->shared_from_this(),
+                                                       boost::asio::placeholders::error,
+                                                       current_request.cancellation)));
+}
+
+void Connection::handle_client_readable(const boost::system::error_code &error,
+                                        const engine::QueryDeadline &cancellation)
+{
+    watching_client = false;
+    // the watch was stopped because the reply has been written
+    if (error == boost::asio::error::operation_aborted)
+    {
+        return;
+    }
+
+    // the socket is readable: either the client closed it or it sent its next request early
+    char next_byte;
+    boost::system::error_code ec;
+    const auto peeked = TCP_socket.receive(
+        boost::asio::buffer(&next_byte, 1), boost::asio::socket_base::message_peek, ec);
+    if (error || ec || peeked == 0)
+    {
+        cancellation.Cancel();
+    }
+}
+
+void Connection::handle_request(const http::compression_type compression_type)
+{
+    auto self = this->shared_from_this();
+    auto *metrics = current_request.uri == "/metrics" ? nullptr : request_handler.GetMetrics();
+    if (metrics)
+    {
+        metrics->ObservePhase(current_service,
+                              RequestPhase::Queue,
+                              std::chrono::steady_clock::now() - current_request.received);
+    }
+
+    request_handler.HandleRequest(
+        current_request,
+        current_reply,
+        [this, compression_type](const char *data, const std::size_t size) {
+            write_chunk(data, size, compression_type);
+        });
+
+    // headers and content of a streamed reply have been written already
+    if (current_reply.chunked)
+    {
+        // a failed streamed reply can only be signalled by closing the connection early
+        const bool written = current_reply.status == http::reply::ok && write_last_chunk();
+        count_reply(chunked_bytes_written);
+        if (!written)
+        {
+            strand.post([self] { self->handle_shutdown(); });
+            return;
+        }
+        strand.post([self] { self->handle_write(boost::system::error_code()); });
+        return;
+    }
+
+    set_connection_headers();
+
+    // compress the result w/ gzip/deflate if requested and worth it
+    const auto selected_compression = current_reply.content_size() < MIN_COMPRESSED_REPLY_SIZE
+                                          ? http::no_compression
+                                          : compression_type;
+    switch (selected_compression)
+    {
+    case http::deflate_rfc1951:
+        // use deflate for compression
+        current_reply.headers.insert(current_reply.headers.begin(),
+                                     {"Content-Encoding", "deflate"});
+        break;
+    case http::gzip_rfc1952:
+        // use gzip for compression
+        current_reply.headers.insert(current_reply.headers.begin(),
+                                     {"Content-Encoding", "gzip"});
+        break;
+    case http::no_compression:
+        break;
+    }
+
+    if (selected_compression != http::no_compression)
+    {
+        const auto compress_start = std::chrono::steady_clock::now();
+        compressor.begin(selected_compression);
+        for (const auto &buffer : current_reply.content_buffers())
+        {
+            compressor.write(boost::asio::buffer_cast<const char *>(buffer),
+                             boost::asio::buffer_size(buffer),
+                             false);
+        }
+        compressor.finish();
+        current_reply.set_size(compressor.output().size());
+        output_buffer = current_reply.headers_to_buffers();
+        output_buffer.push_back(boost::asio::buffer(compressor.output()));
+        if (metrics)
+        {
+            metrics->ObservePhase(current_service,
+                                  RequestPhase::Compress,
+                                  std::chrono::steady_clock::now() - compress_start);
+        }
+        count_reply(compressor.output().size());
+    }
+    else
+    {
+        // don't use any compression
+        current_reply.set_uncompressed_size();
+        output_buffer = current_reply.to_buffers();
+        count_reply(current_reply.content_size());
+    }
+
+    // sockets are only written asynchronously from the strand
+    strand.post([self] { self->write_reply(); });
+}
+
+void Connection::write_reply()
+{
+    boost::asio::async_write(TCP_socket,
+                             output_buffer,
+                             strand.wrap(boost::bind(&Connection::handle_write,
+                                                     this->shared_from_this(),
+                                                     boost::asio::placeholders::error)));
+}
+
+void Connection::set_connection_headers()
+{
+    if (boost::iequals(current_request.connection, "close"))
+    {
+        current_reply.headers.emplace_back("Connection", "close");
+    }
+    else
+    {
+        keep_alive = true;
+        current_reply.headers.emplace_back("Connection", "keep-alive");
+        current_reply.headers.emplace_back("Keep-Alive", "timeout=5, max=512");
+    }
+}
+
+void Connection::write_chunk(const char *data,
+                             const std::size_t size,
+                             const http::compression_type compression_type)
+{
+    auto chunk = std::make_shared<std::string>();
+    if (!chunked_headers_written)
+    {
+        set_connection_headers();
+        switch (compression_type)
+        {
+        case http::deflate_rfc1951:
+            current_reply.headers.insert(current_reply.headers.begin(),
+                                         {"Content-Encoding", "deflate"});
+            break;
+        case http::gzip_rfc1952:
+            current_reply.headers.insert(current_reply.headers.begin(),
+                                         {"Content-Encoding", "gzip"});
+            break;
+        case http::no_compression:
+            break;
+        }
+        if (compression_type != http::no_compression)
+        {
+            compressor.begin(compression_type);
+            compress_chunks = true;
+        }
+        current_reply.headers.emplace_back("Transfer-Encoding", "chunked");
+
+        for (const auto &buffer : current_reply.headers_to_buffers())
+        {
+            chunk->append(boost::asio::buffer_cast<const char *>(buffer),
+                          boost::asio::buffer_size(buffer));
+        }
+        chunked_headers_written = true;
+    }
+
+    if (compress_chunks)
+    {
+        // every chunk is flushed so clients can decompress what they have received so far
+        compressor.write(data, size, true);
+        append_chunk(*chunk, compressor.output().data(), compressor.output().size());
+        compressor.clear_output();
+    }
+    else
+    {
+        append_chunk(*chunk, data, size);
+    }
+
+    // abort handling the request if the client went away
+    const auto ec = write_from_worker(std::move(chunk));
+    if (ec)
+    {
+        throw boost::system::system_error(ec);
+    }
+}
+
+bool Connection::write_last_chunk()
+{
+    auto chunk = std::make_shared<std::string>();
+    if (compress_chunks)
+    {
+        compressor.finish();
+        compress_chunks = false;
+        append_chunk(*chunk, compressor.output().data(), compressor.output().size());
+        compressor.clear_output();
+    }
+    chunk->append("0\r\n\r\n");
+    chunked_headers_written = false;
+    return !write_from_worker(std::move(chunk));
+}
+
+void Connection::append_chunk(std::string &chunk, const char *data, const std::size_t size)
+{
+    // an empty chunk would end the reply
+    if (size == 0)
+    {
+        return;
+    }
+
+    std::ostringstream chunk_size;
+    chunk_size << std::hex << size << "\r\n";
+    chunk.append(chunk_size.str());
+    chunk.append(data, size);
+    chunk.append("\r\n");
+    chunked_bytes_written += size;
+}
+
+boost::system::error_code Connection::write_from_worker(std::shared_ptr<const std::string> data)
+{
+    // the socket is only used from the strand, where the client watch runs as well
+    auto self = this->shared_from_this();
+    auto written = std::make_shared<std::promise<boost::system::error_code>>();
+    auto result = written->get_future();
+    strand.post([self, data, written] {
+        boost::asio::async_write(
+            self->TCP_socket,
+            boost::asio::buffer(*data),
+            self->strand.wrap([self, data, written](const boost::system::error_code &error,
+                                                    std::size_t) { written->set_value(error); }));
+    });
+
+    // waiting for the write holds back the next block until the client took this one
+    if (result.wait_for(CHUNK_WRITE_TIMEOUT) != std::future_status::ready)
+    {
+        strand.post([self] { self->handle_shutdown(); });
+        return boost::asio::error::timed_out;
+    }
+    return result.get();
+}
+
+void Connection::count_reply(const std::size_t body_size)
+{
+    auto *metrics = request_handler.GetMetrics();
+    if (!metrics || current_request.uri == "/metrics")
+    {
+        return;
+    }
+    metrics->CountResponseBytes(current_service, body_size);
+    metrics->CountRequest(current_service,
+                          current_reply.status,
+                          std::chrono::steady_clock::now() - current_request.received);
+}
+
 /// Handle completion of a write operation.
 void Connection::handle_write(const boost::system::error_code &error)
 {
@@ -152,12 +436,21 @@ void Connection::handle_write(const boost::system::error_code &error)
     {
         if (keep_alive && processed_requests > 0)
         {
+            if (watching_client)
+            {
+                // the next request is read instead
+                boost::system::error_code ignore_error;
+                TCP_socket.cancel(ignore_error);
+            }
             --processed_requests;
             current_request = http::request();
             current_reply = http::reply();
             request_parser = RequestParser();
+            continue_sent = false;
+            chunked_bytes_written = 0;
             incoming_data_buffer = boost::array<char, 8192>();
             output_buffer.clear();
+            compressor.release_output();
             this->start();
         }
         else
@@ -188,28 +481,5 @@ void Connection::handle_shutdown()
     TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
 }
 
-std::vector<char> Connection::compress_buffers(const std::vector<char> &uncompressed_data,
-                                               const http::compression_type compression_type)
-{
-    boost::iostreams::gzip_params compression_parameters;
-
-    // there's a trade-off between speed and size. speed wins
-    compression_parameters.level = boost::iostreams::zlib::best_speed;
-    // check which compression flavor is used
-    if (http::deflate_rfc1951 == compression_type)
-    {
-        compression_parameters.noheader = true;
-    }
-
-    std::vector<char> compressed_data;
-    // plug data into boost's compression stream
-    boost::iostreams::filtering_ostream gzip_stream;
-    gzip_stream.push(boost::iostreams::gzip_compressor(compression_parameters));
-    gzip_stream.push(boost::iostreams::back_inserter(compressed_data));
-    gzip_stream.write(&uncompressed_data[0], uncompressed_data.size());
-    boost::iostreams::close(gzip_stream);
-
-    return compressed_data;
-}
 } // namespace server
 } // namespace osrm
@@ -0,0 +1,126 @@
+#include "server/http/compressor.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstring>
+#include <string>
+
+namespace osrm
+{
+namespace server
+{
+namespace http
+{
+
+namespace
+{
+// zlib writes into a block of this size that is appended to the output when it is full
+const constexpr std::size_t OUTPUT_BLOCK_SIZE = 64 * 1024;
+
+// Output buffers that grew beyond this for a large reply are freed once it has been sent
+const constexpr std::size_t MAX_KEPT_OUTPUT_SIZE = 1024 * 1024;
+
+int windowBits(const compression_type type)
+{
+    // a negative window size makes raw deflate, adding 16 wraps it as gzip
+    return type == deflate_rfc1951 ? -MAX_WBITS : MAX_WBITS + 16;
+}
+} // namespace
+
+compressor::compressor() : initialized(false), type(no_compression)
+{
+    std::memset(&stream, 0, sizeof(stream));
+}
+
+compressor::~compressor()
+{
+    if (initialized)
+    {
+        deflateEnd(&stream);
+    }
+}
+
+void compressor::begin(const compression_type type_)
+{
+    BOOST_ASSERT(type_ != no_compression);
+    compressed.clear();
+    if (output_block.empty())
+    {
+        output_block.resize(OUTPUT_BLOCK_SIZE);
+    }
+
+    if (initialized && type == type_)
+    {
+        deflateReset(&stream);
+        return;
+    }
+
+    // gzip and raw deflate use a different framing that a reset cannot change
+    if (initialized)
+    {
+        deflateEnd(&stream);
+        initialized = false;
+    }
+
+    // there's a trade-off between speed and size. speed wins
+    if (deflateInit2(&stream,
+                     Z_BEST_SPEED,
+                     Z_DEFLATED,
+                     windowBits(type_),
+                     8,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        throw util::exception("Could not initialize the zlib compression stream" + SOURCE_REF);
+    }
+    initialized = true;
+    type = type_;
+}
+
+void compressor::write(const char *data, const std::size_t size, const bool flush)
+{
+    BOOST_ASSERT(initialized);
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream.avail_in = static_cast<uInt>(size);
+    deflate_input(flush ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+}
+
+void compressor::finish()
+{
+    BOOST_ASSERT(initialized);
+    stream.next_in = nullptr;
+    stream.avail_in = 0;
+    deflate_input(Z_FINISH);
+}
+
+void compressor::release_output()
+{
+    compressed.clear();
+    if (compressed.capacity() > MAX_KEPT_OUTPUT_SIZE)
+    {
+        std::vector<char>().swap(compressed);
+    }
+}
+
+void compressor::deflate_input(const int flush_mode)
+{
+    int result = Z_OK;
+    do
+    {
+        // the output grows geometrically by appending full blocks, nothing is zero-filled
+        stream.next_out = reinterpret_cast<Bytef *>(output_block.data());
+        stream.avail_out = static_cast<uInt>(output_block.size());
+
+        result = deflate(&stream, flush_mode);
+        BOOST_ASSERT(result != Z_STREAM_ERROR);
+
+        compressed.insert(compressed.end(),
+                          output_block.begin(),
+                          output_block.end() - stream.avail_out);
+    } while (stream.avail_out == 0 || (flush_mode == Z_FINISH && result != Z_STREAM_END));
+}
+} // namespace http
+} // namespace server
+} // namespace osrm
@@ -0,0 +1,80 @@
+#include "server/http/content_chain.hpp"
+
+#include <mutex>
+
+namespace osrm
+{
+namespace server
+{
+namespace http
+{
+
+namespace
+{
+// Blocks kept for later replies, a few replies worth of megabytes
+const constexpr std::size_t MAX_POOLED_BLOCKS = 256;
+
+std::mutex pool_mutex;
+std::vector<std::unique_ptr<std::vector<char>>> pooled_blocks;
+} // namespace
+
+constexpr std::size_t content_chain::BLOCK_SIZE;
+
+content_chain::~content_chain()
+{
+    if (blocks.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(pool_mutex);
+    for (auto &block : blocks)
+    {
+        if (pooled_blocks.size() >= MAX_POOLED_BLOCKS)
+        {
+            break;
+        }
+        block->clear();
+        pooled_blocks.push_back(std::move(block));
+    }
+}
+
+std::size_t content_chain::size() const
+{
+    std::size_t size = 0;
+    for (const auto &block : blocks)
+    {
+        size += block->size();
+    }
+    return size;
+}
+
+std::vector<boost::asio::const_buffer> content_chain::buffers() const
+{
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.reserve(blocks.size());
+    for (const auto &block : blocks)
+    {
+        buffers.push_back(boost::asio::buffer(*block));
+    }
+    return buffers;
+}
+
+void content_chain::add_block()
+{
+    {
+        std::lock_guard<std::mutex> guard(pool_mutex);
+        if (!pooled_blocks.empty())
+        {
+            blocks.push_back(std::move(pooled_blocks.back()));
+            pooled_blocks.pop_back();
+            return;
+        }
+    }
+
+    blocks.push_back(std::make_unique<std::vector<char>>());
+    blocks.back()->reserve(BLOCK_SIZE);
+}
+} // namespace http
+} // namespace server
+} // namespace osrm
@@ -13,11 +13,19 @@ const char ok_html[] = "";
 const char bad_request_html[] = "";
 const char internal_server_error_html[] =
     "{\"code\": \"InternalError\",\"message\":\"Internal Server Error\"}";
+const char service_unavailable_html[] =
+    "{\"code\": \"Overloaded\",\"message\":\"Service Unavailable\"}";
+const char gateway_timeout_html[] =
+    "{\"code\": \"Timeout\",\"message\":\"Query took longer than allowed\"}";
 const char seperators[] = {':', ' '};
 const char crlf[] = {'\r', '\n'};
 const std::string http_ok_string = "HTTP/1.0 200 OK\r\n";
 const std::string http_bad_request_string = "HTTP/1.0 400 Bad Request\r\n";
 const std::string http_internal_server_error_string = "HTTP/1.0 500 Internal Server Error\r\n";
+const std::string http_service_unavailable_string = "HTTP/1.0 503 Service Unavailable\r\n";
+const std::string http_gateway_timeout_string = "HTTP/1.0 504 Gateway Timeout\r\n";
+// chunked transfer encoding needs HTTP/1.1
+const std::string http_chunked_ok_string = "HTTP/1.1 200 OK\r\n";
 
 void reply::set_size(const std::size_t size)
 {
@@ -30,7 +38,25 @@ void reply::set_size(const std::size_t size)
     }
 }
 
-void reply::set_uncompressed_size() { set_size(content.size()); }
+void reply::set_uncompressed_size() { set_size(content_size()); }
+
+std::size_t reply::content_size() const
+{
+    if (!content_owner)
+    {
+        return content.size();
+    }
+    return boost::asio::buffer_size(external_content);
+}
+
+std::vector<boost::asio::const_buffer> reply::content_buffers() const
+{
+    if (!content_owner)
+    {
+        return {boost::asio::buffer(content)};
+    }
+    return external_content;
+}
 
 std::vector<boost::asio::const_buffer> reply::to_buffers()
 {
@@ -44,14 +70,22 @@ std::vector<boost::asio::const_buffer> reply::to_buffers()
         buffers.push_back(boost::asio::buffer(crlf));
     }
     buffers.push_back(boost::asio::buffer(crlf));
-    buffers.push_back(boost::asio::buffer(content));
+    const auto content_chunks = content_buffers();
+    buffers.insert(buffers.end(), content_chunks.begin(), content_chunks.end());
     return buffers;
 }
 
 std::vector<boost::asio::const_buffer> reply::headers_to_buffers()
 {
     std::vector<boost::asio::const_buffer> buffers;
-    buffers.push_back(status_to_buffer(status));
+    if (chunked && status == reply::ok)
+    {
+        buffers.push_back(boost::asio::buffer(http_chunked_ok_string));
+    }
+    else
+    {
+        buffers.push_back(status_to_buffer(status));
+    }
     for (const header &current_header : headers)
     {
         buffers.push_back(boost::asio::buffer(current_header.name));
@@ -87,6 +121,14 @@ std::string reply::status_to_string(const reply::status_type status)
     {
         return bad_request_html;
     }
+    if (reply::service_unavailable == status)
+    {
+        return service_unavailable_html;
+    }
+    if (reply::gateway_timeout == status)
+    {
+        return gateway_timeout_html;
+    }
     return internal_server_error_html;
 }
 
@@ -100,10 +142,18 @@ boost::asio::const_buffer reply::status_to_buffer(const reply::status_type statu
     {
         return boost::asio::buffer(http_internal_server_error_string);
     }
+    if (reply::service_unavailable == status)
+    {
+        return boost::asio::buffer(http_service_unavailable_string);
+    }
+    if (reply::gateway_timeout == status)
+    {
+        return boost::asio::buffer(http_gateway_timeout_string);
+    }
     return boost::asio::buffer(http_bad_request_string);
 }
 
-reply::reply() : status(ok) {}
+reply::reply() : status(ok), chunked(false) {}
 } // namespace http
 } // namespace server
 } // namespace osrm
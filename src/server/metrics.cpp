@@ -0,0 +1,309 @@
+#include "server/metrics.hpp"
+
+#include "engine/data_watchdog.hpp"
+#include "engine/search_engine_data.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace osrm
+{
+namespace server
+{
+
+namespace
+{
+const char *const SERVICES[] = {
+    "route", "table", "nearest", "trip", "match", "tile", "isochrone", "batch"};
+const char *const OTHER_SERVICE = "other";
+
+const char *const PHASE_NAMES[NUMBER_OF_REQUEST_PHASES] = {"queue",
+                                                           "parse",
+                                                           "snapping",
+                                                           "search",
+                                                           "unpacking",
+                                                           "guidance",
+                                                           "assembly",
+                                                           "render",
+                                                           "compress"};
+
+const unsigned STATUS_CODES[] = {200, 400, 500, 503, 504};
+
+// Threads are numbered in the order they first report their heaps
+std::atomic<std::size_t> number_of_threads{0};
+thread_local std::size_t thread_index = std::numeric_limits<std::size_t>::max();
+
+std::size_t getThreadIndex()
+{
+    if (thread_index == std::numeric_limits<std::size_t>::max())
+    {
+        thread_index = number_of_threads.fetch_add(1);
+    }
+    return thread_index;
+}
+
+void writeHeader(std::ostream &out, const char *name, const char *type, const char *help)
+{
+    out << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+}
+} // namespace
+
+RequestPhase toRequestPhase(const engine::QueryPhase phase)
+{
+    switch (phase)
+    {
+    case engine::QueryPhase::Snapping:
+        return RequestPhase::Snapping;
+    case engine::QueryPhase::Search:
+        return RequestPhase::Search;
+    case engine::QueryPhase::Unpacking:
+        return RequestPhase::Unpacking;
+    case engine::QueryPhase::Guidance:
+        return RequestPhase::Guidance;
+    case engine::QueryPhase::Assembly:
+        return RequestPhase::Assembly;
+    }
+    BOOST_ASSERT_MSG(false, "unknown query phase");
+    return RequestPhase::Assembly;
+}
+
+const std::array<double, 15> LatencyHistogram::BUCKET_BOUNDS = {
+    0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30};
+
+LatencyHistogram::LatencyHistogram() : sum_in_nanoseconds(0), count(0)
+{
+    for (auto &bucket : buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::Observe(const std::chrono::nanoseconds duration)
+{
+    const auto seconds = std::chrono::duration<double>(duration).count();
+    std::size_t bucket = 0;
+    while (bucket < BUCKET_BOUNDS.size() && seconds > BUCKET_BOUNDS[bucket])
+    {
+        ++bucket;
+    }
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_in_nanoseconds.fetch_add(duration.count(), std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Render(std::ostream &out,
+                              const std::string &name,
+                              const std::string &labels) const
+{
+    // Prometheus buckets count all observations up to their bound
+    std::uint64_t cumulative_count = 0;
+    for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket)
+    {
+        cumulative_count += buckets[bucket].load(std::memory_order_relaxed);
+        out << name << "_bucket{" << labels << ",le=\"";
+        if (bucket < BUCKET_BOUNDS.size())
+        {
+            out << BUCKET_BOUNDS[bucket];
+        }
+        else
+        {
+            out << "+Inf";
+        }
+        out << "\"} " << cumulative_count << "\n";
+    }
+    out << name << "_sum{" << labels << "} "
+        << sum_in_nanoseconds.load(std::memory_order_relaxed) / 1e9 << "\n";
+    out << name << "_count{" << labels << "} " << count.load(std::memory_order_relaxed) << "\n";
+}
+
+Metrics::Metrics()
+    : other_service(*services.emplace(OTHER_SERVICE, std::make_unique<ServiceMetrics>())
+                         .first->second)
+{
+    for (const auto service : SERVICES)
+    {
+        services.emplace(service, std::make_unique<ServiceMetrics>());
+    }
+    for (auto &heap_size : heap_size_in_bytes)
+    {
+        heap_size.store(0, std::memory_order_relaxed);
+    }
+}
+
+Metrics::ServiceMetrics &Metrics::GetService(const std::string &service)
+{
+    // the map is not changed after construction, so it can be read from all threads
+    const auto iter = services.find(service);
+    return iter == services.end() ? other_service : *iter->second;
+}
+
+void Metrics::CountRequest(const std::string &service,
+                           const unsigned status_code,
+                           const std::chrono::nanoseconds duration)
+{
+    auto &service_metrics = GetService(service);
+    for (std::size_t index = 0; index < service_metrics.requests.size(); ++index)
+    {
+        if (STATUS_CODES[index] == status_code)
+        {
+            service_metrics.requests[index].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    service_metrics.duration.Observe(duration);
+}
+
+void Metrics::ObservePhase(const std::string &service,
+                           const RequestPhase phase,
+                           const std::chrono::nanoseconds duration)
+{
+    GetService(service).phase_durations[static_cast<std::size_t>(phase)].Observe(duration);
+}
+
+void Metrics::ObserveQuery(const std::string &service, const engine::QueryStatistics &statistics)
+{
+    auto &service_metrics = GetService(service);
+    for (std::size_t phase = 0; phase < engine::NUMBER_OF_QUERY_PHASES; ++phase)
+    {
+        const auto request_phase = toRequestPhase(static_cast<engine::QueryPhase>(phase));
+        service_metrics.phase_durations[static_cast<std::size_t>(request_phase)].Observe(
+            statistics.phase_durations[phase]);
+    }
+    service_metrics.settled_nodes.fetch_add(statistics.settled_nodes, std::memory_order_relaxed);
+
+    const auto thread = getThreadIndex();
+    if (thread < heap_size_in_bytes.size())
+    {
+        heap_size_in_bytes[thread].store(statistics.heap_size_in_bytes,
+                                         std::memory_order_relaxed);
+    }
+}
+
+void Metrics::CountResponseBytes(const std::string &service, const std::size_t bytes)
+{
+    GetService(service).response_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void Metrics::Render(std::ostream &out) const
+{
+    // enough digits for the sums of the histograms, the bucket bounds stay short
+    const auto precision = out.precision(12);
+
+    writeHeader(out, "osrm_requests_total", "counter", "Requests answered by osrm-routed.");
+    for (const auto &service : services)
+    {
+        for (std::size_t index = 0; index < service.second->requests.size(); ++index)
+        {
+            out << "osrm_requests_total{service=\"" << service.first << "\",code=\""
+                << STATUS_CODES[index] << "\"} "
+                << service.second->requests[index].load(std::memory_order_relaxed) << "\n";
+        }
+    }
+
+    writeHeader(out,
+                "osrm_request_duration_seconds",
+                "histogram",
+                "Time from receiving a request until its reply is ready.");
+    for (const auto &service : services)
+    {
+        service.second->duration.Render(
+            out, "osrm_request_duration_seconds", "service=\"" + service.first + "\"");
+    }
+
+    writeHeader(out,
+                "osrm_request_phase_duration_seconds",
+                "histogram",
+                "Time spent in each phase of handling a request.");
+    for (const auto &service : services)
+    {
+        for (std::size_t phase = 0; phase < NUMBER_OF_REQUEST_PHASES; ++phase)
+        {
+            service.second->phase_durations[phase].Render(
+                out,
+                "osrm_request_phase_duration_seconds",
+                "service=\"" + service.first + "\",phase=\"" + PHASE_NAMES[phase] + "\"");
+        }
+    }
+
+    writeHeader(out,
+                "osrm_settled_nodes_total",
+                "counter",
+                "Nodes settled by the searches of the requests.");
+    for (const auto &service : services)
+    {
+        out << "osrm_settled_nodes_total{service=\"" << service.first << "\"} "
+            << service.second->settled_nodes.load(std::memory_order_relaxed) << "\n";
+    }
+
+    writeHeader(out,
+                "osrm_response_bytes_total",
+                "counter",
+                "Bytes of the reply bodies as they were sent.");
+    for (const auto &service : services)
+    {
+        out << "osrm_response_bytes_total{service=\"" << service.first << "\"} "
+            << service.second->response_bytes.load(std::memory_order_relaxed) << "\n";
+    }
+
+    writeHeader(out,
+                "osrm_search_heap_bytes",
+                "gauge",
+                "Memory held by the search heaps of a thread after its last request.");
+    const auto threads = std::min(number_of_threads.load(), heap_size_in_bytes.size());
+    for (std::size_t thread = 0; thread < threads; ++thread)
+    {
+        out << "osrm_search_heap_bytes{thread=\"" << thread << "\"} "
+            << heap_size_in_bytes[thread].load(std::memory_order_relaxed) << "\n";
+    }
+
+    const auto heap_memory = engine::getSearchHeapMemory();
+    writeHeader(out,
+                "osrm_search_heap_total_bytes",
+                "gauge",
+                "Memory held by the search heaps of all threads.");
+    out << "osrm_search_heap_total_bytes " << heap_memory.heap_bytes << "\n";
+
+    writeHeader(out,
+                "osrm_search_heap_peak_bytes",
+                "gauge",
+                "Most memory the search heaps of all threads held at once.");
+    out << "osrm_search_heap_peak_bytes " << heap_memory.peak_heap_bytes << "\n";
+
+    writeHeader(out,
+                "osrm_search_heap_budget_bytes",
+                "gauge",
+                "Memory the search heaps of all threads may keep between queries, 0 if there is "
+                "no budget.");
+    out << "osrm_search_heap_budget_bytes " << heap_memory.max_heap_bytes << "\n";
+
+    writeHeader(out,
+                "osrm_search_heap_shrinks_total",
+                "counter",
+                "Search heaps shrunk to their initial size.");
+    out << "osrm_search_heap_shrinks_total " << heap_memory.shrunk_heaps << "\n";
+
+    writeHeader(out,
+                "osrm_search_heap_freed_bytes_total",
+                "counter",
+                "Memory freed by shrinking search heaps.");
+    out << "osrm_search_heap_freed_bytes_total " << heap_memory.freed_bytes << "\n";
+
+    writeHeader(out,
+                "osrm_data_swaps_total",
+                "counter",
+                "Switches to datasets updated by osrm-datastore.");
+    out << "osrm_data_swaps_total " << engine::GetDataSwapCount() << "\n";
+
+    out.precision(precision);
+}
+
+std::string Metrics::Render() const
+{
+    std::ostringstream out;
+    Render(out);
+    return out.str();
+}
+} // namespace server
+} // namespace osrm
@@ -1,7 +1,9 @@
 #include "server/request_handler.hpp"
 #include "server/service_handler.hpp"
 
+#include "server/api/body_parser.hpp"
 #include "server/api/url_parser.hpp"
+#include "server/http/content_chain.hpp"
 #include "server/http/reply.hpp"
 #include "server/http/request.hpp"
 
@@ -11,19 +13,20 @@
 #include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 
+#include "engine/query_deadline.hpp"
 #include "engine/status.hpp"
 #include "osrm/osrm.hpp"
 #include "util/json_container.hpp"
 
-#include <boost/iostreams/copy.hpp>
-#include <boost/iostreams/filter/gzip.hpp>
-#include <boost/iostreams/filtering_streambuf.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
+#include <chrono>
 #include <ctime>
 
 #include <algorithm>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <thread>
 
@@ -32,13 +35,100 @@ namespace osrm
 namespace server
 {
 
+namespace
+{
+void setContentHeaders(http::reply &current_reply, const ServiceHandler::ResultT &result)
+{
+    current_reply.headers.emplace_back("Access-Control-Allow-Origin", "*");
+    current_reply.headers.emplace_back("Access-Control-Allow-Methods", "GET, POST");
+    current_reply.headers.emplace_back("Access-Control-Allow-Headers",
+                                       "X-Requested-With, Content-Type");
+    if (result.is<util::json::Object>())
+    {
+        current_reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
+        current_reply.headers.emplace_back("Content-Disposition",
+                                           "inline; filename=\"response.json\"");
+    }
+    else if (result.is<flatbuffers::FlatBufferBuilder>())
+    {
+        current_reply.headers.emplace_back(
+            "Content-Type", "application/x-flatbuffers;schema=osrm.engine.api.fbresult");
+    }
+    else if (result.is<std::vector<char>>())
+    {
+        // binary results of failed requests hold the error as text
+        current_reply.headers.emplace_back("Content-Type",
+                                           current_reply.status == http::reply::ok
+                                               ? "application/octet-stream"
+                                               : "text/plain; charset=UTF-8");
+    }
+    else
+    {
+        BOOST_ASSERT(result.is<std::string>());
+        current_reply.headers.emplace_back("Content-Type", "application/x-protobuf");
+    }
+}
+
+// Server-Timing header of a request that asked for debug_timing, the engine phases are taken
+// from the microseconds of its debug_timing object
+std::string makeServerTiming(const util::json::Object &debug_timing,
+                             const std::chrono::nanoseconds parse_duration,
+                             const std::chrono::nanoseconds render_duration)
+{
+    const auto milliseconds = [](const double microseconds) {
+        return std::to_string(microseconds / 1000.);
+    };
+    const auto to_microseconds = [](const std::chrono::nanoseconds duration) {
+        return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(duration)
+            .count();
+    };
+
+    std::string server_timing = "parse;dur=" + milliseconds(to_microseconds(parse_duration));
+    const auto durations = debug_timing.values.find("durations");
+    if (durations != debug_timing.values.end() && durations->second.is<util::json::Object>())
+    {
+        const auto &phases = durations->second.get<util::json::Object>().values;
+        for (std::size_t phase = 0; phase < engine::NUMBER_OF_QUERY_PHASES; ++phase)
+        {
+            const auto name = engine::toString(static_cast<engine::QueryPhase>(phase));
+            const auto duration = phases.find(name);
+            if (duration != phases.end() && duration->second.is<util::json::Number>())
+            {
+                server_timing += std::string(", ") + name + ";dur=" +
+                                 milliseconds(duration->second.get<util::json::Number>().value);
+            }
+        }
+    }
+    server_timing += ", render;dur=" + milliseconds(to_microseconds(render_duration));
+    return server_timing;
+}
+} // namespace
+
 void RequestHandler::RegisterServiceHandler(
     std::unique_ptr<ServiceHandlerInterface> service_handler_)
 {
     service_handler = std::move(service_handler_);
 }
 
-void RequestHandler::HandleRequest(const http::request &current_request, http::reply &current_reply)
+void RequestHandler::RegisterAdmissionControl(
+    std::unique_ptr<AdmissionControl> admission_control_)
+{
+    admission_control = std::move(admission_control_);
+}
+
+void RequestHandler::RegisterMetrics(std::unique_ptr<Metrics> metrics_)
+{
+    metrics = std::move(metrics_);
+}
+
+void RequestHandler::RegisterResultCache(std::unique_ptr<ResultCache> result_cache_)
+{
+    result_cache = std::move(result_cache_);
+}
+
+void RequestHandler::HandleRequest(const http::request &current_request,
+                                   http::reply &current_reply,
+                                   const engine::api::ResultChunkWriter &write_chunk)
 {
     if (!service_handler)
     {
@@ -47,6 +137,16 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
         return;
     }
 
+    if (metrics && current_request.uri == "/metrics")
+    {
+        const auto rendered = metrics->Render();
+        current_reply.content.assign(rendered.begin(), rendered.end());
+        current_reply.headers.emplace_back("Content-Type", "text/plain; version=0.0.4");
+        current_reply.headers.emplace_back("Content-Length",
+                                           std::to_string(current_reply.content.size()));
+        return;
+    }
+
     const auto tid = std::this_thread::get_id();
 
     // parse command
@@ -58,24 +158,120 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
 
         util::Log(logDEBUG) << "[req][" << tid << "] " << request_string;
 
+        auto phase_start = std::chrono::steady_clock::now();
+        // Accounts the time since the last phase ended to the given phase
+        const auto observe_phase = [&](const std::string &service, const RequestPhase phase) {
+            const auto now = std::chrono::steady_clock::now();
+            const std::chrono::nanoseconds duration = now - phase_start;
+            if (metrics)
+            {
+                metrics->ObservePhase(service, phase, duration);
+            }
+            phase_start = now;
+            return duration;
+        };
+
+        // POST requests carry their coordinates in the body, the URL holds the options only
+        const bool has_body = boost::iequals(current_request.method, "POST");
         auto api_iterator = request_string.begin();
-        auto maybe_parsed_url = api::parseURL(api_iterator, request_string.end());
+        auto maybe_parsed_url = has_body ? api::parseBodyURL(api_iterator, request_string.end())
+                                         : api::parseURL(api_iterator, request_string.end());
         ServiceHandler::ResultT result;
 
+        // A streamed reply sends its headers ahead of the first chunk
+        const engine::api::ResultChunkWriter write_reply_chunk =
+            [&](const char *data, const std::size_t size) {
+                if (!current_reply.chunked)
+                {
+                    current_reply.chunked = true;
+                    setContentHeaders(current_reply, result);
+                }
+                write_chunk(data, size);
+            };
+
         // check if the was an error with the request
-        if (maybe_parsed_url && api_iterator == request_string.end())
-        {
+        const bool valid_url = maybe_parsed_url && api_iterator == request_string.end();
+        const bool valid_body =
+            !valid_url || !has_body ||
+            api::parseBody(current_request.content_type, current_request.body, *maybe_parsed_url);
+        const auto service = valid_url ? maybe_parsed_url->service : std::string{};
+
+        // cached replies are sent without asking the engine, the data version is taken before
+        // the query to drop replies computed from data that was replaced in the meantime
+        const auto cache_key = result_cache && valid_url && valid_body
+                                   ? result_cache->MakeKey(*maybe_parsed_url)
+                                   : std::string{};
+        const auto cache_generation = ResultCache::GetGeneration();
+        const auto cached_reply = cache_key.empty() ? nullptr : result_cache->Get(cache_key);
+        const auto parse_duration = observe_phase(service, RequestPhase::Parse);
 
-            const engine::Status status =
-                service_handler->RunQuery(*std::move(maybe_parsed_url), result);
-            if (status != engine::Status::Ok)
+        if (!valid_body)
+        {
+            current_reply.status = http::reply::bad_request;
+            result = util::json::Object();
+            auto &json_result = result.get<util::json::Object>();
+            json_result.values["code"] = "InvalidBody";
+            json_result.values["message"] =
+                "Request body malformed, expected a JSON object or packed binary coordinates";
+        }
+        else if (cached_reply)
+        {
+            for (const auto &header : cached_reply->headers)
+            {
+                current_reply.headers.emplace_back(header.first, header.second);
+            }
+            current_reply.external_content = {boost::asio::buffer(cached_reply->content)};
+            current_reply.content_owner = cached_reply;
+        }
+        else if (valid_url)
+        {
+            // the server is too busy if the budgets are exhausted or the request waited too long
+            const auto admission_ticket =
+                admission_control
+                    ? admission_control->Admit(*maybe_parsed_url, current_request.received)
+                    : AdmissionControl::Ticket{};
+            if (admission_control && !admission_ticket)
             {
-                // 4xx bad request return code
-                current_reply.status = http::reply::bad_request;
+                current_reply.status = http::reply::service_unavailable;
+                current_reply.headers.emplace_back(
+                    "Retry-After", std::to_string(admission_control->GetRetryAfter()));
+                result = util::json::Object();
+                auto &json_result = result.get<util::json::Object>();
+                json_result.values["code"] = "Overloaded";
+                json_result.values["message"] = "Too many requests, try again later";
             }
             else
             {
-                BOOST_ASSERT(status == engine::Status::Ok);
+                // the engine reports the phases of the query while statistics are collected
+                engine::QueryStatistics query_statistics;
+                auto statistics_scope =
+                    metrics ? std::make_unique<engine::QueryStatisticsScope>(query_statistics)
+                            : nullptr;
+                // the searches stop once the client went away
+                const engine::QueryDeadlineScope deadline_scope(&current_request.cancellation);
+                const engine::Status status = service_handler->RunQuery(
+                    *std::move(maybe_parsed_url),
+                    result,
+                    write_chunk ? write_reply_chunk : engine::api::ResultChunkWriter{});
+                statistics_scope.reset();
+                if (metrics)
+                {
+                    metrics->ObserveQuery(service, query_statistics);
+                }
+                phase_start = std::chrono::steady_clock::now();
+                if (status == engine::Status::Timeout)
+                {
+                    current_reply.status = http::reply::gateway_timeout;
+                }
+                else if (status != engine::Status::Ok)
+                {
+                    // 4xx bad request return code
+                    current_reply.status = http::reply::bad_request;
+                }
+                else
+                {
+                    BOOST_ASSERT(status == engine::Status::Ok);
+                }
             }
         }
         else
@@ -98,43 +294,84 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
                                             std::to_string(position) + ": \"" + context + "\"";
         }
 
-        current_reply.headers.emplace_back("Access-Control-Allow-Origin", "*");
-        current_reply.headers.emplace_back("Access-Control-Allow-Methods", "GET");
-        current_reply.headers.emplace_back("Access-Control-Allow-Headers",
-                                           "X-Requested-With, Content-Type");
-        if (result.is<util::json::Object>())
-        {
-            current_reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
-            current_reply.headers.emplace_back("Content-Disposition",
-                                               "inline; filename=\"response.json\"");
-
-            util::json::render(current_reply.content, result.get<util::json::Object>());
-        }
-        else if (result.is<flatbuffers::FlatBufferBuilder>())
+        if (cached_reply)
         {
-            auto &buffer = result.get<flatbuffers::FlatBufferBuilder>();
-            current_reply.content.resize(buffer.GetSize());
-            std::copy(buffer.GetBufferPointer(),
-                      buffer.GetBufferPointer() + buffer.GetSize(),
-                      current_reply.content.begin());
-
-            current_reply.headers.emplace_back(
-                "Content-Type", "application/x-flatbuffers;schema=osrm.engine.api.fbresult");
+            current_reply.headers.emplace_back("Content-Length",
+                                               std::to_string(current_reply.content_size()));
         }
-        else
+        else if (!current_reply.chunked)
         {
-            BOOST_ASSERT(result.is<std::string>());
-            current_reply.content.resize(result.get<std::string>().size());
-            std::copy(result.get<std::string>().cbegin(),
-                      result.get<std::string>().cend(),
-                      current_reply.content.begin());
+            setContentHeaders(current_reply, result);
+            // the reply takes over the rendered or serialized result and writes it from there
+            if (result.is<util::json::Object>())
+            {
+                auto rendered = std::make_shared<http::content_chain>();
+                const util::json::BasicArrayRenderer<http::content_chain> renderer(*rendered);
+                renderer(result.get<util::json::Object>());
+                current_reply.external_content = rendered->buffers();
+                current_reply.content_owner = std::move(rendered);
+            }
+            else if (result.is<flatbuffers::FlatBufferBuilder>())
+            {
+                auto buffer = std::make_shared<flatbuffers::DetachedBuffer>(
+                    result.get<flatbuffers::FlatBufferBuilder>().Release());
+                current_reply.external_content = {
+                    boost::asio::buffer(buffer->data(), buffer->size())};
+                current_reply.content_owner = std::move(buffer);
+            }
+            else if (result.is<std::vector<char>>())
+            {
+                current_reply.content = std::move(result.get<std::vector<char>>());
+            }
+            else
+            {
+                BOOST_ASSERT(result.is<std::string>());
+                auto buffer = std::make_shared<std::string>(std::move(result.get<std::string>()));
+                current_reply.external_content = {boost::asio::buffer(*buffer)};
+                current_reply.content_owner = std::move(buffer);
+            }
 
-            current_reply.headers.emplace_back("Content-Type", "application/x-protobuf");
-        }
+            // the cache holds a copy of the successful reply which is then sent from there
+            if (!cache_key.empty() && current_reply.status == http::reply::ok)
+            {
+                auto entry = std::make_shared<ResultCache::Entry>();
+                for (const auto &header : current_reply.headers)
+                {
+                    entry->headers.emplace_back(header.name, header.value);
+                }
+                entry->content.reserve(current_reply.content_size());
+                for (const auto &buffer : current_reply.content_buffers())
+                {
+                    const auto data = boost::asio::buffer_cast<const char *>(buffer);
+                    entry->content.insert(
+                        entry->content.end(), data, data + boost::asio::buffer_size(buffer));
+                }
+                current_reply.content.clear();
+                current_reply.external_content = {boost::asio::buffer(entry->content)};
+                current_reply.content_owner = entry;
+                result_cache->Put(cache_key, cache_generation, std::move(entry));
+            }
 
-        // set headers
-        current_reply.headers.emplace_back("Content-Length",
-                                           std::to_string(current_reply.content.size()));
+            // set headers
+            current_reply.headers.emplace_back("Content-Length",
+                                               std::to_string(current_reply.content_size()));
+            const auto render_duration = observe_phase(service, RequestPhase::Render);
+
+            if (result.is<util::json::Object>())
+            {
+                const auto &values = result.get<util::json::Object>().values;
+                const auto debug_timing = values.find("debug_timing");
+                if (debug_timing != values.end() &&
+                    debug_timing->second.is<util::json::Object>())
+                {
+                    current_reply.headers.emplace_back(
+                        "Server-Timing",
+                        makeServerTiming(debug_timing->second.get<util::json::Object>(),
+                                         parse_duration,
+                                         render_duration));
+                }
+            }
+        }
 
         if (!std::getenv("DISABLE_ACCESS_LOGGING"))
         {
@@ -172,7 +409,15 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
     }
     catch (const std::exception &e)
     {
-        current_reply = http::reply::stock_reply(http::reply::internal_server_error);
+        // Parts of a streamed reply have been sent already, the connection has to be dropped
+        if (current_reply.chunked)
+        {
+            current_reply.status = http::reply::internal_server_error;
+        }
+        else
+        {
+            current_reply = http::reply::stock_reply(http::reply::internal_server_error);
+        }
         util::Log(logWARNING) << "[server error][" << tid << "] code: " << e.what()
                               << ", uri: " << current_request.uri;
     }
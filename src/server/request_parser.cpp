@@ -6,6 +6,7 @@
 
 #include <boost/algorithm/string/predicate.hpp>
 
+#include <algorithm>
 #include <string>
 
 namespace osrm
@@ -13,9 +14,15 @@ namespace osrm
 namespace server
 {
 
+namespace
+{
+// Largest accepted request body, bodies carry at most a few hundred thousand coordinates
+const constexpr std::size_t MAX_BODY_SIZE = 16 * 1024 * 1024;
+} // namespace
+
 RequestParser::RequestParser()
     : state(internal_state::method_start), current_header({"", ""}),
-      selected_compression(http::no_compression)
+      selected_compression(http::no_compression), content_length(0), expect_continue(false)
 {
 }
 
@@ -24,6 +31,20 @@ RequestParser::parse(http::request &current_request, char *begin, char *end)
 {
     while (begin != end)
     {
+        // the body is copied as a whole instead of char by char
+        if (state == internal_state::body)
+        {
+            const auto size = std::min<std::size_t>(
+                end - begin, content_length - current_request.body.size());
+            current_request.body.append(begin, size);
+            begin += size;
+            if (current_request.body.size() == content_length)
+            {
+                return std::make_tuple(RequestStatus::valid, selected_compression);
+            }
+            continue;
+        }
+
         RequestStatus result = consume(current_request, *begin++);
         if (result != RequestStatus::indeterminate)
         {
@@ -35,6 +56,11 @@ RequestParser::parse(http::request &current_request, char *begin, char *end)
     return std::make_tuple(result, selected_compression);
 }
 
+bool RequestParser::expects_continue() const
+{
+    return expect_continue && state == internal_state::body;
+}
+
 RequestParser::RequestStatus RequestParser::consume(http::request &current_request,
                                                     const char input)
 {
@@ -46,6 +72,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             return RequestStatus::invalid;
         }
         state = internal_state::method;
+        current_request.method.push_back(input);
         return RequestStatus::indeterminate;
     case internal_state::method:
         if (input == ' ')
@@ -57,6 +84,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         {
             return RequestStatus::invalid;
         }
+        current_request.method.push_back(input);
         return RequestStatus::indeterminate;
     case internal_state::uri_start:
         if (is_CTL(input))
@@ -185,6 +213,36 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             current_request.connection = current_header.value;
         }
 
+        if (boost::iequals(current_header.name, "Content-Type"))
+        {
+            current_request.content_type = current_header.value;
+        }
+
+        if (boost::iequals(current_header.name, "Content-Length"))
+        {
+            if (current_header.value.empty() ||
+                !std::all_of(current_header.value.begin(),
+                             current_header.value.end(),
+                             [this](const char c) { return is_digit(c); }) ||
+                current_header.value.size() > 9 ||
+                std::stoul(current_header.value) > MAX_BODY_SIZE)
+            {
+                return RequestStatus::invalid;
+            }
+            content_length = std::stoul(current_header.value);
+        }
+
+        // only bodies of a known length are supported
+        if (boost::iequals(current_header.name, "Transfer-Encoding"))
+        {
+            return RequestStatus::invalid;
+        }
+
+        if (boost::iequals(current_header.name, "Expect"))
+        {
+            expect_continue = boost::iequals(current_header.value, "100-continue");
+        }
+
         if (input == '\r')
         {
             state = internal_state::expecting_newline_3;
@@ -250,8 +308,20 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
-    default: // expecting_newline_3
-        return input == '\n' ? RequestStatus::valid : RequestStatus::invalid;
+    case internal_state::expecting_newline_3:
+        if (input != '\n')
+        {
+            return RequestStatus::invalid;
+        }
+        if (content_length == 0)
+        {
+            return RequestStatus::valid;
+        }
+        state = internal_state::body;
+        current_request.body.reserve(content_length);
+        return RequestStatus::indeterminate;
+    default: // body, handled in parse
+        return RequestStatus::invalid;
     }
 }
 
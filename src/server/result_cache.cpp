@@ -0,0 +1,184 @@
+#include "server/result_cache.hpp"
+
+#include "engine/data_watchdog.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace osrm
+{
+namespace server
+{
+
+namespace
+{
+// Bookkeeping of an entry besides its strings: list node, index node and the entry itself
+const constexpr std::size_t ENTRY_OVERHEAD_IN_BYTES = 256;
+
+std::size_t getSizeInBytes(const std::string &key, const ResultCache::Entry &entry)
+{
+    auto size = ENTRY_OVERHEAD_IN_BYTES + 2 * key.size() + entry.content.size();
+    for (const auto &header : entry.headers)
+    {
+        size += header.first.size() + header.second.size();
+    }
+    return size;
+}
+
+// Name of an option like exclude=toll, the whole option if it has no value
+std::string getOptionName(const std::string &option)
+{
+    return option.substr(0, option.find('='));
+}
+} // namespace
+
+ResultCache::ResultCache(ResultCacheConfig config_)
+    : config(std::move(config_)),
+      max_shard_size_in_bytes(config.max_size_in_bytes / NUMBER_OF_SHARDS)
+{
+}
+
+std::string ResultCache::MakeKey(const api::ParsedURL &parsed_url) const
+{
+    // the sub-requests of a batch are not part of the key
+    if (!parsed_url.requests.empty() ||
+        std::find(config.services.begin(), config.services.end(), parsed_url.service) ==
+            config.services.end())
+    {
+        return {};
+    }
+
+    const auto options_begin = parsed_url.query.find('?');
+    std::string key = parsed_url.service + "/v" + std::to_string(parsed_url.version) + "/" +
+                      parsed_url.profile + "/" + parsed_url.query.substr(0, options_begin);
+
+    // The order of the options does not matter, unless an option is repeated
+    std::vector<std::string> options;
+    if (options_begin != std::string::npos)
+    {
+        auto option_begin = options_begin + 1;
+        while (option_begin <= parsed_url.query.size())
+        {
+            const auto option_end = std::min(parsed_url.query.find('&', option_begin),
+                                             parsed_url.query.size());
+            if (option_end > option_begin)
+            {
+                options.push_back(parsed_url.query.substr(option_begin, option_end - option_begin));
+            }
+            option_begin = option_end + 1;
+        }
+    }
+    std::stable_sort(
+        options.begin(), options.end(), [](const std::string &lhs, const std::string &rhs) {
+            return getOptionName(lhs) < getOptionName(rhs);
+        });
+
+    for (std::size_t index = 0; index < options.size(); ++index)
+    {
+        // the timing of a query has to be measured
+        if (getOptionName(options[index]) == "debug_timing")
+        {
+            return {};
+        }
+        key += index == 0 ? '?' : '&';
+        key += options[index];
+    }
+
+    // coordinates of a request body
+    for (const auto &coordinate : parsed_url.coordinates)
+    {
+        key += ';' + std::to_string(static_cast<std::int32_t>(coordinate.lon)) + ',' +
+               std::to_string(static_cast<std::int32_t>(coordinate.lat));
+    }
+    return key;
+}
+
+std::uint64_t ResultCache::GetGeneration() { return engine::GetDataSwapCount(); }
+
+ResultCache::Shard &ResultCache::GetShard(const std::string &key)
+{
+    return shards[std::hash<std::string>()(key) % NUMBER_OF_SHARDS];
+}
+
+void ResultCache::Invalidate(Shard &shard, const std::uint64_t generation)
+{
+    if (shard.generation < generation)
+    {
+        shard.entries.clear();
+        shard.index.clear();
+        shard.size_in_bytes = 0;
+        shard.generation = generation;
+    }
+}
+
+ResultCache::EntryPtr ResultCache::Get(const std::string &key)
+{
+    const auto generation = GetGeneration();
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    Invalidate(shard, generation);
+
+    const auto position = shard.index.find(key);
+    if (position == shard.index.end())
+    {
+        return nullptr;
+    }
+    // move to the front as the most recently used entry
+    shard.entries.splice(shard.entries.begin(), shard.entries, position->second);
+    return position->second->second;
+}
+
+void ResultCache::Put(const std::string &key, const std::uint64_t generation, EntryPtr entry)
+{
+    BOOST_ASSERT(entry);
+    const auto entry_size = getSizeInBytes(key, *entry);
+    if (entry_size > max_shard_size_in_bytes || generation != GetGeneration())
+    {
+        return;
+    }
+
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    Invalidate(shard, generation);
+    // the data was updated while the reply was computed
+    if (shard.generation != generation)
+    {
+        return;
+    }
+
+    const auto position = shard.index.find(key);
+    if (position != shard.index.end())
+    {
+        // a concurrent identical request stored its reply already
+        shard.entries.splice(shard.entries.begin(), shard.entries, position->second);
+        return;
+    }
+
+    while (shard.size_in_bytes + entry_size > max_shard_size_in_bytes)
+    {
+        BOOST_ASSERT(!shard.entries.empty());
+        const auto &oldest = shard.entries.back();
+        shard.size_in_bytes -= getSizeInBytes(oldest.first, *oldest.second);
+        shard.index.erase(oldest.first);
+        shard.entries.pop_back();
+    }
+
+    shard.entries.emplace_front(key, std::move(entry));
+    shard.index.emplace(key, shard.entries.begin());
+    shard.size_in_bytes += entry_size;
+}
+
+std::size_t ResultCache::GetSizeInBytes() const
+{
+    std::size_t size = 0;
+    for (const auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        size += shard.size_in_bytes;
+    }
+    return size;
+}
+} // namespace server
+} // namespace osrm
@@ -0,0 +1,163 @@
+#include "server/service/batch_service.hpp"
+
+#include "server/api/parameters_parser.hpp"
+#include "server/api/url_parser.hpp"
+#include "engine/api/batch_parameters.hpp"
+
+#include "util/json_container.hpp"
+#include "util/string_util.hpp"
+
+#include <boost/optional.hpp>
+#include <boost/spirit/include/qi.hpp>
+
+#include <iterator>
+#include <utility>
+
+namespace osrm
+{
+namespace server
+{
+namespace service
+{
+
+namespace
+{
+engine::Status setError(const std::string &code,
+                        const std::string &message,
+                        osrm::engine::api::ResultT &result)
+{
+    result = util::json::Object();
+    auto &json_result = result.get<util::json::Object>();
+    json_result.values["code"] = code;
+    json_result.values["message"] = message;
+    return engine::Status::Error;
+}
+
+// Parses the query of a sub-request, the error names the sub-request by its index
+template <typename ParametersT>
+boost::optional<ParametersT> parseQuery(const std::string &request_name,
+                                        const api::ParsedURL &parsed_url,
+                                        osrm::engine::api::ResultT &result)
+{
+    auto query = parsed_url.query;
+    auto query_iterator = query.begin();
+    auto parameters = api::parseParameters<ParametersT>(query_iterator, query.end());
+    if (!parameters || query_iterator != query.end())
+    {
+        const auto position = std::distance(query.begin(), query_iterator);
+        setError("InvalidQuery",
+                 request_name + " malformed close to position " +
+                     std::to_string(parsed_url.prefix_length + position),
+                 result);
+        return boost::none;
+    }
+
+    if (!parameters->IsValid())
+    {
+        setError("InvalidOptions", request_name + " has invalid options", result);
+        return boost::none;
+    }
+
+    if (parameters->format &&
+        parameters->format != engine::api::BaseParameters::OutputFormatType::JSON)
+    {
+        setError("InvalidOptions", request_name + " asks for a format other than JSON", result);
+        return boost::none;
+    }
+    return parameters;
+}
+} // namespace
+
+engine::Status BatchService::RunQuery(std::size_t,
+                                      std::string &,
+                                      const std::vector<util::Coordinate> &,
+                                      osrm::engine::api::ResultT &result)
+{
+    return setError("InvalidQuery",
+                    "Batch requests send their sub-requests in a JSON body with a requests array",
+                    result);
+}
+
+engine::Status BatchService::RunBatchQuery(std::size_t prefix_length,
+                                           std::string &query,
+                                           const std::vector<std::string> &requests,
+                                           osrm::engine::api::ResultT &result,
+                                           const osrm::engine::api::ResultChunkWriter &write_chunk)
+{
+    engine::api::BatchParameters parameters;
+
+    // the only option of a batch is its timeout
+    if (!query.empty())
+    {
+        auto query_iterator = query.begin();
+        unsigned timeout = 0;
+        if (!boost::spirit::qi::parse(
+                query_iterator, query.end(), "?timeout=" >> boost::spirit::qi::uint_, timeout) ||
+            query_iterator != query.end())
+        {
+            const auto position = std::distance(query.begin(), query_iterator);
+            return setError("InvalidQuery",
+                            "Batch requests take a timeout option only, found others at "
+                            "position " +
+                                std::to_string(prefix_length + position),
+                            result);
+        }
+        parameters.timeout = timeout;
+    }
+
+    parameters.queries.reserve(requests.size());
+    for (std::size_t index = 0; index < requests.size(); ++index)
+    {
+        const auto request_name = "Request " + std::to_string(index);
+
+        std::string request;
+        util::URIDecode(requests[index], request);
+        auto request_iterator = request.begin();
+        const auto parsed_url = api::parseURL(request_iterator, request.end());
+        if (!parsed_url)
+        {
+            const auto position = std::distance(request.begin(), request_iterator);
+            return setError("InvalidUrl",
+                            request_name + " URL string malformed close to position " +
+                                std::to_string(position),
+                            result);
+        }
+
+        if (parsed_url->version != 1 ||
+            (parsed_url->service != "route" && parsed_url->service != "nearest"))
+        {
+            return setError("InvalidService",
+                            request_name + " asks for service " + parsed_url->service + " v" +
+                                std::to_string(parsed_url->version) +
+                                ", batches hold route and nearest v1 requests only",
+                            result);
+        }
+
+        if (parsed_url->service == "route")
+        {
+            auto route_parameters =
+                parseQuery<engine::api::RouteParameters>(request_name, *parsed_url, result);
+            if (!route_parameters)
+            {
+                return engine::Status::Error;
+            }
+            parameters.queries.emplace_back(*std::move(route_parameters));
+        }
+        else
+        {
+            auto nearest_parameters =
+                parseQuery<engine::api::NearestParameters>(request_name, *parsed_url, result);
+            if (!nearest_parameters)
+            {
+                return engine::Status::Error;
+            }
+            parameters.queries.emplace_back(*std::move(nearest_parameters));
+        }
+    }
+    BOOST_ASSERT(parameters.IsValid());
+
+    return BaseService::routing_machine.Batch(parameters, result, write_chunk);
+}
+} // namespace service
+} // namespace server
+} // namespace osrm
@@ -43,14 +43,15 @@ std::string getWrongOptionHelp(const engine::api::MatchParameters &parameters)
 
 engine::Status MatchService::RunQuery(std::size_t prefix_length,
                                       std::string &query,
+                                      const std::vector<util::Coordinate> &coordinates,
                                       osrm::engine::api::ResultT &result)
 {
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
 
     auto query_iterator = query.begin();
-    auto parameters =
-        api::parseParameters<engine::api::MatchParameters>(query_iterator, query.end());
+    auto parameters = api::parseParameters<engine::api::MatchParameters>(
+        query_iterator, query.end(), coordinates);
     if (!parameters || query_iterator != query.end())
     {
         const auto position = std::distance(query.begin(), query_iterator);
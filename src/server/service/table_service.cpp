@@ -72,14 +72,25 @@ std::string getWrongOptionHelp(const engine::api::TableParameters &parameters)
 
 engine::Status TableService::RunQuery(std::size_t prefix_length,
                                       std::string &query,
+                                      const std::vector<util::Coordinate> &coordinates,
                                       osrm::engine::api::ResultT &result)
+{
+    return RunStreamingQuery(prefix_length, query, coordinates, result, {});
+}
+
+engine::Status
+TableService::RunStreamingQuery(std::size_t prefix_length,
+                                std::string &query,
+                                const std::vector<util::Coordinate> &coordinates,
+                                osrm::engine::api::ResultT &result,
+                                const osrm::engine::api::ResultChunkWriter &write_chunk)
 {
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
 
     auto query_iterator = query.begin();
-    auto parameters =
-        api::parseParameters<engine::api::TableParameters>(query_iterator, query.end());
+    auto parameters = api::parseParameters<engine::api::TableParameters>(
+        query_iterator, query.end(), coordinates);
     if (!parameters || query_iterator != query.end())
     {
         const auto position = std::distance(query.begin(), query_iterator);
@@ -104,6 +115,14 @@ engine::Status TableService::RunQuery(std::size_t prefix_length,
         {
             result = flatbuffers::FlatBufferBuilder();
         }
+        else if (parameters->format == engine::api::BaseParameters::OutputFormatType::BINARY)
+        {
+            result = std::vector<char>();
+        }
+    }
+    if (write_chunk)
+    {
+        return BaseService::routing_machine.Table(*parameters, result, write_chunk);
     }
     return BaseService::routing_machine.Table(*parameters, result);
 }
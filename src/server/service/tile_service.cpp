@@ -17,8 +17,19 @@ namespace service
 
 engine::Status TileService::RunQuery(std::size_t prefix_length,
                                      std::string &query,
+                                     const std::vector<util::Coordinate> &coordinates,
                                      osrm::engine::api::ResultT &result)
 {
+    // tiles are addressed by the query alone
+    if (!coordinates.empty())
+    {
+        result = util::json::Object();
+        auto &json_result = result.get<util::json::Object>();
+        json_result.values["code"] = "InvalidQuery";
+        json_result.values["message"] = "Tile requests do not take coordinates in the body";
+        return engine::Status::Error;
+    }
+
     auto query_iterator = query.begin();
     auto parameters =
         api::parseParameters<engine::api::TileParameters>(query_iterator, query.end());
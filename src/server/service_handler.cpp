@@ -1,5 +1,7 @@
 #include "server/service_handler.hpp"
 
+#include "server/service/batch_service.hpp"
+#include "server/service/isochrone_service.hpp"
 #include "server/service/match_service.hpp"
 #include "server/service/nearest_service.hpp"
 #include "server/service/route_service.hpp"
@@ -24,10 +26,15 @@ ServiceHandler::ServiceHandler(osrm::EngineConfig &config) : routing_machine(con
     service_map["trip"] = std::make_unique<service::TripService>(routing_machine);
     service_map["match"] = std::make_unique<service::MatchService>(routing_machine);
     service_map["tile"] = std::make_unique<service::TileService>(routing_machine);
+    service_map["isochrone"] = std::make_unique<service::IsochroneService>(routing_machine);
+    service_map["batch"] = std::make_unique<service::BatchService>(routing_machine);
 }
 
+void ServiceHandler::WarmUp() const { routing_machine.WarmUp(); }
+
 engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
-                                        osrm::engine::api::ResultT &result)
+                                        osrm::engine::api::ResultT &result,
+                                        const osrm::engine::api::ResultChunkWriter &write_chunk)
 {
     const auto &service_iter = service_map.find(parsed_url.service);
     if (service_iter == service_map.end())
@@ -49,7 +56,16 @@ engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
         return engine::Status::Error;
     }
 
-    return service->RunQuery(parsed_url.prefix_length, parsed_url.query, result);
+    if (!parsed_url.requests.empty())
+    {
+        return service->RunBatchQuery(parsed_url.prefix_length,
+                                      parsed_url.query,
+                                      parsed_url.requests,
+                                      result,
+                                      write_chunk);
+    }
+    return service->RunStreamingQuery(
+        parsed_url.prefix_length, parsed_url.query, parsed_url.coordinates, result, write_chunk);
 }
 } // namespace server
 } // namespace osrm
@@ -1,3 +1,5 @@
+#include "engine/search_engine_data.hpp"
+#include "server/admission_control.hpp"
 #include "server/server.hpp"
 #include "util/exception_utils.hpp"
 #include "util/log.hpp"
@@ -18,14 +20,17 @@
 
 #include <signal.h>
 
+#include <algorithm>
 #include <chrono>
 #include <exception>
 #include <future>
 #include <iostream>
 #include <memory>
 #include <new>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 boost::function0<void> console_ctrl_function;
@@ -81,12 +86,26 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              int &ip_port,
                                              bool &trial,
                                              EngineConfig &config,
-                                             int &requested_thread_num)
+                                             int &requested_thread_num,
+                                             int &requested_io_thread_num,
+                                             int &requested_io_shard_num,
+                                             bool &pin_io_shards,
+                                             bool &warm_up_heaps,
+                                             bool &enable_metrics,
+                                             server::ComputePoolConfig &compute_pool_config,
+                                             server::AdmissionControlConfig &admission_config,
+                                             server::ResultCacheConfig &result_cache_config)
 {
     using boost::filesystem::path;
     using boost::program_options::value;
 
     const auto hardware_threads = std::max<int>(1, std::thread::hardware_concurrency());
+    std::vector<std::string> service_concurrency;
+    std::vector<std::string> service_cost;
+    std::vector<std::string> service_query_time;
+    int max_queue_time = 0;
+    int heap_idle_time = 0;
+    std::size_t result_cache_size = 0;
 
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -113,7 +132,61 @@ inline unsigned generateServerProgramOptions(const int argc,
          "TCP/IP port") //
         ("threads,t",
          value<int>(&requested_thread_num)->default_value(hardware_threads),
-         "Number of threads to use") //
+         "Number of threads running queries") //
+        ("io-threads",
+         value<int>(&requested_io_thread_num)->default_value(std::min(2, hardware_threads)),
+         "Number of threads accepting connections, reading requests and writing replies") //
+        ("io-shards",
+         value<int>(&requested_io_shard_num)->default_value(0),
+         "Number of I/O threads with a listening socket of their own (SO_REUSEPORT), replaces "
+         "--io-threads. 0 shares one listening socket between all I/O threads.") //
+        ("pin-io-shards",
+         value<bool>(&pin_io_shards)->implicit_value(true)->default_value(false),
+         "Pin the thread of each I/O shard to a CPU") //
+        ("max-queued-requests",
+         value<std::size_t>(&compute_pool_config.max_queued_requests)->default_value(0),
+         "Max. number of requests waiting for a thread, further requests are answered with "
+         "503 Service Unavailable. 0 is unlimited.") //
+        ("warm-up-heaps",
+         value<bool>(&warm_up_heaps)->implicit_value(true)->default_value(false),
+         "Create the search heaps of every thread at startup instead of on its first query") //
+        ("heap-idle-time",
+         value<int>(&heap_idle_time)->default_value(0),
+         "Time in seconds after which threads without queries shrink their search heaps. 0 "
+         "keeps them.") //
+        ("max-service-concurrency",
+         value<std::vector<std::string>>(&service_concurrency)->composing(),
+         "Max. number of requests of a service running at the same time, as <service>=<number>, "
+         "e.g. table=2") //
+        ("max-inflight-requests",
+         value<std::size_t>(&admission_config.max_inflight_requests)->default_value(0),
+         "Max. number of requests processed at the same time, further requests are answered with "
+         "503 Service Unavailable. 0 is unlimited.") //
+        ("max-inflight-cost",
+         value<std::vector<std::string>>(&service_cost)->composing(),
+         "Max. estimated cost of the requests of a service processed at the same time, as "
+         "<service>=<cost>. The cost of a table or trip request is the number of its coordinates "
+         "squared, for other services the number of its coordinates.") //
+        ("max-queue-time",
+         value<int>(&max_queue_time)->default_value(0),
+         "Max. time in milliseconds a request may wait for a thread before it is answered with "
+         "503 Service Unavailable. 0 is unlimited.") //
+        ("retry-after",
+         value<unsigned>(&admission_config.retry_after)->default_value(1),
+         "Seconds clients are asked to wait before retrying a request answered with 503") //
+        ("metrics",
+         value<bool>(&enable_metrics)->implicit_value(true)->default_value(false),
+         "Collect request and search statistics and serve them at /metrics in the Prometheus "
+         "text format") //
+        ("result-cache-size",
+         value<std::size_t>(&result_cache_size)->default_value(0),
+         "Memory in MiB for replies of identical requests sent again without running them. "
+         "0 disables the cache.") //
+        ("result-cache-services",
+         value<std::vector<std::string>>(&result_cache_config.services)
+             ->composing()
+             ->default_value(result_cache_config.services, "route nearest"),
+         "Services whose replies are cached, e.g. route") //
         ("shared-memory,s",
          value<bool>(&config.use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
@@ -148,6 +221,38 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("max-alternatives",
          value<int>(&config.max_alternatives)->default_value(3),
          "Max. number of alternatives supported in the MLD route query") //
+        ("max-table-parallelism",
+         value<int>(&config.max_table_parallelism)->default_value(1),
+         "Max. number of threads a single distance table query may use") //
+        ("rphast-min-destinations",
+         value<int>(&config.rphast_min_destinations)->default_value(1000),
+         "Min. number of destinations for which distance table queries sweep over the search "
+         "space of the destinations. -1 disables it.") //
+        ("table-bucket-cache-size",
+         value<int>(&config.table_bucket_cache_size)->default_value(0),
+         "Size in megabytes of the cache keeping the search buckets of distance table targets "
+         "across queries. 0 disables it.") //
+        ("overlay-path-cache-size",
+         value<int>(&config.overlay_path_cache_size)->default_value(0),
+         "Size in megabytes of the cache keeping the unpacked paths of MLD overlay edges across "
+         "queries. 0 disables it.") //
+        ("max-isochrone-duration",
+         value<int>(&config.max_duration_isochrone)->default_value(3600),
+         "Max. contour duration in seconds supported in isochrone query") //
+        ("max-batch-size",
+         value<int>(&config.max_batch_size)->default_value(1000),
+         "Max. number of sub-requests supported in batch query") //
+        ("max-batch-parallelism",
+         value<int>(&config.max_batch_parallelism)->default_value(1),
+         "Max. number of threads a single batch query may use") //
+        ("max-heap-memory",
+         value<int>(&config.max_heap_memory)->default_value(0),
+         "Memory in megabytes the search heaps of all threads may keep between queries, the "
+         "heaps of a thread are shrunk after a query beyond its share. 0 is unlimited.") //
+        ("max-query-time",
+         value<std::vector<std::string>>(&service_query_time)->composing(),
+         "Max. time in milliseconds a query of a service may run, as <service>=<milliseconds>. "
+         "Longer queries are answered with 504 Gateway Timeout.") //
         ("max-matching-radius",
          value<double>(&config.max_radius_map_matching)->default_value(-1.0),
          "Max. radius size supported in map matching query. Default: unlimited.");
@@ -200,6 +305,48 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
+    // Per service limits given as <service>=<number>
+    const auto parse_service_limits = [](const std::vector<std::string> &service_limits,
+                                         const char *option,
+                                         auto &limits) {
+        for (const auto &service_limit : service_limits)
+        {
+            const auto separator = service_limit.find('=');
+            try
+            {
+                if (separator == std::string::npos || separator == 0)
+                {
+                    throw std::invalid_argument(service_limit);
+                }
+                const auto limit = std::stoll(service_limit.substr(separator + 1));
+                if (limit < 0)
+                {
+                    throw std::invalid_argument(service_limit);
+                }
+                limits[service_limit.substr(0, separator)] = limit;
+            }
+            catch (const std::logic_error &)
+            {
+                util::Log(logERROR) << "Invalid " << option << " " << service_limit
+                                    << ", expected <service>=<number>";
+                return false;
+            }
+        }
+        return true;
+    };
+    if (!parse_service_limits(service_concurrency,
+                              "max-service-concurrency",
+                              compute_pool_config.max_service_concurrency) ||
+        !parse_service_limits(
+            service_cost, "max-inflight-cost", admission_config.max_inflight_cost) ||
+        !parse_service_limits(service_query_time, "max-query-time", config.max_query_time))
+    {
+        return INIT_FAILED;
+    }
+    admission_config.max_queue_time = std::chrono::milliseconds(std::max(0, max_queue_time));
+    compute_pool_config.idle_time = std::chrono::seconds(std::max(0, heap_idle_time));
+    result_cache_config.max_size_in_bytes = result_cache_size * 1024 * 1024;
+
     if (!config.use_shared_memory && option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
@@ -233,8 +380,30 @@ try
     boost::filesystem::path base_path;
 
     int requested_thread_num = 1;
-    const unsigned init_result = generateServerProgramOptions(
-        argc, argv, base_path, ip_address, ip_port, trial_run, config, requested_thread_num);
+    int requested_io_thread_num = 1;
+    int requested_io_shard_num = 0;
+    bool pin_io_shards = false;
+    bool warm_up_heaps = false;
+    bool enable_metrics = false;
+    server::ComputePoolConfig compute_pool_config;
+    server::AdmissionControlConfig admission_config;
+    server::ResultCacheConfig result_cache_config;
+    const unsigned init_result = generateServerProgramOptions(argc,
+                                                              argv,
+                                                              base_path,
+                                                              ip_address,
+                                                              ip_port,
+                                                              trial_run,
+                                                              config,
+                                                              requested_thread_num,
+                                                              requested_io_thread_num,
+                                                              requested_io_shard_num,
+                                                              pin_io_shards,
+                                                              warm_up_heaps,
+                                                              enable_metrics,
+                                                              compute_pool_config,
+                                                              admission_config,
+                                                              result_cache_config);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -272,6 +441,14 @@ try
     }
 
     util::Log() << "Threads: " << requested_thread_num;
+    if (requested_io_shard_num > 0)
+    {
+        util::Log() << "I/O shards: " << requested_io_shard_num;
+    }
+    else
+    {
+        util::Log() << "I/O threads: " << requested_io_thread_num;
+    }
     util::Log() << "IP address: " << ip_address;
     util::Log() << "IP port: " << ip_port;
 
@@ -286,9 +463,33 @@ try
 #endif
 
     auto service_handler = std::make_unique<server::ServiceHandler>(config);
-    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
+    compute_pool_config.num_threads = std::max(1, requested_thread_num);
+    if (warm_up_heaps)
+    {
+        // the server keeps the handler until the workers are joined
+        const auto &handler = *service_handler;
+        compute_pool_config.on_start = [&handler] { handler.WarmUp(); };
+    }
+    compute_pool_config.on_idle = engine::shrinkSearchHeaps;
+    auto routing_server = server::Server::CreateServer(ip_address,
+                                                       ip_port,
+                                                       std::max(1, requested_io_thread_num),
+                                                       std::max(0, requested_io_shard_num),
+                                                       pin_io_shards,
+                                                       compute_pool_config);
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
+    routing_server->RegisterAdmissionControl(
+        std::make_unique<server::AdmissionControl>(std::move(admission_config)));
+    if (enable_metrics)
+    {
+        routing_server->RegisterMetrics(std::make_unique<server::Metrics>());
+    }
+    if (result_cache_config.max_size_in_bytes > 0)
+    {
+        routing_server->RegisterResultCache(
+            std::make_unique<server::ResultCache>(std::move(result_cache_config)));
+    }
 
     if (trial_run)
     {
@@ -62,6 +62,39 @@ test('table: returns buffer', function(assert) {
     });
 });
 
+test('table: returns binary buffer', function(assert) {
+    assert.plan(9);
+    var osrm = new OSRM(data_path);
+    var options = {
+        coordinates: [three_test_coordinates[0], three_test_coordinates[1]],
+        annotations: ['duration', 'distance']
+    };
+    osrm.table(options, { format: 'bin' }, function(err, table) {
+        assert.ifError(err);
+        assert.ok(table instanceof Buffer);
+        var rows = table.readUInt32LE(0);
+        var cols = table.readUInt32LE(4);
+        assert.equal(rows, 2);
+        assert.equal(cols, 2);
+        assert.equal(table.readUInt32LE(8), 3, 'durations and distances');
+        assert.equal(table.readUInt32LE(12), 10, 'durations in deciseconds');
+        // header, padded estimated cell bitmap, durations and distances
+        assert.equal(table.length, 16 + 4 + 2 * rows * cols * 4);
+        assert.equal(table.readInt32LE(20), 0, 'zero duration on the diagonal');
+        assert.ok(table.readFloatLE(20 + rows * cols * 4 + 4) > 0, 'distance between the coordinates');
+    });
+});
+
+test('table: binary format only for table', function(assert) {
+    assert.plan(1);
+    var osrm = new OSRM(data_path);
+    var options = {
+        coordinates: [three_test_coordinates[0], three_test_coordinates[1]]
+    };
+    assert.throws(function() { osrm.route(options, { format: 'bin' }, function(err, route) {}); },
+        /format "bin" is only supported by the table plugin/);
+});
+
 var tables = ['distances', 'durations'];
 
 tables.forEach(function(annotation) {
@@ -1,5 +1,8 @@
 #include "contractor/files.hpp"
 #include "contractor/graph_contractor_adaptors.hpp"
+#include "contractor/shortcut_children.hpp"
+
+#include "util/integer_range.hpp"
 
 #include "../common/range_tools.hpp"
 #include "../common/temporary_file.hpp"
@@ -30,9 +33,22 @@ BOOST_AUTO_TEST_CASE(read_write_hsgr)
         {false, false, false, false, false, false, false},
         {true, true, true, true, true, true, true},
     };
+    // the graph has no shortcuts, the tables hold made up children of one edge each
+    const auto number_of_edges = reference_graph.GetNumberOfEdges();
+    std::vector<ShortcutChildrenTable> reference_children;
+    for (const auto index : util::irange<EdgeID>(0, reference_filters.size()))
+    {
+        std::vector<ShortcutChildren> edge_children(
+            number_of_edges, ShortcutChildren{SPECIAL_EDGEID, SPECIAL_EDGEID});
+        edge_children[index] = {index + 1, index + 2};
+        reference_children.emplace_back(edge_children);
+    }
 
     std::unordered_map<std::string, ContractedMetric> reference_metrics = {
-        {"duration", {std::move(reference_graph), std::move(reference_filters)}}};
+        {"duration",
+         {std::move(reference_graph),
+          std::move(reference_filters),
+          std::move(reference_children)}}};
 
     TemporaryFile tmp{TEST_DATA_DIR "/read_write_hsgr_test.osrm.hsgr"};
     contractor::files::writeGraph(tmp.path, reference_metrics, reference_connectivity_checksum);
@@ -53,6 +69,45 @@ BOOST_AUTO_TEST_CASE(read_write_hsgr)
                             reference_metrics["duration"].edge_filter[2]);
     CHECK_EQUAL_COLLECTIONS(metrics["duration"].edge_filter[3],
                             reference_metrics["duration"].edge_filter[3]);
+
+    const auto &children = metrics["duration"].shortcut_children;
+    const auto &reference = reference_metrics["duration"].shortcut_children;
+    BOOST_REQUIRE_EQUAL(children.size(), reference.size());
+    for (const auto index : util::irange<std::size_t>(0, reference.size()))
+    {
+        BOOST_REQUIRE_EQUAL(children[index].GetNumberOfShortcuts(), 1);
+        for (const auto edge : util::irange<EdgeID>(0, number_of_edges))
+        {
+            BOOST_CHECK_EQUAL(children[index][edge].first, reference[index][edge].first);
+            BOOST_CHECK_EQUAL(children[index][edge].second, reference[index][edge].second);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(read_hsgr_without_shortcut_children)
+{
+    // a file of an older version, without the children of shortcuts
+    std::vector<TestEdge> edges = {TestEdge{0, 1, 3}, TestEdge{1, 2, 1}};
+    const auto reference_graph = QueryGraph{3, toEdges<QueryEdge>(makeGraph(edges))};
+
+    TemporaryFile tmp{TEST_DATA_DIR "/read_hsgr_without_children_test.osrm.hsgr"};
+    {
+        storage::tar::FileWriter writer{tmp.path, storage::tar::FileWriter::GenerateFingerprint};
+        writer.WriteElementCount64("/ch/connectivity_checksum", 1);
+        writer.WriteFrom("/ch/connectivity_checksum", 0xDEADBEEF);
+        util::serialization::write(
+            writer, "/ch/metrics/duration/contracted_graph", reference_graph);
+        writer.WriteElementCount64("/ch/metrics/duration/exclude", 0);
+    }
+
+    unsigned connectivity_checksum;
+    std::unordered_map<std::string, ContractedMetric> metrics = {{"duration", {}}};
+    contractor::files::readGraph(tmp.path, metrics, connectivity_checksum);
+
+    BOOST_CHECK_EQUAL(connectivity_checksum, 0xDEADBEEF);
+    BOOST_CHECK_EQUAL(metrics["duration"].graph.GetNumberOfEdges(),
+                      reference_graph.GetNumberOfEdges());
+    BOOST_CHECK(metrics["duration"].shortcut_children.empty());
 }
 
 BOOST_AUTO_TEST_SUITE_END()
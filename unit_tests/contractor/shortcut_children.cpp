@@ -0,0 +1,92 @@
+#include "contractor/shortcut_children.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(shortcut_children)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+namespace
+{
+QueryEdge makeEdge(const NodeID source,
+                   const NodeID target,
+                   const NodeID turn_id,
+                   const bool shortcut,
+                   const EdgeWeight weight,
+                   const bool forward,
+                   const bool backward)
+{
+    return {source, target, {turn_id, shortcut, weight, weight, 0, forward, backward}};
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(children_of_shortcuts)
+{
+    // Node 0 is contracted first, the shortcuts between 1, 2 and 3 skip it.
+    std::vector<QueryEdge> edges = {
+        makeEdge(0, 1, 10, false, 1, false, true), // 1 -> 0
+        makeEdge(0, 2, 11, false, 2, true, false), // 0 -> 2
+        makeEdge(0, 2, 12, false, 5, true, false), // 0 -> 2, longer
+        makeEdge(0, 3, 13, false, 1, true, true),  // 0 <-> 3
+        makeEdge(1, 2, 0, true, 3, true, false),   // 1 -> 0 -> 2
+        makeEdge(1, 3, 0, true, 2, true, true),    // 1 <-> 0 <-> 3
+        makeEdge(3, 1, 0, true, 2, false, true),   // 1 -> 0 -> 3
+    };
+    const QueryGraph graph{4, edges};
+
+    const std::vector<bool> all_edges(edges.size(), true);
+    const auto children = makeShortcutChildren(graph, all_edges);
+    BOOST_CHECK_EQUAL(children.GetNumberOfShortcuts(), 2);
+
+    // edges are no shortcuts, the shortcut usable in both directions falls back to the lookup
+    for (const auto edge : {0, 1, 2, 3, 5})
+    {
+        BOOST_CHECK_EQUAL(children[edge].first, SPECIAL_EDGEID);
+        BOOST_CHECK_EQUAL(children[edge].second, SPECIAL_EDGEID);
+    }
+
+    // the halves take the smallest edges
+    BOOST_CHECK_EQUAL(children[4].first, 0);
+    BOOST_CHECK_EQUAL(children[4].second, 1);
+
+    // the path of a backward shortcut ends at the node it is stored at
+    BOOST_CHECK_EQUAL(children[6].first, 0);
+    BOOST_CHECK_EQUAL(children[6].second, 3);
+
+    // children are found among the edges the filter keeps
+    std::vector<bool> edge_filter(edges.size(), true);
+    edge_filter[1] = false;
+    edge_filter[6] = false;
+    const auto filtered_children = makeShortcutChildren(graph, edge_filter);
+    BOOST_CHECK_EQUAL(filtered_children[4].first, 0);
+    BOOST_CHECK_EQUAL(filtered_children[4].second, 2);
+    BOOST_CHECK_EQUAL(filtered_children[6].first, SPECIAL_EDGEID);
+    BOOST_CHECK_EQUAL(filtered_children[6].second, SPECIAL_EDGEID);
+}
+
+BOOST_AUTO_TEST_CASE(children_table_lookup)
+{
+    // children of every third edge, spread over several words of the table
+    std::vector<ShortcutChildren> edge_children(200,
+                                                ShortcutChildren{SPECIAL_EDGEID, SPECIAL_EDGEID});
+    for (EdgeID edge = 0; edge < edge_children.size(); edge += 3)
+    {
+        edge_children[edge] = {edge + 1000, edge + 2000};
+    }
+
+    const ShortcutChildrenTable table{edge_children};
+    BOOST_CHECK_EQUAL(table.GetNumberOfShortcuts(), 67);
+    for (EdgeID edge = 0; edge < edge_children.size(); ++edge)
+    {
+        BOOST_CHECK_EQUAL(table[edge].first, edge_children[edge].first);
+        BOOST_CHECK_EQUAL(table[edge].second, edge_children[edge].second);
+    }
+
+    // an empty table has no children for any edge
+    const ShortcutChildrenTable empty_table;
+    BOOST_CHECK_EQUAL(empty_table[0].first, SPECIAL_EDGEID);
+    BOOST_CHECK_EQUAL(empty_table[100].second, SPECIAL_EDGEID);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
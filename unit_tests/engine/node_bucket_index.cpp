@@ -0,0 +1,73 @@
+#include "engine/routing_algorithms/many_to_many.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(node_bucket_index)
+
+using namespace osrm;
+using namespace osrm::engine::routing_algorithms;
+
+BOOST_AUTO_TEST_CASE(empty_index)
+{
+    const NodeBucketIndex index(std::vector<std::vector<NodeBucket>>(3));
+
+    BOOST_CHECK_EQUAL(index.size(), 0);
+    BOOST_CHECK(index[0].empty());
+    BOOST_CHECK(index[42].empty());
+    BOOST_CHECK(index.Find(42, 1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(buckets_grouped_by_node_and_ordered_by_column)
+{
+    std::vector<std::vector<NodeBucket>> column_buckets(3);
+    column_buckets[0] = {{10, 10, 0, 0, 0, 0}, {11, 10, 0, 5, 5, 5}, {12, 11, 0, 7, 7, 7}};
+    column_buckets[1] = {{12, 12, 1, 0, 0, 0}, {10, 12, 1, 3, 3, 3}};
+    column_buckets[2] = {{10, 10, 2, 0, 0, 0}, {13, 10, 2, 4, 4, 4}, {12, 13, 2, 9, 9, 9}};
+
+    const NodeBucketIndex index(column_buckets);
+    BOOST_CHECK_EQUAL(index.size(), 8);
+
+    const auto check_columns = [&](const NodeID node, const std::vector<unsigned> &columns) {
+        std::vector<unsigned> result;
+        for (const auto &bucket : index[node])
+        {
+            BOOST_CHECK_EQUAL(bucket.middle_node, node);
+            result.push_back(bucket.column_index);
+        }
+        BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), columns.begin(), columns.end());
+    };
+
+    check_columns(10, {0, 1, 2});
+    check_columns(11, {0});
+    check_columns(12, {0, 1, 2});
+    check_columns(13, {2});
+    check_columns(14, {});
+
+    const auto bucket = index.Find(12, 2);
+    BOOST_REQUIRE_EQUAL(bucket.size(), 1);
+    BOOST_CHECK_EQUAL(bucket.front().parent_node, 13);
+    BOOST_CHECK_EQUAL(bucket.front().weight, 9);
+    BOOST_CHECK(index.Find(11, 1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(many_nodes)
+{
+    std::vector<std::vector<NodeBucket>> column_buckets(2);
+    for (NodeID node = 0; node < 10000; ++node)
+    {
+        column_buckets[node % 2].emplace_back(node * 7, node, node % 2, node, node, node);
+    }
+
+    const NodeBucketIndex index(column_buckets);
+    for (NodeID node = 0; node < 10000; ++node)
+    {
+        const auto buckets = index[node * 7];
+        BOOST_REQUIRE_EQUAL(buckets.size(), 1);
+        BOOST_CHECK_EQUAL(buckets.front().parent_node, node);
+        BOOST_CHECK(index[node * 7 + 1].empty());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+#include "engine/routing_algorithms/overlay_path_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+
+BOOST_AUTO_TEST_SUITE(overlay_path_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::engine::routing_algorithms;
+
+namespace
+{
+OverlayPathCache::PathPtr makePath(const NodeID source, const NodeID target)
+{
+    return std::make_shared<const OverlayPathCache::Path>(
+        OverlayPathCache::Path{{source, source + 1, target}, {source, source + 1}});
+}
+
+OverlayPathCache::Key makeKey(const void *dataset, const NodeID source, const NodeID target)
+{
+    return OverlayPathCache::Key{dataset, 1, source, target, false, false};
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(disabled_cache)
+{
+    OverlayPathCache cache;
+    BOOST_CHECK(!cache.IsEnabled());
+
+    const auto dataset = std::make_shared<int>(0);
+    const OverlayPathCacheScope scope(cache, dataset);
+    BOOST_CHECK(!OverlayPathCacheScope::Current(dataset.get()));
+}
+
+BOOST_AUTO_TEST_CASE(find_same_edge_and_dataset)
+{
+    const auto dataset = std::make_shared<int>(0);
+    const auto other_dataset = std::make_shared<int>(0);
+
+    OverlayPathCache cache(1 << 20);
+    cache.AddDataset(dataset);
+    cache.AddDataset(other_dataset);
+    const auto path = makePath(1, 3);
+    cache.Insert(makeKey(dataset.get(), 1, 3), path);
+
+    BOOST_CHECK(cache.Find(makeKey(dataset.get(), 1, 3)) == path);
+    // Other edges, levels, forced loops or datasets have their own paths
+    BOOST_CHECK(!cache.Find(makeKey(dataset.get(), 3, 1)));
+    BOOST_CHECK(!cache.Find(OverlayPathCache::Key{dataset.get(), 2, 1, 3, false, false}));
+    BOOST_CHECK(!cache.Find(OverlayPathCache::Key{dataset.get(), 1, 1, 3, true, false}));
+    BOOST_CHECK(!cache.Find(makeKey(other_dataset.get(), 1, 3)));
+}
+
+BOOST_AUTO_TEST_CASE(released_dataset_is_dropped)
+{
+    auto dataset = std::make_shared<int>(0);
+
+    OverlayPathCache cache(1 << 20);
+    cache.AddDataset(dataset);
+    cache.Insert(makeKey(dataset.get(), 1, 3), makePath(1, 3));
+    BOOST_CHECK_GT(cache.GetSizeInBytes(), 0);
+
+    const auto address = dataset.get();
+    dataset.reset();
+    cache.AddDataset(std::make_shared<int>(0));
+    BOOST_CHECK(!cache.Find(makeKey(address, 1, 3)));
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(least_recently_used_is_evicted)
+{
+    const auto dataset = std::make_shared<int>(0);
+
+    // Paths of all sizes fit into the shards, but only a few thousand of them
+    OverlayPathCache cache(1 << 20);
+    cache.AddDataset(dataset);
+    for (NodeID source = 0; source < 20000; ++source)
+    {
+        cache.Insert(makeKey(dataset.get(), source, source + 2), makePath(source, source + 2));
+        // the first path stays the most recently used one
+        BOOST_CHECK(cache.Find(makeKey(dataset.get(), 0, 2)));
+    }
+    BOOST_CHECK_LE(cache.GetSizeInBytes(), 1 << 20);
+    BOOST_CHECK(!cache.Find(makeKey(dataset.get(), 1, 3)));
+    BOOST_CHECK(cache.Find(makeKey(dataset.get(), 19999, 20001)));
+
+    // Paths larger than a shard are not kept
+    OverlayPathCache small_cache(16);
+    small_cache.AddDataset(dataset);
+    small_cache.Insert(makeKey(dataset.get(), 1, 3), makePath(1, 3));
+    BOOST_CHECK(!small_cache.Find(makeKey(dataset.get(), 1, 3)));
+}
+
+BOOST_AUTO_TEST_CASE(scopes_select_the_cache)
+{
+    const auto dataset = std::make_shared<int>(0);
+    const auto other_dataset = std::make_shared<int>(0);
+    OverlayPathCache cache(1 << 20);
+    OverlayPathCache other_cache(1 << 20);
+
+    BOOST_CHECK(!OverlayPathCacheScope::Current(dataset.get()));
+    {
+        const OverlayPathCacheScope scope(cache, dataset);
+        BOOST_CHECK(OverlayPathCacheScope::Current(dataset.get()) == &cache);
+        // searches on other data do not use the cache
+        BOOST_CHECK(!OverlayPathCacheScope::Current(other_dataset.get()));
+        {
+            const OverlayPathCacheScope inner_scope(other_cache, other_dataset);
+            BOOST_CHECK(OverlayPathCacheScope::Current(other_dataset.get()) == &other_cache);
+        }
+        BOOST_CHECK(OverlayPathCacheScope::Current(dataset.get()) == &cache);
+    }
+    BOOST_CHECK(!OverlayPathCacheScope::Current(dataset.get()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
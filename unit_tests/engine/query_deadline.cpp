@@ -0,0 +1,65 @@
+#include "engine/query_deadline.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+BOOST_AUTO_TEST_SUITE(query_deadline)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+// Runs the checks of a search loop with the given number of steps
+void runSteps(const std::uint32_t steps)
+{
+    for (std::uint32_t step = 0; step < steps; ++step)
+    {
+        checkDeadline();
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(expiry)
+{
+    const QueryDeadline unlimited;
+    BOOST_CHECK(!unlimited.IsExpired());
+
+    const QueryDeadline past(QueryDeadline::Clock::now() - std::chrono::milliseconds(1));
+    BOOST_CHECK(past.IsExpired());
+    BOOST_CHECK(!past.IsCancelled());
+
+    // an earlier time keeps the cancellation flag of the deadline
+    const auto earlier = unlimited.Before(QueryDeadline::Clock::now() + std::chrono::hours(1));
+    BOOST_CHECK(!earlier.IsExpired());
+    unlimited.Cancel();
+    BOOST_CHECK(unlimited.IsCancelled());
+    BOOST_CHECK(earlier.IsExpired());
+}
+
+BOOST_AUTO_TEST_CASE(checks)
+{
+    // nothing to check without a scope
+    BOOST_CHECK(QueryDeadlineScope::Current() == nullptr);
+    runSteps(2 * detail::DEADLINE_CHECK_INTERVAL);
+    checkDeadlineNow();
+
+    const QueryDeadline deadline;
+    {
+        const QueryDeadlineScope scope(&deadline);
+        BOOST_CHECK(QueryDeadlineScope::Current() == &deadline);
+        runSteps(2 * detail::DEADLINE_CHECK_INTERVAL);
+
+        deadline.Cancel();
+        // the deadline is only looked at every few steps
+        runSteps(detail::DEADLINE_CHECK_INTERVAL - 1);
+        BOOST_CHECK_THROW(runSteps(detail::DEADLINE_CHECK_INTERVAL), QueryTimeout);
+        BOOST_CHECK_THROW(checkDeadlineNow(), QueryTimeout);
+    }
+    BOOST_CHECK(QueryDeadlineScope::Current() == nullptr);
+    checkDeadlineNow();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
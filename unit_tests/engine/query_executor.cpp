@@ -0,0 +1,57 @@
+#include "engine/query_executor.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(query_executor)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+BOOST_AUTO_TEST_CASE(single_tasks)
+{
+    QueryExecutor executor(2);
+    std::promise<int> result;
+    executor.Submit([&result] { result.set_value(42); });
+    BOOST_CHECK_EQUAL(result.get_future().get(), 42);
+}
+
+BOOST_AUTO_TEST_CASE(batch_submission)
+{
+    std::atomic<std::size_t> finished{0};
+    {
+        QueryExecutor executor(4);
+        std::vector<QueryExecutor::Task> tasks;
+        for (std::size_t index = 0; index < 1000; ++index)
+        {
+            tasks.push_back([&finished] { finished.fetch_add(1); });
+        }
+        executor.Submit(std::move(tasks));
+        executor.Submit(std::vector<QueryExecutor::Task>());
+        executor.Submit([&finished] { finished.fetch_add(1); });
+        // the executor waits for its tasks when it is destroyed
+    }
+    BOOST_CHECK_EQUAL(finished.load(), 1001u);
+}
+
+BOOST_AUTO_TEST_CASE(throwing_tasks)
+{
+    std::atomic<std::size_t> finished{0};
+    {
+        QueryExecutor executor(2);
+        executor.Submit([] { throw std::runtime_error("callback failed"); });
+        executor.Submit(std::vector<QueryExecutor::Task>{
+            [] { throw std::runtime_error("callback failed"); },
+            [&finished] { finished.fetch_add(1); }});
+        executor.Submit([&finished] { finished.fetch_add(1); });
+        // throwing tasks are finished as well, so the executor does not wait for them forever
+    }
+    BOOST_CHECK_EQUAL(finished.load(), 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
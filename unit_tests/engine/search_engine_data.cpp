@@ -0,0 +1,84 @@
+#include "engine/search_engine_data.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(search_engine_data)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+using CH = routing_algorithms::ch::Algorithm;
+
+namespace
+{
+// Grows the first heaps of this thread like a search over many nodes does
+void runLargeSearch(SearchEngineData<CH> &heaps)
+{
+    heaps.InitializeOrClearFirstThreadLocalStorage(100000);
+    for (NodeID node = 0; node < 100000; ++node)
+    {
+        heaps.forward_heap_1->Insert(node, node, node);
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(heap_memory_budget)
+{
+    SearchEngineData<CH> heaps;
+    runLargeSearch(heaps);
+    const auto grown_size = heaps.GetSizeInBytes();
+
+    // the growth of the searches is accounted for once their query is done
+    trimSearchHeaps();
+    const auto before = getSearchHeapMemory();
+    BOOST_CHECK_EQUAL(before.heap_bytes, heaps.GetSizeInBytes());
+    BOOST_CHECK(before.peak_heap_bytes >= before.heap_bytes);
+    BOOST_CHECK_EQUAL(before.max_heap_bytes, 0u);
+
+    // preparing the heaps for a search never shrinks them
+    setSearchHeapBudget(1);
+    heaps.InitializeOrClearFirstThreadLocalStorage(100000);
+    BOOST_CHECK_EQUAL(heaps.GetSizeInBytes(), grown_size);
+    BOOST_CHECK(heaps.forward_heap_1->Empty());
+
+    // only the heap that grew beyond the share of the thread is shrunk after the query
+    runLargeSearch(heaps);
+    trimSearchHeaps();
+    const auto after = getSearchHeapMemory();
+    BOOST_CHECK_EQUAL(after.shrunk_heaps - before.shrunk_heaps, 1u);
+    BOOST_CHECK(after.freed_bytes > before.freed_bytes);
+    BOOST_CHECK(heaps.GetSizeInBytes() < grown_size);
+    BOOST_CHECK_EQUAL(after.heap_bytes, heaps.GetSizeInBytes());
+    BOOST_CHECK(heaps.forward_heap_1->Empty());
+
+    // heaps within the share are kept
+    setSearchHeapBudget(4 * grown_size);
+    runLargeSearch(heaps);
+    trimSearchHeaps();
+    BOOST_CHECK_EQUAL(heaps.GetSizeInBytes(), grown_size);
+    BOOST_CHECK_EQUAL(getSearchHeapMemory().shrunk_heaps, after.shrunk_heaps);
+    setSearchHeapBudget(0);
+
+    // shrinking idle heaps frees what they grew to
+    shrinkSearchHeaps();
+    BOOST_CHECK_EQUAL(getSearchHeapMemory().heap_bytes, heaps.GetSizeInBytes());
+    BOOST_CHECK(getSearchHeapMemory().heap_bytes < grown_size);
+}
+
+BOOST_AUTO_TEST_CASE(graph_sized_arrays_outside_budget)
+{
+    using MLD = routing_algorithms::mld::Algorithm;
+
+    // the overlay index of MLD heaps is an array sized by the boundary nodes
+    SearchEngineData<MLD> heaps;
+    heaps.InitializeOrClearFirstThreadLocalStorage(1000, 100000);
+    BOOST_CHECK_EQUAL(heaps.forward_heap_1->GetGrowthInBytes(), 0u);
+
+    const auto before = getSearchHeapMemory();
+    setSearchHeapBudget(1);
+    trimSearchHeaps();
+    setSearchHeapBudget(0);
+    BOOST_CHECK_EQUAL(getSearchHeapMemory().shrunk_heaps, before.shrunk_heaps);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+#include "engine/routing_algorithms/many_to_many.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(table_bucket_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::engine::routing_algorithms;
+
+namespace
+{
+struct SnappedSegment
+{
+    SegmentID forward_segment_id;
+    SegmentID reverse_segment_id;
+    unsigned short fwd_segment_position;
+};
+
+PhantomNode makeTarget(const NodeID node, const EdgeWeight weight)
+{
+    return PhantomNode{SnappedSegment{{node, true}, {SPECIAL_SEGMENTID, false}, 0},
+                       ComponentID{0, false},
+                       weight,
+                       INVALID_EDGE_WEIGHT,
+                       0,
+                       0,
+                       static_cast<EdgeDistance>(weight),
+                       INVALID_EDGE_DISTANCE,
+                       0,
+                       0,
+                       weight,
+                       MAXIMAL_EDGE_DURATION,
+                       0,
+                       0,
+                       true,
+                       true,
+                       false,
+                       false,
+                       util::Coordinate{},
+                       util::Coordinate{},
+                       0};
+}
+
+std::shared_ptr<const NodeBucketIndex> makeBuckets(const std::size_t number_of_buckets)
+{
+    std::vector<std::vector<NodeBucket>> column_buckets(1);
+    for (std::size_t node = 0; node < number_of_buckets; ++node)
+        column_buckets[0].emplace_back(node, node, 0, 0, 0, 0);
+    return std::make_shared<const NodeBucketIndex>(column_buckets);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(disabled_cache)
+{
+    TableBucketCache cache;
+    BOOST_CHECK(!cache.IsEnabled());
+    BOOST_CHECK(!TableBucketCacheRef{}.IsEnabled());
+}
+
+BOOST_AUTO_TEST_CASE(find_same_targets_and_dataset)
+{
+    const std::vector<PhantomNode> phantoms = {makeTarget(1, 10), makeTarget(2, 20)};
+    const auto dataset = std::make_shared<int>(0);
+    const auto other_dataset = std::make_shared<int>(0);
+
+    TableBucketCache cache(1 << 20);
+    const TableBucketCache::Key key(phantoms, {0, 1}, TableSearchLimits{});
+    const auto buckets = makeBuckets(4);
+    cache.Insert(dataset, key, buckets);
+
+    BOOST_CHECK(cache.Find(dataset, TableBucketCache::Key(phantoms, {0, 1}, {})) == buckets);
+    // Other targets, target order, limits or datasets have their own buckets
+    BOOST_CHECK(!cache.Find(dataset, TableBucketCache::Key(phantoms, {0}, {})));
+    BOOST_CHECK(!cache.Find(dataset, TableBucketCache::Key(phantoms, {1, 0}, {})));
+    BOOST_CHECK(!cache.Find(dataset, TableBucketCache::Key(phantoms, {0, 1}, {600, 1000.})));
+    BOOST_CHECK(!cache.Find(other_dataset, key));
+
+    const std::vector<PhantomNode> moved_phantoms = {makeTarget(1, 10), makeTarget(2, 21)};
+    BOOST_CHECK(!cache.Find(dataset, TableBucketCache::Key(moved_phantoms, {0, 1}, {})));
+}
+
+BOOST_AUTO_TEST_CASE(released_dataset_is_dropped)
+{
+    const std::vector<PhantomNode> phantoms = {makeTarget(1, 10)};
+    auto dataset = std::make_shared<int>(0);
+
+    TableBucketCache cache(1 << 20);
+    cache.Insert(dataset, TableBucketCache::Key(phantoms, {0}, {}), makeBuckets(4));
+    BOOST_CHECK_GT(cache.GetSizeInBytes(), 0);
+
+    dataset.reset();
+    const auto new_dataset = std::make_shared<int>(0);
+    BOOST_CHECK(!cache.Find(new_dataset, TableBucketCache::Key(phantoms, {0}, {})));
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(least_recently_used_is_evicted)
+{
+    const std::vector<PhantomNode> phantoms = {
+        makeTarget(1, 10), makeTarget(2, 20), makeTarget(3, 30)};
+    const auto dataset = std::make_shared<int>(0);
+
+    const auto buckets = makeBuckets(64);
+    const TableBucketCache::Key key_0(phantoms, {0}, {});
+    const TableBucketCache::Key key_1(phantoms, {1}, {});
+    const TableBucketCache::Key key_2(phantoms, {2}, {});
+    const auto entry_size = key_0.GetSizeInBytes() + buckets->GetSizeInBytes();
+
+    // Room for two entries
+    TableBucketCache cache(2 * entry_size + entry_size / 2);
+    cache.Insert(dataset, key_0, buckets);
+    cache.Insert(dataset, key_1, buckets);
+    BOOST_CHECK(cache.Find(dataset, key_0));
+
+    cache.Insert(dataset, key_2, buckets);
+    BOOST_CHECK(cache.Find(dataset, key_0));
+    BOOST_CHECK(!cache.Find(dataset, key_1));
+    BOOST_CHECK(cache.Find(dataset, key_2));
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 2 * entry_size);
+
+    // Entries larger than the whole cache are not kept
+    TableBucketCache small_cache(entry_size / 2);
+    small_cache.Insert(dataset, key_0, buckets);
+    BOOST_CHECK(!small_cache.Find(dataset, key_0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+#include "equal_json.hpp"
+#include "fixture.hpp"
+
+#include "osrm/nearest_parameters.hpp"
+#include "osrm/route_parameters.hpp"
+#include "osrm/table_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <future>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(async)
+
+void test_async_matches_blocking_queries(const std::string &base_path,
+                                         osrm::EngineConfig::Algorithm algorithm)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {base_path};
+    config.use_shared_memory = false;
+    config.algorithm = algorithm;
+    config.async_threads = 4;
+    OSRM osrm{config};
+
+    const auto locations = get_locations_in_big_component();
+    std::vector<RouteParameters> params(50);
+    for (std::size_t index = 0; index < params.size(); ++index)
+    {
+        params[index].coordinates.push_back(locations[index % locations.size()]);
+        params[index].coordinates.push_back(locations[(index + 1) % locations.size()]);
+    }
+
+    // queries submitted together have their futures in the same order
+    auto futures = osrm.RouteAsync(params);
+    BOOST_REQUIRE_EQUAL(futures.size(), params.size());
+    for (std::size_t index = 0; index < params.size(); ++index)
+    {
+        auto async_result = futures[index].get();
+        BOOST_REQUIRE(async_result.status == Status::Ok);
+
+        json::Object blocking_result;
+        osrm.Route(params[index], blocking_result);
+        const json::Value expected = std::move(blocking_result);
+        const json::Value actual = std::move(async_result.result.get<json::Object>());
+        CHECK_EQUAL_JSON(actual, expected);
+    }
+
+    TableParameters table_params;
+    table_params.coordinates.assign(locations.begin(), locations.begin() + 3);
+    const auto table_result = osrm.TableAsync(table_params).get();
+    BOOST_CHECK(table_result.status == Status::Ok);
+    BOOST_CHECK(table_result.result.is<json::Object>());
+
+    // errors are results of the query
+    std::promise<AsyncResult> callback_result;
+    NearestParameters nearest_params;
+    nearest_params.coordinates.push_back(locations[0]);
+    nearest_params.coordinates.push_back(locations[1]);
+    osrm.NearestAsync(nearest_params, [&](AsyncResult async_result) {
+        callback_result.set_value(std::move(async_result));
+    });
+    const auto nearest_result = callback_result.get_future().get();
+    BOOST_CHECK(nearest_result.status == Status::Error);
+}
+BOOST_AUTO_TEST_CASE(test_async_matches_blocking_queries_ch)
+{
+    test_async_matches_blocking_queries(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                                        osrm::EngineConfig::Algorithm::CH);
+}
+BOOST_AUTO_TEST_CASE(test_async_matches_blocking_queries_mld)
+{
+    test_async_matches_blocking_queries(OSRM_TEST_DATA_DIR "/mld/monaco.osrm",
+                                        osrm::EngineConfig::Algorithm::MLD);
+}
+
+BOOST_AUTO_TEST_CASE(test_async_flatbuffers)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+    config.use_shared_memory = false;
+    OSRM osrm{config};
+
+    RouteParameters params;
+    params.coordinates = get_split_trace_locations();
+    params.format = engine::api::BaseParameters::OutputFormatType::FLATBUFFERS;
+    const auto async_result = osrm.RouteAsync(params).get();
+    BOOST_CHECK(async_result.status == Status::Ok);
+    BOOST_CHECK(async_result.result.is<flatbuffers::FlatBufferBuilder>());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
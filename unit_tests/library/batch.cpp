@@ -0,0 +1,149 @@
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+#include "equal_json.hpp"
+#include "fixture.hpp"
+
+#include "osrm/batch_parameters.hpp"
+#include "osrm/nearest_parameters.hpp"
+#include "osrm/route_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include "util/json_renderer.hpp"
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(batch)
+
+namespace
+{
+osrm::BatchParameters makeBatchParameters()
+{
+    using namespace osrm;
+
+    BatchParameters params;
+    const auto locations = get_locations_in_big_component();
+    for (std::size_t index = 0; index < 100; ++index)
+    {
+        if (index % 3 == 0)
+        {
+            NearestParameters nearest_params;
+            nearest_params.coordinates.push_back(locations[index % locations.size()]);
+            params.queries.emplace_back(std::move(nearest_params));
+        }
+        else
+        {
+            RouteParameters route_params;
+            route_params.coordinates.push_back(locations[index % locations.size()]);
+            route_params.coordinates.push_back(locations[(index + 1) % locations.size()]);
+            params.queries.emplace_back(std::move(route_params));
+        }
+    }
+    return params;
+}
+
+osrm::json::Object runSingleQuery(const osrm::OSRM &osrm, const osrm::BatchParameters::Query &query)
+{
+    osrm::json::Object json_result;
+    if (query.is<osrm::RouteParameters>())
+    {
+        osrm.Route(query.get<osrm::RouteParameters>(), json_result);
+    }
+    else
+    {
+        osrm.Nearest(query.get<osrm::NearestParameters>(), json_result);
+    }
+    return json_result;
+}
+} // namespace
+
+void test_batch_matches_single_queries(const std::string &base_path,
+                                       osrm::EngineConfig::Algorithm algorithm)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {base_path};
+    config.use_shared_memory = false;
+    config.algorithm = algorithm;
+    config.max_batch_parallelism = 4;
+    OSRM osrm{config};
+
+    const auto params = makeBatchParameters();
+    json::Object json_result;
+    const auto rc = osrm.Batch(params, json_result);
+    BOOST_REQUIRE(rc == Status::Ok);
+    BOOST_CHECK_EQUAL(json_result.values.at("code").get<json::String>().value, "Ok");
+
+    // results are in the order of the queries
+    const auto &results = json_result.values.at("results").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(results.size(), params.queries.size());
+    for (std::size_t index = 0; index < results.size(); ++index)
+    {
+        const json::Value single_result = runSingleQuery(osrm, params.queries[index]);
+        CHECK_EQUAL_JSON(results[index], single_result);
+    }
+
+    // the streamed response is the rendered response
+    engine::api::ResultT streamed_result = json::Object();
+    std::string streamed;
+    const auto streamed_rc =
+        osrm.Batch(params, streamed_result, [&](const char *data, const std::size_t size) {
+            streamed.append(data, size);
+        });
+    BOOST_REQUIRE(streamed_rc == Status::Ok);
+    std::vector<char> rendered;
+    util::json::render(rendered, json_result);
+    BOOST_CHECK_EQUAL(streamed.size(), rendered.size());
+}
+BOOST_AUTO_TEST_CASE(test_batch_matches_single_queries_ch)
+{
+    test_batch_matches_single_queries(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                                      osrm::EngineConfig::Algorithm::CH);
+}
+BOOST_AUTO_TEST_CASE(test_batch_matches_single_queries_mld)
+{
+    test_batch_matches_single_queries(OSRM_TEST_DATA_DIR "/mld/monaco.osrm",
+                                      osrm::EngineConfig::Algorithm::MLD);
+}
+
+BOOST_AUTO_TEST_CASE(test_batch_too_big)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+    config.use_shared_memory = false;
+    config.max_batch_size = 10;
+    OSRM osrm{config};
+
+    json::Object json_result;
+    const auto rc = osrm.Batch(makeBatchParameters(), json_result);
+    BOOST_CHECK(rc == Status::Error);
+    BOOST_CHECK_EQUAL(json_result.values.at("code").get<json::String>().value, "TooBig");
+}
+
+BOOST_AUTO_TEST_CASE(test_batch_timeout)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+    config.use_shared_memory = false;
+    OSRM osrm{config};
+
+    // a batch without any time left fails as a whole
+    auto params = makeBatchParameters();
+    params.timeout = 0;
+    json::Object json_result;
+    const auto rc = osrm.Batch(params, json_result);
+    BOOST_CHECK(rc == Status::Timeout);
+    BOOST_CHECK_EQUAL(json_result.values.at("code").get<json::String>().value, "Timeout");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+#include "fixture.hpp"
+
+#include "osrm/isochrone_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+BOOST_AUTO_TEST_SUITE(isochrone)
+
+BOOST_AUTO_TEST_CASE(test_isochrone_points)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", osrm::EngineConfig::Algorithm::MLD);
+
+    using namespace osrm;
+
+    IsochroneParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.contours = {60, 120, 300};
+
+    json::Object json_result;
+    const auto rc = osrm.Isochrone(params, json_result);
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    const auto code = json_result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "Ok");
+
+    const auto &waypoints = json_result.values.at("waypoints").get<json::Array>().values;
+    BOOST_CHECK_EQUAL(waypoints.size(), 1);
+
+    const auto &isochrones = json_result.values.at("isochrones").get<json::Object>();
+    BOOST_CHECK_EQUAL(isochrones.values.at("type").get<json::String>().value, "FeatureCollection");
+
+    const auto &features = isochrones.values.at("features").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(features.size(), params.contours.size());
+
+    std::size_t number_of_points = 0;
+    for (std::size_t index = 0; index < features.size(); ++index)
+    {
+        const auto &feature = features[index].get<json::Object>();
+        const auto &properties = feature.values.at("properties").get<json::Object>();
+        BOOST_CHECK_EQUAL(properties.values.at("contour").get<json::Number>().value,
+                          params.contours[index]);
+
+        const auto &geometry = feature.values.at("geometry").get<json::Object>();
+        BOOST_CHECK_EQUAL(geometry.values.at("type").get<json::String>().value, "MultiPoint");
+        number_of_points += geometry.values.at("coordinates").get<json::Array>().values.size();
+    }
+    // five minutes cover more than a handful of segments in monaco
+    BOOST_CHECK(number_of_points > 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_isochrone_polygons)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", osrm::EngineConfig::Algorithm::MLD);
+
+    using namespace osrm;
+
+    IsochroneParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.contours = {120, 300};
+    params.polygons = true;
+
+    json::Object json_result;
+    const auto rc = osrm.Isochrone(params, json_result);
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    const auto &features = json_result.values.at("isochrones")
+                               .get<json::Object>()
+                               .values.at("features")
+                               .get<json::Array>()
+                               .values;
+    BOOST_REQUIRE_EQUAL(features.size(), 2);
+
+    for (const auto &feature : features)
+    {
+        const auto &geometry =
+            feature.get<json::Object>().values.at("geometry").get<json::Object>();
+        BOOST_CHECK_EQUAL(geometry.values.at("type").get<json::String>().value, "Polygon");
+        const auto &rings = geometry.values.at("coordinates").get<json::Array>().values;
+        BOOST_REQUIRE_EQUAL(rings.size(), 1);
+        BOOST_CHECK(rings.front().get<json::Array>().values.size() >= 4);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_isochrone_ch_points)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    using namespace osrm;
+
+    IsochroneParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.contours = {60, 300};
+
+    json::Object json_result;
+    const auto rc = osrm.Isochrone(params, json_result);
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    const auto &features = json_result.values.at("isochrones")
+                               .get<json::Object>()
+                               .values.at("features")
+                               .get<json::Array>()
+                               .values;
+    BOOST_REQUIRE_EQUAL(features.size(), params.contours.size());
+
+    std::size_t number_of_points = 0;
+    for (const auto &feature : features)
+    {
+        const auto &geometry =
+            feature.get<json::Object>().values.at("geometry").get<json::Object>();
+        number_of_points += geometry.values.at("coordinates").get<json::Array>().values.size();
+    }
+    BOOST_CHECK(number_of_points > 10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,6 +1,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <cmath>
+#include <memory>
 
 #include "coordinates.hpp"
 #include "equal_json.hpp"
@@ -732,4 +733,39 @@ BOOST_AUTO_TEST_CASE(test_route_serialize_fb_skip_waypoints)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_route_overlay_path_cache_matches_searches)
+{
+    using namespace osrm;
+
+    const auto make_osrm = [](const int overlay_path_cache_size) {
+        EngineConfig config;
+        config.storage_config = {OSRM_TEST_DATA_DIR "/mld/monaco.osrm"};
+        config.use_shared_memory = false;
+        config.algorithm = EngineConfig::Algorithm::MLD;
+        config.overlay_path_cache_size = overlay_path_cache_size;
+        return std::make_unique<OSRM>(config);
+    };
+
+    const auto locations = get_locations_in_big_component();
+    RouteParameters params;
+    params.coordinates = {locations.at(0), locations.at(1)};
+    params.alternatives = true;
+    params.overview = RouteParameters::OverviewType::Full;
+    params.annotations = true;
+
+    const auto uncached = make_osrm(0);
+    const auto cached = make_osrm(16);
+
+    json::Object uncached_result;
+    BOOST_CHECK(uncached->Route(params, uncached_result) == Status::Ok);
+
+    // The second query takes the paths of the overlay edges from the cache
+    for (int query = 0; query < 2; ++query)
+    {
+        json::Object cached_result;
+        BOOST_CHECK(cached->Route(params, cached_result) == Status::Ok);
+        CHECK_EQUAL_JSON(uncached_result.values.at("routes"), cached_result.values.at("routes"));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,6 +1,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "coordinates.hpp"
+#include "equal_json.hpp"
 #include "fixture.hpp"
 #include "waypoint_check.hpp"
 
@@ -11,6 +12,13 @@
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include "util/json_renderer.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
 osrm::Status run_table_json(const osrm::OSRM &osrm,
                             const osrm::TableParameters &params,
                             osrm::json::Object &json_result,
@@ -292,6 +300,416 @@ BOOST_AUTO_TEST_CASE(test_table_no_segment_for_some_coordinates_new_api)
     test_table_no_segment_for_some_coordinates(false);
 }
 
+void test_table_parallel_matches_sequential(const std::string &base_path,
+                                            osrm::EngineConfig::Algorithm algorithm)
+{
+    using namespace osrm;
+
+    const auto run_table = [&](const int max_table_parallelism) {
+        EngineConfig config;
+        config.storage_config = {base_path};
+        config.use_shared_memory = false;
+        config.algorithm = algorithm;
+        config.max_table_parallelism = max_table_parallelism;
+        OSRM osrm{config};
+
+        TableParameters params;
+        for (const auto &location : get_split_trace_locations())
+            params.coordinates.push_back(location);
+        for (const auto &location : get_locations_in_big_component())
+            params.coordinates.push_back(location);
+        params.sources = {0, 1, 2, 3};
+        params.annotations = TableParameters::AnnotationsType::All;
+
+        json::Object json_result;
+        const auto rc = osrm.Table(params, json_result);
+        BOOST_CHECK(rc == Status::Ok);
+        return json_result;
+    };
+
+    const auto sequential_result = run_table(1);
+    const auto parallel_result = run_table(4);
+
+    CHECK_EQUAL_JSON(sequential_result.values.at("durations"),
+                     parallel_result.values.at("durations"));
+    CHECK_EQUAL_JSON(sequential_result.values.at("distances"),
+                     parallel_result.values.at("distances"));
+}
+BOOST_AUTO_TEST_CASE(test_table_parallel_matches_sequential_ch)
+{
+    test_table_parallel_matches_sequential(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                                           osrm::EngineConfig::Algorithm::CH);
+}
+BOOST_AUTO_TEST_CASE(test_table_parallel_matches_sequential_mld)
+{
+    test_table_parallel_matches_sequential(OSRM_TEST_DATA_DIR "/mld/monaco.osrm",
+                                           osrm::EngineConfig::Algorithm::MLD);
+}
+
+void test_table_sweep_matches_buckets(const std::string &base_path,
+                                      osrm::EngineConfig::Algorithm algorithm)
+{
+    using namespace osrm;
+
+    const auto run_table = [&](const int rphast_min_destinations) {
+        EngineConfig config;
+        config.storage_config = {base_path};
+        config.use_shared_memory = false;
+        config.algorithm = algorithm;
+        config.rphast_min_destinations = rphast_min_destinations;
+        OSRM osrm{config};
+
+        TableParameters params;
+        for (const auto &location : get_split_trace_locations())
+            params.coordinates.push_back(location);
+        for (const auto &location : get_locations_in_big_component())
+            params.coordinates.push_back(location);
+        params.annotations = TableParameters::AnnotationsType::All;
+
+        json::Object json_result;
+        const auto rc = osrm.Table(params, json_result);
+        BOOST_CHECK(rc == Status::Ok);
+        return json_result;
+    };
+
+    const auto bucket_result = run_table(-1);
+    const auto sweep_result = run_table(2);
+
+    CHECK_EQUAL_JSON(bucket_result.values.at("durations"), sweep_result.values.at("durations"));
+    CHECK_EQUAL_JSON(bucket_result.values.at("distances"), sweep_result.values.at("distances"));
+}
+BOOST_AUTO_TEST_CASE(test_table_sweep_matches_buckets_ch)
+{
+    test_table_sweep_matches_buckets(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                                     osrm::EngineConfig::Algorithm::CH);
+}
+BOOST_AUTO_TEST_CASE(test_table_sweep_matches_buckets_mld)
+{
+    test_table_sweep_matches_buckets(OSRM_TEST_DATA_DIR "/mld/monaco.osrm",
+                                     osrm::EngineConfig::Algorithm::MLD);
+}
+
+void test_table_stream_matches_response(const std::string &base_path,
+                                        osrm::EngineConfig::Algorithm algorithm)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(base_path, algorithm);
+
+    TableParameters params;
+    for (const auto &location : get_split_trace_locations())
+        params.coordinates.push_back(location);
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    params.annotations = TableParameters::AnnotationsType::All;
+
+    json::Object json_result;
+    BOOST_CHECK(osrm.Table(params, json_result) == Status::Ok);
+
+    const auto rendered = [](const json::Value &value) {
+        std::vector<char> output;
+        mapbox::util::apply_visitor(util::json::ArrayRenderer(output), value);
+        return std::string(output.begin(), output.end());
+    };
+    const auto stream_table = [&](const TableParameters::AnnotationsType annotations,
+                                  std::string &streamed_string) {
+        auto stream_params = params;
+        stream_params.stream = true;
+        stream_params.annotations = annotations;
+        std::vector<char> streamed;
+        engine::api::ResultT result = json::Object();
+        const auto rc =
+            osrm.Table(stream_params, result, [&](const char *data, const std::size_t size) {
+                streamed.insert(streamed.end(), data, data + size);
+            });
+        streamed_string.assign(streamed.begin(), streamed.end());
+        return rc;
+    };
+
+    std::string streamed_string;
+    BOOST_CHECK(stream_table(TableParameters::AnnotationsType::Duration, streamed_string) ==
+                Status::Ok);
+    BOOST_CHECK_EQUAL(streamed_string.find("{\"code\":\"Ok\""), 0);
+    BOOST_CHECK_EQUAL(streamed_string.back(), '}');
+    BOOST_CHECK(streamed_string.find("\"durations\":" +
+                                     rendered(json_result.values.at("durations"))) !=
+                std::string::npos);
+    BOOST_CHECK(streamed_string.find("\"sources\":" + rendered(json_result.values.at("sources"))) !=
+                std::string::npos);
+
+    BOOST_CHECK(stream_table(TableParameters::AnnotationsType::Distance, streamed_string) ==
+                Status::Ok);
+    BOOST_CHECK(streamed_string.find("\"distances\":" +
+                                     rendered(json_result.values.at("distances"))) !=
+                std::string::npos);
+
+    // all durations precede all distances, so streaming both would hold a whole table
+    BOOST_CHECK(stream_table(TableParameters::AnnotationsType::All, streamed_string) ==
+                Status::Error);
+    BOOST_CHECK(streamed_string.empty());
+}
+BOOST_AUTO_TEST_CASE(test_table_stream_matches_response_ch)
+{
+    test_table_stream_matches_response(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                                       osrm::EngineConfig::Algorithm::CH);
+}
+BOOST_AUTO_TEST_CASE(test_table_stream_matches_response_mld)
+{
+    test_table_stream_matches_response(OSRM_TEST_DATA_DIR "/mld/monaco.osrm",
+                                       osrm::EngineConfig::Algorithm::MLD);
+}
+
+BOOST_AUTO_TEST_CASE(test_table_bucket_cache_matches_searches)
+{
+    using namespace osrm;
+
+    const auto make_osrm = [](const int table_bucket_cache_size) {
+        EngineConfig config;
+        config.storage_config = {OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+        config.use_shared_memory = false;
+        config.algorithm = EngineConfig::Algorithm::CH;
+        config.table_bucket_cache_size = table_bucket_cache_size;
+        return std::make_unique<OSRM>(config);
+    };
+    const auto run_table = [](const OSRM &osrm, const std::vector<std::size_t> &sources) {
+        TableParameters params;
+        for (const auto &location : get_split_trace_locations())
+            params.coordinates.push_back(location);
+        for (const auto &location : get_locations_in_big_component())
+            params.coordinates.push_back(location);
+        params.sources = sources;
+        params.destinations = {4, 5, 6};
+        params.annotations = TableParameters::AnnotationsType::All;
+
+        json::Object json_result;
+        const auto rc = osrm.Table(params, json_result);
+        BOOST_CHECK(rc == Status::Ok);
+        return json_result;
+    };
+
+    const auto uncached = make_osrm(0);
+    const auto cached = make_osrm(16);
+
+    // The second request reuses the buckets of the first one
+    for (const auto &sources : {std::vector<std::size_t>{0, 1}, std::vector<std::size_t>{2, 3}})
+    {
+        const auto uncached_result = run_table(*uncached, sources);
+        const auto cached_result = run_table(*cached, sources);
+        CHECK_EQUAL_JSON(uncached_result.values.at("durations"),
+                         cached_result.values.at("durations"));
+        CHECK_EQUAL_JSON(uncached_result.values.at("distances"),
+                         cached_result.values.at("distances"));
+    }
+}
+
+void test_table_max_duration(const std::string &base_path,
+                             osrm::EngineConfig::Algorithm algorithm)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {base_path};
+    config.use_shared_memory = false;
+    config.algorithm = algorithm;
+    OSRM osrm{config};
+
+    const auto run_table = [&](const boost::optional<double> max_duration) {
+        TableParameters params;
+        for (const auto &location : get_split_trace_locations())
+            params.coordinates.push_back(location);
+        for (const auto &location : get_locations_in_big_component())
+            params.coordinates.push_back(location);
+        params.max_duration = max_duration;
+
+        json::Object json_result;
+        const auto rc = osrm.Table(params, json_result);
+        BOOST_CHECK(rc == Status::Ok);
+        return json_result;
+    };
+
+    const auto unbounded_result = run_table(boost::none);
+    const auto bounded_result = run_table(60.);
+
+    const auto &unbounded_rows = unbounded_result.values.at("durations").get<json::Array>().values;
+    const auto &bounded_rows = bounded_result.values.at("durations").get<json::Array>().values;
+    BOOST_CHECK_EQUAL(unbounded_rows.size(), bounded_rows.size());
+
+    std::size_t pruned_cells = 0;
+    for (std::size_t row = 0; row < bounded_rows.size(); ++row)
+    {
+        const auto &unbounded_row = unbounded_rows[row].get<json::Array>().values;
+        const auto &bounded_row = bounded_rows[row].get<json::Array>().values;
+        BOOST_CHECK_EQUAL(unbounded_row.size(), bounded_row.size());
+        for (std::size_t column = 0; column < bounded_row.size(); ++column)
+        {
+            if (bounded_row[column].is<json::Null>())
+            {
+                ++pruned_cells;
+                continue;
+            }
+            // Durations within the bound are the ones of the unbounded search
+            const auto duration = bounded_row[column].get<json::Number>().value;
+            BOOST_CHECK_LE(duration, 60.);
+            BOOST_CHECK_EQUAL(duration, unbounded_row[column].get<json::Number>().value);
+        }
+    }
+    BOOST_CHECK_GT(pruned_cells, 0);
+}
+BOOST_AUTO_TEST_CASE(test_table_max_duration_ch)
+{
+    test_table_max_duration(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                            osrm::EngineConfig::Algorithm::CH);
+}
+BOOST_AUTO_TEST_CASE(test_table_max_duration_mld)
+{
+    test_table_max_duration(OSRM_TEST_DATA_DIR "/mld/monaco.osrm",
+                            osrm::EngineConfig::Algorithm::MLD);
+}
+
+BOOST_AUTO_TEST_CASE(test_table_stream_fb)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    TableParameters params;
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    params.annotations = TableParameters::AnnotationsType::All;
+
+    engine::api::ResultT result = flatbuffers::FlatBufferBuilder();
+    BOOST_CHECK(osrm.Table(params, result) == Status::Ok);
+    auto &fb_result = result.get<flatbuffers::FlatBufferBuilder>();
+    auto fb = engine::api::fbresult::GetFBResult(fb_result.GetBufferPointer());
+
+    params.stream = true;
+    std::vector<std::uint8_t> streamed;
+    engine::api::ResultT stream_result = flatbuffers::FlatBufferBuilder();
+    const auto rc =
+        osrm.Table(params, stream_result, [&](const char *data, const std::size_t size) {
+            streamed.insert(streamed.end(), data, data + size);
+        });
+    BOOST_CHECK(rc == Status::Ok);
+
+    // a header message followed by messages with blocks of rows
+    std::vector<const engine::api::fbresult::FBResult *> messages;
+    for (std::size_t offset = 0; offset < streamed.size();)
+    {
+        messages.push_back(engine::api::fbresult::GetSizePrefixedFBResult(&streamed[offset]));
+        offset += sizeof(flatbuffers::uoffset_t) +
+                  flatbuffers::ReadScalar<flatbuffers::uoffset_t>(&streamed[offset]);
+    }
+    BOOST_REQUIRE_GE(messages.size(), 2);
+
+    const auto header = messages.front()->table();
+    BOOST_CHECK_EQUAL(header->rows(), fb->table()->rows());
+    BOOST_CHECK_EQUAL(header->cols(), fb->table()->cols());
+    BOOST_CHECK_EQUAL(header->destinations()->size(), fb->table()->destinations()->size());
+    BOOST_CHECK_EQUAL(messages.front()->waypoints()->size(), fb->waypoints()->size());
+
+    std::vector<float> durations, distances;
+    std::size_t rows = 0;
+    for (auto message = messages.begin() + 1; message != messages.end(); ++message)
+    {
+        const auto block = (*message)->table();
+        BOOST_CHECK_EQUAL(block->cols(), header->cols());
+        rows += block->rows();
+        durations.insert(durations.end(), block->durations()->begin(), block->durations()->end());
+        distances.insert(distances.end(), block->distances()->begin(), block->distances()->end());
+    }
+    BOOST_CHECK_EQUAL(rows, header->rows());
+    BOOST_CHECK_EQUAL_COLLECTIONS(durations.begin(),
+                                  durations.end(),
+                                  fb->table()->durations()->begin(),
+                                  fb->table()->durations()->end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(distances.begin(),
+                                  distances.end(),
+                                  fb->table()->distances()->begin(),
+                                  fb->table()->distances()->end());
+}
+
+BOOST_AUTO_TEST_CASE(test_table_serialize_bin)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    TableParameters params;
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    params.sources.push_back(0);
+    params.sources.push_back(1);
+    params.annotations = TableParameters::AnnotationsType::All;
+    params.fallback_speed = 1;
+
+    json::Object json_result;
+    BOOST_CHECK(osrm.Table(params, json_result) == Status::Ok);
+
+    engine::api::ResultT result = std::vector<char>();
+    BOOST_CHECK(osrm.Table(params, result) == Status::Ok);
+    const auto &bytes = result.get<std::vector<char>>();
+
+    const auto read = [&bytes](const std::size_t offset, auto value) {
+        BOOST_REQUIRE_LE(offset + sizeof(value), bytes.size());
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        return value;
+    };
+
+    const std::size_t rows = read(0, std::uint32_t{});
+    const std::size_t cols = read(4, std::uint32_t{});
+    BOOST_CHECK_EQUAL(rows, params.sources.size());
+    BOOST_CHECK_EQUAL(cols, params.coordinates.size());
+    BOOST_CHECK_EQUAL(read(8, std::uint32_t{}), 3);
+    BOOST_CHECK_EQUAL(read(12, std::uint32_t{}), 10);
+
+    const auto bitmap_size = (rows * cols + 31) / 32 * 4;
+    const auto durations_offset = 16 + bitmap_size;
+    const auto distances_offset = durations_offset + rows * cols * sizeof(std::int32_t);
+    BOOST_CHECK_EQUAL(bytes.size(), distances_offset + rows * cols * sizeof(float));
+
+    const auto &durations = json_result.values.at("durations").get<json::Array>().values;
+    const auto &distances = json_result.values.at("distances").get<json::Array>().values;
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+        const auto &durations_row = durations[row].get<json::Array>().values;
+        const auto &distances_row = distances[row].get<json::Array>().values;
+        for (std::size_t column = 0; column < cols; ++column)
+        {
+            const auto cell = row * cols + column;
+            const auto duration = read(durations_offset + cell * 4, std::int32_t{});
+            const auto distance = read(distances_offset + cell * 4, float{});
+            BOOST_CHECK_EQUAL(duration / 10., durations_row[column].get<json::Number>().value);
+            BOOST_CHECK_CLOSE(std::round(distance * 10) / 10.,
+                              distances_row[column].get<json::Number>().value,
+                              1e-6);
+            BOOST_CHECK_EQUAL((bytes[16 + cell / 8] >> (cell % 8)) & 1, 0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_table_stream_bin_rejected)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    TableParameters params;
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    params.stream = true;
+
+    std::vector<char> streamed;
+    engine::api::ResultT result = std::vector<char>();
+    const auto rc = osrm.Table(params, result, [&](const char *data, const std::size_t size) {
+        streamed.insert(streamed.end(), data, data + size);
+    });
+    BOOST_CHECK(rc == Status::Error);
+    BOOST_CHECK(streamed.empty());
+
+    const auto &error = result.get<std::vector<char>>();
+    BOOST_CHECK_EQUAL(std::string(error.begin(), error.end()).find("code=InvalidOptions"), 0);
+}
+
 BOOST_AUTO_TEST_CASE(test_table_serialiaze_fb)
 {
     using namespace osrm;
@@ -315,6 +315,11 @@ class MockAlgorithmDataFacade<engine::datafacade::CH>
         return SPECIAL_EDGEID;
     }
 
+    contractor::ShortcutChildren GetShortcutChildren(const EdgeID /* e */) const override
+    {
+        return {SPECIAL_EDGEID, SPECIAL_EDGEID};
+    }
+
     EdgeID FindEdgeIndicateIfReverse(const NodeID /* from */,
                                      const NodeID /* to */,
                                      bool & /* result */) const override
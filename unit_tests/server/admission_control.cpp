@@ -0,0 +1,79 @@
+#include "server/admission_control.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(admission_control)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+api::ParsedURL makeURL(std::string service, std::string query)
+{
+    return api::ParsedURL{std::move(service), 1, "driving", std::move(query), 0, {}, {}};
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(estimate_cost)
+{
+    BOOST_CHECK_EQUAL(AdmissionControl::EstimateCost(makeURL("route", "1,2;3,4;5,6?steps=true")),
+                      3);
+    BOOST_CHECK_EQUAL(AdmissionControl::EstimateCost(makeURL("table", "1,2;3,4;5,6")), 9);
+    BOOST_CHECK_EQUAL(AdmissionControl::EstimateCost(makeURL("nearest", "1,2.json")), 1);
+    // polyline of (38.5, -120.2), (40.7, -120.95), (43.252, -126.453)
+    const auto polyline_url = makeURL("trip", "polyline(_p~iF~ps|U_ulLnnqC_mqNvxq`@)");
+    BOOST_CHECK_EQUAL(AdmissionControl::EstimateCost(polyline_url), 9);
+
+    auto body_url = makeURL("table", "?sources=0");
+    body_url.coordinates.resize(4);
+    BOOST_CHECK_EQUAL(AdmissionControl::EstimateCost(body_url), 16);
+
+    auto batch_url = makeURL("batch", "");
+    batch_url.requests = {"/route/v1/driving/1,2;3,4?steps=true", "/nearest/v1/driving/1,2"};
+    BOOST_CHECK_EQUAL(AdmissionControl::EstimateCost(batch_url), 3);
+}
+
+BOOST_AUTO_TEST_CASE(inflight_budgets)
+{
+    AdmissionControlConfig config;
+    config.max_inflight_requests = 3;
+    config.max_inflight_cost["table"] = 10;
+    AdmissionControl admission_control(config);
+    const auto now = std::chrono::steady_clock::now();
+
+    {
+        const auto table_1 = admission_control.Admit(makeURL("table", "1,2;3,4;5,6"), now);
+        BOOST_CHECK(table_1);
+        // 9 + 4 exceeds the budget of the table service
+        BOOST_CHECK(!admission_control.Admit(makeURL("table", "1,2;3,4"), now));
+        const auto table_2 = admission_control.Admit(makeURL("table", "1,2"), now);
+        BOOST_CHECK(table_2);
+
+        const auto route = admission_control.Admit(makeURL("route", "1,2;3,4"), now);
+        BOOST_CHECK(route);
+        // three requests are in flight already
+        BOOST_CHECK(!admission_control.Admit(makeURL("nearest", "1,2"), now));
+    }
+
+    // the budgets are released with the tickets, an idle service admits any request
+    BOOST_CHECK(admission_control.Admit(makeURL("table", "1,2;3,4;5,6;7,8"), now));
+}
+
+BOOST_AUTO_TEST_CASE(queue_time)
+{
+    AdmissionControlConfig config;
+    config.max_queue_time = std::chrono::milliseconds(100);
+    AdmissionControl admission_control(config);
+    const auto now = std::chrono::steady_clock::now();
+
+    BOOST_CHECK(admission_control.Admit(makeURL("route", "1,2;3,4"), now));
+    BOOST_CHECK(!admission_control.Admit(makeURL("route", "1,2;3,4"),
+                                         now - std::chrono::milliseconds(200)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+#include "server/api/body_parser.hpp"
+
+#include "util/debug.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <string>
+
+#define CHECK_EQUAL_RANGE(R1, R2)                                                                  \
+    BOOST_CHECK_EQUAL_COLLECTIONS(R1.begin(), R1.end(), R2.begin(), R2.end());
+
+BOOST_AUTO_TEST_SUITE(api_body_parser)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+void appendLittleEndian(const std::int32_t value, std::string &body)
+{
+    const auto bits = static_cast<std::uint32_t>(value);
+    for (const auto shift : {0, 8, 16, 24})
+    {
+        body.push_back(static_cast<char>((bits >> shift) & 0xff));
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(json_bodies)
+{
+    const std::vector<util::Coordinate> coordinates = {
+        {util::FloatLongitude{7.41}, util::FloatLatitude{43.73}},
+        {util::FloatLongitude{-3.5}, util::FloatLatitude{-1}}};
+
+    api::ParsedURL url_1{"table", 1, "profile", "", 17UL, {}, {}};
+    BOOST_CHECK(api::parseBody("application/json",
+                               R"({"coordinates": [[7.41, 43.73], [-3.5, -1]],
+                                   "sources": [0], "annotations": "duration,distance",
+                                   "bearings": [[10, 20], null], "max_duration": 600.5,
+                                   "generate_hints": false})",
+                               url_1));
+    CHECK_EQUAL_RANGE(coordinates, url_1.coordinates);
+    const std::string query_1 = "?sources=0&annotations=duration,distance&bearings=10,20;&"
+                                "max_duration=600.5&generate_hints=false";
+    CHECK_EQUAL_RANGE(query_1, url_1.query);
+
+    // options of the body follow those of the URL
+    api::ParsedURL url_2{"route", 1, "profile", ".json?steps=true", 18UL, {}, {}};
+    BOOST_CHECK(api::parseBody("application/json; charset=UTF-8",
+                               R"({"coordinates": [[7.41, 43.73], [-3.5, -1]], "overview": "full"})",
+                               url_2));
+    const std::string query_2 = ".json?steps=true&overview=full";
+    CHECK_EQUAL_RANGE(query_2, url_2.query);
+
+    // strings stay a single option, characters that would end it are percent-encoded
+    api::ParsedURL url_3{"route", 1, "profile", "", 18UL, {}, {}};
+    BOOST_CHECK(api::parseBody("application/json",
+                               R"({"coordinates": [[7.41, 43.73], [-3.5, -1]],
+                                   "exclude": "toll&steps=true", "hints": ["a=", "b c?#%"]})",
+                               url_3));
+    const std::string query_3 = "?exclude=toll%26steps=true&hints=a=;b%20c%3F%23%25";
+    CHECK_EQUAL_RANGE(query_3, url_3.query);
+
+    api::ParsedURL url_4{"route", 1, "profile", "", 18UL, {}, {}};
+    BOOST_CHECK(!api::parseBody("application/json", R"({"overview": "full"})", url_4));
+    BOOST_CHECK(!api::parseBody("application/json", R"([[7.41, 43.73]])", url_4));
+    BOOST_CHECK(!api::parseBody("application/json", R"({"coordinates": [[7.41]]})", url_4));
+    BOOST_CHECK(!api::parseBody(
+        "application/json", R"({"coordinates": [[1, 2]], "sources": {"a": 0}})", url_4));
+    BOOST_CHECK(!api::parseBody(
+        "application/json", R"({"coordinates": [[1, 2]], "sources": [[[0]]]})", url_4));
+    BOOST_CHECK(!api::parseBody("application/json", R"({"coordinates": [[1, 2]])", url_4));
+    BOOST_CHECK(!api::parseBody("text/plain", R"({"coordinates": [[1, 2]]})", url_4));
+}
+
+BOOST_AUTO_TEST_CASE(batch_bodies)
+{
+    api::ParsedURL url_1{"batch", 1, "profile", "", 17UL, {}, {}};
+    BOOST_CHECK(api::parseBody(
+        "application/json",
+        R"({"requests": ["/route/v1/driving/1,2;3,4?steps=true", "/nearest/v1/driving/1,2"]})",
+        url_1));
+    BOOST_CHECK_EQUAL(url_1.requests.size(), 2);
+    BOOST_CHECK_EQUAL(url_1.requests[0], "/route/v1/driving/1,2;3,4?steps=true");
+    BOOST_CHECK_EQUAL(url_1.requests[1], "/nearest/v1/driving/1,2");
+    BOOST_CHECK(url_1.coordinates.empty());
+
+    api::ParsedURL url_2{"batch", 1, "profile", "", 17UL, {}, {}};
+    BOOST_CHECK(!api::parseBody("application/json", R"({"requests": []})", url_2));
+    BOOST_CHECK(!api::parseBody("application/json", R"({"requests": [1, 2]})", url_2));
+    BOOST_CHECK(!api::parseBody("application/json", R"({"requests": "/nearest/v1/a/1,2"})", url_2));
+    // sub-requests have their own coordinates
+    BOOST_CHECK(!api::parseBody("application/json",
+                                R"({"requests": ["/nearest/v1/driving/1,2"],
+                                    "coordinates": [[1, 2]]})",
+                                url_2));
+}
+
+BOOST_AUTO_TEST_CASE(binary_bodies)
+{
+    std::string body;
+    appendLittleEndian(7410000, body);
+    appendLittleEndian(43730000, body);
+    appendLittleEndian(-3500000, body);
+    appendLittleEndian(-1000000, body);
+
+    api::ParsedURL url_1{"table", 1, "profile", "?sources=0", 17UL, {}, {}};
+    BOOST_CHECK(api::parseBody("application/octet-stream", body, url_1));
+    BOOST_CHECK_EQUAL(url_1.coordinates.size(), 2);
+    BOOST_CHECK_EQUAL(url_1.coordinates[0].lon, util::FixedLongitude{7410000});
+    BOOST_CHECK_EQUAL(url_1.coordinates[0].lat, util::FixedLatitude{43730000});
+    BOOST_CHECK_EQUAL(url_1.coordinates[1].lon, util::FixedLongitude{-3500000});
+    BOOST_CHECK_EQUAL(url_1.coordinates[1].lat, util::FixedLatitude{-1000000});
+    BOOST_CHECK_EQUAL(url_1.query, "?sources=0");
+
+    api::ParsedURL url_2{"table", 1, "profile", "", 17UL, {}, {}};
+    BOOST_CHECK(!api::parseBody("application/octet-stream", body.substr(0, 12), url_2));
+    BOOST_CHECK(!api::parseBody("application/octet-stream", "", url_2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
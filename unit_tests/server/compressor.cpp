@@ -0,0 +1,125 @@
+#include "server/http/compressor.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <zlib.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(compressor)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+std::string inflateOutput(const std::vector<char> &compressed, const http::compression_type type)
+{
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    BOOST_REQUIRE_EQUAL(
+        inflateInit2(&stream, type == http::deflate_rfc1951 ? -MAX_WBITS : MAX_WBITS + 16),
+        Z_OK);
+
+    std::string inflated;
+    std::vector<char> buffer(1024);
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(compressed.data()));
+    stream.avail_in = compressed.size();
+    int result = Z_OK;
+    while (result == Z_OK)
+    {
+        stream.next_out = reinterpret_cast<Bytef *>(buffer.data());
+        stream.avail_out = buffer.size();
+        result = inflate(&stream, Z_NO_FLUSH);
+        inflated.append(buffer.data(), buffer.size() - stream.avail_out);
+    }
+    BOOST_CHECK_EQUAL(result, Z_STREAM_END);
+    inflateEnd(&stream);
+    return inflated;
+}
+
+std::string makeContent(const std::size_t repetitions)
+{
+    std::string content;
+    for (std::size_t i = 0; i < repetitions; ++i)
+        content += "{\"distance\":" + std::to_string(i) + ",\"duration\":42.1},";
+    return content;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(reused_stream)
+{
+    http::compressor compressor;
+    const auto content = makeContent(1000);
+
+    // the same stream is reset for the next reply and re-initialized for another framing
+    for (const auto type : {http::gzip_rfc1952,
+                            http::gzip_rfc1952,
+                            http::deflate_rfc1951,
+                            http::deflate_rfc1951,
+                            http::gzip_rfc1952})
+    {
+        compressor.begin(type);
+        compressor.write(content.data(), content.size(), false);
+        compressor.finish();
+        BOOST_CHECK_LT(compressor.output().size(), content.size());
+        BOOST_CHECK_EQUAL(inflateOutput(compressor.output(), type), content);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(flushed_chunks)
+{
+    http::compressor compressor;
+    const auto first = makeContent(10);
+    const auto second = makeContent(20000);
+
+    compressor.begin(http::gzip_rfc1952);
+    std::vector<char> compressed;
+    for (const auto &chunk : {first, second, first})
+    {
+        compressor.write(chunk.data(), chunk.size(), true);
+        BOOST_CHECK(!compressor.output().empty());
+        compressed.insert(
+            compressed.end(), compressor.output().begin(), compressor.output().end());
+        compressor.clear_output();
+    }
+    compressor.finish();
+    compressed.insert(compressed.end(), compressor.output().begin(), compressor.output().end());
+
+    BOOST_CHECK_EQUAL(inflateOutput(compressed, http::gzip_rfc1952), first + second + first);
+}
+
+BOOST_AUTO_TEST_CASE(large_reply)
+{
+    http::compressor compressor;
+
+    // incompressible content takes many output blocks
+    std::string content(4 * 1024 * 1024, ' ');
+    unsigned state = 1;
+    for (auto &character : content)
+    {
+        state = state * 1103515245 + 12345;
+        character = static_cast<char>(state >> 16);
+    }
+
+    compressor.begin(http::deflate_rfc1951);
+    compressor.write(content.data(), content.size(), false);
+    compressor.finish();
+    BOOST_CHECK_EQUAL(inflateOutput(compressor.output(), http::deflate_rfc1951), content);
+
+    // the output of a large reply is not kept for the next ones
+    compressor.release_output();
+    BOOST_CHECK(compressor.output().empty());
+    BOOST_CHECK_EQUAL(compressor.output().capacity(), 0);
+
+    const auto small_content = makeContent(10);
+    compressor.begin(http::deflate_rfc1951);
+    compressor.write(small_content.data(), small_content.size(), false);
+    compressor.finish();
+    BOOST_CHECK_EQUAL(inflateOutput(compressor.output(), http::deflate_rfc1951), small_content);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,165 @@
+#include "server/compute_pool.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(compute_pool)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+// Holds the jobs of a test until it is opened
+class Gate
+{
+  public:
+    void Wait()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        ++waiting;
+        arrived.notify_all();
+        opened.wait(guard, [this] { return open; });
+    }
+
+    void WaitForArrivals(const unsigned count)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        arrived.wait(guard, [this, count] { return waiting >= count; });
+    }
+
+    void Open()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        open = true;
+        opened.notify_all();
+    }
+
+  private:
+    std::mutex lock;
+    std::condition_variable arrived;
+    std::condition_variable opened;
+    unsigned waiting = 0;
+    bool open = false;
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(runs_all_jobs)
+{
+    ComputePoolConfig config;
+    config.num_threads = 2;
+    ComputePool pool(config);
+
+    std::atomic<int> runs{0};
+    for (int job = 0; job < 100; ++job)
+    {
+        BOOST_CHECK(pool.Submit("route", [&runs] { ++runs; }));
+    }
+    while (runs < 100)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    BOOST_CHECK_EQUAL(runs, 100);
+}
+
+BOOST_AUTO_TEST_CASE(rejects_beyond_queue_depth)
+{
+    Gate gate;
+    std::atomic<int> runs{0};
+    {
+        ComputePoolConfig config;
+        config.num_threads = 1;
+        config.max_queued_requests = 2;
+        ComputePool pool(config);
+
+        BOOST_CHECK(pool.Submit("table", [&] {
+            gate.Wait();
+            ++runs;
+        }));
+        gate.WaitForArrivals(1);
+        // the running job does not count against the queue
+        BOOST_CHECK(pool.Submit("table", [&] { ++runs; }));
+        BOOST_CHECK(pool.Submit("table", [&] { ++runs; }));
+        BOOST_CHECK(!pool.Submit("table", [&] { ++runs; }));
+        gate.Open();
+        while (runs < 3)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    BOOST_CHECK_EQUAL(runs, 3);
+}
+
+BOOST_AUTO_TEST_CASE(caps_service_concurrency)
+{
+    Gate gate;
+    std::atomic<int> running_tables{0};
+    std::atomic<int> max_running_tables{0};
+    std::atomic<int> nearest_runs{0};
+    {
+        ComputePoolConfig config;
+        config.num_threads = 4;
+        config.max_service_concurrency["table"] = 1;
+        ComputePool pool(config);
+
+        for (int job = 0; job < 3; ++job)
+        {
+            BOOST_CHECK(pool.Submit("table", [&] {
+                max_running_tables = std::max<int>(max_running_tables, ++running_tables);
+                gate.Wait();
+                --running_tables;
+            }));
+        }
+        gate.WaitForArrivals(1);
+
+        // other services pass the waiting table jobs
+        BOOST_CHECK(pool.Submit("nearest", [&] { ++nearest_runs; }));
+        while (nearest_runs == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        gate.Open();
+    }
+    BOOST_CHECK_EQUAL(max_running_tables, 1);
+    BOOST_CHECK_EQUAL(nearest_runs, 1);
+}
+
+BOOST_AUTO_TEST_CASE(runs_thread_hooks)
+{
+    std::atomic<int> starts{0};
+    std::atomic<int> idle_runs{0};
+    std::atomic<int> runs{0};
+    {
+        ComputePoolConfig config;
+        config.num_threads = 2;
+        config.on_start = [&] { ++starts; };
+        config.idle_time = std::chrono::milliseconds(1);
+        config.on_idle = [&] { ++idle_runs; };
+        ComputePool pool(config);
+
+        // every worker runs out of work once
+        while (idle_runs < 2)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        BOOST_CHECK_EQUAL(idle_runs, 2);
+
+        // and again after a job
+        BOOST_CHECK(pool.Submit("route", [&] { ++runs; }));
+        while (idle_runs < 3)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    BOOST_CHECK_EQUAL(starts, 2);
+    BOOST_CHECK_EQUAL(runs, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
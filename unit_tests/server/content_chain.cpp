@@ -0,0 +1,80 @@
+#include "server/http/content_chain.hpp"
+
+#include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(content_chain)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+std::string joinBuffers(const std::vector<boost::asio::const_buffer> &buffers)
+{
+    std::string joined;
+    for (const auto &buffer : buffers)
+    {
+        joined.append(boost::asio::buffer_cast<const char *>(buffer),
+                      boost::asio::buffer_size(buffer));
+    }
+    return joined;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(render_into_blocks)
+{
+    util::json::Array coordinates;
+    for (int i = 0; i < 20000; ++i)
+    {
+        util::json::Array coordinate;
+        coordinate.values.push_back(util::json::Number(13.388798 + i));
+        coordinate.values.push_back(util::json::Number(52.517033));
+        coordinates.values.push_back(std::move(coordinate));
+    }
+    util::json::Object object;
+    object.values["code"] = "Ok";
+    object.values["valid"] = util::json::True();
+    object.values["coordinates"] = std::move(coordinates);
+
+    std::vector<char> contiguous;
+    util::json::render(contiguous, object);
+    const std::string expected(contiguous.begin(), contiguous.end());
+
+    http::content_chain chain;
+    const util::json::BasicArrayRenderer<http::content_chain> renderer(chain);
+    renderer(object);
+
+    // the content spans several blocks that are written out as they are
+    const auto buffers = chain.buffers();
+    BOOST_CHECK_GT(buffers.size(), 1);
+    BOOST_CHECK_EQUAL(boost::asio::buffer_size(buffers.front()), http::content_chain::BLOCK_SIZE);
+    BOOST_CHECK_EQUAL(chain.size(), expected.size());
+    BOOST_CHECK_EQUAL(joinBuffers(buffers), expected);
+}
+
+BOOST_AUTO_TEST_CASE(reused_blocks_start_empty)
+{
+    {
+        http::content_chain chain;
+        for (std::size_t i = 0; i < 2 * http::content_chain::BLOCK_SIZE; ++i)
+            chain.push_back('x');
+    }
+
+    http::content_chain chain;
+    BOOST_CHECK_EQUAL(chain.size(), 0);
+    BOOST_CHECK(chain.buffers().empty());
+
+    chain.push_back('a');
+    chain.push_back('b');
+    BOOST_CHECK_EQUAL(chain.size(), 2);
+    BOOST_CHECK_EQUAL(joinBuffers(chain.buffers()), "ab");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+#include "server/metrics.hpp"
+
+#include "engine/query_statistics.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(metrics)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+bool contains(const std::string &rendered, const std::string &line)
+{
+    return rendered.find(line + "\n") != std::string::npos;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(render_counters)
+{
+    Metrics metrics;
+    metrics.CountRequest("route", 200, std::chrono::milliseconds(3));
+    metrics.CountRequest("route", 200, std::chrono::milliseconds(40));
+    metrics.CountRequest("route", 400, std::chrono::microseconds(100));
+    metrics.CountRequest("unknown", 503, std::chrono::microseconds(100));
+    metrics.CountResponseBytes("table", 1024);
+    metrics.ObservePhase("route", RequestPhase::Parse, std::chrono::microseconds(20));
+
+    const auto rendered = metrics.Render();
+    BOOST_CHECK(contains(rendered, "# TYPE osrm_requests_total counter"));
+    BOOST_CHECK(contains(rendered, "osrm_requests_total{service=\"route\",code=\"200\"} 2"));
+    BOOST_CHECK(contains(rendered, "osrm_requests_total{service=\"route\",code=\"400\"} 1"));
+    BOOST_CHECK(contains(rendered, "osrm_requests_total{service=\"other\",code=\"503\"} 1"));
+    BOOST_CHECK(contains(rendered, "osrm_response_bytes_total{service=\"table\"} 1024"));
+
+    // buckets count all requests up to their bound
+    BOOST_CHECK(contains(rendered,
+                         "osrm_request_duration_seconds_bucket{service=\"route\",le=\"0.0005\"} 1"));
+    BOOST_CHECK(contains(rendered,
+                         "osrm_request_duration_seconds_bucket{service=\"route\",le=\"0.005\"} 2"));
+    BOOST_CHECK(contains(rendered,
+                         "osrm_request_duration_seconds_bucket{service=\"route\",le=\"+Inf\"} 3"));
+    BOOST_CHECK(contains(rendered, "osrm_request_duration_seconds_sum{service=\"route\"} 0.0431"));
+    BOOST_CHECK(contains(rendered, "osrm_request_duration_seconds_count{service=\"route\"} 3"));
+    BOOST_CHECK(contains(rendered,
+                         "osrm_request_phase_duration_seconds_count{service=\"route\","
+                         "phase=\"parse\"} 1"));
+}
+
+BOOST_AUTO_TEST_CASE(query_statistics)
+{
+    engine::QueryStatistics statistics;
+    {
+        engine::QueryStatisticsScope scope(statistics);
+        const engine::QueryPhaseTimer assembly(engine::QueryPhase::Assembly);
+        {
+            const engine::QueryPhaseTimer search(engine::QueryPhase::Search);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+    BOOST_CHECK(statistics.phase_durations[static_cast<int>(engine::QueryPhase::Search)] >=
+                std::chrono::milliseconds(2));
+    // nested phases are not counted for the phase around them
+    BOOST_CHECK(statistics.phase_durations[static_cast<int>(engine::QueryPhase::Assembly)] <
+                std::chrono::milliseconds(2));
+
+    // the scope is gone with the query
+    BOOST_CHECK(engine::QueryStatisticsScope::Current() == nullptr);
+
+    statistics.settled_nodes = 42;
+    Metrics metrics;
+    metrics.ObserveQuery("route", statistics);
+    const auto rendered = metrics.Render();
+    BOOST_CHECK(contains(rendered, "osrm_settled_nodes_total{service=\"route\"} 42"));
+    BOOST_CHECK(contains(rendered,
+                         "osrm_request_phase_duration_seconds_count{service=\"route\","
+                         "phase=\"search\"} 1"));
+    BOOST_CHECK(contains(rendered,
+                         "osrm_request_phase_duration_seconds_count{service=\"route\","
+                         "phase=\"guidance\"} 1"));
+    BOOST_CHECK(contains(rendered, "osrm_data_swaps_total 0"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
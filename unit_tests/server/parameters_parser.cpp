@@ -4,6 +4,7 @@
 
 #include "engine/api/base_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
+#include "engine/api/isochrone_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
 #include "engine/api/table_parameters.hpp"
@@ -76,6 +77,7 @@ BOOST_AUTO_TEST_CASE(invalid_route_urls)
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?annotations=true,false"), 24UL);
     BOOST_CHECK_EQUAL(
         testInvalidOptions<RouteParameters>("1,2;3,4?annotations=&overview=simplified"), 20UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?timeout=-1"), 16UL);
 }
 
 BOOST_AUTO_TEST_CASE(invalid_table_urls)
@@ -92,6 +94,8 @@ BOOST_AUTO_TEST_CASE(invalid_table_urls)
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?fallback_coordinate=asdf"),
                       28UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?fallback_coordinate=10"), 28UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?max_duration=foo"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?max_distance=foo"), 21UL);
     BOOST_CHECK_EQUAL(
         testInvalidOptions<TableParameters>("1,2;3,4?annotations=durations&scale_factor=-1"), 28UL);
     BOOST_CHECK_EQUAL(
@@ -360,6 +364,17 @@ BOOST_AUTO_TEST_CASE(valid_route_urls)
     auto result_13 = parseParameters<RouteParameters>("1,2;3,4");
     BOOST_CHECK(result_13);
     BOOST_CHECK_EQUAL(result_13->generate_hints, true);
+    BOOST_CHECK_EQUAL(result_13->debug_timing, false);
+
+    auto result_debug_timing = parseParameters<RouteParameters>("1,2;3,4?debug_timing=true");
+    BOOST_CHECK(result_debug_timing);
+    BOOST_CHECK_EQUAL(result_debug_timing->debug_timing, true);
+    BOOST_CHECK(!result_debug_timing->timeout);
+
+    auto result_timeout = parseParameters<RouteParameters>("1,2;3,4?timeout=250");
+    BOOST_CHECK(result_timeout);
+    BOOST_CHECK_EQUAL(result_timeout->timeout.value_or(0), 250u);
+    CHECK_EQUAL_RANGE(result_timeout->coordinates, coords_1);
 
     // parse none annotations value correctly
     RouteParameters reference_14{};
@@ -632,6 +647,23 @@ BOOST_AUTO_TEST_CASE(valid_table_urls)
     CHECK_EQUAL_RANGE(reference_1.radiuses, result_11->radiuses);
     CHECK_EQUAL_RANGE(reference_1.approaches, result_11->approaches);
     CHECK_EQUAL_RANGE(reference_1.coordinates, result_11->coordinates);
+
+    auto result_12 = parseParameters<TableParameters>("1,2;3,4?stream=true");
+    BOOST_CHECK(result_12);
+    BOOST_CHECK_EQUAL(result_12->stream, true);
+    BOOST_CHECK_EQUAL(result_1->stream, false);
+
+    auto result_13 = parseParameters<TableParameters>("1,2;3,4?format=bin");
+    BOOST_CHECK(result_13);
+    BOOST_CHECK(result_13->format == engine::api::BaseParameters::OutputFormatType::BINARY);
+    BOOST_CHECK(result_1->format == engine::api::BaseParameters::OutputFormatType::JSON);
+
+    auto result_14 = parseParameters<TableParameters>("1,2;3,4?max_duration=1800&max_distance=2.5");
+    BOOST_CHECK(result_14);
+    BOOST_CHECK_EQUAL(*result_14->max_duration, 1800.);
+    BOOST_CHECK_EQUAL(*result_14->max_distance, 2.5);
+    BOOST_CHECK(!result_1->max_duration);
+    BOOST_CHECK(!result_1->max_distance);
 }
 
 BOOST_AUTO_TEST_CASE(valid_match_urls)
@@ -728,6 +760,38 @@ BOOST_AUTO_TEST_CASE(valid_nearest_urls)
     CHECK_EQUAL_RANGE(reference_2.coordinates, result_2->coordinates);
 }
 
+BOOST_AUTO_TEST_CASE(valid_isochrone_urls)
+{
+    std::vector<util::Coordinate> coords_1 = {{util::FloatLongitude{1}, util::FloatLatitude{2}}};
+
+    IsochroneParameters reference_1{};
+    reference_1.coordinates = coords_1;
+    reference_1.contours = {300, 600};
+    auto result_1 = parseParameters<IsochroneParameters>("1,2?contours=300;600");
+    BOOST_CHECK(result_1);
+    BOOST_CHECK(result_1->IsValid());
+    CHECK_EQUAL_RANGE(reference_1.contours, result_1->contours);
+    BOOST_CHECK_EQUAL(reference_1.polygons, result_1->polygons);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_1->coordinates);
+
+    IsochroneParameters reference_2{};
+    reference_2.coordinates = coords_1;
+    reference_2.contours = {60};
+    reference_2.polygons = true;
+    auto result_2 = parseParameters<IsochroneParameters>("1,2?contours=60&polygons=true");
+    BOOST_CHECK(result_2);
+    CHECK_EQUAL_RANGE(reference_2.contours, result_2->contours);
+    BOOST_CHECK_EQUAL(reference_2.polygons, result_2->polygons);
+
+    auto result_3 = parseParameters<IsochroneParameters>("1,2?contours=600;300");
+    BOOST_CHECK(result_3);
+    BOOST_CHECK(!result_3->IsValid());
+
+    auto result_4 = parseParameters<IsochroneParameters>("1,2");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(!result_4->IsValid());
+}
+
 BOOST_AUTO_TEST_CASE(invalid_tile_urls)
 {
     TileParameters reference_1{1, 2, 3};
@@ -798,4 +862,44 @@ BOOST_AUTO_TEST_CASE(valid_trip_urls)
     BOOST_CHECK_EQUAL(param_fail_2, 33UL);
 }
 
+BOOST_AUTO_TEST_CASE(valid_body_coordinates)
+{
+    std::vector<util::Coordinate> coords = {{util::FloatLongitude{1}, util::FloatLatitude{2}},
+                                            {util::FloatLongitude{3}, util::FloatLatitude{4}}};
+
+    std::string options_1 = "?sources=0&destinations=1";
+    auto iter_1 = options_1.begin();
+    auto result_1 = parseParameters<TableParameters>(iter_1, options_1.end(), coords);
+    BOOST_CHECK(result_1);
+    CHECK_EQUAL_RANGE(coords, result_1->coordinates);
+    BOOST_CHECK_EQUAL(result_1->sources.size(), 1);
+    BOOST_CHECK_EQUAL(result_1->destinations.size(), 1);
+
+    std::string options_2 = "";
+    auto iter_2 = options_2.begin();
+    auto result_2 = parseParameters<RouteParameters>(iter_2, options_2.end(), coords);
+    BOOST_CHECK(result_2);
+    CHECK_EQUAL_RANGE(coords, result_2->coordinates);
+
+    std::string options_3 = ".flatbuffers?overview=false";
+    auto iter_3 = options_3.begin();
+    auto result_3 = parseParameters<RouteParameters>(iter_3, options_3.end(), coords);
+    BOOST_CHECK(result_3);
+    CHECK_EQUAL_RANGE(coords, result_3->coordinates);
+    BOOST_CHECK(result_3->format == BaseParameters::OutputFormatType::FLATBUFFERS);
+
+    // Coordinates are not repeated in the query
+    std::string options_4 = "1,2;3,4?overview=false";
+    auto iter_4 = options_4.begin();
+    BOOST_CHECK(!parseParameters<RouteParameters>(iter_4, options_4.end(), coords));
+    BOOST_CHECK_EQUAL(std::distance(options_4.begin(), iter_4), 0);
+
+    // Without body coordinates they are parsed from the query
+    std::string options_5 = "1,2;3,4?overview=false";
+    auto iter_5 = options_5.begin();
+    auto result_5 = parseParameters<RouteParameters>(iter_5, options_5.end(), {});
+    BOOST_CHECK(result_5);
+    CHECK_EQUAL_RANGE(coords, result_5->coordinates);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
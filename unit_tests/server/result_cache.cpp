@@ -0,0 +1,115 @@
+#include "server/result_cache.hpp"
+
+#include "engine/data_watchdog.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(result_cache)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+api::ParsedURL makeURL(const std::string &service, const std::string &query)
+{
+    api::ParsedURL parsed_url;
+    parsed_url.service = service;
+    parsed_url.version = 1;
+    parsed_url.profile = "car";
+    parsed_url.query = query;
+    return parsed_url;
+}
+
+ResultCache::EntryPtr makeEntry(const std::size_t size)
+{
+    auto entry = std::make_shared<ResultCache::Entry>();
+    entry->headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
+    entry->content.assign(size, 'x');
+    return entry;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(canonical_keys)
+{
+    ResultCacheConfig config;
+    config.max_size_in_bytes = 1024 * 1024;
+    const ResultCache cache(config);
+
+    const auto key = cache.MakeKey(makeURL("route", "1,2;3,4?steps=true&overview=false"));
+    BOOST_CHECK_EQUAL(key, "route/v1/car/1,2;3,4?overview=false&steps=true");
+    BOOST_CHECK_EQUAL(key, cache.MakeKey(makeURL("route", "1,2;3,4?overview=false&steps=true")));
+    BOOST_CHECK_EQUAL(cache.MakeKey(makeURL("nearest", "1,2.json")), "nearest/v1/car/1,2.json");
+
+    // repeated options keep their order
+    BOOST_CHECK(cache.MakeKey(makeURL("route", "1,2;3,4?steps=true&steps=false")) !=
+                cache.MakeKey(makeURL("route", "1,2;3,4?steps=false&steps=true")));
+
+    // coordinates of a request body
+    auto body_url = makeURL("route", "?steps=true");
+    body_url.coordinates.push_back(
+        util::Coordinate{util::FloatLongitude{1}, util::FloatLatitude{2}});
+    BOOST_CHECK_EQUAL(cache.MakeKey(body_url), "route/v1/car/?steps=true;1000000,2000000");
+
+    // uncached services and timed requests
+    BOOST_CHECK(cache.MakeKey(makeURL("table", "1,2;3,4")).empty());
+    BOOST_CHECK(cache.MakeKey(makeURL("route", "1,2;3,4?debug_timing=true")).empty());
+    auto batch_url = makeURL("route", "");
+    batch_url.requests = {"/route/v1/driving/1,2;3,4"};
+    BOOST_CHECK(cache.MakeKey(batch_url).empty());
+}
+
+BOOST_AUTO_TEST_CASE(least_recently_used)
+{
+    ResultCacheConfig config;
+    // 16 shards of 4 KiB
+    config.max_size_in_bytes = 64 * 1024;
+    ResultCache cache(config);
+    const auto generation = ResultCache::GetGeneration();
+
+    BOOST_CHECK(!cache.Get("a"));
+    cache.Put("a", generation, makeEntry(100));
+    const auto entry = cache.Get("a");
+    BOOST_REQUIRE(entry);
+    BOOST_CHECK_EQUAL(entry->content.size(), 100u);
+    BOOST_CHECK_EQUAL(entry->headers.size(), 1u);
+
+    // larger than a shard
+    cache.Put("b", generation, makeEntry(8 * 1024));
+    BOOST_CHECK(!cache.Get("b"));
+
+    // new entries push out the least recently used ones of their shard
+    for (std::size_t index = 0; index < 100; ++index)
+    {
+        cache.Put("c" + std::to_string(index), generation, makeEntry(1024));
+    }
+    BOOST_CHECK(cache.GetSizeInBytes() <= config.max_size_in_bytes);
+    BOOST_CHECK(cache.Get("c99"));
+}
+
+BOOST_AUTO_TEST_CASE(data_updates)
+{
+    ResultCacheConfig config;
+    config.max_size_in_bytes = 1024 * 1024;
+    ResultCache cache(config);
+
+    const auto generation = ResultCache::GetGeneration();
+    cache.Put("a", generation, makeEntry(100));
+    BOOST_CHECK(cache.Get("a"));
+
+    engine::detail::CountDataSwap();
+    BOOST_CHECK(!cache.Get("a"));
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 0u);
+
+    // replies computed from the replaced data are not stored
+    cache.Put("a", generation, makeEntry(100));
+    BOOST_CHECK(!cache.Get("a"));
+    cache.Put("a", ResultCache::GetGeneration(), makeEntry(100));
+    BOOST_CHECK(cache.Get("a"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -51,7 +51,8 @@ BOOST_AUTO_TEST_CASE(invalid_urls)
 
 BOOST_AUTO_TEST_CASE(valid_urls)
 {
-    api::ParsedURL reference_1{"route", 1, "profile", "0,1;2,3;4,5?options=value&foo=bar", 18UL};
+    api::ParsedURL reference_1{
+        "route", 1, "profile", "0,1;2,3;4,5?options=value&foo=bar", 18UL, {}, {}};
     auto result_1 = api::parseURL("/route/v1/profile/0,1;2,3;4,5?options=value&foo=bar");
     BOOST_CHECK(result_1);
     BOOST_CHECK_EQUAL(reference_1.service, result_1->service);
@@ -61,7 +62,7 @@ BOOST_AUTO_TEST_CASE(valid_urls)
     BOOST_CHECK_EQUAL(reference_1.prefix_length, result_1->prefix_length);
 
     // no options
-    api::ParsedURL reference_2{"route", 1, "profile", "0,1;2,3;4,5", 18UL};
+    api::ParsedURL reference_2{"route", 1, "profile", "0,1;2,3;4,5", 18UL, {}, {}};
     auto result_2 = api::parseURL("/route/v1/profile/0,1;2,3;4,5");
     BOOST_CHECK(result_2);
     BOOST_CHECK_EQUAL(reference_2.service, result_2->service);
@@ -74,7 +75,7 @@ BOOST_AUTO_TEST_CASE(valid_urls)
     std::vector<util::Coordinate> coords_3 = {
         util::Coordinate{util::FloatLongitude{0}, util::FloatLatitude{1}},
     };
-    api::ParsedURL reference_3{"route", 1, "profile", "0,1", 18UL};
+    api::ParsedURL reference_3{"route", 1, "profile", "0,1", 18UL, {}, {}};
     auto result_3 = api::parseURL("/route/v1/profile/0,1");
     BOOST_CHECK(result_3);
     BOOST_CHECK_EQUAL(reference_3.service, result_3->service);
@@ -84,7 +85,8 @@ BOOST_AUTO_TEST_CASE(valid_urls)
     BOOST_CHECK_EQUAL(reference_3.prefix_length, result_3->prefix_length);
 
     // polyline
-    api::ParsedURL reference_5{"route", 1, "profile", "polyline(_ibE?_seK_seK_seK_seK)?", 18UL};
+    api::ParsedURL reference_5{
+        "route", 1, "profile", "polyline(_ibE?_seK_seK_seK_seK)?", 18UL, {}, {}};
     auto result_5 = api::parseURL("/route/v1/profile/polyline(_ibE?_seK_seK_seK_seK)?");
     BOOST_CHECK(result_5);
     BOOST_CHECK_EQUAL(reference_5.service, result_5->service);
@@ -94,7 +96,8 @@ BOOST_AUTO_TEST_CASE(valid_urls)
     BOOST_CHECK_EQUAL(reference_5.prefix_length, result_5->prefix_length);
 
     // polyline6
-    api::ParsedURL reference_6{"route", 1, "profile", "polyline6(_ibE?_seK_seK_seK_seK)?", 18UL};
+    api::ParsedURL reference_6{
+        "route", 1, "profile", "polyline6(_ibE?_seK_seK_seK_seK)?", 18UL, {}, {}};
     auto result_6 = api::parseURL("/route/v1/profile/polyline6(_ibE?_seK_seK_seK_seK)?");
     BOOST_CHECK(result_6);
     BOOST_CHECK_EQUAL(reference_6.service, result_6->service);
@@ -104,7 +107,7 @@ BOOST_AUTO_TEST_CASE(valid_urls)
     BOOST_CHECK_EQUAL(reference_6.prefix_length, result_6->prefix_length);
 
     // tile
-    api::ParsedURL reference_7{"route", 1, "profile", "tile(1,2,3).mvt", 18UL};
+    api::ParsedURL reference_7{"route", 1, "profile", "tile(1,2,3).mvt", 18UL, {}, {}};
     auto result_7 = api::parseURL("/route/v1/profile/tile(1,2,3).mvt");
     BOOST_CHECK(result_7);
     BOOST_CHECK_EQUAL(reference_7.service, result_7->service);
@@ -115,7 +118,7 @@ BOOST_AUTO_TEST_CASE(valid_urls)
 
     // polyline with %HEX
     api::ParsedURL reference_8{
-        "match", 1, "car", "polyline(}jmwFz~ubMyCa@`@yDJqE)?你好&\n \"%~", 14UL};
+        "match", 1, "car", "polyline(}jmwFz~ubMyCa@`@yDJqE)?你好&\n \"%~", 14UL, {}, {}};
     auto result_8 = api::parseURL(
         "/match/v1/car/polyline(%7DjmwFz~ubMyCa@%60@yDJqE)?%e4%bd%a0%e5%a5%bd&%0A%20%22%25%7e");
     BOOST_CHECK(result_8);
@@ -126,4 +129,32 @@ BOOST_AUTO_TEST_CASE(valid_urls)
     BOOST_CHECK_EQUAL(reference_8.prefix_length, result_8->prefix_length);
 }
 
+BOOST_AUTO_TEST_CASE(body_urls)
+{
+    api::ParsedURL reference_1{"table", 1, "profile", "?sources=0", 17UL, {}, {}};
+    auto result_1 = api::parseBodyURL("/table/v1/profile?sources=0");
+    BOOST_CHECK(result_1);
+    BOOST_CHECK_EQUAL(reference_1.service, result_1->service);
+    BOOST_CHECK_EQUAL(reference_1.version, result_1->version);
+    BOOST_CHECK_EQUAL(reference_1.profile, result_1->profile);
+    CHECK_EQUAL_RANGE(reference_1.query, result_1->query);
+    BOOST_CHECK_EQUAL(reference_1.prefix_length, result_1->prefix_length);
+
+    auto result_2 = api::parseBodyURL("/table/v1/profile");
+    BOOST_CHECK(result_2);
+    BOOST_CHECK(result_2->query.empty());
+    BOOST_CHECK_EQUAL(result_2->prefix_length, 17UL);
+
+    auto result_3 = api::parseBodyURL("/route/v1/profile/.flatbuffers?steps=true");
+    BOOST_CHECK(result_3);
+    const std::string query_3 = ".flatbuffers?steps=true";
+    CHECK_EQUAL_RANGE(query_3, result_3->query);
+    BOOST_CHECK_EQUAL(result_3->prefix_length, 18UL);
+
+    std::string invalid = "/route/1/profile";
+    auto iter = invalid.begin();
+    BOOST_CHECK(!api::parseBodyURL(iter, invalid.end()));
+    BOOST_CHECK_EQUAL(std::distance(invalid.begin(), iter), 7);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
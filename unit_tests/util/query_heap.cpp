@@ -22,10 +22,16 @@ struct TestData
 typedef NodeID TestNodeID;
 typedef int TestKey;
 typedef int TestWeight;
-typedef boost::mpl::list<ArrayStorage<TestNodeID, TestKey>,
-                         MapStorage<TestNodeID, TestKey>,
-                         UnorderedMapStorage<TestNodeID, TestKey>>
-    storage_types;
+template <typename Storage, template <typename W, typename K> class PriorityQueue = DAryHeapQueue>
+using TestHeap = QueryHeap<TestNodeID, TestKey, TestWeight, TestData, Storage, PriorityQueue>;
+typedef boost::mpl::list<TestHeap<ArrayStorage<TestNodeID, TestKey>>,
+                         TestHeap<MapStorage<TestNodeID, TestKey>>,
+                         TestHeap<UnorderedMapStorage<TestNodeID, TestKey>>,
+                         TestHeap<GenerationArrayStorage<TestNodeID, TestKey>>,
+                         TestHeap<FlatHashStorage<TestNodeID, TestKey>>,
+                         TestHeap<ArrayStorage<TestNodeID, TestKey>, RadixHeapQueue>,
+                         TestHeap<UnorderedMapStorage<TestNodeID, TestKey>, RadixHeapQueue>>
+    heap_types;
 
 template <unsigned NUM_ELEM> struct RandomDataFixture
 {
@@ -53,9 +59,9 @@ template <unsigned NUM_ELEM> struct RandomDataFixture
 
 constexpr unsigned NUM_NODES = 100;
 
-BOOST_FIXTURE_TEST_CASE_TEMPLATE(insert_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(insert_test, T, heap_types, RandomDataFixture<NUM_NODES>)
 {
-    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+    T heap(NUM_NODES);
 
     TestWeight min_weight = std::numeric_limits<TestWeight>::max();
     TestNodeID min_id;
@@ -86,9 +92,9 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(insert_test, T, storage_types, RandomDataFixtur
     }
 }
 
-BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_min_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_min_test, T, heap_types, RandomDataFixture<NUM_NODES>)
 {
-    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+    T heap(NUM_NODES);
 
     for (unsigned idx : order)
     {
@@ -108,9 +114,9 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_min_test, T, storage_types, RandomDataFi
     }
 }
 
-BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_all_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_all_test, T, heap_types, RandomDataFixture<NUM_NODES>)
 {
-    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+    T heap(NUM_NODES);
 
     for (unsigned idx : order)
     {
@@ -122,9 +128,9 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_all_test, T, storage_types, RandomDataFi
     BOOST_CHECK(heap.Empty());
 }
 
-BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomDataFixture<10>)
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, heap_types, RandomDataFixture<10>)
 {
-    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(10);
+    T heap(10);
 
     for (unsigned idx : order)
     {
@@ -156,4 +162,131 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomData
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(counters_test, T, heap_types, RandomDataFixture<NUM_NODES>)
+{
+    T heap(NUM_NODES);
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+    heap.DeleteMin();
+    heap.DeleteMinGetHeapNode();
+    heap.CountRelaxedEdges(5, 2);
+    BOOST_CHECK_EQUAL(heap.GetCounters().settled_nodes, 2u);
+    BOOST_CHECK_EQUAL(heap.GetCounters().relaxed_edges, 5u);
+    BOOST_CHECK_EQUAL(heap.GetCounters().overlay_edges, 2u);
+
+    // the counters outlive the searches
+    const auto counters = heap.GetCounters();
+    heap.Clear();
+    heap.Insert(ids[0], weights[0], data[0]);
+    heap.DeleteMin();
+    heap.CountRelaxedEdges(3);
+    const auto difference = heap.GetCounters() - counters;
+    BOOST_CHECK_EQUAL(difference.settled_nodes, 1u);
+    BOOST_CHECK_EQUAL(difference.relaxed_edges, 3u);
+    BOOST_CHECK_EQUAL(difference.overlay_edges, 0u);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(shrink_test, T, heap_types, RandomDataFixture<NUM_NODES>)
+{
+    T heap(NUM_NODES);
+    const auto initial_size = heap.GetSizeInBytes();
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+    BOOST_CHECK(heap.GetSizeInBytes() > initial_size);
+
+    // the heap is empty and holds its initial memory, it can be used again
+    heap.Shrink();
+    BOOST_CHECK(heap.Empty());
+    BOOST_CHECK(!heap.WasInserted(ids[0]));
+    BOOST_CHECK_EQUAL(heap.GetSizeInBytes(), initial_size);
+
+    heap.Insert(ids[1], weights[1], data[1]);
+    heap.Insert(ids[0], weights[0], data[0]);
+    BOOST_CHECK_EQUAL(heap.DeleteMin(), ids[0]);
+    BOOST_CHECK(heap.WasInserted(ids[1]));
+}
+
+BOOST_AUTO_TEST_CASE(radix_heap_order_test)
+{
+    // pops of both queues agree, also for negative weights and weights below the last pop
+    TestHeap<ArrayStorage<TestNodeID, TestKey>> dary_heap(1000);
+    TestHeap<ArrayStorage<TestNodeID, TestKey>, RadixHeapQueue> radix_heap(1000);
+    std::mt19937 g(42);
+    std::uniform_int_distribution<TestWeight> weight_distribution(-1000, 100000);
+
+    TestNodeID next_node = 0;
+    for (unsigned round = 0; round < 2; ++round)
+    {
+        for (unsigned step = 0; step < 5000; ++step)
+        {
+            const auto weight = weight_distribution(g);
+            if (next_node < 1000 && (step % 3 != 0 || dary_heap.Empty()))
+            {
+                dary_heap.Insert(next_node, weight, TestData{next_node});
+                radix_heap.Insert(next_node, weight, TestData{next_node});
+                ++next_node;
+            }
+            else if (!dary_heap.Empty())
+            {
+                const auto node = next_node - 1 - g() % next_node;
+                if (step % 2 == 0 && !dary_heap.WasRemoved(node) &&
+                    !radix_heap.WasRemoved(node) && weight < dary_heap.GetKey(node))
+                {
+                    dary_heap.DecreaseKey(node, weight);
+                    radix_heap.DecreaseKey(node, weight);
+                    BOOST_CHECK(!radix_heap.WasRemoved(node));
+                }
+                else
+                {
+                    BOOST_REQUIRE_EQUAL(dary_heap.MinKey(), radix_heap.MinKey());
+                    const auto dary_node = dary_heap.DeleteMin();
+                    const auto radix_node = radix_heap.DeleteMin();
+                    // equal weights may be popped in any order
+                    BOOST_CHECK_EQUAL(dary_heap.GetKey(dary_node), radix_heap.GetKey(radix_node));
+                    BOOST_CHECK(radix_heap.WasRemoved(radix_node));
+                }
+            }
+            BOOST_REQUIRE_EQUAL(dary_heap.Size(), radix_heap.Size());
+        }
+
+        dary_heap.Clear();
+        radix_heap.Clear();
+        next_node = 0;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_storage_test)
+{
+    FlatHashStorage<TestNodeID, TestKey> storage(0);
+    const auto initial_size = storage.GetSizeInBytes();
+
+    // spread ids far apart and past the initial capacity so the table grows with collisions
+    for (unsigned round = 0; round < 3; ++round)
+    {
+        for (TestNodeID node = 0; node < 5000; ++node)
+        {
+            BOOST_CHECK_EQUAL(storage.peek_index(node * 1024 + round),
+                              std::numeric_limits<TestKey>::max());
+            storage[node * 1024 + round] = node + round;
+        }
+        for (TestNodeID node = 0; node < 5000; ++node)
+        {
+            BOOST_CHECK_EQUAL(storage.peek_index(node * 1024 + round), node + round);
+        }
+        BOOST_CHECK(storage.GetSizeInBytes() > initial_size);
+
+        // entries of earlier searches are gone, the table keeps its memory
+        const auto size = storage.GetSizeInBytes();
+        storage.Clear();
+        BOOST_CHECK_EQUAL(storage.peek_index(round), std::numeric_limits<TestKey>::max());
+        BOOST_CHECK_EQUAL(storage.GetSizeInBytes(), size);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()